@@ -0,0 +1,135 @@
+/**
+ * Oh My Ondas - Host HAL: Arduino core
+ * Simulated clock, Print and Serial for the native build
+ */
+
+#include "Arduino.h"
+#include "host_hal.h"
+#include <stdarg.h>
+#include <chrono>
+
+extern "C" { uint8_t external_psram_size = 8; }
+
+HostSerial Serial;
+HostSerial Serial2;
+
+static uint64_t clockMicros = 0;
+static bool serialEcho = true;
+static uint32_t randomState = 1;
+
+// ============================================
+// CLOCK
+// ============================================
+
+uint64_t hostClockMicros() {
+    return clockMicros;
+}
+
+void hostClockSet(uint64_t us) {
+    clockMicros = us;
+}
+
+void hostClockAdvance(uint64_t us) {
+    clockMicros += us;
+}
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(clockMicros / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)clockMicros;
+}
+
+void delay(uint32_t ms) {
+    clockMicros += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+    clockMicros += us;
+}
+
+uint32_t hostCycleCount() {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return (uint32_t)((unsigned __int128)ns * F_CPU_ACTUAL / 1000000000ULL);
+}
+
+// ============================================
+// RANDOM (same contract as Arduino: [0, howBig))
+// ============================================
+
+void randomSeed(unsigned long seed) {
+    randomState = seed ? (uint32_t)seed : 1;
+}
+
+long random(long howBig) {
+    if (howBig <= 0) return 0;
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return (long)(randomState % (uint32_t)howBig);
+}
+
+long random(long howSmall, long howBig) {
+    if (howSmall >= howBig) return howSmall;
+    return howSmall + random(howBig - howSmall);
+}
+
+// ============================================
+// PRINT
+// ============================================
+
+size_t Print::write(const uint8_t* buf, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buf++);
+    return n;
+}
+
+size_t Print::print(long n, int base) {
+    char buf[40];
+    if (base == HEX) snprintf(buf, sizeof(buf), "%lX", (unsigned long)n);
+    else snprintf(buf, sizeof(buf), "%ld", n);
+    return write(buf);
+}
+
+size_t Print::print(unsigned long n, int base) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), base == HEX ? "%lX" : "%lu", n);
+    return write(buf);
+}
+
+size_t Print::print(double n, int digits) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+}
+
+int Print::printf(const char* format, ...) {
+    char buf[512];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return len;
+    if (len >= (int)sizeof(buf)) len = sizeof(buf) - 1;
+    return (int)write((const uint8_t*)buf, len);
+}
+
+// ============================================
+// SERIAL
+// ============================================
+
+void hostSerialEcho(bool enabled) {
+    serialEcho = enabled;
+}
+
+size_t HostSerial::write(uint8_t b) {
+    if (serialEcho) fputc(b, stdout);
+    return 1;
+}
+
+size_t HostSerial::write(const uint8_t* buf, size_t size) {
+    if (serialEcho) fwrite(buf, 1, size, stdout);
+    return size;
+}
@@ -0,0 +1,592 @@
+/**
+ * Oh My Ondas - Host HAL: Audio objects
+ * Offline versions of the Teensy Audio Library objects the firmware uses
+ */
+
+#include "Audio.h"
+
+static inline int16_t saturate16(int32_t v) {
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+static inline int32_t gainQ16(float g) {
+    if (g > 32767.0f) g = 32767.0f;
+    if (g < -32767.0f) g = -32767.0f;
+    return (int32_t)(g * 65536.0f);
+}
+
+// ============================================
+// AudioAmplifier
+// ============================================
+
+void AudioAmplifier::gain(float n) {
+    multiplier = gainQ16(n);
+}
+
+void AudioAmplifier::update(void) {
+    if (multiplier == 0) {
+        audio_block_t* block = receiveReadOnly();
+        if (block) release(block);
+        return;
+    }
+    if (multiplier == 65536) {
+        audio_block_t* block = receiveReadOnly();
+        if (block) {
+            transmit(block);
+            release(block);
+        }
+        return;
+    }
+
+    audio_block_t* block = receiveWritable();
+    if (!block) return;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        block->data[i] = saturate16((int32_t)(((int64_t)block->data[i] * multiplier) >> 16));
+    }
+    transmit(block);
+    release(block);
+}
+
+// ============================================
+// AudioMixer4
+// ============================================
+
+void AudioMixer4::gain(unsigned int channel, float gain) {
+    if (channel >= 4) return;
+    multiplier[channel] = gainQ16(gain);
+}
+
+void AudioMixer4::update(void) {
+    audio_block_t* out = nullptr;
+
+    for (int ch = 0; ch < 4; ch++) {
+        if (!out) {
+            out = receiveWritable(ch);
+            if (out && multiplier[ch] != 65536) {
+                for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+                    out->data[i] = saturate16((int32_t)(((int64_t)out->data[i] * multiplier[ch]) >> 16));
+                }
+            }
+        } else {
+            audio_block_t* in = receiveReadOnly(ch);
+            if (!in) continue;
+            for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+                int32_t v = (int32_t)(((int64_t)in->data[i] * multiplier[ch]) >> 16);
+                out->data[i] = saturate16(out->data[i] + v);
+            }
+            release(in);
+        }
+    }
+
+    if (out) {
+        transmit(out);
+        release(out);
+    }
+}
+
+// ============================================
+// AudioFilterStateVariable
+// ============================================
+
+void AudioFilterStateVariable::frequency(float freq) {
+    if (freq < 20.0f) freq = 20.0f;
+    if (freq > AUDIO_SAMPLE_RATE_EXACT / 2.5f) freq = AUDIO_SAMPLE_RATE_EXACT / 2.5f;
+    f = 2.0f * sinf((float)M_PI * freq / (2.0f * AUDIO_SAMPLE_RATE_EXACT));
+}
+
+void AudioFilterStateVariable::resonance(float q) {
+    if (q < 0.7f) q = 0.7f;
+    if (q > 5.0f) q = 5.0f;
+    damp = 1.0f / q;
+}
+
+void AudioFilterStateVariable::update(void) {
+    audio_block_t* in = receiveReadOnly(0);
+    audio_block_t* ctrl = receiveReadOnly(1);
+    if (ctrl) release(ctrl);    // Frequency control input is not modelled
+    if (!in) {
+        lowState = bandState = 0.0f;
+        return;
+    }
+
+    audio_block_t* lp = allocate();
+    audio_block_t* bp = allocate();
+    audio_block_t* hp = allocate();
+
+    float low = lowState, band = bandState, high = 0.0f;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        float x = in->data[i];
+        for (int pass = 0; pass < 2; pass++) {
+            low += f * band;
+            high = x - low - damp * band;
+            band += f * high;
+        }
+        if (lp) lp->data[i] = saturate16((int32_t)low);
+        if (bp) bp->data[i] = saturate16((int32_t)band);
+        if (hp) hp->data[i] = saturate16((int32_t)high);
+    }
+    lowState = low;
+    bandState = band;
+    release(in);
+
+    if (lp) { transmit(lp, 0); release(lp); }
+    if (bp) { transmit(bp, 1); release(bp); }
+    if (hp) { transmit(hp, 2); release(hp); }
+}
+
+// ============================================
+// AudioPlaySdWav
+// ============================================
+
+static uint32_t le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool AudioPlaySdWav::play(const char* filename) {
+    stop();
+    file = SD.open(filename);
+    if (!file) return false;
+
+    uint8_t hdr[12];
+    if (file.read(hdr, 12) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) {
+        file.close();
+        return false;
+    }
+
+    uint16_t bits = 0;
+    channels = 0;
+    uint32_t pos = 12;
+    while (true) {
+        uint8_t ch[8];
+        if (!file.seek(pos) || file.read(ch, 8) != 8) break;
+        uint32_t size = le32(ch + 4);
+        if (memcmp(ch, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < 16 || file.read(fmt, 16) != 16) break;
+            channels = fmt[2] | (fmt[3] << 8);
+            sampleRate = le32(fmt + 4);
+            bits = fmt[14] | (fmt[15] << 8);
+        } else if (memcmp(ch, "data", 4) == 0) {
+            if (bits != 16 || channels < 1 || channels > 2) break;
+            totalFrames = size / (channels * 2);
+            remaining = totalFrames;
+            playing = remaining > 0;
+            return playing;
+        }
+        pos += 8 + size + (size & 1);
+    }
+
+    file.close();
+    return false;
+}
+
+void AudioPlaySdWav::stop() {
+    playing = false;
+    remaining = 0;
+    file.close();
+}
+
+uint32_t AudioPlaySdWav::positionMillis() {
+    if (!sampleRate) return 0;
+    return (uint32_t)((uint64_t)(totalFrames - remaining) * 1000 / sampleRate);
+}
+
+uint32_t AudioPlaySdWav::lengthMillis() {
+    if (!sampleRate) return 0;
+    return (uint32_t)((uint64_t)totalFrames * 1000 / sampleRate);
+}
+
+void AudioPlaySdWav::update(void) {
+    if (!playing) return;
+
+    audio_block_t* left = allocate();
+    audio_block_t* right = (channels == 2) ? allocate() : nullptr;
+    if (!left) {
+        if (right) release(right);
+        return;
+    }
+
+    int16_t pcm[AUDIO_BLOCK_SAMPLES * 2];
+    uint32_t frames = remaining < AUDIO_BLOCK_SAMPLES ? remaining : AUDIO_BLOCK_SAMPLES;
+    int got = file.read(pcm, frames * channels * 2);
+    if (got < 0) got = 0;
+    frames = got / (channels * 2);
+
+    for (uint32_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        bool in = i < frames;
+        left->data[i] = in ? pcm[i * channels] : 0;
+        if (right) right->data[i] = in ? pcm[i * channels + 1] : 0;
+    }
+
+    remaining -= frames;
+    if (remaining == 0 || frames < AUDIO_BLOCK_SAMPLES) stop();
+
+    transmit(left, 0);
+    transmit(right ? right : left, 1);
+    release(left);
+    if (right) release(right);
+}
+
+// ============================================
+// AudioEffectDelay
+// ============================================
+
+AudioEffectDelay::AudioEffectDelay()
+    : AudioStream(1, inputQueueArray)
+    , line(new int16_t[LINE_SAMPLES]())
+    , head(0)
+    , tapActive(0)
+{
+    memset(tapDelay, 0, sizeof(tapDelay));
+}
+
+void AudioEffectDelay::delay(uint8_t channel, float milliseconds) {
+    if (channel >= 8) return;
+    if (milliseconds < 0.0f) milliseconds = 0.0f;
+    uint32_t n = (uint32_t)(milliseconds * AUDIO_SAMPLE_RATE_EXACT / 1000.0f + 0.5f);
+    if (n > LINE_SAMPLES - AUDIO_BLOCK_SAMPLES) n = LINE_SAMPLES - AUDIO_BLOCK_SAMPLES;
+    tapDelay[channel] = n;
+    tapActive |= 1 << channel;
+}
+
+void AudioEffectDelay::disable(uint8_t channel) {
+    if (channel < 8) tapActive &= ~(1 << channel);
+}
+
+void AudioEffectDelay::update(void) {
+    audio_block_t* in = receiveReadOnly();
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        line[(head + i) & (LINE_SAMPLES - 1)] = in ? in->data[i] : 0;
+    }
+    if (in) release(in);
+
+    for (int ch = 0; ch < 8; ch++) {
+        if (!(tapActive & (1 << ch))) continue;
+        audio_block_t* out = allocate();
+        if (!out) continue;
+        uint32_t start = head - tapDelay[ch];
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+            out->data[i] = line[(start + i) & (LINE_SAMPLES - 1)];
+        }
+        transmit(out, ch);
+        release(out);
+    }
+    head = (head + AUDIO_BLOCK_SAMPLES) & (LINE_SAMPLES - 1);
+}
+
+// ============================================
+// AudioEffectBitcrusher
+// ============================================
+
+void AudioEffectBitcrusher::bits(uint8_t b) {
+    crushBits = constrain(b, 1, 16);
+}
+
+void AudioEffectBitcrusher::sampleRate(float hz) {
+    int step = 1;
+    if (hz > 0.0f) step = (int)(0.5f + AUDIO_SAMPLE_RATE_EXACT / hz);
+    sampleStep = constrain(step, 1, 64);
+}
+
+void AudioEffectBitcrusher::update(void) {
+    if (crushBits == 16 && sampleStep <= 1) {
+        audio_block_t* block = receiveReadOnly();
+        if (block) {
+            transmit(block);
+            release(block);
+        }
+        return;
+    }
+
+    audio_block_t* block = receiveWritable();
+    if (!block) return;
+
+    int shift = 16 - crushBits;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i += sampleStep) {
+        int16_t held = (int16_t)((block->data[i] >> shift) << shift);
+        for (int j = i; j < i + sampleStep && j < AUDIO_BLOCK_SAMPLES; j++) {
+            block->data[j] = held;
+        }
+    }
+    transmit(block);
+    release(block);
+}
+
+// ============================================
+// AudioSynthWaveform / AudioSynthNoiseWhite
+// ============================================
+
+void AudioSynthWaveform::frequency(float freq) {
+    if (freq < 0.0f) freq = 0.0f;
+    if (freq > AUDIO_SAMPLE_RATE_EXACT / 2.0f) freq = AUDIO_SAMPLE_RATE_EXACT / 2.0f;
+    phaseInc = (uint32_t)(freq * (4294967296.0f / AUDIO_SAMPLE_RATE_EXACT));
+}
+
+void AudioSynthWaveform::amplitude(float n) {
+    magnitude = gainQ16(constrain(n, 0.0f, 1.0f));
+}
+
+void AudioSynthWaveform::update(void) {
+    if (magnitude == 0) {
+        phaseAcc += phaseInc * AUDIO_BLOCK_SAMPLES;
+        return;
+    }
+    audio_block_t* block = allocate();
+    if (!block) return;
+
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        int32_t v;
+        switch (tone) {
+            case WAVEFORM_SAWTOOTH:         v = (int16_t)(phaseAcc >> 16);              break;
+            case WAVEFORM_SAWTOOTH_REVERSE: v = -(int32_t)(int16_t)(phaseAcc >> 16);    break;
+            case WAVEFORM_SQUARE:
+            case WAVEFORM_PULSE:            v = (phaseAcc & 0x80000000u) ? -32767 : 32767; break;
+            case WAVEFORM_TRIANGLE: {
+                uint32_t p = phaseAcc >> 15;             // 0..131071
+                v = (p < 65536) ? (int32_t)p - 32768 : 98303 - (int32_t)p;
+                break;
+            }
+            case WAVEFORM_SAMPLE_HOLD:
+                if (phaseAcc < phaseInc) held = (int16_t)random(-32767, 32768);
+                v = held;
+                break;
+            default:
+                v = (int32_t)(sinf(phaseAcc * (2.0f * (float)M_PI / 4294967296.0f)) * 32767.0f);
+                break;
+        }
+        block->data[i] = saturate16((int32_t)(((int64_t)v * magnitude) >> 16));
+        phaseAcc += phaseInc;
+    }
+    transmit(block);
+    release(block);
+}
+
+void AudioSynthNoiseWhite::amplitude(float n) {
+    level = gainQ16(constrain(n, 0.0f, 1.0f));
+}
+
+void AudioSynthNoiseWhite::update(void) {
+    if (level == 0) return;
+    audio_block_t* block = allocate();
+    if (!block) return;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int32_t v = (int16_t)(seed >> 16);
+        block->data[i] = (int16_t)((v * level) >> 16);
+    }
+    transmit(block);
+    release(block);
+}
+
+// ============================================
+// AudioFilterLadder
+// ============================================
+
+void AudioFilterLadder::frequency(float freq) {
+    freq = constrain(freq, 5.0f, AUDIO_SAMPLE_RATE_EXACT * 0.45f);
+    g = 1.0f - expf(-2.0f * (float)M_PI * freq / AUDIO_SAMPLE_RATE_EXACT);
+}
+
+void AudioFilterLadder::resonance(float res) {
+    // Library range 0..1.8 (self-oscillation near 1); feedback up to 4
+    k = constrain(res, 0.0f, 1.8f) * (4.0f / 1.8f);
+}
+
+void AudioFilterLadder::update(void) {
+    audio_block_t* in = receiveReadOnly(0);
+    for (int i = 1; i < 3; i++) {
+        audio_block_t* ctrl = receiveReadOnly(i);
+        if (ctrl) release(ctrl);
+    }
+    if (!in) {
+        memset(stage, 0, sizeof(stage));
+        return;
+    }
+
+    audio_block_t* out = allocate();
+    if (!out) {
+        release(in);
+        return;
+    }
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        float x = in->data[i] * (1.0f / 32768.0f) - k * stage[3];
+        x = tanhf(x);
+        stage[0] += g * (x - stage[0]);
+        stage[1] += g * (stage[0] - stage[1]);
+        stage[2] += g * (stage[1] - stage[2]);
+        stage[3] += g * (stage[2] - stage[3]);
+        out->data[i] = saturate16((int32_t)(stage[3] * 32767.0f));
+    }
+    release(in);
+    transmit(out);
+    release(out);
+}
+
+// ============================================
+// AudioEffectEnvelope
+// ============================================
+
+AudioEffectEnvelope::AudioEffectEnvelope()
+    : AudioStream(1, inputQueueArray)
+    , stage(STAGE_IDLE)
+    , level(0.0f)
+    , releaseStep(0.0f)
+    , sustainLevel(0.667f)
+{
+    attack(10.5f);
+    decay(35.0f);
+    release(300.0f);
+}
+
+void AudioEffectEnvelope::noteOn() {
+    stage = STAGE_ATTACK;
+}
+
+void AudioEffectEnvelope::noteOff() {
+    if (stage == STAGE_IDLE) return;
+    stage = STAGE_RELEASE;
+    releaseStep = level / releaseSamples;
+}
+
+void AudioEffectEnvelope::update(void) {
+    audio_block_t* block = receiveWritable();
+    if (!block) return;
+    if (stage == STAGE_IDLE) {
+        AudioStream::release(block);
+        return;
+    }
+
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        switch (stage) {
+            case STAGE_ATTACK:
+                level += 1.0f / attackSamples;
+                if (level >= 1.0f) { level = 1.0f; stage = STAGE_DECAY; }
+                break;
+            case STAGE_DECAY:
+                level -= (1.0f - sustainLevel) / decaySamples;
+                if (level <= sustainLevel) { level = sustainLevel; stage = STAGE_SUSTAIN; }
+                break;
+            case STAGE_RELEASE:
+                level -= releaseStep;
+                if (level <= 0.0f) { level = 0.0f; stage = STAGE_IDLE; }
+                break;
+            default:
+                break;
+        }
+        block->data[i] = (int16_t)(block->data[i] * level);
+    }
+    transmit(block);
+    AudioStream::release(block);
+}
+
+// ============================================
+// AudioAnalyzeFFT1024 / AudioRecordQueue
+// ============================================
+
+void AudioAnalyzeFFT1024::update(void) {
+    audio_block_t* block = receiveReadOnly();
+    if (block) release(block);
+}
+
+void AudioRecordQueue::update(void) {
+    audio_block_t* block = receiveReadOnly();
+    if (!block) return;
+    if (!enabled) {
+        release(block);
+        return;
+    }
+    int next = (head + 1) % QUEUE_BLOCKS;
+    if (next == tail) {
+        release(block);     // Full: dropped, as on the Teensy
+        return;
+    }
+    queue[head] = block;
+    head = next;
+}
+
+int AudioRecordQueue::available() {
+    return (head - tail + QUEUE_BLOCKS) % QUEUE_BLOCKS;
+}
+
+void AudioRecordQueue::clear() {
+    while (tail != head) {
+        release(queue[tail]);
+        tail = (tail + 1) % QUEUE_BLOCKS;
+    }
+}
+
+int16_t* AudioRecordQueue::readBuffer() {
+    if (tail == head) return nullptr;
+    return queue[tail]->data;
+}
+
+void AudioRecordQueue::freeBuffer() {
+    if (tail == head) return;
+    release(queue[tail]);
+    tail = (tail + 1) % QUEUE_BLOCKS;
+}
+
+// ============================================
+// Effects not modelled on the host: consume input, output nothing
+// ============================================
+
+void AudioEffectFreeverb::update(void) {
+    audio_block_t* block = receiveReadOnly();
+    if (block) release(block);
+}
+
+void AudioEffectGranular::update(void) {
+    audio_block_t* block = receiveReadOnly();
+    if (block) release(block);
+}
+
+void AudioEffectChorus::update(void) {
+    audio_block_t* block = receiveReadOnly();
+    if (block) release(block);
+}
+
+// ============================================
+// AudioOutputI2S / AudioAnalyzePeak
+// ============================================
+
+void AudioOutputI2S::update(void) {
+    int16_t* dest[2] = { left, right };
+    for (int ch = 0; ch < 2; ch++) {
+        audio_block_t* block = receiveReadOnly(ch);
+        if (block) {
+            memcpy(dest[ch], block->data, sizeof(left));
+            release(block);
+        } else {
+            memset(dest[ch], 0, sizeof(left));
+        }
+    }
+}
+
+void AudioAnalyzePeak::update(void) {
+    audio_block_t* block = receiveReadOnly();
+    if (!block) return;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        if (block->data[i] < minSample) minSample = block->data[i];
+        if (block->data[i] > maxSample) maxSample = block->data[i];
+    }
+    newOutput = true;
+    release(block);
+}
+
+float AudioAnalyzePeak::read() {
+    int peak = max(-(int)minSample, (int)maxSample);
+    minSample = 32767;
+    maxSample = -32768;
+    newOutput = false;
+    return peak / 32767.0f;
+}
+
+float AudioAnalyzePeak::readPeakToPeak() {
+    int range = (int)maxSample - (int)minSample;
+    minSample = 32767;
+    maxSample = -32768;
+    newOutput = false;
+    return range < 0 ? 0.0f : range / 65534.0f;
+}
@@ -0,0 +1,202 @@
+/**
+ * Oh My Ondas - Host HAL: AudioStream
+ * Block pool, patch cords and the update list, run offline
+ */
+
+#include "AudioStream.h"
+#include "host_hal.h"
+#include <chrono>
+#include <vector>
+
+AudioStream* AudioStream::first_update = nullptr;
+uint16_t AudioStream::cpu_cycles_total = 0;
+uint16_t AudioStream::cpu_cycles_total_max = 0;
+uint16_t AudioStream::memory_used = 0;
+uint16_t AudioStream::memory_used_max = 0;
+
+static std::vector<audio_block_t*> freeBlocks;
+
+static uint64_t blocksRendered = 0;
+static uint64_t renderNanos = 0;
+
+void AudioMemory(unsigned int num) {
+    static std::vector<audio_block_t> storage;
+    if (!storage.empty()) return;   // Like the Teensy macro: once, at setup
+    storage.resize(num);
+    AudioStream::initialize_memory(storage.data(), num);
+}
+
+void AudioStream::initialize_memory(audio_block_t* data, unsigned int num) {
+    freeBlocks.clear();
+    for (unsigned int i = num; i > 0; i--) {
+        data[i - 1].memory_pool_index = i - 1;
+        freeBlocks.push_back(&data[i - 1]);
+    }
+    memory_used = 0;
+    memory_used_max = 0;
+}
+
+AudioStream::AudioStream(unsigned char ninput, audio_block_t** iqueue)
+    : cpu_cycles(0)
+    , cpu_cycles_max(0)
+    , active(false)
+    , num_inputs(ninput)
+    , destination_list(nullptr)
+    , inputQueue(iqueue)
+    , next_update(nullptr)
+{
+    for (int i = 0; i < ninput; i++) inputQueue[i] = nullptr;
+
+    // Update order is construction order
+    if (!first_update) {
+        first_update = this;
+    } else {
+        AudioStream* p = first_update;
+        while (p->next_update) p = p->next_update;
+        p->next_update = this;
+    }
+}
+
+audio_block_t* AudioStream::allocate(void) {
+    if (freeBlocks.empty()) return nullptr;
+    audio_block_t* block = freeBlocks.back();
+    freeBlocks.pop_back();
+    block->ref_count = 1;
+    if (++memory_used > memory_used_max) memory_used_max = memory_used;
+    return block;
+}
+
+void AudioStream::release(audio_block_t* block) {
+    if (!block) return;
+    if (block->ref_count > 1) {
+        block->ref_count--;
+        return;
+    }
+    block->ref_count = 0;
+    freeBlocks.push_back(block);
+    memory_used--;
+}
+
+void AudioStream::transmit(audio_block_t* block, unsigned char index) {
+    for (AudioConnection* c = destination_list; c; c = c->next_dest) {
+        if (c->src_index != index) continue;
+        if (!c->dst.inputQueue[c->dest_index]) {
+            c->dst.inputQueue[c->dest_index] = block;
+            block->ref_count++;
+        }
+    }
+}
+
+audio_block_t* AudioStream::receiveReadOnly(unsigned int index) {
+    if (index >= num_inputs) return nullptr;
+    audio_block_t* in = inputQueue[index];
+    inputQueue[index] = nullptr;
+    return in;
+}
+
+audio_block_t* AudioStream::receiveWritable(unsigned int index) {
+    audio_block_t* in = receiveReadOnly(index);
+    if (in && in->ref_count > 1) {
+        audio_block_t* copy = allocate();
+        if (copy) memcpy(copy->data, in->data, sizeof(copy->data));
+        in->ref_count--;
+        in = copy;
+    }
+    return in;
+}
+
+// ============================================
+// AudioConnection
+// ============================================
+
+AudioConnection::AudioConnection(AudioStream& source, AudioStream& destination)
+    : AudioConnection(source, 0, destination, 0)
+{
+}
+
+AudioConnection::AudioConnection(AudioStream& source, unsigned char sourceOutput,
+                                 AudioStream& destination, unsigned char destinationInput)
+    : src(source)
+    , dst(destination)
+    , src_index(sourceOutput)
+    , dest_index(destinationInput)
+    , next_dest(nullptr)
+    , isConnected(false)
+{
+    connect();
+}
+
+AudioConnection::~AudioConnection() {
+    disconnect();
+}
+
+int AudioConnection::connect() {
+    if (isConnected) return 0;
+    if (dest_index >= dst.num_inputs) return 2;
+
+    next_dest = nullptr;
+    if (!src.destination_list) {
+        src.destination_list = this;
+    } else {
+        AudioConnection* p = src.destination_list;
+        while (p->next_dest) p = p->next_dest;
+        p->next_dest = this;
+    }
+    src.active = true;
+    dst.active = true;
+    isConnected = true;
+    return 0;
+}
+
+int AudioConnection::disconnect() {
+    if (!isConnected) return 1;
+
+    AudioConnection** p = &src.destination_list;
+    while (*p && *p != this) p = &(*p)->next_dest;
+    if (*p) *p = next_dest;
+
+    // A block already queued on the input is dropped with the cord
+    audio_block_t*& queued = dst.inputQueue[dest_index];
+    if (queued) {
+        AudioStream::release(queued);
+        queued = nullptr;
+    }
+    isConnected = false;
+    return 0;
+}
+
+// ============================================
+// Update ("audio interrupt")
+// ============================================
+
+void hostAudioUpdate() {
+    auto t0 = std::chrono::steady_clock::now();
+    uint32_t totalStart = ARM_DWT_CYCCNT;
+
+    for (AudioStream* p = AudioStream::first_update; p; p = p->next_update) {
+        if (!p->active) continue;
+        uint32_t cycles = ARM_DWT_CYCCNT;
+        p->update();
+        cycles = (ARM_DWT_CYCCNT - cycles) >> 6;
+        if (cycles > 0xFFFF) cycles = 0xFFFF;
+        p->cpu_cycles = cycles;
+        if (cycles > p->cpu_cycles_max) p->cpu_cycles_max = cycles;
+    }
+
+    uint32_t total = (ARM_DWT_CYCCNT - totalStart) >> 6;
+    if (total > 0xFFFF) total = 0xFFFF;
+    AudioStream::cpu_cycles_total = total;
+    if (total > AudioStream::cpu_cycles_total_max) AudioStream::cpu_cycles_total_max = total;
+
+    blocksRendered++;
+    renderNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+uint64_t hostAudioBlocks() {
+    return blocksRendered;
+}
+
+uint64_t hostAudioNanos() {
+    return renderNanos;
+}
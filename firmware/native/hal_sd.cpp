@@ -0,0 +1,206 @@
+/**
+ * Oh My Ondas - Host HAL: SD card
+ * SD library API over a host directory
+ */
+
+#include "SD.h"
+#include "host_hal.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+SDClass SD;
+
+static std::string sdRoot = "sdcard";
+
+struct HostFileHandle {
+    FILE* fp = nullptr;
+    bool directory = false;
+    std::string path;               // Host path
+    std::string name;               // Last path component, as SD reports it
+    std::vector<std::string> entries;
+    size_t nextEntry = 0;
+
+    ~HostFileHandle() {
+        if (fp) fclose(fp);
+    }
+};
+
+bool hostSdMount(const char* directory) {
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (!fs::is_directory(directory, ec)) return false;
+    sdRoot = directory;
+    return true;
+}
+
+const char* hostSdRoot() {
+    return sdRoot.c_str();
+}
+
+static std::string hostPath(const char* path) {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return sdRoot + p;
+}
+
+// ============================================
+// SDClass
+// ============================================
+
+bool SDClass::begin(uint8_t) {
+    std::error_code ec;
+    fs::create_directories(sdRoot, ec);
+    return fs::is_directory(sdRoot, ec);
+}
+
+File SDClass::open(const char* path, uint8_t mode) {
+    std::string full = hostPath(path);
+    std::error_code ec;
+
+    auto h = std::make_shared<HostFileHandle>();
+    h->path = full;
+    h->name = fs::path(full).filename().string();
+
+    if (fs::is_directory(full, ec)) {
+        if (mode != FILE_READ) return File();
+        h->directory = true;
+        for (const auto& e : fs::directory_iterator(full, ec)) {
+            h->entries.push_back(e.path().filename().string());
+        }
+        std::sort(h->entries.begin(), h->entries.end());
+        return File(h);
+    }
+
+    if (mode == FILE_READ) {
+        h->fp = fopen(full.c_str(), "rb");
+    } else {
+        h->fp = fopen(full.c_str(), "r+b");
+        if (!h->fp) h->fp = fopen(full.c_str(), "w+b");
+        if (h->fp && mode == FILE_WRITE) fseek(h->fp, 0, SEEK_END);
+    }
+    if (!h->fp) return File();
+    return File(h);
+}
+
+bool SDClass::exists(const char* path) {
+    std::error_code ec;
+    return fs::exists(hostPath(path), ec);
+}
+
+bool SDClass::mkdir(const char* path) {
+    std::error_code ec;
+    fs::create_directories(hostPath(path), ec);
+    return fs::is_directory(hostPath(path), ec);
+}
+
+bool SDClass::remove(const char* path) {
+    std::error_code ec;
+    std::string full = hostPath(path);
+    if (fs::is_directory(full, ec)) return false;
+    return fs::remove(full, ec);
+}
+
+bool SDClass::rename(const char* from, const char* to) {
+    std::error_code ec;
+    fs::rename(hostPath(from), hostPath(to), ec);
+    return !ec;
+}
+
+bool SDClass::rmdir(const char* path) {
+    std::error_code ec;
+    std::string full = hostPath(path);
+    if (!fs::is_directory(full, ec)) return false;
+    return fs::remove(full, ec);    // Only if empty, as on the card
+}
+
+// ============================================
+// File
+// ============================================
+
+int File::read() {
+    if (!h || !h->fp) return -1;
+    return fgetc(h->fp);
+}
+
+int File::read(void* buf, size_t size) {
+    if (!h || !h->fp) return -1;
+    return (int)fread(buf, 1, size, h->fp);
+}
+
+int File::peek() {
+    if (!h || !h->fp) return -1;
+    int c = fgetc(h->fp);
+    if (c != EOF) ungetc(c, h->fp);
+    return c;
+}
+
+int File::available() {
+    if (!h || !h->fp) return 0;
+    return (int)(size() - position());
+}
+
+uint32_t File::size() {
+    if (!h || !h->fp) return 0;
+    long here = ftell(h->fp);
+    fseek(h->fp, 0, SEEK_END);
+    long end = ftell(h->fp);
+    fseek(h->fp, here, SEEK_SET);
+    return (uint32_t)end;
+}
+
+uint32_t File::position() {
+    if (!h || !h->fp) return 0;
+    return (uint32_t)ftell(h->fp);
+}
+
+bool File::seek(uint32_t pos) {
+    if (!h || !h->fp) return false;
+    if (pos > size()) return false;
+    return fseek(h->fp, pos, SEEK_SET) == 0;
+}
+
+void File::flush() {
+    if (h && h->fp) fflush(h->fp);
+}
+
+void File::close() {
+    h.reset();
+}
+
+size_t File::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!h || !h->fp) return 0;
+    // Switching from reading to writing needs a positioning call
+    fseek(h->fp, 0, SEEK_CUR);
+    return fwrite(buf, 1, size, h->fp);
+}
+
+const char* File::name() {
+    return h ? h->name.c_str() : "";
+}
+
+bool File::isDirectory() {
+    return h && h->directory;
+}
+
+File File::openNextFile(uint8_t mode) {
+    if (!h || !h->directory) return File();
+    while (h->nextEntry < h->entries.size()) {
+        std::string child = h->path + "/" + h->entries[h->nextEntry++];
+        std::string rel = child.substr(sdRoot.size());
+        File f = SD.open(rel.c_str(), mode);
+        if (f) return f;
+    }
+    return File();
+}
+
+void File::rewindDirectory() {
+    if (h) h->nextEntry = 0;
+}
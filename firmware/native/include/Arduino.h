@@ -0,0 +1,134 @@
+/**
+ * Oh My Ondas - Host HAL: Arduino core
+ * The part of the Teensyduino core the firmware classes use, for the
+ * native (Linux) build
+ *
+ * millis()/micros() read a simulated clock that only moves when the host
+ * program advances it (host_hal.h) or the firmware calls delay(), so
+ * timing logic runs deterministically and as fast as the host allows.
+ * Serial prints to stdout; interrupts and pins are no-ops.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 4
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+
+#define F_CPU_ACTUAL 600000000UL
+
+// Memory placement attributes have no meaning on the host
+#define DMAMEM
+#define EXTMEM
+#define FASTRUN
+#define FLASHMEM
+#define PROGMEM
+#define F(s) (s)
+
+template <class T, class L, class H>
+inline T constrain(T x, L lo, H hi) {
+    return x < lo ? (T)lo : (x > hi ? (T)hi : x);
+}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Simulated clock
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// Cycle counter, from the host clock scaled to F_CPU_ACTUAL
+uint32_t hostCycleCount();
+#define ARM_DWT_CYCCNT (hostCycleCount())
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// Single-threaded: the "ISR" runs when the host calls it
+inline void __disable_irq() {}
+inline void __enable_irq() {}
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return HIGH; }
+inline int analogRead(int) { return 0; }
+inline void analogReadResolution(int) {}
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(int, void (*)(), int) {}
+
+// PSRAM: plain heap; external_psram_size reports a fitted 8 MB chip
+inline void* extmem_malloc(size_t size) { return malloc(size); }
+inline void extmem_free(void* ptr) { free(ptr); }
+extern "C" uint8_t external_psram_size;
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size);
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(uint8_t n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// USB serial: stdout, or nothing when silenced (host_hal.h)
+class HostSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    void flush() { fflush(stdout); }
+    operator bool() { return true; }
+
+    virtual size_t write(uint8_t b);
+    virtual size_t write(const uint8_t* buf, size_t size);
+    using Print::write;
+};
+
+extern HostSerial Serial;
+extern HostSerial Serial2;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,337 @@
+/**
+ * Oh My Ondas - Host HAL: Audio objects
+ * Offline versions of the Teensy Audio Library objects the firmware uses
+ *
+ * Same class names and control methods as the library. The signal path a
+ * render depends on is modelled: amplifier, mixer, state variable filter,
+ * SD WAV player, delay, bitcrusher and peak analysis follow the library's
+ * behaviour (not bit-exact), and so do the synth voice's oscillators,
+ * noise, ladder filter and envelope. Freeverb, granular and chorus only
+ * record their settings and output nothing, so the host hears their wet
+ * returns as silence; the FFT does no analysis. Audio input is silent;
+ * the I2S output keeps the last block it was sent for the host to
+ * collect.
+ */
+
+#ifndef HOST_AUDIO_H
+#define HOST_AUDIO_H
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+// Stubbed effects, for labelling host timings and renders: they cost
+// nothing here and are not heard
+#define HOST_AUDIO_SILENT_EFFECTS "freeverb, granular, chorus"
+#include "SD.h"
+
+#define AUDIO_INPUT_LINEIN 0
+#define AUDIO_INPUT_MIC 1
+
+#define WAVEFORM_SINE 0
+#define WAVEFORM_SAWTOOTH 1
+#define WAVEFORM_SQUARE 2
+#define WAVEFORM_TRIANGLE 3
+#define WAVEFORM_ARBITRARY 4
+#define WAVEFORM_PULSE 5
+#define WAVEFORM_SAWTOOTH_REVERSE 6
+#define WAVEFORM_SAMPLE_HOLD 7
+
+class AudioAmplifier : public AudioStream {
+public:
+    AudioAmplifier() : AudioStream(1, inputQueueArray), multiplier(65536) {}
+    virtual void update(void);
+    void gain(float n);
+
+private:
+    int32_t multiplier;     // Q16
+    audio_block_t* inputQueueArray[1];
+};
+
+class AudioMixer4 : public AudioStream {
+public:
+    AudioMixer4() : AudioStream(4, inputQueueArray) {
+        for (int i = 0; i < 4; i++) multiplier[i] = 65536;
+    }
+    virtual void update(void);
+    void gain(unsigned int channel, float gain);
+
+private:
+    int32_t multiplier[4];  // Q16
+    audio_block_t* inputQueueArray[4];
+};
+
+// Chamberlin state variable filter, run twice per sample like the
+// library's. Outputs: 0 lowpass, 1 bandpass, 2 highpass.
+class AudioFilterStateVariable : public AudioStream {
+public:
+    AudioFilterStateVariable() : AudioStream(2, inputQueueArray) {
+        frequency(1000.0f);
+        resonance(0.707f);
+    }
+    virtual void update(void);
+    void frequency(float freq);
+    void resonance(float q);
+    void octaveControl(float) {}
+
+private:
+    float f;                // 2 sin(pi fc / 2fs)
+    float damp;             // 1 / q
+    float lowState, bandState;
+    audio_block_t* inputQueueArray[2];
+};
+
+// Streams 16-bit PCM WAV (mono or stereo) from the SD HAL
+class AudioPlaySdWav : public AudioStream {
+public:
+    AudioPlaySdWav() : AudioStream(0, nullptr), playing(false), channels(0), remaining(0) {}
+    virtual void update(void);
+    bool play(const char* filename);
+    void stop();
+    bool isPlaying() { return playing; }
+    uint32_t positionMillis();
+    uint32_t lengthMillis();
+
+private:
+    File file;
+    bool playing;
+    uint16_t channels;
+    uint32_t sampleRate;
+    uint32_t totalFrames;
+    uint32_t remaining;
+};
+
+// Eight taps on one delay line, as in the library
+class AudioEffectDelay : public AudioStream {
+public:
+    AudioEffectDelay();
+    virtual void update(void);
+    void delay(uint8_t channel, float milliseconds);
+    void disable(uint8_t channel);
+
+private:
+    static const uint32_t LINE_SAMPLES = 65536;     // ~1.49 s
+    int16_t* line;
+    uint32_t head;
+    uint32_t tapDelay[8];
+    uint8_t tapActive;
+    audio_block_t* inputQueueArray[1];
+};
+
+class AudioEffectBitcrusher : public AudioStream {
+public:
+    AudioEffectBitcrusher() : AudioStream(1, inputQueueArray), crushBits(16), sampleStep(1) {}
+    virtual void update(void);
+    void bits(uint8_t b);
+    void sampleRate(float hz);
+
+private:
+    uint8_t crushBits;
+    uint16_t sampleStep;
+    audio_block_t* inputQueueArray[1];
+};
+
+class AudioEffectFreeverb : public AudioStream {
+public:
+    AudioEffectFreeverb() : AudioStream(1, inputQueueArray), room(0.5f), damp(0.5f) {}
+    virtual void update(void);
+    void roomsize(float n) { room = n; }
+    void damping(float n) { damp = n; }
+
+private:
+    float room, damp;
+    audio_block_t* inputQueueArray[1];
+};
+
+class AudioEffectGranular : public AudioStream {
+public:
+    AudioEffectGranular() : AudioStream(1, inputQueueArray), speed(1.0f) {}
+    virtual void update(void);
+    void begin(int16_t* sampleBank, int16_t maxLength) { (void)sampleBank; (void)maxLength; }
+    void beginFreeze(float grainLength) { (void)grainLength; }
+    void beginPitchShift(float grainLength) { (void)grainLength; }
+    void stop() {}
+    void setSpeed(float ratio) { speed = ratio; }
+
+private:
+    float speed;
+    audio_block_t* inputQueueArray[1];
+};
+
+class AudioEffectChorus : public AudioStream {
+public:
+    AudioEffectChorus() : AudioStream(1, inputQueueArray), numVoices(1) {}
+    virtual void update(void);
+    bool begin(short* delayline, int delayLength, int voices) {
+        (void)delayline; (void)delayLength; numVoices = voices;
+        return true;
+    }
+    void voices(int n) { numVoices = n; }
+
+private:
+    int numVoices;
+    audio_block_t* inputQueueArray[1];
+};
+
+// Naive (aliasing) shapes from a 32-bit phase accumulator, as the
+// library's non-bandlimited waveforms. Silent while amplitude is 0.
+class AudioSynthWaveform : public AudioStream {
+public:
+    AudioSynthWaveform() : AudioStream(0, nullptr), phaseAcc(0), phaseInc(0),
+                           magnitude(0), tone(WAVEFORM_SINE), held(0) {}
+    virtual void update(void);
+    void begin(short type) { tone = type; }
+    void begin(float amp, float freq, short type) {
+        amplitude(amp);
+        frequency(freq);
+        tone = type;
+    }
+    void frequency(float freq);
+    void amplitude(float n);
+
+private:
+    uint32_t phaseAcc;
+    uint32_t phaseInc;
+    int32_t magnitude;      // Q16
+    short tone;
+    int16_t held;           // Sample & hold value
+};
+
+class AudioSynthNoiseWhite : public AudioStream {
+public:
+    AudioSynthNoiseWhite() : AudioStream(0, nullptr), level(0), seed(1) {}
+    virtual void update(void);
+    void amplitude(float n);
+
+private:
+    int32_t level;          // Q16
+    uint32_t seed;
+};
+
+// Four one-pole stages with resonance feedback. Input 0 audio; the
+// frequency and resonance modulation inputs are not modelled.
+class AudioFilterLadder : public AudioStream {
+public:
+    AudioFilterLadder() : AudioStream(3, inputQueueArray), k(0.0f) {
+        memset(stage, 0, sizeof(stage));
+        frequency(1000.0f);
+    }
+    virtual void update(void);
+    void frequency(float freq);
+    void resonance(float res);
+    void octaveControl(float) {}
+
+private:
+    float g;                // One-pole coefficient
+    float k;                // Feedback, 0..4
+    float stage[4];
+    audio_block_t* inputQueueArray[3];
+};
+
+// Linear ADSR (with the library's delay/hold stages left out)
+class AudioEffectEnvelope : public AudioStream {
+public:
+    AudioEffectEnvelope();
+    virtual void update(void);
+    void noteOn();
+    void noteOff();
+    void attack(float ms)  { attackSamples = msToSamples(ms); }
+    void decay(float ms)   { decaySamples = msToSamples(ms); }
+    void sustain(float level) { sustainLevel = constrain(level, 0.0f, 1.0f); }
+    void release(float ms) { releaseSamples = msToSamples(ms); }
+    bool isActive() { return stage != STAGE_IDLE; }
+    bool isSustain() { return stage == STAGE_SUSTAIN; }
+
+private:
+    enum Stage : uint8_t { STAGE_IDLE, STAGE_ATTACK, STAGE_DECAY, STAGE_SUSTAIN, STAGE_RELEASE };
+    static uint32_t msToSamples(float ms) {
+        return ms <= 0.0f ? 1 : (uint32_t)(ms * AUDIO_SAMPLE_RATE_EXACT / 1000.0f) + 1;
+    }
+
+    Stage stage;
+    float level;
+    float releaseStep;
+    uint32_t attackSamples, decaySamples, releaseSamples;
+    float sustainLevel;
+    audio_block_t* inputQueueArray[1];
+};
+
+// Consumes its input; no analysis on the host
+class AudioAnalyzeFFT1024 : public AudioStream {
+public:
+    AudioAnalyzeFFT1024() : AudioStream(1, inputQueueArray) {}
+    virtual void update(void);
+    bool available() { return false; }
+    float read(unsigned int) { return 0.0f; }
+    float read(unsigned int, unsigned int) { return 0.0f; }
+
+private:
+    audio_block_t* inputQueueArray[1];
+};
+
+// Holds up to 53 blocks between begin() and end(), like the library
+class AudioRecordQueue : public AudioStream {
+public:
+    AudioRecordQueue() : AudioStream(1, inputQueueArray), head(0), tail(0), enabled(false) {}
+    virtual void update(void);
+    void begin() { clear(); enabled = true; }
+    void end() { enabled = false; }
+    int available();
+    void clear();
+    int16_t* readBuffer();
+    void freeBuffer();
+
+private:
+    static const int QUEUE_BLOCKS = 53;
+    audio_block_t* queue[QUEUE_BLOCKS];
+    volatile int head, tail;
+    bool enabled;
+    audio_block_t* inputQueueArray[1];
+};
+
+class AudioInputI2S : public AudioStream {
+public:
+    AudioInputI2S() : AudioStream(0, nullptr) {}
+    virtual void update(void) {}
+};
+
+// Keeps the last block per channel (silence when nothing arrived)
+class AudioOutputI2S : public AudioStream {
+public:
+    AudioOutputI2S() : AudioStream(2, inputQueueArray) {
+        memset(left, 0, sizeof(left));
+        memset(right, 0, sizeof(right));
+    }
+    virtual void update(void);
+
+    int16_t left[AUDIO_BLOCK_SAMPLES];
+    int16_t right[AUDIO_BLOCK_SAMPLES];
+
+private:
+    audio_block_t* inputQueueArray[2];
+};
+
+class AudioAnalyzePeak : public AudioStream {
+public:
+    AudioAnalyzePeak() : AudioStream(1, inputQueueArray), minSample(32767), maxSample(-32768), newOutput(false) {}
+    virtual void update(void);
+    bool available() { return newOutput; }
+    float read();
+    float readPeakToPeak();
+
+private:
+    int16_t minSample, maxSample;
+    bool newOutput;
+    audio_block_t* inputQueueArray[1];
+};
+
+class AudioControlSGTL5000 {
+public:
+    bool enable() { return true; }
+    bool volume(float) { return true; }
+    bool inputSelect(int) { return true; }
+    bool lineInLevel(uint8_t) { return true; }
+    bool lineOutLevel(uint8_t) { return true; }
+    bool micGain(unsigned int) { return true; }
+};
+
+#endif // HOST_AUDIO_H
@@ -0,0 +1,114 @@
+/**
+ * Oh My Ondas - Host HAL: AudioStream
+ * The Teensy Audio Library object graph, run offline
+ *
+ * Same model as the Teensy: objects join a global update list in
+ * construction order, AudioConnection patches an output to an input,
+ * blocks come from a fixed pool sized by AudioMemory() and are passed by
+ * reference count. hostAudioUpdate() stands in for the audio interrupt.
+ *
+ * CPU accounting uses the host clock scaled to F_CPU_ACTUAL, so
+ * processorUsage() reads as a percentage of the block period in real
+ * time: 100% is exactly realtime on the host, not on the Teensy.
+ */
+
+#ifndef HOST_AUDIOSTREAM_H
+#define HOST_AUDIOSTREAM_H
+
+#include "Arduino.h"
+
+#ifndef AUDIO_BLOCK_SAMPLES
+#define AUDIO_BLOCK_SAMPLES 128
+#endif
+
+#define AUDIO_SAMPLE_RATE_EXACT 44117.64706f
+#define AUDIO_SAMPLE_RATE AUDIO_SAMPLE_RATE_EXACT
+
+typedef struct audio_block_struct {
+    uint8_t ref_count;
+    uint8_t reserved1;
+    uint16_t memory_pool_index;
+    int16_t data[AUDIO_BLOCK_SAMPLES];
+} audio_block_t;
+
+// Percentage of one block period for a count in 64-cycle units
+#define CYCLE_COUNTER_APPROX_PERCENT(n) \
+    (((float)((uint32_t)(n) * 6400u) * (float)(AUDIO_SAMPLE_RATE_EXACT / AUDIO_BLOCK_SAMPLES)) / \
+     (float)(F_CPU_ACTUAL))
+
+class AudioStream;
+
+class AudioConnection {
+public:
+    AudioConnection(AudioStream& source, AudioStream& destination);
+    AudioConnection(AudioStream& source, unsigned char sourceOutput,
+                    AudioStream& destination, unsigned char destinationInput);
+    ~AudioConnection();
+
+    int connect();
+    int disconnect();
+
+private:
+    friend class AudioStream;
+    AudioStream& src;
+    AudioStream& dst;
+    unsigned char src_index;
+    unsigned char dest_index;
+    AudioConnection* next_dest;
+    bool isConnected;
+};
+
+class AudioStream {
+public:
+    AudioStream(unsigned char ninput, audio_block_t** iqueue);
+    virtual ~AudioStream() {}
+
+    virtual void update(void) = 0;
+
+    float processorUsage(void) { return CYCLE_COUNTER_APPROX_PERCENT(cpu_cycles); }
+    float processorUsageMax(void) { return CYCLE_COUNTER_APPROX_PERCENT(cpu_cycles_max); }
+    void processorUsageMaxReset(void) { cpu_cycles_max = cpu_cycles; }
+    bool isActive(void) { return active; }
+
+    static void initialize_memory(audio_block_t* data, unsigned int num);
+
+    uint16_t cpu_cycles;
+    uint16_t cpu_cycles_max;
+    static uint16_t cpu_cycles_total;
+    static uint16_t cpu_cycles_total_max;
+    static uint16_t memory_used;
+    static uint16_t memory_used_max;
+
+protected:
+    bool active;
+    unsigned char num_inputs;
+
+    static audio_block_t* allocate(void);
+    static void release(audio_block_t* block);
+    void transmit(audio_block_t* block, unsigned char index = 0);
+    audio_block_t* receiveReadOnly(unsigned int index = 0);
+    audio_block_t* receiveWritable(unsigned int index = 0);
+
+private:
+    friend class AudioConnection;
+    friend void hostAudioUpdate();
+
+    AudioConnection* destination_list;
+    audio_block_t** inputQueue;
+    AudioStream* next_update;
+    static AudioStream* first_update;
+};
+
+void AudioMemory(unsigned int num);
+
+#define AudioProcessorUsage() (CYCLE_COUNTER_APPROX_PERCENT(AudioStream::cpu_cycles_total))
+#define AudioProcessorUsageMax() (CYCLE_COUNTER_APPROX_PERCENT(AudioStream::cpu_cycles_total_max))
+#define AudioProcessorUsageMaxReset() (AudioStream::cpu_cycles_total_max = AudioStream::cpu_cycles_total)
+#define AudioMemoryUsage() (AudioStream::memory_used)
+#define AudioMemoryUsageMax() (AudioStream::memory_used_max)
+#define AudioMemoryUsageMaxReset() (AudioStream::memory_used_max = AudioStream::memory_used)
+
+inline void AudioNoInterrupts() {}
+inline void AudioInterrupts() {}
+
+#endif // HOST_AUDIOSTREAM_H
@@ -0,0 +1,70 @@
+/**
+ * Oh My Ondas - Host HAL: SD card
+ * SD library API over a host directory (see hostSdMount())
+ *
+ * FILE_WRITE opens for read/write positioned at the end, creating the
+ * file, as SdFat does on the Teensy. File objects share their handle on
+ * copy and close it with the last copy.
+ */
+
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+#include "Arduino.h"
+#include <memory>
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+#define FILE_WRITE_BEGIN 2
+#define BUILTIN_SDCARD 254
+
+struct HostFileHandle;
+
+class File : public Print {
+public:
+    File() {}
+    explicit File(std::shared_ptr<HostFileHandle> handle) : h(handle) {}
+
+    operator bool() const { return (bool)h; }
+
+    int read();
+    int read(void* buf, size_t size);
+    size_t readBytes(char* buf, size_t size) {     // Stream API, used by ArduinoJson
+        int n = read(buf, size);
+        return n > 0 ? (size_t)n : 0;
+    }
+    int peek();
+    int available();
+    uint32_t size();
+    uint32_t position();
+    bool seek(uint32_t pos);
+    void flush();
+    void close();
+
+    virtual size_t write(uint8_t b);
+    virtual size_t write(const uint8_t* buf, size_t size);
+    using Print::write;
+
+    const char* name();
+    bool isDirectory();
+    File openNextFile(uint8_t mode = FILE_READ);
+    void rewindDirectory();
+
+private:
+    std::shared_ptr<HostFileHandle> h;
+};
+
+class SDClass {
+public:
+    bool begin(uint8_t csPin = BUILTIN_SDCARD);
+    File open(const char* path, uint8_t mode = FILE_READ);
+    bool exists(const char* path);
+    bool mkdir(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool rmdir(const char* path);
+};
+
+extern SDClass SD;
+
+#endif // HOST_SD_H
@@ -0,0 +1,37 @@
+/**
+ * Oh My Ondas - Host HAL control
+ * What a host program (test, benchmark, offline renderer) uses to drive
+ * the simulated hardware the firmware classes run on
+ *
+ * Clock: millis()/micros() start at 0 and only move through
+ *   hostClockAdvance() and the firmware's own delay() calls.
+ * SD: every path is resolved under the directory passed to hostSdMount().
+ * Audio: hostAudioUpdate() does what the Teensy audio interrupt does once
+ *   per block: update() every active AudioStream in construction order.
+ */
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <stdint.h>
+
+// Simulated clock
+uint64_t hostClockMicros();
+void hostClockSet(uint64_t us);
+void hostClockAdvance(uint64_t us);
+
+// SD card root; created if missing. False if it cannot be used.
+bool hostSdMount(const char* directory);
+const char* hostSdRoot();
+
+// Serial (and so DEBUG_PRINT) output on stdout, on by default
+void hostSerialEcho(bool enabled);
+
+// Render one audio block through the object graph
+void hostAudioUpdate();
+
+// Blocks rendered since start, and the wall time they took (ns)
+uint64_t hostAudioBlocks();
+uint64_t hostAudioNanos();
+
+#endif // HOST_HAL_H
@@ -0,0 +1,247 @@
+/**
+ * Oh My Ondas - Offline Renderer Implementation
+ * Firmware graph + sequencer driven block by block on the simulated clock
+ */
+
+#include "offline_render.h"
+#include <Arduino.h>
+#include <chrono>
+#include <filesystem>
+#include "host_hal.h"
+#include "config.h"
+#include "audio_commands.h"
+#include "sampling_engine.h"
+#include "sequencer.h"
+#include "fx_engine.h"
+#include "poly_synth.h"
+#include "scene_manager.h"
+
+// ============================================
+// FIRMWARE GRAPH AND SUBSYSTEMS (as in main.ino)
+// ============================================
+
+#include "audio_objects.h"
+
+AudioCommandQueue audioCommands;
+
+SamplingEngine samplingEngine;
+Sequencer      sequencer;
+FXEngine       fxEngine;
+PolySynth      polySynth;
+SceneManager   sceneManager;
+AudioProfiler  audioProfiler;
+
+#include "audio_dispatch.h"
+
+static float masterVolume = 0.8f;
+static uint32_t triggerCount = 0;
+
+static void countTrigger(int track, int step, const Step& stepData, StepLocks locks,
+                         uint32_t sampleTime) {
+    triggerCount++;
+    onSequencerTrigger(track, step, stepData, locks, sampleTime);
+}
+
+static void countNote(int track, int step, const Step& stepData, StepLocks locks,
+                      uint32_t sampleTime, uint32_t gateSamples) {
+    triggerCount++;
+    onSequencerNote(track, step, stepData, locks, sampleTime, gateSamples);
+}
+
+// Profiler rows go to stdout even with the firmware's Serial silenced
+class StdoutPrint : public Print {
+public:
+    virtual size_t write(uint8_t b) { return fputc(b, stdout) == EOF ? 0 : 1; }
+    virtual size_t write(const uint8_t* buf, size_t size) { return fwrite(buf, 1, size, stdout); }
+    using Print::write;
+};
+
+static StdoutPrint profileOut;
+
+// ============================================
+// WAV OUTPUT (16-bit stereo, sizes patched on close)
+// ============================================
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+static void wavHeader(uint8_t* h, uint32_t frames) {
+    uint32_t dataBytes = frames * 4;
+    memcpy(h, "RIFF", 4);
+    put32(h + 4, 36 + dataBytes);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    put32(h + 16, 16);
+    put16(h + 20, 1);               // PCM
+    put16(h + 22, 2);
+    put32(h + 24, SAMPLE_RATE);
+    put32(h + 28, SAMPLE_RATE * 4);
+    put16(h + 32, 4);
+    put16(h + 34, 16);
+    memcpy(h + 36, "data", 4);
+    put32(h + 40, dataBytes);
+}
+
+// ============================================
+// SETUP (the audio half of setup())
+// ============================================
+
+static void setupFirmware(float bpm) {
+    AudioMemory(AUDIO_MEMORY_BLOCKS);
+    initAudioGraph();
+
+    samplingEngine.begin(player, memPlayer, amp);
+    sequencer.begin(bpm);
+    sequencer.setTriggerCallback(countTrigger);
+    sequencer.setNoteCallback(countNote);
+    sequencer.setClockSource(CLOCK_AUDIO);
+    audioCommands.setHandler(applyAudioCommand);
+    audioClock.setBlockCallback(onAudioBlock);
+    fxEngine.begin(&reverb, &delayL, &crusher, &granular, &chorus,
+                   filterCtl, &fxReturn, &fxReturn2, &fxSend, &modMatrix);
+    polySynth.begin(synthWave1, synthWave2, &synthNoise,
+                    synthMixer, synthFilterCtl, synthEnv);
+    sceneManager.begin();
+    audioProfiler.begin(&audioClock, &profileOut);
+    addProfiledObjects(audioProfiler);
+}
+
+// Scene recall as the SCENE pads do it, plus the FX type they leave to
+// the performer. Mutes live in the pattern, so load that first.
+static void applyScene(const Scene& scene) {
+    masterVolume = scene.masterVolume;
+    sequencer.setTempo(scene.bpm);
+    for (int i = 0; i < MAX_TRACKS; i++) {
+        samplingEngine.setVolume(i, scene.trackVolumes[i]);
+        if (scene.trackMutes[i]) sequencer.muteTrack(i);
+        else sequencer.unmuteTrack(i);
+    }
+    fxEngine.selectEffect(scene.currentFX - (int)fxEngine.getCurrentEffect());
+    fxEngine.setMix(scene.fxMix);
+    for (int i = 0; i < 3; i++) {
+        fxEngine.setParam(i, scene.fxParams[i]);
+    }
+}
+
+// ============================================
+// RENDER
+// ============================================
+
+bool renderOffline(const RenderOptions& options, RenderResult& result) {
+    static bool used = false;
+    if (used) {
+        fprintf(stderr, "render: the graph has already rendered in this process\n");
+        return false;
+    }
+    used = true;
+    result = RenderResult();
+
+    if (!std::filesystem::is_directory(options.sdRoot) ||
+        !hostSdMount(options.sdRoot) || !SD.begin(BUILTIN_SDCARD)) {
+        fprintf(stderr, "render: cannot use SD root %s\n", options.sdRoot);
+        return false;
+    }
+
+    setupFirmware(120.0f);
+
+    Scene scene;
+    int pattern = options.pattern;
+    if (options.scene >= 0) {
+        if (!sceneManager.recallScene(options.scene, scene)) {
+            fprintf(stderr, "render: scene %d is not saved\n", options.scene);
+            return false;
+        }
+        pattern = scene.patternNumber;
+    }
+    if (pattern < 0 || pattern >= MAX_PATTERNS) {
+        fprintf(stderr, "render: no pattern %d\n", pattern);
+        return false;
+    }
+    sequencer.loadPattern(pattern);
+    if (options.scene >= 0) applyScene(scene);
+
+    FILE* out = fopen(options.outPath, "wb");
+    if (!out) {
+        fprintf(stderr, "render: cannot write %s\n", options.outPath);
+        return false;
+    }
+    uint8_t header[44];
+    wavHeader(header, 0);
+    fwrite(header, 1, sizeof(header), out);
+
+    // The first SEQ_LOOKAHEAD_BLOCKS blocks come before step 0's
+    // timestamp: render them but leave them out, so the file starts on
+    // the first step
+    float samplesPerStep = AUDIO_SAMPLE_RATE_EXACT * 60.0f / sequencer.getTempo() / 4.0f;
+    uint64_t patternFrames = (uint64_t)(options.loops * sequencer.getPatternLength() * samplesPerStep);
+    uint64_t frames = patternFrames + (uint64_t)(options.tailSeconds * AUDIO_SAMPLE_RATE_EXACT);
+    uint64_t blocks = (frames + AUDIO_BLOCK_SAMPLES - 1) / AUDIO_BLOCK_SAMPLES + SEQ_LOOKAHEAD_BLOCKS;
+    double blockMicros = AUDIO_BLOCK_SAMPLES * 1e6 / AUDIO_SAMPLE_RATE_EXACT;
+    double clockMicros = (double)hostClockMicros();
+
+    sequencer.setReplaySeed(options.seed);
+    sequencer.start();
+    audioProfiler.setEnabled(options.profile);
+
+    uint64_t graphStart = hostAudioNanos();
+    int16_t pcm[AUDIO_BLOCK_SAMPLES * 2];
+    int peak = 0;
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (uint64_t b = 0; b < blocks; b++) {
+        // Ticks are decided a step ahead of where they land in the file:
+        // pause before the block that would decide the next loop's first
+        // step, so the tail only holds releases and FX
+        if (sequencer.isRunning() &&
+            (b + 1) * AUDIO_BLOCK_SAMPLES + samplesPerStep > patternFrames) {
+            sequencer.pause();
+        }
+
+        // Audio interrupt: clock, sequencer, commands, then every object
+        hostAudioUpdate();
+
+        if (b >= SEQ_LOOKAHEAD_BLOCKS) {
+            for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+                pcm[i * 2] = audioOutput.left[i];
+                pcm[i * 2 + 1] = audioOutput.right[i];
+                peak = max(peak, abs((int)audioOutput.left[i]));
+                peak = max(peak, abs((int)audioOutput.right[i]));
+            }
+            fwrite(pcm, sizeof(int16_t), AUDIO_BLOCK_SAMPLES * 2, out);
+        }
+
+        // loop(): the audio-related part, once per block
+        sequencer.update();
+        samplingEngine.update();
+        fxEngine.update();
+        outputMixer.gain(0, masterVolume);
+        audioProfiler.update();
+
+        clockMicros += blockMicros;
+        hostClockSet((uint64_t)clockMicros);
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    result.frames = (blocks - SEQ_LOOKAHEAD_BLOCKS) * AUDIO_BLOCK_SAMPLES;
+    result.audioSeconds = result.frames / (double)AUDIO_SAMPLE_RATE_EXACT;
+    result.wallSeconds = std::chrono::duration<double>(t1 - t0).count();
+    result.graphSeconds = (hostAudioNanos() - graphStart) * 1e-9;
+    result.peak = (int16_t)min(peak, 32767);
+    result.triggers = triggerCount;
+    result.lateCommands = audioCommands.getLate();
+    result.droppedCommands = audioCommands.getDropped() + sequencer.getDroppedEvents();
+
+    wavHeader(header, (uint32_t)result.frames);
+    fseek(out, 0, SEEK_SET);
+    fwrite(header, 1, sizeof(header), out);
+    bool ok = (fclose(out) == 0);
+    if (!ok) fprintf(stderr, "render: error writing %s\n", options.outPath);
+    return ok;
+}
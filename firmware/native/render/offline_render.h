@@ -0,0 +1,55 @@
+/**
+ * Oh My Ondas - Offline Renderer
+ * Renders a pattern (optionally under a scene) to a WAV file on the host
+ *
+ * Runs the firmware's own graph (audio_objects.h), sequencer, sample
+ * players and FX engine against the host HAL. The audio clock, the
+ * audio command queue and the sequencer trigger callback are the same
+ * code the Teensy runs (audio_dispatch.h); only the scheduling is
+ * replaced: one audio block, then one pass of the loop() work, with the
+ * simulated clock advanced by a block period. Nothing waits on real
+ * time, so a render runs as fast as the CPU allows.
+ *
+ * The SD card is a host directory laid out like the card: samples in
+ * /samples/bank00/sampleNN.wav, patterns in /patterns/patternNN.bin
+ * (or .json), scenes in /presets/scenes.json.
+ *
+ * The graph is global, as on the Teensy: render once per process.
+ */
+
+#ifndef OFFLINE_RENDER_H
+#define OFFLINE_RENDER_H
+
+#include <stdint.h>
+
+struct RenderOptions {
+    const char* sdRoot = "sdcard";
+    const char* outPath = "render.wav";
+    int pattern = 0;
+    int scene = -1;             // -1: no scene, else recall this slot first
+    int loops = 1;              // Passes of the master pattern length
+    float tailSeconds = 1.0f;   // Rendered past the last step (releases, delay)
+    uint32_t seed = 0;          // Performance seed for probability trigs
+    bool profile = false;       // Audio profiler CSV on stdout, a row per second of audio
+};
+
+struct RenderResult {
+    uint64_t frames = 0;        // Written to the WAV
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;   // Render loop only, setup excluded
+    double graphSeconds = 0.0;  // Of which in AudioStream::update()
+    int16_t peak = 0;           // Absolute, both channels
+    uint32_t triggers = 0;      // Sequencer trigger callbacks
+    uint32_t lateCommands = 0;  // Applied after their block (should be 0)
+    uint32_t droppedCommands = 0;
+
+    double realtimeFactor() const {
+        return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0;
+    }
+};
+
+// False (with a message on stderr) if the SD root, pattern, scene or
+// output file cannot be used
+bool renderOffline(const RenderOptions& options, RenderResult& result);
+
+#endif // OFFLINE_RENDER_H
@@ -0,0 +1,76 @@
+/**
+ * Oh My Ondas - Offline Render Tool
+ * Renders a pattern or scene from an SD card directory to a WAV file
+ *
+ *   omo_render --sd <dir> [--pattern N | --scene N] [--loops N]
+ *              [--tail SECONDS] [--seed N] [--profile] [-o out.wav]
+ *
+ * Prints the realtime factor (seconds of audio per wall second) on the
+ * last line as `realtime_factor=<x>`, for tracking DSP cost per commit.
+ * Reverb, granular and chorus are host stubs: the audio and the timing
+ * both leave them out, and the output says so.
+ * --profile adds the audio profiler's CSV rows (heaviest objects per
+ * second of audio, as the firmware prints them on serial).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Audio.h>           // HOST_AUDIO_SILENT_EFFECTS
+#include "host_hal.h"
+#include "offline_render.h"
+
+static void usage() {
+    fprintf(stderr,
+            "usage: omo_render --sd <dir> [--pattern N | --scene N] [--loops N]\n"
+            "                  [--tail SECONDS] [--seed N] [--profile] [-o out.wav] [--verbose]\n");
+}
+
+int main(int argc, char** argv) {
+    RenderOptions options;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--verbose") == 0) {
+            verbose = true;
+            continue;
+        }
+        if (strcmp(arg, "--profile") == 0) {
+            options.profile = true;
+            continue;
+        }
+        if (!value) {
+            usage();
+            return 2;
+        }
+        if (strcmp(arg, "--sd") == 0)           options.sdRoot = value;
+        else if (strcmp(arg, "-o") == 0)        options.outPath = value;
+        else if (strcmp(arg, "--pattern") == 0) options.pattern = atoi(value);
+        else if (strcmp(arg, "--scene") == 0)   options.scene = atoi(value);
+        else if (strcmp(arg, "--loops") == 0)   options.loops = atoi(value);
+        else if (strcmp(arg, "--tail") == 0)    options.tailSeconds = (float)atof(value);
+        else if (strcmp(arg, "--seed") == 0)    options.seed = (uint32_t)strtoul(value, nullptr, 0);
+        else {
+            usage();
+            return 2;
+        }
+        i++;
+    }
+
+    // Firmware DEBUG output only on request
+    hostSerialEcho(verbose);
+
+    RenderResult r;
+    if (!renderOffline(options, r)) return 1;
+
+    printf("%s: %.2f s, peak %d, %u triggers\n",
+           options.outPath, r.audioSeconds, r.peak, r.triggers);
+    printf("wall %.3f s (graph %.3f s), late %u, dropped %u\n",
+           r.wallSeconds, r.graphSeconds, r.lateCommands, r.droppedCommands);
+    printf("excludes %s: silent on the host, no DSP cost\n", HOST_AUDIO_SILENT_EFFECTS);
+    printf("realtime_factor=%.1f\n", r.realtimeFactor());
+    return 0;
+}
@@ -0,0 +1,36 @@
+/**
+ * Oh My Ondas - Audio Clock Implementation
+ * Sample counter driven by the Teensy audio update interrupt
+ */
+
+#include "audio_clock.h"
+
+AudioClock::AudioClock()
+    : AudioStream(0, NULL)
+    , samplePosition(0)
+    , overruns(0)
+    , blockCallback(nullptr)
+{
+    // Not connected to anything, so AudioConnection never marks us active
+    active = true;
+}
+
+void AudioClock::setBlockCallback(AudioBlockCallback callback) {
+    __disable_irq();
+    blockCallback = callback;
+    __enable_irq();
+}
+
+void AudioClock::update(void) {
+    uint32_t blockStart = samplePosition;
+
+    // The library totals a pass after its last object returns, so running
+    // first, this sees every block's total exactly once
+    if (AudioProcessorUsage() > 100.0f) overruns++;
+
+    if (blockCallback) {
+        blockCallback(blockStart, AUDIO_BLOCK_SAMPLES);
+    }
+
+    samplePosition = blockStart + AUDIO_BLOCK_SAMPLES;
+}
@@ -0,0 +1,74 @@
+/**
+ * Oh My Ondas - Audio Commands Implementation
+ * Timestamped parameter/trigger commands from loop() to the audio ISR
+ */
+
+#include "audio_commands.h"
+
+AudioCommandQueue::AudioCommandQueue()
+    : stagedCount(0)
+    , handler(nullptr)
+    , dropped(0)
+    , late(0)
+{
+}
+
+void AudioCommandQueue::setHandler(AudioCommandHandler h) {
+    __disable_irq();
+    handler = h;
+    __enable_irq();
+}
+
+bool AudioCommandQueue::post(AudioCommandType type, int track, float value,
+                             uint32_t when, uint8_t param, float end) {
+    if (track < 0 || track >= MAX_TRACKS) return false;
+
+    AudioCommand cmd;
+    cmd.when = when;
+    cmd.type = type;
+    cmd.track = (uint8_t)track;
+    cmd.param = param;
+    cmd.value = value;
+    cmd.end = end;
+
+    if (!queue.push(cmd)) {
+        dropped++;
+        return false;
+    }
+    return true;
+}
+
+void AudioCommandQueue::processBlock(uint32_t blockStart, uint16_t blockSamples) {
+    uint32_t blockEnd = blockStart + blockSamples;
+
+    // Stage new commands in timestamp order (stable: equal times keep
+    // posting order, so gain/filter posted before a trigger apply first)
+    AudioCommand cmd;
+    while (stagedCount < AUDIO_CMD_STAGE_SIZE && queue.pop(cmd)) {
+        int pos = stagedCount;
+        while (pos > 0 && (int32_t)(staged[pos - 1].when - cmd.when) > 0) {
+            staged[pos] = staged[pos - 1];
+            pos--;
+        }
+        staged[pos] = cmd;
+        stagedCount++;
+    }
+
+    // Apply everything due before this block ends
+    uint16_t applied = 0;
+    while (applied < stagedCount &&
+           (int32_t)(staged[applied].when - blockEnd) < 0) {
+        int32_t offset = (int32_t)(staged[applied].when - blockStart);
+        if (offset < 0) {
+            late++;
+            offset = 0;
+        }
+        if (handler) handler(staged[applied], (uint16_t)offset);
+        applied++;
+    }
+
+    if (applied > 0) {
+        stagedCount -= applied;
+        memmove(staged, staged + applied, stagedCount * sizeof(AudioCommand));
+    }
+}
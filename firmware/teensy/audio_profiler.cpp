@@ -0,0 +1,141 @@
+/**
+ * Oh My Ondas - Audio Profiler Implementation
+ * Per-object audio CPU, block overruns and audio memory high-water mark
+ */
+
+#include "audio_profiler.h"
+#include "audio_clock.h"
+
+AudioProfiler::AudioProfiler()
+    : clock(nullptr)
+    , out(nullptr)
+    , enabled(false)
+    , csv(true)
+    , count(0)
+    , topCount(0)
+    , total(0.0f)
+    , totalPeak(0.0f)
+    , overrunBase(0)
+    , windowStart(0)
+{
+}
+
+void AudioProfiler::begin(AudioClock* audioClock, Print* csvOut) {
+    clock = audioClock;
+    out = csvOut;
+}
+
+void AudioProfiler::add(const char* name, AudioStream& object, int index) {
+    if (count >= PROFILER_MAX_OBJECTS) {
+        DEBUG_PRINTF("AudioProfiler: No room for %s\n", name);
+        return;
+    }
+    ProfiledObject& o = objects[count++];
+    o.object = &object;
+    o.name = name;
+    o.index = index;
+    o.windowMax = 0.0f;
+    o.peak = 0.0f;
+}
+
+void AudioProfiler::setEnabled(bool on) {
+    if (on == enabled) return;
+    enabled = on;
+    if (!on) {
+        DEBUG_PRINTLN("AudioProfiler: Off");
+        return;
+    }
+
+    // Start clean: maxima from before now are not this run's
+    for (int i = 0; i < count; i++) {
+        objects[i].object->processorUsageMaxReset();
+        objects[i].windowMax = 0.0f;
+        objects[i].peak = 0.0f;
+    }
+    AudioProcessorUsageMaxReset();
+    total = 0.0f;
+    totalPeak = 0.0f;
+    topCount = 0;
+    overrunBase = clock ? clock->getOverruns() : 0;
+    windowStart = millis();
+
+    DEBUG_PRINTF("AudioProfiler: On, %d objects\n", count);
+    if (csv) printHeader();
+}
+
+uint32_t AudioProfiler::getOverruns() const {
+    return clock ? clock->getOverruns() - overrunBase : 0;
+}
+
+void AudioProfiler::update() {
+    if (!enabled) return;
+    if (millis() - windowStart < PROFILER_WINDOW_MS) return;
+    windowStart = millis();
+
+    sample();
+    rank();
+    if (csv) printRow();
+}
+
+void AudioProfiler::sample() {
+    for (int i = 0; i < count; i++) {
+        ProfiledObject& o = objects[i];
+        o.windowMax = o.object->processorUsageMax();
+        o.object->processorUsageMaxReset();
+        if (o.windowMax > o.peak) o.peak = o.windowMax;
+    }
+
+    total = AudioProcessorUsageMax();
+    AudioProcessorUsageMaxReset();
+    if (total > totalPeak) totalPeak = total;
+}
+
+void AudioProfiler::rank() {
+    // Insertion into a short sorted list: N stays small
+    topCount = 0;
+    for (int i = 0; i < count; i++) {
+        float usage = objects[i].windowMax;
+        int pos = topCount;
+        while (pos > 0 && objects[top[pos - 1]].windowMax < usage) pos--;
+        if (pos >= PROFILER_TOP_N) continue;
+
+        int last = (topCount < PROFILER_TOP_N) ? topCount++ : PROFILER_TOP_N - 1;
+        for (int j = last; j > pos; j--) top[j] = top[j - 1];
+        top[pos] = (uint8_t)i;
+    }
+}
+
+void AudioProfiler::formatName(const ProfiledObject& o, char* buf, size_t size) {
+    if (o.index < 0) snprintf(buf, size, "%s", o.name);
+    else snprintf(buf, size, "%s%d", o.name, o.index);
+}
+
+// ============================================
+// SERIAL CSV
+// ============================================
+
+void AudioProfiler::printHeader() {
+    if (!out) return;
+    out->print("prof,ms,total,total_peak,overruns,mem_peak");
+    for (int i = 1; i <= PROFILER_TOP_N; i++) {
+        out->printf(",top%d,top%d_pct", i, i);
+    }
+    out->println();
+}
+
+void AudioProfiler::printRow() {
+    if (!out) return;
+    out->printf("prof,%lu,%.2f,%.2f,%lu,%u", (unsigned long)windowStart, total, totalPeak,
+                (unsigned long)getOverruns(), (unsigned)getMemoryPeak());
+
+    char name[24];
+    for (int i = 0; i < PROFILER_TOP_N; i++) {
+        if (i < topCount) {
+            formatName(getTop(i), name, sizeof(name));
+            out->printf(",%s,%.2f", name, getTop(i).windowMax);
+        } else {
+            out->print(",,");
+        }
+    }
+    out->println();
+}
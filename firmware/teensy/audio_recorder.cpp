@@ -18,16 +18,17 @@ void AudioRecorder::begin(AudioRecordQueue* q) {
     DEBUG_PRINTLN("AudioRecorder: Ready");
 }
 
-void AudioRecorder::update() {
-    if (!recording || !queue) return;
+bool AudioRecorder::update() {
+    if (!recording || !queue) return true;
 
-    // Drain available audio buffers to SD
-    while (queue->available() > 0) {
+    // Drain available audio buffers to SD, a few per slice
+    for (int i = 0; i < RECORDER_BLOCKS_PER_SLICE && queue->available() > 0; i++) {
         int16_t* buf = queue->readBuffer();
         wavFile.write((byte*)buf, 256);  // 128 samples * 2 bytes
         queue->freeBuffer();
         totalSamples += 128;
     }
+    return queue->available() == 0;
 }
 
 void AudioRecorder::startRecording(const char* filename) {
@@ -5,7 +5,9 @@
 
 #include "fx_engine.h"
 #include <SD.h>
+#if HAVE_ARDUINOJSON
 #include <ArduinoJson.h>
+#endif
 
 FXEngine::FXEngine()
     : currentEffect(FX_NONE)
@@ -18,12 +20,10 @@ FXEngine::FXEngine()
     , fxReturnMix(nullptr)
     , fxReturn2Mix(nullptr)
     , fxSendMix(nullptr)
-    , lfoRate(1.0f)
-    , lfoDepth(0.0f)
-    , lfoTarget(-1)
-    , lfoPhase(0.0f)
-    , lastLFOUpdate(0)
+    , modMatrix(nullptr)
+    , lastWowUpdate(0)
 {
+    wow.setFrequency(1.0f, 1000.0f);
     initializeDefaults();
 }
 
@@ -32,10 +32,11 @@ void FXEngine::begin(AudioEffectFreeverb* reverb,
                      AudioEffectBitcrusher* crusher,
                      AudioEffectGranular* granular,
                      AudioEffectChorus* chorus,
-                     AudioFilterStateVariable* trackFilters,
-                     AudioMixer4* fxReturn,
-                     AudioMixer4* fxReturn2,
-                     AudioMixer4* fxSend) {
+                     StateVariableSmoother* trackFilters,
+                     AudioMixer4Smooth* fxReturn,
+                     AudioMixer4Smooth* fxReturn2,
+                     AudioMixer4Smooth* fxSend,
+                     const ModMatrix* mod) {
     reverbFX = reverb;
     delayFX = delay;
     crusherFX = crusher;
@@ -45,6 +46,7 @@ void FXEngine::begin(AudioEffectFreeverb* reverb,
     fxReturnMix = fxReturn;
     fxReturn2Mix = fxReturn2;
     fxSendMix = fxSend;
+    modMatrix = mod;
 
     DEBUG_PRINTLN("FXEngine: Initializing...");
     initializeDefaults();
@@ -53,7 +55,6 @@ void FXEngine::begin(AudioEffectFreeverb* reverb,
 }
 
 void FXEngine::update() {
-    updateLFO();
     applyEffect();
 }
 
@@ -89,72 +90,81 @@ void FXEngine::muteAllReturns() {
 void FXEngine::applyEffect() {
     if (!fxReturnMix) return;
 
-    float mix = currentParams.mix;
+    // Base values with this block's modulation; currentParams keeps the
+    // base, so nothing drifts
+    FXParams p = currentParams;
+    if (modMatrix) {
+        p.param1 = modMatrix->apply(MOD_DST_FX_PARAM1, p.param1);
+        p.param2 = modMatrix->apply(MOD_DST_FX_PARAM2, p.param2);
+        p.param3 = modMatrix->apply(MOD_DST_FX_PARAM3, p.param3);
+        p.mix = modMatrix->apply(MOD_DST_FX_MIX, p.mix);
+    }
+    float mix = p.mix;
 
-    // First mute all return channels
-    muteAllReturns();
+    // Only the active effect's return channels are open. Each return is
+    // written once per pass: the mixers glide to the last value written,
+    // so muting first and reopening would dip whenever a block fell between
+    float ret[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float ret2 = 0.0f;
 
-    // Then enable only the active effect's return channel
     switch (currentEffect) {
         case FX_REVERB:
             if (reverbFX) {
-                reverbFX->roomsize(currentParams.param1);
-                reverbFX->damping(currentParams.param2);
-                fxReturnMix->gain(0, mix);  // ch0 = reverb
+                reverbFX->roomsize(p.param1);
+                reverbFX->damping(p.param2);
+                ret[0] = mix;  // ch0 = reverb
             }
             break;
 
         case FX_DELAY:
             if (delayFX) {
                 // param1 = delay time (50-1000ms), param2 = feedback
-                int delayMs = (int)(currentParams.param1 * DELAY_MAX_MS);
+                int delayMs = (int)(p.param1 * DELAY_MAX_MS);
                 if (delayMs < 50) delayMs = 50;
                 delayFX->delay(0, delayMs);
                 // Feedback via fxSend mixer ch1
                 if (fxSendMix) {
-                    fxSendMix->gain(1, currentParams.param2 * 0.8f);
+                    fxSendMix->gain(1, p.param2 * 0.8f);
                 }
-                fxReturnMix->gain(1, mix);  // ch1 = delay
+                ret[1] = mix;  // ch1 = delay
             }
             break;
 
         case FX_BITCRUSH:
             if (crusherFX) {
                 // param1 = bits (4-16), param2 = sample rate reduction
-                int bits = 4 + (int)(currentParams.param1 * 12);
-                int sr = 4000 + (int)(currentParams.param2 * 40000);
+                int bits = 4 + (int)(p.param1 * 12);
+                int sr = 4000 + (int)(p.param2 * 40000);
                 crusherFX->bits(bits);
                 crusherFX->sampleRate(sr);
-                fxReturnMix->gain(2, mix);  // ch2 = bitcrusher
+                ret[2] = mix;  // ch2 = bitcrusher
             }
             break;
 
         case FX_GRAIN:
             if (granularFX) {
                 // param1 = grain size/speed, param2 = pitch shift ratio
-                float speed = 0.25f + currentParams.param1 * 1.75f;
-                granularFX->beginPitchShift(50 + (int)(currentParams.param2 * 200));
+                float speed = 0.25f + p.param1 * 1.75f;
+                granularFX->beginPitchShift(50 + (int)(p.param2 * 200));
                 granularFX->setSpeed(speed);
-                fxReturnMix->gain(3, mix);  // ch3 = granular
+                ret[3] = mix;  // ch3 = granular
             }
             break;
 
         case FX_CHORUS:
             if (chorusFX) {
-                int voices = 2 + (int)(currentParams.param1 * 4);
+                int voices = 2 + (int)(p.param1 * 4);
                 if (voices > 6) voices = 6;
                 chorusFX->voices(voices);
-                if (fxReturn2Mix) {
-                    fxReturn2Mix->gain(0, mix);  // fxReturn2 ch0 = chorus
-                }
+                ret2 = mix;  // fxReturn2 ch0 = chorus
             }
             break;
 
         case FX_FILTER:
             // Per-track filter sweep (applies to all track filters)
             if (filters) {
-                float freq = 100.0f + currentParams.param1 * 9900.0f;
-                float res = 0.7f + currentParams.param2 * 4.3f;
+                float freq = 100.0f + p.param1 * 9900.0f;
+                float res = 0.7f + p.param2 * 4.3f;
                 for (int i = 0; i < MAX_TRACKS; i++) {
                     filters[i].frequency(freq);
                     filters[i].resonance(res);
@@ -165,7 +175,7 @@ void FXEngine::applyEffect() {
         case FX_WAVEFOLD:
             // Wavefold via drive into the filter resonance
             if (filters) {
-                float res = 0.7f + currentParams.param1 * 9.0f;
+                float res = 0.7f + p.param1 * 9.0f;
                 for (int i = 0; i < MAX_TRACKS; i++) {
                     filters[i].resonance(res);
                 }
@@ -176,11 +186,11 @@ void FXEngine::applyEffect() {
             // Extreme bitcrusher: low sample rate + low bit depth
             if (crusherFX) {
                 // param1 = sample rate (2000-8000Hz), param2 = bits (4-8)
-                int glitchSR = 2000 + (int)(currentParams.param1 * 6000);
-                int glitchBits = 4 + (int)(currentParams.param2 * 4);
+                int glitchSR = 2000 + (int)(p.param1 * 6000);
+                int glitchBits = 4 + (int)(p.param2 * 4);
                 crusherFX->sampleRate(glitchSR);
                 crusherFX->bits(glitchBits);
-                fxReturnMix->gain(2, mix);  // ch2 = bitcrusher
+                ret[2] = mix;  // ch2 = bitcrusher
             }
             break;
 
@@ -188,13 +198,13 @@ void FXEngine::applyEffect() {
             // Comb filter via very short delay + high feedback
             if (delayFX) {
                 // param1 = delay time (1-30ms), param2 = feedback (0.5-0.95)
-                int combMs = 1 + (int)(currentParams.param1 * 29);
-                float combFb = 0.5f + currentParams.param2 * 0.45f;
+                int combMs = 1 + (int)(p.param1 * 29);
+                float combFb = 0.5f + p.param2 * 0.45f;
                 delayFX->delay(0, combMs);
                 if (fxSendMix) {
                     fxSendMix->gain(1, combFb);
                 }
-                fxReturnMix->gain(1, mix);  // ch1 = delay
+                ret[1] = mix;  // ch1 = delay
             }
             break;
 
@@ -204,16 +214,20 @@ void FXEngine::applyEffect() {
                 crusherFX->bits(12);
                 crusherFX->sampleRate(22050);
                 // param1 = wow amount (5-30ms delay), param2 = flutter depth
-                float lfo = sinf(lfoPhase * 2.0f * PI);
-                int tapeDelay = 5 + (int)(currentParams.param1 * 25
-                                + currentParams.param2 * 10.0f * lfo);
+                // 1 Hz wow, free running
+                unsigned long now = millis();
+                wow.advance(now - lastWowUpdate);
+                lastWowUpdate = now;
+                float lfo = lfoRead(lfoSineTable, wow.phase);
+                int tapeDelay = 5 + (int)(p.param1 * 25
+                                + p.param2 * 10.0f * lfo);
                 if (tapeDelay < 1) tapeDelay = 1;
                 delayFX->delay(0, tapeDelay);
                 if (fxSendMix) {
                     fxSendMix->gain(1, 0.3f);  // mild feedback
                 }
-                fxReturnMix->gain(1, mix * 0.6f);  // delay return
-                fxReturnMix->gain(2, mix * 0.4f);  // crush return
+                ret[1] = mix * 0.6f;  // delay return
+                ret[2] = mix * 0.4f;  // crush return
             }
             break;
 
@@ -229,6 +243,13 @@ void FXEngine::applyEffect() {
             }
             break;
     }
+
+    for (int i = 0; i < 4; i++) {
+        fxReturnMix->gain(i, ret[i]);
+    }
+    if (fxReturn2Mix) {
+        fxReturn2Mix->gain(0, ret2);
+    }
 }
 
 // Effect selection
@@ -360,7 +381,7 @@ void FXEngine::setTrackFXParam(int track, int paramIndex, float value) {
 // Presets
 void FXEngine::loadPreset(int presetNumber) {
     DEBUG_PRINTF("FXEngine: Loading preset %d\n", presetNumber);
-
+#if HAVE_ARDUINOJSON
     char path[64];
     snprintf(path, sizeof(path), "%sfx_preset%02d.json", PRESETS_DIR, presetNumber);
 
@@ -378,11 +399,12 @@ void FXEngine::loadPreset(int presetNumber) {
         currentParams.mix = doc["mix"] | 0.0f;
     }
     file.close();
+#endif
 }
 
 void FXEngine::savePreset(int presetNumber) {
     DEBUG_PRINTF("FXEngine: Saving preset %d\n", presetNumber);
-
+#if HAVE_ARDUINOJSON
     char path[64];
     snprintf(path, sizeof(path), "%sfx_preset%02d.json", PRESETS_DIR, presetNumber);
 
@@ -398,44 +420,5 @@ void FXEngine::savePreset(int presetNumber) {
 
     serializeJson(doc, file);
     file.close();
-}
-
-// LFO
-void FXEngine::setLFORate(float hz) {
-    lfoRate = constrain(hz, 0.01f, 20.0f);
-}
-
-void FXEngine::setLFODepth(float depth) {
-    lfoDepth = constrain(depth, 0.0f, 1.0f);
-}
-
-void FXEngine::setLFOTarget(int paramIndex) {
-    lfoTarget = paramIndex;
-}
-
-float FXEngine::getLFOValue() {
-    return sin(lfoPhase * 2.0f * PI) * lfoDepth;
-}
-
-void FXEngine::updateLFO() {
-    unsigned long now = millis();
-    if (now - lastLFOUpdate >= 10) {
-        float dt = (now - lastLFOUpdate) / 1000.0f;
-        lfoPhase += lfoRate * dt;
-        if (lfoPhase >= 1.0f) lfoPhase -= 1.0f;
-        lastLFOUpdate = now;
-
-        // Apply LFO modulation to target parameter
-        if (lfoTarget >= 0 && lfoDepth > 0.0f) {
-            float lfoVal = getLFOValue();
-            float base = getParam(lfoTarget);
-            float modulated = constrain(base + lfoVal * 0.3f, 0.0f, 1.0f);
-            // Temporarily override the param (will be rewritten next frame)
-            switch (lfoTarget) {
-                case 0: currentParams.param1 = modulated; break;
-                case 1: currentParams.param2 = modulated; break;
-                case 2: currentParams.param3 = modulated; break;
-            }
-        }
-    }
+#endif
 }
@@ -0,0 +1,147 @@
+/**
+ * Oh My Ondas - I2C Bus Implementation
+ * LPI2C1 interrupt state machine (Teensy 4.x Wire port, pins 18/19)
+ */
+
+#include "i2c_bus.h"
+
+static IMXRT_LPI2C_t* const port = (IMXRT_LPI2C_t*)IMXRT_LPI2C1_ADDRESS;
+static I2cBus* instance = nullptr;
+
+static const int TX_FIFO_WORDS = 4;
+
+static const uint32_t ERROR_FLAGS = LPI2C_MSR_NDF | LPI2C_MSR_ALF
+                                  | LPI2C_MSR_FEF | LPI2C_MSR_PLTF;
+static const uint32_t ERROR_IRQS = LPI2C_MIER_NDIE | LPI2C_MIER_ALIE
+                                 | LPI2C_MIER_FEIE | LPI2C_MIER_PLTIE;
+
+I2cBus::I2cBus()
+    : ready(false)
+    , timeouts(0)
+{
+}
+
+void I2cBus::begin() {
+    instance = this;
+
+    // Wire has configured the master; stop it polling, start interrupting
+    port->MIER = 0;
+    port->MCR |= LPI2C_MCR_RTF | LPI2C_MCR_RRF;
+    port->MSR = 0x00003F00;     // Clear every w1c flag
+    port->MFCR = LPI2C_MFCR_RXWATER(0) | LPI2C_MFCR_TXWATER(1);
+
+    attachInterruptVector(IRQ_LPI2C1, isr);
+    NVIC_SET_PRIORITY(IRQ_LPI2C1, 192);     // Below audio and SPI DMA
+    NVIC_ENABLE_IRQ(IRQ_LPI2C1);
+    ready = true;
+    DEBUG_PRINTLN("I2cBus: LPI2C1 interrupt-driven");
+}
+
+// ============================================
+// SUBMISSION (loop)
+// ============================================
+
+bool I2cBus::submit(uint8_t addr, const uint8_t* tx, uint8_t txLen, uint8_t rxLen,
+                    I2cCallback cb, void* ctx) {
+    if (!queue.submit(addr, tx, txLen, rxLen, cb, ctx)) return false;
+    kick();
+    return true;
+}
+
+bool I2cBus::writeReg(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len,
+                      I2cCallback cb, void* ctx) {
+    if (!queue.writeReg(addr, reg, data, len, cb, ctx)) return false;
+    kick();
+    return true;
+}
+
+bool I2cBus::readReg(uint8_t addr, uint8_t reg, uint8_t len, I2cCallback cb, void* ctx) {
+    if (!queue.readReg(addr, reg, len, cb, ctx)) return false;
+    kick();
+    return true;
+}
+
+// The command FIFO is empty while the bus is idle, so enabling the
+// transmit-data interrupt fires it at once; it starts the transfer.
+void I2cBus::kick() {
+    if (!ready) return;
+    NVIC_DISABLE_IRQ(IRQ_LPI2C1);
+    port->MIER |= LPI2C_MIER_TDIE | LPI2C_MIER_SDIE | ERROR_IRQS;
+    NVIC_ENABLE_IRQ(IRQ_LPI2C1);
+}
+
+void I2cBus::service() {
+    queue.dispatch();
+    if (!ready) return;
+
+    NVIC_DISABLE_IRQ(IRQ_LPI2C1);
+    const I2cTransfer* t = queue.current();
+    if (t && queue.isStarted() && micros() - t->startedAt > I2C_TIMEOUT_US) {
+        // A device holding SCL, or a lost interrupt: drop the transfer,
+        // send a STOP and go on with the next one
+        port->MCR |= LPI2C_MCR_RTF | LPI2C_MCR_RRF;
+        port->MSR = 0x00003F00;
+        if (port->MSR & LPI2C_MSR_MBF) port->MTDR = I2cQueue::CMD_STOP;
+        queue.finish(I2C_TIMEOUT, micros());
+        timeouts++;
+        port->MIER |= LPI2C_MIER_TDIE | LPI2C_MIER_SDIE | ERROR_IRQS;
+    }
+    NVIC_ENABLE_IRQ(IRQ_LPI2C1);
+}
+
+// ============================================
+// INTERRUPT
+// ============================================
+
+void I2cBus::isr() {
+    if (instance) instance->handleInterrupt();
+}
+
+void I2cBus::handleInterrupt() {
+    uint32_t msr = port->MSR;
+
+    if (msr & ERROR_FLAGS) {
+        // The master sends STOP itself after a NACK; drop what is left of
+        // the transfer from both FIFOs
+        port->MCR |= LPI2C_MCR_RTF | LPI2C_MCR_RRF;
+        port->MSR = ERROR_FLAGS | LPI2C_MSR_SDF | LPI2C_MSR_EPF;
+        if ((msr & (LPI2C_MSR_ALF | LPI2C_MSR_FEF | LPI2C_MSR_PLTF))
+            && (port->MSR & LPI2C_MSR_MBF)) {
+            port->MTDR = I2cQueue::CMD_STOP;
+        }
+        if (queue.current() && queue.isStarted()) {
+            queue.finish((msr & LPI2C_MSR_NDF) ? I2C_NACK : I2C_BUS_ERROR, micros());
+        }
+    }
+
+    // A STOP ends each transfer, then the next one starts in the same pass
+    for (;;) {
+        bool fresh = !queue.isStarted();
+        I2cTransfer* t = queue.start(micros());
+        if (!t) {
+            port->MIER = 0;
+            return;
+        }
+        if (fresh) port->MSR = LPI2C_MSR_SDF | LPI2C_MSR_EPF;
+
+        while ((port->MFSR >> 16) & 0x7) {
+            queue.received((uint8_t)port->MRDR);
+        }
+        uint16_t word;
+        while ((int)(port->MFSR & 0x7) < TX_FIFO_WORDS && queue.nextCommand(word)) {
+            port->MTDR = word;
+        }
+
+        if (queue.commandsDone() && queue.readDone() && (port->MSR & LPI2C_MSR_SDF)) {
+            port->MSR = LPI2C_MSR_SDF;
+            queue.finish(I2C_OK, micros());
+            continue;
+        }
+
+        uint32_t mier = LPI2C_MIER_SDIE | ERROR_IRQS;
+        if (!queue.commandsDone()) mier |= LPI2C_MIER_TDIE;
+        if (!queue.readDone()) mier |= LPI2C_MIER_RDIE;
+        port->MIER = mier;
+        return;
+    }
+}
@@ -0,0 +1,180 @@
+/**
+ * Oh My Ondas - I2C Transfer Queue Implementation
+ * Submission, LPI2C command sequencing and in-order completion
+ */
+
+#include "i2c_queue.h"
+
+I2cQueue::I2cQueue()
+    : head(0)
+    , active(0)
+    , tail(0)
+    , started(false)
+    , cmdIndex(0)
+    , rxCount(0)
+    , completed(0)
+    , failed(0)
+    , dropped(0)
+    , peakDepth(0)
+    , busyMicros(0)
+{
+    memset(slots, 0, sizeof(slots));
+}
+
+// ============================================
+// LOOP SIDE
+// ============================================
+
+bool I2cQueue::submit(uint8_t addr, const uint8_t* tx, uint8_t txLen, uint8_t rxLen,
+                      I2cCallback cb, void* ctx) {
+    if (txLen > I2C_MAX_WRITE || rxLen > I2C_MAX_READ) return false;
+
+    uint16_t h = head.load(std::memory_order_relaxed);
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    if ((uint16_t)(h - t) >= I2C_QUEUE_SIZE) {
+        dropped++;
+        return false;
+    }
+
+    I2cTransfer& s = slot(h);
+    s.addr = addr;
+    s.txLen = txLen;
+    s.rxLen = rxLen;
+    s.status = I2C_PENDING;
+    if (txLen) memcpy(s.tx, tx, txLen);
+    s.cb = cb;
+    s.ctx = ctx;
+    s.startedAt = 0;
+    s.finishedAt = 0;
+    head.store((uint16_t)(h + 1), std::memory_order_release);
+
+    int depth = (uint16_t)(h + 1 - t);
+    if (depth > peakDepth) peakDepth = depth;
+    return true;
+}
+
+bool I2cQueue::writeReg(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len,
+                        I2cCallback cb, void* ctx) {
+    if (len + 1 > I2C_MAX_WRITE) return false;
+    uint8_t tx[I2C_MAX_WRITE];
+    tx[0] = reg;
+    if (len) memcpy(tx + 1, data, len);
+    return submit(addr, tx, len + 1, 0, cb, ctx);
+}
+
+bool I2cQueue::readReg(uint8_t addr, uint8_t reg, uint8_t len, I2cCallback cb, void* ctx) {
+    return submit(addr, &reg, 1, len, cb, ctx);
+}
+
+int I2cQueue::dispatch() {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    uint16_t a = active.load(std::memory_order_acquire);
+    int n = 0;
+
+    while (t != a) {
+        const I2cTransfer& s = slot(t);
+        if (s.status == I2C_OK) completed++;
+        else failed++;
+        if (s.cb) s.cb(s, s.ctx);
+
+        // Free the slot before the next callback so it can resubmit
+        t++;
+        tail.store(t, std::memory_order_release);
+        n++;
+    }
+    return n;
+}
+
+int I2cQueue::space() const {
+    return I2C_QUEUE_SIZE - (uint16_t)(head.load(std::memory_order_relaxed)
+                                     - tail.load(std::memory_order_relaxed));
+}
+
+int I2cQueue::pending() const {
+    return (uint16_t)(head.load(std::memory_order_acquire)
+                    - active.load(std::memory_order_acquire));
+}
+
+// ============================================
+// INTERRUPT SIDE
+// ============================================
+
+I2cTransfer* I2cQueue::current() {
+    uint16_t a = active.load(std::memory_order_relaxed);
+    uint16_t h = head.load(std::memory_order_acquire);
+    return a == h ? nullptr : &slot(a);
+}
+
+I2cTransfer* I2cQueue::start(uint32_t now) {
+    I2cTransfer* t = current();
+    if (t && !started) {
+        t->startedAt = now;
+        started = true;
+        cmdIndex = 0;
+        rxCount = 0;
+    }
+    return t;
+}
+
+// START+W, register and data bytes, then for a read a repeated START+R
+// and one RECEIVE for all bytes; STOP last. A read with nothing to write
+// starts with START+R; a probe (nothing either way) is START+W, STOP.
+int I2cQueue::commandCount(const I2cTransfer& t) const {
+    int n = 1 + t.txLen + 1;
+    if (t.rxLen) n += t.txLen ? 2 : 1;
+    return n;
+}
+
+uint16_t I2cQueue::command(const I2cTransfer& t, int i) const {
+    uint16_t addrW = CMD_START | (uint16_t)(t.addr << 1);
+    uint16_t addrR = addrW | 1;
+
+    if (i == 0) return (t.txLen == 0 && t.rxLen) ? addrR : addrW;
+    if (i <= t.txLen) return CMD_TRANSMIT | t.tx[i - 1];
+    i -= t.txLen + 1;
+    if (t.rxLen) {
+        if (t.txLen) {
+            if (i == 0) return addrR;
+            i--;
+        }
+        if (i == 0) return CMD_RECEIVE | (uint16_t)(t.rxLen - 1);
+        i--;
+    }
+    return CMD_STOP;
+}
+
+bool I2cQueue::nextCommand(uint16_t& word) {
+    I2cTransfer* t = current();
+    if (!t || !started || cmdIndex >= commandCount(*t)) return false;
+    word = command(*t, cmdIndex++);
+    return true;
+}
+
+bool I2cQueue::commandsDone() const {
+    uint16_t a = active.load(std::memory_order_relaxed);
+    return started && cmdIndex >= commandCount(slots[a & (I2C_QUEUE_SIZE - 1)]);
+}
+
+void I2cQueue::received(uint8_t b) {
+    I2cTransfer* t = current();
+    if (!t || rxCount >= t->rxLen) return;
+    t->rx[rxCount++] = b;
+}
+
+bool I2cQueue::readDone() const {
+    uint16_t a = active.load(std::memory_order_relaxed);
+    return rxCount >= slots[a & (I2C_QUEUE_SIZE - 1)].rxLen;
+}
+
+void I2cQueue::finish(uint8_t status, uint32_t now) {
+    I2cTransfer* t = current();
+    if (!t) return;
+    if (!started) t->startedAt = now;
+
+    t->status = status;
+    t->finishedAt = now;
+    busyMicros = busyMicros + (now - t->startedAt);
+    started = false;
+    active.store((uint16_t)(active.load(std::memory_order_relaxed) + 1),
+                 std::memory_order_release);
+}
@@ -0,0 +1,44 @@
+/**
+ * Oh My Ondas - Audio Clock
+ * Sample counter driven by the Teensy audio update interrupt
+ *
+ * Has no inputs or outputs: it only exists to get update() called once
+ * per AUDIO_BLOCK_SAMPLES block, in the same interrupt that renders audio.
+ * Declare it before every other AudioStream object so it runs first in the
+ * update list and anything it schedules lands in the block being rendered.
+ */
+
+#ifndef AUDIO_CLOCK_H
+#define AUDIO_CLOCK_H
+
+#include <Arduino.h>
+#include <AudioStream.h>
+#include "config.h"
+
+// Called from the audio ISR at the start of every block.
+// blockStart is the absolute sample index of the block's first sample.
+typedef void (*AudioBlockCallback)(uint32_t blockStart, uint16_t blockSamples);
+
+class AudioClock : public AudioStream {
+public:
+    AudioClock();
+
+    virtual void update(void);
+
+    void setBlockCallback(AudioBlockCallback callback);
+
+    // Absolute sample position (wraps after ~27h at 44.1kHz;
+    // compare with (int32_t)(a - b), never a < b)
+    uint32_t getSamplePosition() const { return samplePosition; }
+
+    // Blocks whose full update pass took longer than the block period
+    // (the output under-ran or the next interrupt was held off)
+    uint32_t getOverruns() const { return overruns; }
+
+private:
+    volatile uint32_t samplePosition;
+    volatile uint32_t overruns;
+    AudioBlockCallback blockCallback;
+};
+
+#endif // AUDIO_CLOCK_H
@@ -0,0 +1,81 @@
+/**
+ * Oh My Ondas - Audio Commands
+ * Timestamped parameter/trigger commands from loop() to the audio ISR
+ *
+ * loop() (sequencer dispatch, touch pads, encoders) is the only producer;
+ * the AudioClock block callback is the only consumer. Each command carries
+ * the absolute sample it belongs on and is applied at the start of the
+ * block containing that sample, so writes to amp/filter/player objects
+ * never race the audio update and always land on a known block boundary.
+ * The handler also gets the sample offset inside that block, which the
+ * memory sample players use to start on the exact sample.
+ *
+ * The ISR moves queued commands into a small staging list kept sorted by
+ * timestamp, so an immediate command (pad hit) is not held up behind a
+ * sequencer trigger scheduled further ahead.
+ */
+
+#ifndef AUDIO_COMMANDS_H
+#define AUDIO_COMMANDS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "spsc_queue.h"
+
+enum AudioCommandType : uint8_t {
+    CMD_TRIGGER = 0,    // Start sample playback on track: value..end = region, fractions
+    CMD_STOP,           // Stop sample playback on track
+    CMD_GAIN,           // Track amp gain (value)
+    CMD_FILTER_FREQ,    // Track filter cutoff in Hz (value)
+    CMD_FILTER_RES,     // Track filter resonance (value)
+    CMD_PITCH,          // Per-note playback rate ratio on top of slot pitch (value)
+    CMD_PLOCK,          // Parameter lock: param = ParamType, value
+    CMD_SYNTH_LOCK,     // Lock for the next CMD_NOTE_ON: param = ParamType, value
+    CMD_NOTE_ON,        // Synth note: param = MIDI note, value = velocity
+    CMD_NOTE_OFF        // Gate off: param = MIDI note, value = note length in samples
+};
+
+struct AudioCommand {
+    uint32_t when;      // Absolute sample (AudioClock timeline)
+    uint8_t type;       // AudioCommandType
+    uint8_t track;
+    uint8_t param;      // ParamType or MIDI note, see AudioCommandType
+    float value;
+    float end;          // CMD_TRIGGER only: region end (value = region start)
+};
+
+// Applies one command. Runs in the audio ISR: no Serial, no blocking.
+// offset = position of `when` inside the block about to render (0 if late)
+typedef void (*AudioCommandHandler)(const AudioCommand& cmd, uint16_t offset);
+
+class AudioCommandQueue {
+public:
+    AudioCommandQueue();
+
+    void setHandler(AudioCommandHandler handler);
+
+    // Producer (loop): returns false and counts a drop if the ring is full
+    bool post(AudioCommandType type, int track, float value,
+              uint32_t when, uint8_t param = 0, float end = 1.0f);
+
+    // Consumer (audio ISR): apply every command due before the block ends
+    void processBlock(uint32_t blockStart, uint16_t blockSamples);
+
+    // Statistics
+    uint32_t getDropped()  { return dropped; }
+    uint32_t getLate()     { return late; }     // Arrived after their block
+    uint16_t getPending()  { return queue.size() + stagedCount; }
+
+private:
+    SPSCQueue<AudioCommand, AUDIO_CMD_QUEUE_SIZE> queue;
+
+    // ISR-only: commands pulled off the queue, sorted by `when`
+    AudioCommand staged[AUDIO_CMD_STAGE_SIZE];
+    uint16_t stagedCount;
+
+    AudioCommandHandler handler;
+    volatile uint32_t dropped;
+    volatile uint32_t late;
+};
+
+#endif // AUDIO_COMMANDS_H
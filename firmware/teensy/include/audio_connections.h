@@ -2,10 +2,13 @@
  * Oh My Ondas - Audio Connections
  * All AudioConnection patch cords wiring the signal chain:
  *
- * Sample Players [0-7] → filters → amps → playerMixers → sampleSum
- * Synth (osc1+osc2+noise) → synthMixer → synthFilter → synthEnv → synthAmp
+ * Sample Players [0-7] (cached memPlayer + SD player) → srcMix → filters → amps
+ *   → playerMixers → sampleSum
+ * Synth voices [0-7] (osc1+osc2+shared noise) → synthMixer → synthFilter
+ *   → synthEnv → synthVoiceMix → synthSum
  * Audio Input → inputMixer
- * sampleSum + synthAmp + inputMixer → masterMix
+ * inputMixer, sampleSum → envFollow (modulation sources)
+ * sampleSum + synthSum + inputMixer → masterMix
  * masterMix → fxSend → delay/reverb/bitcrusher/granular/chorus → fxReturn
  * masterMix (dry) + fxReturn (wet) → outputMixer → audioOutput + recorder + peak/fft
  */
@@ -17,15 +20,35 @@
 // Player → Filter → Amp → Mixer chain (8 tracks)
 // ============================================
 
-// Players L channel → per-track state variable filters (lowpass)
-AudioConnection pc_p0f(player[0], 0, filter[0], 0);
-AudioConnection pc_p1f(player[1], 0, filter[1], 0);
-AudioConnection pc_p2f(player[2], 0, filter[2], 0);
-AudioConnection pc_p3f(player[3], 0, filter[3], 0);
-AudioConnection pc_p4f(player[4], 0, filter[4], 0);
-AudioConnection pc_p5f(player[5], 0, filter[5], 0);
-AudioConnection pc_p6f(player[6], 0, filter[6], 0);
-AudioConnection pc_p7f(player[7], 0, filter[7], 0);
+// Cached (PSRAM) players → per-track source mixer ch0
+AudioConnection pc_m0s(memPlayer[0], 0, srcMix[0], 0);
+AudioConnection pc_m1s(memPlayer[1], 0, srcMix[1], 0);
+AudioConnection pc_m2s(memPlayer[2], 0, srcMix[2], 0);
+AudioConnection pc_m3s(memPlayer[3], 0, srcMix[3], 0);
+AudioConnection pc_m4s(memPlayer[4], 0, srcMix[4], 0);
+AudioConnection pc_m5s(memPlayer[5], 0, srcMix[5], 0);
+AudioConnection pc_m6s(memPlayer[6], 0, srcMix[6], 0);
+AudioConnection pc_m7s(memPlayer[7], 0, srcMix[7], 0);
+
+// SD fallback players L channel → per-track source mixer ch1
+AudioConnection pc_p0s(player[0], 0, srcMix[0], 1);
+AudioConnection pc_p1s(player[1], 0, srcMix[1], 1);
+AudioConnection pc_p2s(player[2], 0, srcMix[2], 1);
+AudioConnection pc_p3s(player[3], 0, srcMix[3], 1);
+AudioConnection pc_p4s(player[4], 0, srcMix[4], 1);
+AudioConnection pc_p5s(player[5], 0, srcMix[5], 1);
+AudioConnection pc_p6s(player[6], 0, srcMix[6], 1);
+AudioConnection pc_p7s(player[7], 0, srcMix[7], 1);
+
+// Source mixers → per-track state variable filters (lowpass)
+AudioConnection pc_s0f(srcMix[0], 0, filter[0], 0);
+AudioConnection pc_s1f(srcMix[1], 0, filter[1], 0);
+AudioConnection pc_s2f(srcMix[2], 0, filter[2], 0);
+AudioConnection pc_s3f(srcMix[3], 0, filter[3], 0);
+AudioConnection pc_s4f(srcMix[4], 0, filter[4], 0);
+AudioConnection pc_s5f(srcMix[5], 0, filter[5], 0);
+AudioConnection pc_s6f(srcMix[6], 0, filter[6], 0);
+AudioConnection pc_s7f(srcMix[7], 0, filter[7], 0);
 
 // Filters (lowpass output = channel 0) → per-track amplifiers
 AudioConnection pc_f0a(filter[0], 0, amp[0], 0);
@@ -55,14 +78,38 @@ AudioConnection pc_prS(playerMixR, 0, sampleSum, 1);
 // Synth voice chain
 // ============================================
 
-// Oscillators + noise → synth mixer
-AudioConnection pc_sw1(synthWave1, 0, synthMixer, 0);
-AudioConnection pc_sw2(synthWave2, 0, synthMixer, 1);
-AudioConnection pc_snm(synthNoise, 0, synthMixer, 2);
-
-// Synth mixer → Moog ladder filter → ADSR envelope
-AudioConnection pc_smf(synthMixer, 0, synthFilter, 0);
-AudioConnection pc_sfe(synthFilter, 0, synthEnv, 0);
+// One voice: oscillators + shared noise → synth mixer → Moog ladder
+// filter → ADSR envelope → voice sub-mixer (4 voices per sub-mixer)
+#define SYNTH_VOICE_CORDS(v) \
+    AudioConnection pc_sv##v##w1(synthWave1[v], 0, synthMixer[v], 0); \
+    AudioConnection pc_sv##v##w2(synthWave2[v], 0, synthMixer[v], 1); \
+    AudioConnection pc_sv##v##nm(synthNoise, 0, synthMixer[v], 2); \
+    AudioConnection pc_sv##v##mf(synthMixer[v], 0, synthFilter[v], 0); \
+    AudioConnection pc_sv##v##fe(synthFilter[v], 0, synthEnv[v], 0); \
+    AudioConnection pc_sv##v##em(synthEnv[v], 0, synthVoiceMix[v / 4], v % 4);
+
+SYNTH_VOICE_CORDS(0)
+SYNTH_VOICE_CORDS(1)
+SYNTH_VOICE_CORDS(2)
+SYNTH_VOICE_CORDS(3)
+#if SYNTH_VOICES > 4
+SYNTH_VOICE_CORDS(4)
+#endif
+#if SYNTH_VOICES > 5
+SYNTH_VOICE_CORDS(5)
+#endif
+#if SYNTH_VOICES > 6
+SYNTH_VOICE_CORDS(6)
+#endif
+#if SYNTH_VOICES > 7
+SYNTH_VOICE_CORDS(7)
+#endif
+
+#undef SYNTH_VOICE_CORDS
+
+// Voice sub-mixers → synth sum
+AudioConnection pc_sv0S(synthVoiceMix[0], 0, synthSum, 0);
+AudioConnection pc_sv1S(synthVoiceMix[1], 0, synthSum, 1);
 
 // ============================================
 // Input chain
@@ -72,13 +119,21 @@ AudioConnection pc_sfe(synthFilter, 0, synthEnv, 0);
 AudioConnection pc_inL(audioInput, 0, inputMixer, 0);
 AudioConnection pc_inR(audioInput, 1, inputMixer, 1);
 
+// ============================================
+// Modulation sources
+// ============================================
+
+// Envelope followers (mod matrix ENV1, ENV2): input bus, sample bus
+AudioConnection pc_iEf(inputMixer, 0, envFollow[0], 0);
+AudioConnection pc_sEf(sampleSum, 0, envFollow[1], 0);
+
 // ============================================
 // Master mix (dry path)
 // ============================================
 
-// sampleSum + synthEnv + inputMixer → masterMix (ch0=samples, ch1=synth, ch2=input)
+// sampleSum + synthSum + inputMixer → masterMix (ch0=samples, ch1=synth, ch2=input)
 AudioConnection pc_sMm(sampleSum, 0, masterMix, 0);
-AudioConnection pc_sEm(synthEnv, 0, masterMix, 1);
+AudioConnection pc_sEm(synthSum, 0, masterMix, 1);
 AudioConnection pc_iMm(inputMixer, 0, masterMix, 2);
 
 // ============================================
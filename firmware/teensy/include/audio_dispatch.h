@@ -0,0 +1,290 @@
+/**
+ * Oh My Ondas - Audio Dispatch
+ * Glue between the sequencer, the audio command queue and the graph
+ *
+ * The audio-ISR block callback, the command handler it runs, the
+ * sequencer trigger callbacks that post those commands, and the graph's
+ * power-on mixer/filter/effect levels. Shared by the firmware and the
+ * offline renderer so both turn a pattern into the same commands.
+ *
+ * Include exactly once per program, after audio_objects.h and after
+ * `audioCommands`, `samplingEngine`, `sequencer` and `polySynth` are
+ * defined.
+ */
+
+#ifndef AUDIO_DISPATCH_H
+#define AUDIO_DISPATCH_H
+
+#include "audio_commands.h"
+#include "pattern.h"
+
+// ============================================
+// GRAPH LEVELS
+// ============================================
+
+void initAudioGraph() {
+    // Per-track filters. Levels are set without a ramp here; everything
+    // written later glides (smoothed_audio.h)
+    for (int i = 0; i < MAX_TRACKS; i++) {
+        filterCtl[i].begin(&filter[i], TRACK_FILTER_FREQ, TRACK_FILTER_RES);
+        amp[i].gainNow(1.0);
+    }
+
+    // Player sub-mixer gains
+    for (int i = 0; i < 4; i++) {
+        playerMixL.gain(i, 0.25);
+        playerMixR.gain(i, 0.25);
+    }
+    sampleSum.gain(0, 1.0);
+    sampleSum.gain(1, 1.0);
+
+    // Synth voices
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        synthWave1[v].begin(0.5, 440, WAVEFORM_SAWTOOTH);
+        synthWave1[v].amplitude(0.0);
+        synthWave2[v].begin(0.5, 440, WAVEFORM_SQUARE);
+        synthWave2[v].amplitude(0.0);
+        synthMixer[v].gainNow(0, 0.5);
+        synthMixer[v].gainNow(1, 0.3);
+        synthMixer[v].gainNow(2, 0.0);
+        synthFilterCtl[v].begin(&synthFilter[v], 8000, 0.7);
+        synthEnv[v].attack(10);
+        synthEnv[v].decay(100);
+        synthEnv[v].sustain(0.7);
+        synthEnv[v].release(200);
+    }
+    synthNoise.amplitude(0.0);
+    modMatrix.begin(envFollow);
+
+    // Voice sub-mixers: a chord of all voices at full velocity stays
+    // short of clipping at masterMix ch1's 0.5
+    for (int i = 0; i < 4; i++) {
+        synthVoiceMix[0].gain(i, 0.5);
+        synthVoiceMix[1].gain(i, 0.5);
+    }
+    synthSum.gain(0, 1.0);
+    synthSum.gain(1, 1.0);
+
+    // Input mixer
+    inputMixer.gainNow(0, 0.5);
+    inputMixer.gainNow(1, 0.5);
+
+    // Master mix
+    masterMix.gainNow(0, 0.8);
+    masterMix.gainNow(1, 0.5);
+    masterMix.gainNow(2, 0.3);
+
+    // FX send/return
+    fxSend.gainNow(0, 1.0);
+    fxSend.gainNow(1, 0.3);
+    fxReturn.gainNow(0, 0.0);
+    fxReturn.gainNow(1, 0.0);
+    fxReturn.gainNow(2, 0.0);
+    fxReturn.gainNow(3, 0.0);
+    fxReturn2.gainNow(0, 0.0);
+
+    // Output mixer
+    outputMixer.gainNow(0, 0.8);
+    outputMixer.gainNow(1, 0.5);
+    outputMixer.gainNow(2, 0.5);
+
+    // Effects init
+    reverb.roomsize(0.7);
+    reverb.damping(0.5);
+    delayL.delay(0, 250);
+    crusher.bits(12);
+    crusher.sampleRate(22050);
+    granular.begin(granularBuffer, GRANULAR_BUFFER_SIZE);
+    chorus.begin(chorusDelayLine, CHORUS_DELAY_LENGTH, 2);
+}
+
+// ============================================
+// AUDIO BLOCK CALLBACK (audio ISR — keep it short, no Serial/SD)
+// ============================================
+
+// Modulation matrix results to the objects it drives. The FX engine
+// applies its own destinations from loop()
+void applyModulation(uint16_t blockSamples) {
+    modMatrix.process(blockSamples);
+    polySynth.modulate(modMatrix.value(MOD_DST_SYNTH_CUTOFF),
+                       modMatrix.value(MOD_DST_SYNTH_PITCH));
+    masterMix.modulate(1, modMatrix.value(MOD_DST_SYNTH_LEVEL));   // ch1 = synth
+    for (int i = 0; i < MAX_TRACKS; i++) {
+        amp[i].modulate(modMatrix.value((ModDest)(MOD_DST_TRACK_LEVEL + i)));
+    }
+}
+
+void onAudioBlock(uint32_t blockStart, uint16_t blockSamples) {
+    sequencer.processAudioBlock(blockStart, blockSamples);
+    audioCommands.processBlock(blockStart, blockSamples);
+    applyModulation(blockSamples);
+
+    // Filter ramps, after the commands so a p-lock is in place this block
+    for (int i = 0; i < MAX_TRACKS; i++) filterCtl[i].update();
+    // Synth filter ramps, parking, and the voice limit for the next block
+    polySynth.update();
+}
+
+// Earliest sample a command posted from loop() can still land on
+uint32_t audioNow() {
+    return audioClock.getSamplePosition();
+}
+
+void applyAudioCommand(const AudioCommand& cmd, uint16_t offset) {
+    int track = cmd.track;
+
+    switch (cmd.type) {
+        case CMD_TRIGGER:
+            samplingEngine.trigger(track, offset, cmd.value, cmd.end);
+            break;
+        case CMD_STOP:
+            samplingEngine.stop(track);
+            break;
+        // Trigger-time values: in place for the note, no ramp
+        case CMD_GAIN:
+            amp[track].gainNow(cmd.value);
+            break;
+        case CMD_FILTER_FREQ:
+            filterCtl[track].frequencyNow(cmd.value);
+            break;
+        case CMD_FILTER_RES:
+            filterCtl[track].resonanceNow(cmd.value);
+            break;
+        case CMD_PITCH:
+            samplingEngine.setPlaybackRate(track, cmd.value);
+            break;
+        case CMD_PLOCK:
+            switch (cmd.param) {
+                case PARAM_PAN:
+                    samplingEngine.setPan(track, cmd.value);
+                    break;
+                default:
+                    // FX sends: no per-track send bus yet
+                    break;
+            }
+            break;
+        // Synth tracks: every synth track plays the one PolySynth
+        case CMD_SYNTH_LOCK:
+            polySynth.lockNextNote((ParamType)cmd.param, cmd.value);
+            break;
+        case CMD_NOTE_ON:
+            polySynth.playNote(cmd.param, cmd.value, cmd.when);
+            break;
+        case CMD_NOTE_OFF:
+            polySynth.releaseNote(cmd.param, cmd.when - (uint32_t)cmd.value);
+            break;
+    }
+}
+
+// ============================================
+// SEQUENCER TRIGGER CALLBACK
+// ============================================
+
+void onSequencerTrigger(int track, int step, const Step& stepData, StepLocks locks,
+                        uint32_t sampleTime) {
+    float vel = stepData.velocity / 127.0f;
+    float gain = samplingEngine.getVolume(track) * vel;
+    float semitones = stepData.pitchOffset;
+    float freq = samplingEngine.getFilterFreq(track);
+    float res = samplingEngine.getFilterRes(track);
+    float start = 0.0f;
+    float end = 1.0f;
+
+    // Walk only the locks present (values are in mask order). Every value
+    // a lock can change is posted on unlocked steps too, from the track's
+    // base, so a lock never outlasts its step
+    const uint16_t* q = locks.values;
+    for (uint16_t m = locks.mask; m; m &= m - 1) {
+        ParamType p = (ParamType)__builtin_ctz(m);
+        float value = paramLockDecode(p, *q++);
+
+        switch (p) {
+            case PARAM_FILTER_FREQ:
+                freq = value;
+                break;
+            case PARAM_FILTER_RES:
+                res = value;
+                break;
+            case PARAM_VOLUME:
+                gain = value * vel;
+                break;
+            case PARAM_PITCH:
+                semitones = value;
+                break;
+            case PARAM_SAMPLE_START:
+                start = value;
+                break;
+            case PARAM_SAMPLE_END:
+                end = value;
+                break;
+            case PARAM_PAN:
+            case PARAM_FX_SEND_1:
+            case PARAM_FX_SEND_2:
+                audioCommands.post(CMD_PLOCK, track, value, sampleTime, p);
+                break;
+            default:
+                // Synth envelope: synth tracks only
+                break;
+        }
+    }
+
+    // Everything for this step shares one timestamp; equal timestamps are
+    // applied in posting order. The gain and pitch that follow the
+    // trigger override the slot defaults it applies
+    audioCommands.post(CMD_FILTER_FREQ, track, freq, sampleTime);
+    audioCommands.post(CMD_FILTER_RES, track, res, sampleTime);
+    audioCommands.post(CMD_TRIGGER, track, start, sampleTime, 0, end);
+    audioCommands.post(CMD_GAIN, track, gain, sampleTime);
+    if (locks.has(PARAM_PITCH) || stepData.pitchOffset != 0) {
+        audioCommands.post(CMD_PITCH, track, powf(2.0f, semitones / 12.0f), sampleTime);
+    }
+
+    DEBUG_PRINTF("Trigger: T%d S%d vel=%.2f @%lu\n", track, step, vel,
+                 (unsigned long)sampleTime);
+}
+
+// Synth track step: the note and its gate-off both go out now, on the
+// same timestamped path as a sample trigger
+void onSequencerNote(int track, int step, const Step& stepData, StepLocks locks,
+                     uint32_t sampleTime, uint32_t gateSamples) {
+    float vel = stepData.velocity / 127.0f;
+    float semitones = stepData.pitchOffset;
+
+    // Locks for this note go ahead of it at the same timestamp
+    const uint16_t* q = locks.values;
+    for (uint16_t m = locks.mask; m; m &= m - 1) {
+        ParamType p = (ParamType)__builtin_ctz(m);
+        float value = paramLockDecode(p, *q++);
+
+        switch (p) {
+            case PARAM_FILTER_FREQ:
+            case PARAM_FILTER_RES:
+            case PARAM_SYNTH_ATTACK:
+            case PARAM_SYNTH_DECAY:
+            case PARAM_SYNTH_SUSTAIN:
+            case PARAM_SYNTH_RELEASE:
+                audioCommands.post(CMD_SYNTH_LOCK, track, value, sampleTime, p);
+                break;
+            case PARAM_VOLUME:
+                vel *= value;
+                break;
+            case PARAM_PITCH:
+                semitones = value;
+                break;
+            default:
+                // Pan, sends, sample start/end: sample tracks only
+                break;
+        }
+    }
+
+    int note = constrain(stepData.note + (int)lroundf(semitones), 0, 127);
+    audioCommands.post(CMD_NOTE_ON, track, constrain(vel, 0.0f, 1.0f), sampleTime, note);
+    // Carries its length, so the ISR can tell which note it ends
+    audioCommands.post(CMD_NOTE_OFF, track, (float)gateSamples, sampleTime + gateSamples, note);
+
+    DEBUG_PRINTF("Note: T%d S%d note=%d vel=%.2f gate=%lu @%lu\n",
+                 track, step, note, vel, (unsigned long)gateSamples,
+                 (unsigned long)sampleTime);
+}
+
+#endif // AUDIO_DISPATCH_H
@@ -0,0 +1,120 @@
+/**
+ * Oh My Ondas - Audio Objects
+ * Every Teensy Audio Library object in the signal chain
+ *
+ * Defines the objects (not just declares them), wires them with
+ * audio_connections.h and names them for the profiler. Include exactly
+ * once per program: main.ino, or a host program that renders the same
+ * graph (native/render/).
+ */
+
+#ifndef AUDIO_OBJECTS_H
+#define AUDIO_OBJECTS_H
+
+#include <Audio.h>
+#include "config.h"
+#include "audio_clock.h"
+#include "sample_player.h"
+#include "audio_profiler.h"
+#include "smoothed_audio.h"
+#include "mod_matrix.h"
+#include "wavetable_osc.h"
+
+// Must stay first: update order follows declaration order, and the
+// sequencer has to schedule a block before the players render it
+AudioClock               audioClock;
+
+AudioInputI2S            audioInput;
+AudioAnalyzeFFT1024      fft;
+AudioAnalyzePeak         peakL, peakR;
+AudioAnalyzeEnvelope     envFollow[MOD_ENV_COUNT];  // Mod sources: input, samples
+
+AudioPlaySample          memPlayer[MAX_TRACKS];
+AudioPlaySdWav           player[MAX_TRACKS];
+AudioMixer4              srcMix[MAX_TRACKS];
+AudioFilterStateVariable filter[MAX_TRACKS];
+AudioAmpSmooth           amp[MAX_TRACKS];
+
+AudioMixer4              playerMixL;
+AudioMixer4              playerMixR;
+AudioMixer4              sampleSum;
+
+AudioSynthWavetableOsc   synthWave1[SYNTH_VOICES];
+AudioSynthWavetableOsc   synthWave2[SYNTH_VOICES];
+AudioSynthNoiseWhite     synthNoise;
+AudioMixer4Smooth        synthMixer[SYNTH_VOICES];
+AudioFilterLadder        synthFilter[SYNTH_VOICES];
+AudioEffectEnvelope      synthEnv[SYNTH_VOICES];
+AudioMixer4              synthVoiceMix[2];
+AudioMixer4              synthSum;
+
+AudioMixer4Smooth        inputMixer;
+AudioMixer4Smooth        masterMix;
+
+AudioMixer4Smooth        fxSend;
+AudioEffectFreeverb      reverb;
+AudioEffectDelay         delayL;
+AudioEffectBitcrusher    crusher;
+AudioEffectGranular      granular;
+AudioEffectChorus        chorus;
+AudioMixer4Smooth        fxReturn;
+AudioMixer4Smooth        fxReturn2;
+
+AudioMixer4Smooth        outputMixer;
+AudioOutputI2S           audioOutput;
+AudioRecordQueue         recorder;
+
+// Cutoff/resonance ramps in front of the filters, run from onAudioBlock();
+// set the filters through these
+StateVariableSmoother    filterCtl[MAX_TRACKS];
+LadderSmoother           synthFilterCtl[SYNTH_VOICES];
+
+// LFOs and envelope followers routed to FX, synth and track levels, run
+// from onAudioBlock()
+ModMatrix                modMatrix;
+
+int16_t granularBuffer[GRANULAR_BUFFER_SIZE];
+short chorusDelayLine[CHORUS_DELAY_LENGTH];
+
+#include "audio_connections.h"
+
+// Every object above, by name (keep in step when adding one)
+void addProfiledObjects(AudioProfiler& profiler) {
+    profiler.add("clock", audioClock);
+    profiler.add("input", audioInput);
+    profiler.add("fft", fft);
+    profiler.add("peakL", peakL);
+    profiler.add("peakR", peakR);
+    profiler.add("envFollow", envFollow);
+    profiler.add("memPlayer", memPlayer);
+    profiler.add("player", player);
+    profiler.add("srcMix", srcMix);
+    profiler.add("filter", filter);
+    profiler.add("amp", amp);
+    profiler.add("playerMixL", playerMixL);
+    profiler.add("playerMixR", playerMixR);
+    profiler.add("sampleSum", sampleSum);
+    profiler.add("synthWave1", synthWave1);
+    profiler.add("synthWave2", synthWave2);
+    profiler.add("synthNoise", synthNoise);
+    profiler.add("synthMixer", synthMixer);
+    profiler.add("synthFilter", synthFilter);
+    profiler.add("synthEnv", synthEnv);
+    profiler.add("synthVoiceMix", synthVoiceMix);
+    profiler.add("synthSum", synthSum);
+    profiler.add("inputMixer", inputMixer);
+    profiler.add("masterMix", masterMix);
+    profiler.add("fxSend", fxSend);
+    profiler.add("reverb", reverb);
+    profiler.add("delay", delayL);
+    profiler.add("crusher", crusher);
+    profiler.add("granular", granular);
+    profiler.add("chorus", chorus);
+    profiler.add("fxReturn", fxReturn);
+    profiler.add("fxReturn2", fxReturn2);
+    profiler.add("outputMixer", outputMixer);
+    profiler.add("output", audioOutput);
+    profiler.add("recorder", recorder);
+}
+
+#endif // AUDIO_OBJECTS_H
@@ -0,0 +1,88 @@
+/**
+ * Oh My Ondas - Audio Profiler
+ * Per-object audio CPU, block overruns and audio memory high-water mark
+ *
+ * The Audio Library already times every object's update() in the audio
+ * interrupt (processorUsage()/processorUsageMax()); this only names the
+ * objects and reads those counters from loop(). Once per
+ * PROFILER_WINDOW_MS it takes each object's worst block in the window,
+ * resets it, and ranks the heaviest PROFILER_TOP_N for LCD_SETTINGS and
+ * for a CSV row on serial.
+ *
+ * Off by default and switchable at runtime (SHIFT+MENU). When off,
+ * update() is a single branch and nothing is read, reset or printed.
+ */
+
+#ifndef AUDIO_PROFILER_H
+#define AUDIO_PROFILER_H
+
+#include <Arduino.h>
+#include <AudioStream.h>
+#include "config.h"
+
+class AudioClock;
+
+struct ProfiledObject {
+    AudioStream* object;
+    const char* name;
+    int8_t index;           // Array element, -1 for a single object
+    float windowMax;        // Worst block of the last window, % of the block period
+    float peak;             // Worst block since enabled
+};
+
+class AudioProfiler {
+public:
+    AudioProfiler();
+
+    // Overruns come from the clock; CSV rows go to out
+    void begin(AudioClock* clock, Print* out = &Serial);
+
+    // Register by name before enabling; arrays as "name0".."nameN-1"
+    void add(const char* name, AudioStream& object, int index = -1);
+    template <class T, size_t N>
+    void add(const char* name, T (&objects)[N]) {
+        for (size_t i = 0; i < N; i++) add(name, objects[i], (int)i);
+    }
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled; }
+    void setCSV(bool on) { csv = on; }
+
+    // Call from loop(): samples and ranks once per window
+    void update();
+
+    // Last window (valid while enabled)
+    int getObjectCount() const { return count; }
+    int getTopCount() const { return topCount; }
+    const ProfiledObject& getTop(int rank) const { return objects[top[rank]]; }
+    float getTotal() const { return total; }           // Whole pass, % of block
+    float getTotalPeak() const { return totalPeak; }
+    uint32_t getOverruns() const;                       // Since enabled
+    uint16_t getMemoryPeak() const { return AudioMemoryUsageMax(); }
+
+    // "player3", "reverb"
+    static void formatName(const ProfiledObject& o, char* buf, size_t size);
+
+private:
+    AudioClock* clock;
+    Print* out;
+    bool enabled;
+    bool csv;
+
+    ProfiledObject objects[PROFILER_MAX_OBJECTS];
+    int count;
+    uint8_t top[PROFILER_TOP_N];
+    int topCount;
+
+    float total;
+    float totalPeak;
+    uint32_t overrunBase;
+    unsigned long windowStart;
+
+    void sample();
+    void rank();
+    void printHeader();
+    void printRow();
+};
+
+#endif // AUDIO_PROFILER_H
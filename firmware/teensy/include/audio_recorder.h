@@ -16,7 +16,9 @@ public:
     AudioRecorder();
 
     void begin(AudioRecordQueue* queue);
-    void update();  // Call every loop iteration
+    // One slice of draining the queue to SD (RECORDER_BLOCKS_PER_SLICE
+    // blocks): false while more are waiting
+    bool update();
 
     void startRecording(const char* filename);
     void stopRecording();
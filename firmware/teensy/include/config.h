@@ -19,6 +19,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <stdint.h>
+
 // ============================================
 // SYSTEM CONSTANTS
 // ============================================
@@ -26,14 +28,33 @@
 #define VERSION "0.3.0"
 #define MAX_TRACKS 8
 #define MAX_PADS 8
-#define MAX_STEPS 16
+#define MAX_STEPS 64
+#define STEPS_PER_PAGE 16           // Step storage and LCD grid page
+#define PATTERN_STEP_PAGES (MAX_TRACKS * MAX_STEPS / STEPS_PER_PAGE)  // Shared step pages: every track at 64 steps
 #define MAX_PATTERNS 64
+#define BANK_STEP_PAGES 512         // Step pages the pattern bank shares: every pattern at 16 steps
+#define TRACK_PARAM_LOCKS 128       // Lock values shared by a track's steps (2 per step at 64)
 #define MAX_SCENES 16
 
 // Audio settings
 #define SAMPLE_RATE 44100
 #define AUDIO_MEMORY_BLOCKS 200
 #define MAX_SAMPLE_LENGTH_MS 30000  // 30 seconds per sample
+#define TRACK_FILTER_FREQ 10000.0f  // Track filter on steps without a filter lock (Hz)
+#define TRACK_FILTER_RES 0.7f
+
+// loop() → audio ISR command ring (see audio_commands.h)
+#define AUDIO_CMD_QUEUE_SIZE 256    // Power of 2
+#define AUDIO_CMD_STAGE_SIZE 192    // ISR-side time-ordered staging (ratchets and note-offs post ahead)
+
+// Decoded sample cache (see sample_cache.h)
+#define SAMPLE_CACHE_ENTRIES 32                     // Resident samples, pinned + LRU
+// PSRAM left for the other EXTMEM users: pattern bank (~260 KB), LCD
+// framebuffer (300 KB) and wavetables. Checked in sequencer.cpp
+#define SAMPLE_CACHE_PSRAM_RESERVE (576 * 1024 + WAVETABLE_PSRAM_BUDGET)
+#define SAMPLE_CACHE_RAM_BUDGET (96 * 1024)         // Heap budget when no PSRAM is fitted
+#define SAMPLE_CACHE_FILL_FRAMES 4096               // Loaded per loop() pass after a miss (<= 16 KB read)
+#define SAMPLE_INTERP_DEFAULT INTERP_HERMITE        // Resampler mode (see resampler.h)
 
 // Audio buffer sizes
 #define GRANULAR_BUFFER_SIZE 12800  // ~290ms at 44.1kHz
@@ -52,6 +73,12 @@
 
 #define LCD_WIDTH  480   // ILI9488 in landscape
 #define LCD_HEIGHT 320   // (native 320×480, rotated)
+#define LCD_MAX_WIDGETS 96   // Retained widgets on one screen (lcd_widgets.h)
+#define LCD_DIFF_RENDER 1    // 0: repaint every widget every frame, for comparing SPI bytes
+#define LCD_FRAMEBUFFER 1    // Draw into RAM and flush by SPI DMA (0: draw on the panel directly)
+#define LCD_FB_BAND_ROWS 16  // Flush granularity: dirty rectangles are tracked per band of rows
+#define LCD_FB_STAGING 4     // DMA staging buffers (15 KB each, RAM2): bands double-buffered per frame
+#define LCD_SPI_CLOCK 30000000
 
 // Secondary: SSD1306 128×64 OLED (I2C) — GPS map display
 #define OLED_WIDTH  128
@@ -66,14 +93,22 @@
 // SDA = Pin 18, SCL = Pin 19
 
 // Audio Shield (I2S) — RESERVED PINS, do NOT reuse:
-// Pin 2  = I2S RX (audio input)
 // Pin 7  = I2S TX (BCLK)
 // Pin 20 = I2S LRCLK
 // Pin 21 = I2S BCLK
 // Pin 23 = I2S TX
 
-// Touch Sensor IRQ (MPR121)
-#define TOUCH_IRQ 15
+// ADS1115 ALERT/RDY (open drain, pulses low when a conversion is ready).
+// Was reserved for the MPR121 IRQ, which is unused: touch is polled.
+#define ADS_ALERT_PIN 15
+
+// MCP23017 INTA/INTB of both expanders (open drain, mirrored and wired
+// together, low while either has an unread pin change). Not wired on the
+// documented hardware: the BOM's pin 2 is the MPR121 IRQ, and reading the
+// MCPs on that line would leave the encoders to the 100ms safety poll.
+// -1 = poll every ENCODER_POLL_MS; set the pin once the wiring and the
+// pin docs carry it.
+#define MCP_INT_PIN -1
 
 // ── Direct Encoders (5) ──────────────────────
 // Using Encoder library (interrupt-based)
@@ -102,7 +137,7 @@
 
 // ── MCP23017 Encoders (8) ────────────────────
 // 8 encoders × 2 pins = 16 pins = all of MCP#1
-// Read via I2C polling, software quadrature decode
+// Read via I2C (on pin change if MCP_INT_PIN is wired), software quadrature decode
 // Port A: CUT(0,1) RES(2,3) ATK(4,5) REL(6,7)
 // Port B: DLY(0,1) GLT(2,3) GRN(4,5) CRU(6,7)
 #define NUM_MCP_ENCODERS 8
@@ -189,6 +224,7 @@ enum JoystickDir {
 // Crossfader on Teensy ADC pin 39 (A15)
 #define CROSSFADER_PIN 39
 #define NUM_FADERS 4     // via ADS1115
+#define ADS_FADER_FULL_SCALE 26400  // Counts at the fader top: 3.3V on the ±4.096V range
 #define TOTAL_FADERS 5   // + crossfader
 
 enum FaderID {
@@ -228,12 +264,17 @@ enum FaderID {
 // SD card: uses SDIO (dedicated 4-bit bus on Teensy 4.1), NOT SPI0 — no LCD contention
 // I2S: dedicated audio peripheral (pins 7,20,21,23) — no bus sharing
 //
-// I2C bus (400kHz, Wire.setTimeout 1ms):
+// I2C bus (400kHz): Wire at boot, then the interrupt-driven queue in
+// i2c_bus.h, which all of these share — nothing waits on the bus:
 //   0x20 MCP23017A — 8 encoders,  polled every 2ms
 //   0x21 MCP23017B — 14 buttons,  polled every 10ms
-//   0x48 ADS1115   — 4 faders,    polled every 20ms
-//   0x5A MPR121    — 8 touch pads, polled every loop (~1ms)
-//   0x3C SSD1306   — OLED map,    updated every 200ms
+//   0x48 ADS1115   — 4 faders,    read on each ALERT/RDY (~1.4ms)
+//   0x5A MPR121    — 8 touch pads, polled every 1ms
+//   0x3C SSD1306   — OLED map,    one page per slice every 200ms
+#define I2C_QUEUE_SIZE  16      // Transfers in flight (power of 2)
+#define I2C_MAX_WRITE   33      // Bytes written per transfer (OLED: control + 32)
+#define I2C_MAX_READ    8       // Bytes read per transfer
+#define I2C_TIMEOUT_US  2000    // A transfer stuck longer is abandoned
 
 // ============================================
 // AUDIO ROUTING
@@ -266,8 +307,22 @@ enum FXType {
 // SEQUENCER
 // ============================================
 
+#define SEQ_EVENT_QUEUE_SIZE 64   // Audio-clock triggers awaiting loop() (power of 2)
+#define SEQ_LOOKAHEAD_BLOCKS 4    // Steps are stamped this many blocks ahead (~11.6ms)
+                                  // so loop() can post them before they are due
+#define SEQ_STEPS_PER_BAR 16      // Quantization grid for SWITCH_NEXT_BAR
+#define SEQ_TICKS_PER_STEP 12     // Clock ticks per 1x step (covers 1/8x..2x, 3/4x, 3/2x)
+#define MICRO_TIMING_PER_STEP 24  // Micro-timing units per step (1/384 of a 16-step bar)
+#define MICRO_TIMING_MAX 12       // ±half a step
+#define MAX_RATCHETS 7            // Extra hits per step
+#define GATE_PER_STEP 16          // Synth note length units per step (or ratchet hit)
+#define GATE_MAX (4 * GATE_PER_STEP)    // Longest note: 4 steps, bounds the note-offs staged ahead
+#define SEQ_DEFAULT_NOTE 60       // Synth step note until set (middle C)
+#define PATTERN_DEFAULT_SEED 0x4F4E4441UL   // Probability seed of a cleared pattern
+#define PATTERN_WRITEBACK_DELAY_MS 2000  // Quiet time after an edit before it goes to SD
+
 // Trig condition types (Octatrack-style)
-enum TrigCondition {
+enum TrigCondition : uint8_t {
     TRIG_ALWAYS = 0,
     TRIG_FILL,
     TRIG_NOT_FILL,
@@ -280,9 +335,33 @@ enum TrigCondition {
     TRIG_2ND,
     TRIG_3RD,
     TRIG_4TH,
+    TRIG_PROB,          // Chance from Step::probability
     TRIG_COUNT
 };
 
+// ============================================
+// SYNTH
+// ============================================
+
+#define SYNTH_VOICES 8            // Voice chains in the graph (poly_synth.h), 4..8
+#define SYNTH_CPU_CEILING 80.0f   // % of the block period the audio pass may use with the synth
+#define SYNTH_CPU_HEADROOM 5.0f   // % left over before the voice limit rises again
+#define SYNTH_VOICE_COST 2.0f     // % per voice assumed until one has been measured
+#define SYNTH_STEAL_MS 5.0f       // Release of a stolen or shed voice
+
+// User wavetables (see wavetable_bank.h): /wavetables/wtNN.wav, 2048-sample cycles
+#define WAVETABLE_SLOTS 4
+#define WAVETABLE_MAX_FRAMES 64
+#define WAVETABLE_PSRAM_BUDGET (1024 * 1024)        // All slots together, ~10.5 KB per frame
+
+// ============================================
+// AUDIO PROFILER
+// ============================================
+
+#define PROFILER_MAX_OBJECTS 128  // Named AudioStream objects it can track
+#define PROFILER_TOP_N 8          // Heaviest objects on LCD_SETTINGS and in the CSV
+#define PROFILER_WINDOW_MS 1000   // processorUsageMax() is sampled and reset this often
+
 // ============================================
 // SYSTEM MODES
 // ============================================
@@ -303,8 +382,29 @@ enum SystemMode {
 #define DEBOUNCE_MS 50
 #define LONG_PRESS_MS 500
 #define DOUBLE_TAP_MS 300
-#define FADER_THRESHOLD 0.01f   // Change threshold for fader events
-#define ENCODER_POLL_MS 2       // MCP encoder polling interval
+#define FADER_SMOOTHING 0.5f    // One-pole coefficient per fader reading (fader_filter.h)
+#define FADER_HYSTERESIS 0.004f // Fader events only once a fader leaves this band
+#define CROSSFADER_POLL_MS 5    // Teensy ADC crossfader polling interval
+#define ENCODER_POLL_MS 2       // Direct encoders; MCP encoders if MCP_INT_PIN is -1
+#define MCP_SAFETY_POLL_MS 100  // MCP reads without an interrupt (missed edge, lost read)
+#define ENC_ACCEL_MIN_RATE 8.0f // MCP encoder detents/s where acceleration starts...
+#define ENC_ACCEL_MAX_RATE 40.0f // ...and reaches ENC_ACCEL_MAX steps per detent
+#define ENC_ACCEL_MAX 8
+#define ENC_ACCEL_IDLE_MS 150   // A pause this long (or a reversal) starts again at 1
+#define TOUCH_POLL_MS 1         // MPR121 polling interval
+#define MAX_TASKS 16            // Main-loop tasks (task_scheduler.h)
+#define LCD_CLEAR_BANDS 4       // A full-screen clear takes this many slices
+#define RECORDER_BLOCKS_PER_SLICE 4   // Audio blocks written to SD per slice
+#define GAIN_SLEW_MS 10.0f      // Mixer/amp gain ramp (smoothed_audio.h)
+#define FILTER_SLEW_MS 10.0f    // Filter cutoff/resonance ramp, in whole audio blocks
+#define MOD_LFO_COUNT 4         // Modulation matrix LFOs (mod_matrix.h)
+#define MOD_ENV_COUNT 2         // Envelope followers: input, samples
+#define MOD_MAX_ROUTES 16       // Source -> destination routes
+#define MOD_FX_RANGE 0.5f       // FX param/mix offset at depth 1
+#define MOD_CUTOFF_OCTAVES 4.0f // Synth cutoff offset at depth 1
+#define MOD_PITCH_SEMITONES 12.0f // Synth pitch offset at depth 1
+#define MOD_ENV_ATTACK_MS 5.0f  // Envelope follower rise...
+#define MOD_ENV_RELEASE_MS 150.0f // ...and fall
 
 // ============================================
 // FILE PATHS
@@ -315,6 +415,17 @@ enum SystemMode {
 #define RECORDINGS_DIR "/recordings/"
 #define PRESETS_DIR "/presets/"
 
+// ============================================
+// BUILD
+// ============================================
+
+// JSON import (patterns, scenes, FX presets) needs ArduinoJson. Always
+// there on the Teensy; optional in the host build (native/), which then
+// reads and writes the binary formats only.
+#if __has_include(<ArduinoJson.h>)
+#define HAVE_ARDUINOJSON 1
+#endif
+
 // ============================================
 // DEBUG
 // ============================================
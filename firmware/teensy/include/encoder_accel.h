@@ -0,0 +1,56 @@
+/**
+ * Oh My Ondas - Encoder Acceleration
+ * Velocity-based step size for one encoder
+ *
+ * Each detent updates a smoothed turning rate (detents/s). Below
+ * ENC_ACCEL_MIN_RATE a detent is one step, so slow turns stay exact;
+ * from there the step grows linearly up to ENC_ACCEL_MAX at
+ * ENC_ACCEL_MAX_RATE. A reversal or a pause of ENC_ACCEL_IDLE_MS starts
+ * again at one step, so the fine adjustment after a fast sweep is never
+ * accelerated.
+ *
+ * Header-only and free of Arduino includes so it also builds on the host
+ * (see test/native/test_encoder_accel.cpp).
+ */
+
+#ifndef ENCODER_ACCEL_H
+#define ENCODER_ACCEL_H
+
+#include <stdint.h>
+#include "config.h"
+
+class EncoderAccel {
+public:
+    EncoderAccel() : lastMs(0), rate(0.0f), lastDir(0) {}
+
+    // One detent in direction dir (+1/-1) at nowMs; returns the steps to report
+    int detent(int dir, uint32_t nowMs) {
+        uint32_t dt = nowMs - lastMs;
+        lastMs = nowMs;
+        if (dir != lastDir || dt >= ENC_ACCEL_IDLE_MS) {
+            lastDir = dir;
+            rate = 0.0f;
+            return dir;
+        }
+        float instant = 1000.0f / (dt > 0 ? dt : 1);
+        rate += 0.5f * (instant - rate);
+        return dir * steps(rate);
+    }
+
+    float getRate() const { return rate; }
+
+    // Steps per detent at a turning rate of detents/s
+    static int steps(float detentsPerSec) {
+        if (detentsPerSec <= ENC_ACCEL_MIN_RATE) return 1;
+        if (detentsPerSec >= ENC_ACCEL_MAX_RATE) return ENC_ACCEL_MAX;
+        float t = (detentsPerSec - ENC_ACCEL_MIN_RATE) / (ENC_ACCEL_MAX_RATE - ENC_ACCEL_MIN_RATE);
+        return 1 + (int)(t * (ENC_ACCEL_MAX - 1) + 0.5f);
+    }
+
+private:
+    uint32_t lastMs;
+    float rate;
+    int8_t lastDir;
+};
+
+#endif // ENCODER_ACCEL_H
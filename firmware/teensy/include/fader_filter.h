@@ -0,0 +1,79 @@
+/**
+ * Oh My Ondas - Fader Filter
+ * Median-of-3, one-pole smoothing and hysteresis for one fader
+ *
+ * The median throws out single-reading spikes (wiper bounce), the
+ * one-pole (FADER_SMOOTHING per reading) takes out the remaining noise,
+ * and the hysteresis band (FADER_HYSTERESIS) keeps a fader at rest from
+ * reporting at all: the reported value only moves once the smoothed one
+ * has left the band around it. Within one band of either end the value
+ * snaps to exactly 0 or 1, so a fader pulled all the way down is off.
+ *
+ * Header-only and free of Arduino includes so it also builds on the host
+ * (see test/native/test_fader_filter.cpp).
+ */
+
+#ifndef FADER_FILTER_H
+#define FADER_FILTER_H
+
+#include <stdint.h>
+#include <math.h>
+#include "config.h"
+
+class FaderFilter {
+public:
+    FaderFilter() { reset(0.0f); }
+
+    // Reported value before the first reading; that reading is taken as is
+    void reset(float v) {
+        history[0] = history[1] = history[2] = v;
+        next = 0;
+        primed = false;
+        smooth = v;
+        reported = v;
+    }
+
+    // One new reading (0..1); true if the reported value changed
+    bool update(float raw) {
+        if (!primed) {
+            history[0] = history[1] = history[2] = raw;
+            smooth = raw;
+            primed = true;
+        } else {
+            history[next] = raw;
+            next = next == 2 ? 0 : next + 1;
+            smooth += FADER_SMOOTHING * (median() - smooth);
+        }
+
+        float v = snap(smooth);
+        bool end = v == 0.0f || v == 1.0f;
+        if (end ? v == reported : fabsf(v - reported) <= FADER_HYSTERESIS) return false;
+        reported = v;
+        return true;
+    }
+
+    float value() const { return reported; }
+    float smoothed() const { return smooth; }
+
+private:
+    float history[3];
+    uint8_t next;
+    bool primed;
+    float smooth;
+    float reported;
+
+    float median() const {
+        float a = history[0], b = history[1], c = history[2];
+        if (a > b) { float t = a; a = b; b = t; }
+        if (b > c) b = c;
+        return a > b ? a : b;
+    }
+
+    static float snap(float v) {
+        if (v < FADER_HYSTERESIS) return 0.0f;
+        if (v > 1.0f - FADER_HYSTERESIS) return 1.0f;
+        return v;
+    }
+};
+
+#endif // FADER_FILTER_H
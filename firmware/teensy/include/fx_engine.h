@@ -9,6 +9,9 @@
 #include <Arduino.h>
 #include <Audio.h>
 #include "config.h"
+#include "smoothed_audio.h"
+#include "mod_matrix.h"
+#include "lfo_tables.h"
 
 struct FXParams {
     float param1;  // Primary parameter
@@ -27,10 +30,11 @@ public:
                AudioEffectBitcrusher* crusher,
                AudioEffectGranular* granular,
                AudioEffectChorus* chorus,
-               AudioFilterStateVariable* trackFilters,
-               AudioMixer4* fxReturn,
-               AudioMixer4* fxReturn2,
-               AudioMixer4* fxSend);
+               StateVariableSmoother* trackFilters,
+               AudioMixer4Smooth* fxReturn,
+               AudioMixer4Smooth* fxReturn2,
+               AudioMixer4Smooth* fxSend,
+               const ModMatrix* modMatrix);
     void update();
 
     // Effect selection
@@ -38,7 +42,8 @@ public:
     FXType getCurrentEffect();
     const char* getEffectName(FXType type);
 
-    // Parameter control
+    // Parameter control (base values; the mod matrix offsets them when
+    // they are applied, MOD_DST_FX_PARAM1..3 and MOD_DST_FX_MIX)
     void adjustParam(int paramIndex, float delta);
     void setParam(int paramIndex, float value);
     float getParam(int paramIndex);
@@ -47,6 +52,8 @@ public:
     void setMix(float mix);
     float getMix();
 
+    const ModMatrix* getModMatrix() { return modMatrix; }
+
     // Enable/bypass
     void enable();
     void disable();
@@ -62,12 +69,6 @@ public:
     void loadPreset(int presetNumber);
     void savePreset(int presetNumber);
 
-    // LFO modulation
-    void setLFORate(float hz);
-    void setLFODepth(float depth);
-    void setLFOTarget(int paramIndex);
-    float getLFOValue();
-
 private:
     FXType currentEffect;
     FXParams currentParams;
@@ -80,20 +81,17 @@ private:
     AudioEffectBitcrusher* crusherFX;
     AudioEffectGranular* granularFX;
     AudioEffectChorus* chorusFX;
-    AudioFilterStateVariable* filters;
-    AudioMixer4* fxReturnMix;
-    AudioMixer4* fxReturn2Mix;
-    AudioMixer4* fxSendMix;
-
-    // LFO state
-    float lfoRate;
-    float lfoDepth;
-    int lfoTarget;
-    float lfoPhase;
-    unsigned long lastLFOUpdate;
+    StateVariableSmoother* filters;
+    AudioMixer4Smooth* fxReturnMix;
+    AudioMixer4Smooth* fxReturn2Mix;
+    AudioMixer4Smooth* fxSendMix;
+    const ModMatrix* modMatrix;
+
+    // Tape wow, stepped per ms
+    LfoPhase wow;
+    unsigned long lastWowUpdate;
 
     void initializeDefaults();
-    void updateLFO();
     void applyEffect();
     void muteAllReturns();
 };
@@ -0,0 +1,53 @@
+/**
+ * Oh My Ondas - I2C Bus
+ * Interrupt-driven LPI2C1 master working through an I2cQueue
+ *
+ * Wire sets the bus up at boot (pins, 400 kHz timing) and the drivers
+ * probe and configure their chips with it. begin() then takes LPI2C1
+ * over: from there on every transfer goes through the queue, and the
+ * LPI2C interrupt feeds the 4-word command FIFO, drains the receive
+ * FIFO and moves on to the next transfer at each STOP. Nothing on the
+ * main loop waits for the bus; do not call Wire after begin().
+ *
+ * service() runs from the main loop: it dispatches completion callbacks
+ * and abandons a transfer stuck for longer than I2C_TIMEOUT_US.
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "i2c_queue.h"
+
+class I2cBus {
+public:
+    I2cBus();
+
+    void begin();
+    void service();
+
+    // As I2cQueue, then wakes the interrupt if the bus is idle
+    bool submit(uint8_t addr, const uint8_t* tx, uint8_t txLen, uint8_t rxLen,
+                I2cCallback cb = nullptr, void* ctx = nullptr);
+    bool writeReg(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len,
+                  I2cCallback cb = nullptr, void* ctx = nullptr);
+    bool readReg(uint8_t addr, uint8_t reg, uint8_t len,
+                 I2cCallback cb, void* ctx = nullptr);
+
+    int space() const { return queue.space(); }
+    bool isReady() const { return ready; }
+    const I2cQueue& getQueue() const { return queue; }
+    uint32_t getTimeouts() const { return timeouts; }
+
+private:
+    I2cQueue queue;
+    bool ready;
+    uint32_t timeouts;
+
+    static void isr();
+    void handleInterrupt();
+    void kick();
+};
+
+#endif // I2C_BUS_H
@@ -0,0 +1,133 @@
+/**
+ * Oh My Ondas - I2C Transfer Queue
+ * Fixed ring of I2C transfers shared by everything on the bus
+ *
+ * loop() submits transfers (a register write, or a register read with a
+ * repeated start) and carries on. The bus interrupt takes them in order,
+ * turns each into LPI2C command words with nextCommand(), stores what
+ * it reads with received() and closes it with finish(). Back in loop(),
+ * dispatch() hands finished transfers to their callbacks, in submission
+ * order, so callbacks never run in interrupt context and may submit the
+ * next transfer themselves.
+ *
+ * One ring, three indices: loop() writes `head` (submit) and `tail`
+ * (dispatch), the interrupt writes `active` (finish). As in SPSCQueue,
+ * acquire/release ordering makes a slot visible before the index that
+ * hands it over, so neither side masks interrupts.
+ *
+ * Hardware-free so it builds on the host (test/native/test_i2c_queue.cpp);
+ * the LPI2C driver is I2cBus (i2c_bus.h).
+ */
+
+#ifndef I2C_QUEUE_H
+#define I2C_QUEUE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "config.h"
+
+enum I2cStatus : uint8_t {
+    I2C_PENDING = 0,
+    I2C_OK,
+    I2C_NACK,           // No device at the address, or a byte refused
+    I2C_BUS_ERROR,      // Arbitration lost, FIFO error or pin stuck low
+    I2C_TIMEOUT         // Abandoned after I2C_TIMEOUT_US
+};
+
+struct I2cTransfer;
+typedef void (*I2cCallback)(const I2cTransfer& t, void* ctx);
+
+struct I2cTransfer {
+    uint8_t addr;                   // 7-bit
+    uint8_t txLen;
+    uint8_t rxLen;
+    uint8_t status;                 // I2cStatus
+    uint8_t tx[I2C_MAX_WRITE];
+    uint8_t rx[I2C_MAX_READ];
+    I2cCallback cb;
+    void* ctx;
+    uint32_t startedAt;             // micros() when the bus took it
+    uint32_t finishedAt;
+
+    bool ok() const { return status == I2C_OK; }
+    // Two bytes read, low byte first (MCP23017 GPIOA/B, MPR121)
+    uint16_t rx16le() const { return rx[0] | (uint16_t)rx[1] << 8; }
+    // Two bytes read, high byte first (ADS1115)
+    uint16_t rx16be() const { return (uint16_t)rx[0] << 8 | rx[1]; }
+};
+
+class I2cQueue {
+    static_assert(I2C_QUEUE_SIZE >= 2 && (I2C_QUEUE_SIZE & (I2C_QUEUE_SIZE - 1)) == 0,
+                  "I2C_QUEUE_SIZE must be a power of 2");
+
+public:
+    // LPI2C MTDR command words (CMD in bits 8-10, DATA in 0-7)
+    static const uint16_t CMD_TRANSMIT = 0x000;
+    static const uint16_t CMD_RECEIVE  = 0x100;    // DATA + 1 bytes
+    static const uint16_t CMD_STOP     = 0x200;
+    static const uint16_t CMD_START    = 0x400;    // DATA = address << 1 | R/W
+
+    I2cQueue();
+
+    // ── loop() side ──
+
+    // false if the queue is full or the lengths do not fit; nothing is sent
+    bool submit(uint8_t addr, const uint8_t* tx, uint8_t txLen, uint8_t rxLen,
+                I2cCallback cb = nullptr, void* ctx = nullptr);
+    bool writeReg(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len,
+                  I2cCallback cb = nullptr, void* ctx = nullptr);
+    bool readReg(uint8_t addr, uint8_t reg, uint8_t len,
+                 I2cCallback cb, void* ctx = nullptr);
+
+    // Runs the callbacks of finished transfers and frees their slots
+    int dispatch();
+
+    int space() const;
+    int pending() const;        // Submitted, not yet finished
+
+    // ── Interrupt side ──
+
+    // Oldest unfinished transfer, marked started at `now`; nullptr if none
+    I2cTransfer* start(uint32_t now);
+    I2cTransfer* current();
+    bool isStarted() const { return started; }
+    // Next command word for the current transfer; false once STOP is out
+    bool nextCommand(uint16_t& word);
+    bool commandsDone() const;
+    void received(uint8_t b);
+    bool readDone() const;
+    void finish(uint8_t status, uint32_t now);
+
+    // ── Statistics (loop side) ──
+
+    uint32_t getCompleted() const { return completed; }
+    uint32_t getFailed() const { return failed; }
+    uint32_t getDropped() const { return dropped; }     // Submits refused: full
+    int getPeakDepth() const { return peakDepth; }
+    // Sum of start-to-finish time of all transfers; written by the interrupt
+    uint32_t getBusyMicros() const { return busyMicros; }
+
+private:
+    I2cTransfer slots[I2C_QUEUE_SIZE];
+    std::atomic<uint16_t> head;         // loop(): next free slot
+    std::atomic<uint16_t> active;       // Interrupt: oldest unfinished
+    std::atomic<uint16_t> tail;         // loop(): oldest undispatched
+
+    // Current transfer's progress (interrupt side)
+    bool started;
+    uint8_t cmdIndex;
+    uint8_t rxCount;
+
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t dropped;
+    int peakDepth;
+    volatile uint32_t busyMicros;
+
+    I2cTransfer& slot(uint16_t i) { return slots[i & (I2C_QUEUE_SIZE - 1)]; }
+    int commandCount(const I2cTransfer& t) const;
+    uint16_t command(const I2cTransfer& t, int i) const;
+};
+
+#endif // I2C_QUEUE_H
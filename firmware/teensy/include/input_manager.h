@@ -2,11 +2,31 @@
  * Oh My Ondas - Input Manager
  * Unified handling for all physical controls:
  *   5 direct encoders (interrupt-based via Encoder library)
- *   8 MCP23017 encoders (polled via I2C, software quadrature)
+ *   8 MCP23017 encoders (read via I2C on change, software quadrature,
+ *     velocity acceleration)
  *   4 direct buttons + 14 MCP23017 buttons (debounced)
  *   5-way joystick (4 GPIO + 1 MCP pin)
  *   4 ADS1115 faders + 1 Teensy ADC crossfader
  *   8 MPR121 touch pads
+ *
+ * The chips are probed and configured with Wire in begin(). After that
+ * every I2C read is queued on the shared I2cBus and handled in its
+ * completion callback, so update() never waits for the bus.
+ *
+ * With MCP_INT_PIN wired, both MCP23017s interrupt on any pin change on
+ * that one shared line, and update() reads them only while it is low,
+ * plus a slow safety poll. At -1 (the default, not on the documented
+ * hardware) they are polled every ENCODER_POLL_MS. The encoder read
+ * takes the pins captured at the interrupt as well as the current ones,
+ * so two transitions between reads still decode. MCP encoder deltas are
+ * scaled by EncoderAccel.
+ *
+ * The ADS1115 converts continuously, one channel after the other. Its
+ * ALERT/RDY pin interrupts at each result; update() then queues the read
+ * and the switch to the next channel, so a fader is read every ~5.6ms
+ * with no waiting. Every fader (and the crossfader) goes through a
+ * FaderFilter, and its callback fires only when the filtered value
+ * leaves the hysteresis band.
  */
 
 #ifndef INPUT_MANAGER_H
@@ -17,6 +37,9 @@
 #include <Encoder.h>
 #include <Adafruit_MPR121.h>
 #include "config.h"
+#include "i2c_bus.h"
+#include "fader_filter.h"
+#include "encoder_accel.h"
 
 // Callbacks
 typedef void (*EncoderCallback)(int encoderID, int delta);
@@ -29,7 +52,7 @@ class InputManager {
 public:
     InputManager();
 
-    void begin();
+    void begin(I2cBus* bus);
     void update();   // Call from loop, handles polling intervals internally
 
     // Register callbacks
@@ -45,6 +68,15 @@ public:
     uint8_t getJoystickState();
     uint32_t getI2CErrorCount() const { return i2cErrorCount; }
 
+    // Fader events, and the time from the reading's conversion to the
+    // return of the fader callback (the mixer applies it at the next
+    // audio block, up to 2.9ms later)
+    uint32_t getFaderReports() const { return faderReports; }
+    uint32_t getFaderLatencyAvgMicros() const {
+        return faderReports ? (uint32_t)(faderLatencySum / faderReports) : 0;
+    }
+    uint32_t getFaderLatencyPeakMicros() const { return faderLatencyPeak; }
+
 private:
     // Callbacks
     EncoderCallback  encoderCB;
@@ -60,6 +92,7 @@ private:
     // ── MCP23017 Encoders ──
     uint8_t  mcpEncLastState[NUM_MCP_ENCODERS];  // 2-bit grey code per encoder
     int8_t   mcpEncAccum[NUM_MCP_ENCODERS];       // accumulator for detent
+    EncoderAccel mcpEncAccel[NUM_MCP_ENCODERS];
 
     // ── Buttons ──
     bool     buttonStates[BTN_COUNT];
@@ -68,7 +101,10 @@ private:
 
     // ── Faders ──
     float    faderValues[FADER_COUNT];
-    float    faderLastValues[FADER_COUNT];
+    FaderFilter faderFilters[FADER_COUNT];
+    uint32_t faderReports;
+    uint64_t faderLatencySum;
+    uint32_t faderLatencyPeak;
 
     // ── Joystick ──
     uint8_t  joystickState;
@@ -82,10 +118,22 @@ private:
     // ── MCP23017 state ──
     bool     mcpAReady;   // encoder expander
     bool     mcpBReady;   // button expander
+    bool     mcpBRecheck;        // A button change waits out its debounce...
+    unsigned long mcpBRecheckAt; // ...read the expander again then
 
     // ── ADS1115 state ──
     bool     adsReady;
     uint8_t  adsCurrentChannel;
+    uint8_t  adsPhase;           // AdsPhase
+    uint32_t adsMuxAt;           // micros() when the channel switch finished
+    uint32_t adsSeenAlerts;      // ALERT/RDY pulses already acted on
+    uint32_t adsSampleAt;        // micros() of the conversion being read
+
+    // ── Queued I2C ──
+    I2cBus*  bus;
+    bool     mcpAPending;        // A read is queued, do not queue another
+    bool     mcpBPending;
+    bool     touchPending;
 
     // ── I2C error handling ──
     uint32_t i2cErrorCount;
@@ -97,6 +145,8 @@ private:
     unsigned long lastEncoderPoll;
     unsigned long lastButtonPoll;
     unsigned long lastFaderPoll;
+    unsigned long lastTouchPoll;
+    unsigned long lastMcpPoll;     // MCP safety poll
 
     // ── Internal methods ──
     void initDirectEncoders();
@@ -107,17 +157,36 @@ private:
     void initTouch();
 
     void pollDirectEncoders();
-    void pollMCPEncoders();
     void pollDirectButtons();
-    void pollMCPButtons();
-    void pollFaders();
+    void pollADS();
+    void pollCrossfader();
     void pollJoystick();
-    void pollTouch();
 
-    // I2C helpers (return false on bus error, increment i2cErrorCount)
+    // Queue the reads; the results arrive in the handlers below
+    void requestMCPEncoders();
+    void requestMCPButtons();
+    void requestTouch();
+    void adsSelectChannel();
+    void adsRequestResult();
+
+    void handleMCPEncoders(uint16_t pins);
+    void stepMCPEncoder(int i, uint8_t newState);
+    void handleMCPButtons(uint16_t pins);
+    void handleTouch(uint16_t current);
+    void reportFader(int id, float value, uint32_t sampledAt);
+
+    static void onMCPEncoders(const I2cTransfer& t, void* ctx);
+    static void onMCPButtons(const I2cTransfer& t, void* ctx);
+    static void onTouch(const I2cTransfer& t, void* ctx);
+    static void onADSConfig(const I2cTransfer& t, void* ctx);
+    static void onADSResult(const I2cTransfer& t, void* ctx);
+    static void onADSAlert();
+
+    // Blocking Wire helpers for begin() (return false on bus error,
+    // increment i2cErrorCount)
     bool mcpRead16(uint8_t addr, uint8_t reg, uint16_t& outVal);
     bool mcpWrite8(uint8_t addr, uint8_t reg, uint8_t value);
-    bool adsReadChannel(uint8_t channel, int16_t& outVal);
+    bool adsWrite16(uint8_t reg, uint16_t value);
 
     // Quadrature decode helper
     int8_t   decodeQuadrature(uint8_t oldState, uint8_t newState);
@@ -5,6 +5,19 @@
  * Uses ILI9341_t3 library (Teensy-optimized, works with ILI9488 in 16-bit mode)
  * Screens: MAIN, PATTERN, FX, SYNTH, SCENE, MIXER, SETTINGS, MESSAGE
  *
+ * A frame is drawn in slices so the main loop can poll input between
+ * them: update() draws one (a band of a full clear, the header, or the
+ * screen body) and returns true once the frame is complete.
+ *
+ * Screens are built from retained widgets (lcd_widgets.h): a frame only
+ * repaints what changed since the last one, and every SPI primitive is
+ * metered, so getSpiMeter() reports the bytes each frame cost.
+ *
+ * With LCD_FRAMEBUFFER (and the memory for it), widgets are drawn into a
+ * RAM framebuffer (lcd_framebuffer.h) instead, and flush(), called every
+ * main-loop pass, sends the changed bands to the panel by SPI DMA in the
+ * background. update() then costs only the render into RAM.
+ *
  * NOTE: ILI9341_t3.h is only included in lcd_display.cpp to avoid
  * Adafruit_GFX_Button class redefinition conflict with Adafruit_SSD1306.
  */
@@ -15,15 +28,18 @@
 #include <Arduino.h>
 #include "config.h"
 #include "system_state.h"
+#include "lcd_widgets.h"
+#include "lcd_framebuffer.h"
 
 // Forward declarations — avoids header conflict
 class ILI9341_t3;
 class Sequencer;
 class FXEngine;
 class SamplingEngine;
-class SynthVoice;
+class PolySynth;
 class SceneManager;
 class InputManager;
+class AudioProfiler;
 
 // Color palette (RGB565)
 #define COL_BG        0x0000  // Black
@@ -57,9 +73,10 @@ public:
     ~LCDDisplay();
 
     void begin();
-    void update(SystemState& state, Sequencer& seq, FXEngine& fx,
-                SamplingEngine& sampler, SynthVoice& synth,
-                SceneManager& scenes, InputManager& input);
+    bool update(SystemState& state, Sequencer& seq, FXEngine& fx,
+                SamplingEngine& sampler, PolySynth& synth,
+                SceneManager& scenes, InputManager& input,
+                AudioProfiler& profiler);
 
     void setScreen(LCDScreen screen);
     LCDScreen getScreen();
@@ -68,40 +85,67 @@ public:
     void showError(const char* msg);
     void invalidate();
 
+    // One step of the framebuffer's DMA flush; never blocks
+    bool flush();
+    bool usesFrameBuffer() const { return fb != nullptr; }
+
+    const LcdSpiMeter& getSpiMeter() const { return meter; }
+
 private:
     ILI9341_t3* tft;
+    LcdFrameBuffer* fb;     // nullptr: drawing goes straight to the panel
+    bool dmaBand;           // The staging buffer at fb->front() is being sent
     LCDScreen currentScreen;
     LCDScreen lastScreen;
     bool needsFullRedraw;
 
+    enum DrawPhase : uint8_t { DRAW_BEGIN, DRAW_CLEAR, DRAW_HEADER, DRAW_BODY };
+    DrawPhase drawPhase;
+    uint8_t clearBand;
+
     char msgBuffer[64];
     unsigned long msgStart;
     int msgDuration;
     bool msgActive;
 
-    float lastBPM;
-    float lastVolume;
-    int   lastStep;
-    int   lastMode;
-    bool  lastPlaying;
-    bool  lastRecording;
+    LcdWidgets widgets;
+    LcdSpiMeter meter;
 
     void drawHeader(SystemState& state);
     void drawMainScreen(SystemState& state, Sequencer& seq,
                         SamplingEngine& sampler, FXEngine& fx);
     void drawPatternScreen(SystemState& state, Sequencer& seq);
     void drawFXScreen(SystemState& state, FXEngine& fx);
-    void drawSynthScreen(SystemState& state, SynthVoice& synth);
+    void drawSynthScreen(SystemState& state, PolySynth& synth);
     void drawSceneScreen(SystemState& state, SceneManager& scenes);
     void drawMixerScreen(SystemState& state, SamplingEngine& sampler,
                          InputManager& input);
-    void drawSettingsScreen(SystemState& state);
+    void drawSettingsScreen(SystemState& state, SamplingEngine& sampler,
+                            AudioProfiler& profiler);
+    void drawProfilePanel(int x, int y, AudioProfiler& profiler);
     void drawMessageOverlay();
 
-    void drawBar(int x, int y, int w, int h, float value, uint16_t fg, uint16_t bg);
-    void drawStepGrid(int x, int y, Sequencer& seq, int track);
-    void drawKnob(int cx, int cy, int r, float value, const char* label);
-    void drawFader(int x, int y, int w, int h, float value, const char* label);
+    void drawBar(int id, int x, int y, int w, int h, float value, uint16_t fg, uint16_t bg);
+    void drawStepGrid(int id, int x, int y, Sequencer& seq, int track, bool visible);
+    void drawKnob(int id, int cx, int cy, int r, float value, const char* label);
+    void drawFader(int id, int x, int y, int w, int h, float value, const char* label);
+    void drawBox(int id, int x, int y, int w, int h, bool filled, uint16_t color,
+                 int tx, int ty, uint8_t size, uint16_t textColor, const char* text);
+
+    // Text widget: repainted only when the text or colours change, and
+    // padded with spaces over the end of a longer previous string
+    void label(int id, int x, int y, uint8_t size, uint16_t fg, uint16_t bg,
+               const char* fmt, ...);
+    void hide(int id);
+    void flushClears();
+
+    // Metered primitives: all drawing goes through these
+    void fill(int x, int y, int w, int h, uint16_t color);
+    void outline(int x, int y, int w, int h, uint16_t color);
+    void text(int x, int y, uint8_t size, uint16_t fg, uint16_t bg, const char* s);
+    void circle(int cx, int cy, int r, uint16_t color);
+    void disc(int cx, int cy, int r, uint16_t color);
+    void triangle(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color);
 
     const char* getModeString(int mode);
     const char* getScreenName(LCDScreen screen);
@@ -0,0 +1,94 @@
+/**
+ * Oh My Ondas - LCD Framebuffer
+ * RAM copy of the LCD, flushed to the panel in bands by SPI DMA
+ *
+ * With LCD_FRAMEBUFFER, LCDDisplay draws into this buffer (PSRAM if
+ * fitted, otherwise RAM2) instead of onto the panel, so the display task
+ * costs only the time to render into memory. Every primitive marks the
+ * LCD_FB_BAND_ROWS-high bands it touches dirty, with the rectangle
+ * touched in each.
+ *
+ * When a frame is complete, publish() queues its dirty rectangles and
+ * copies as many as there are free staging buffers (LCD_FB_STAGING, in
+ * RAM2). The DMA sends from those copies, never from the framebuffer, so
+ * the next frame can be drawn while they go out. Frames that only touch
+ * a few bands (a playhead, a fader) are double-buffered like this in
+ * full. A frame touching more bands than that (a screen change) streams:
+ * each band is copied as a buffer frees up, and isFlushing() tells the
+ * display to hold off drawing until the last one is copied, so no band
+ * leaves with half of the next frame in it.
+ *
+ * Hardware-free: the SPI DMA that sends front() lives in LCDDisplay.
+ * Pixels are RGB565 stored high byte first, as the panel takes them.
+ */
+
+#ifndef LCD_FRAMEBUFFER_H
+#define LCD_FRAMEBUFFER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "lcd_widgets.h"
+
+struct LcdBand {
+    LcdRect rect;           // Window on the panel
+    uint16_t* pixels;       // rect.w × rect.h, contiguous, ready for DMA
+
+    uint32_t bytes() const { return (uint32_t)rect.w * rect.h * 2; }
+};
+
+class LcdFrameBuffer {
+public:
+    static const int BANDS = (LCD_HEIGHT + LCD_FB_BAND_ROWS - 1) / LCD_FB_BAND_ROWS;
+
+    LcdFrameBuffer();
+    ~LcdFrameBuffer();
+
+    // false if the buffers cannot be allocated
+    bool begin();
+    // glcdfont layout: 5 column bytes per character, bit 0 at the top
+    void setFont(const uint8_t* glcdfont) { font = glcdfont; }
+
+    // Drawing, clipped to the screen, like the ILI9341_t3 calls of the same name
+    void fillRect(int x, int y, int w, int h, uint16_t color);
+    void drawRect(int x, int y, int w, int h, uint16_t color);
+    void drawCircle(int cx, int cy, int r, uint16_t color);
+    void fillCircle(int cx, int cy, int r, uint16_t color);
+    void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color);
+    // Opaque text: each character paints its whole 6×8 cell times size
+    void drawText(int x, int y, uint8_t size, uint16_t fg, uint16_t bg, const char* s);
+
+    uint16_t getPixel(int x, int y) const;
+
+    // The frame is complete: queue its dirty bands, stage what fits
+    void publish();
+    // Bands of a published frame are still waiting to be copied
+    bool isFlushing() const { return queuedCount > 0; }
+    // Copies queued bands into free staging buffers
+    void service();
+    // Oldest staged band, or nullptr; sent() frees its buffer
+    const LcdBand* front() const { return stagedCount ? &staging[stagedHead] : nullptr; }
+    void sent();
+
+    int getDirtyBands() const;
+    int getQueuedBands() const { return queuedCount; }
+    int getStagedBands() const { return stagedCount; }
+
+private:
+    uint16_t* pixels;
+    uint16_t* stagingPixels;
+    const uint8_t* font;
+
+    LcdRect dirty[BANDS];       // Drawn since the last publish (w 0: clean)
+    LcdRect queued[BANDS];      // Published, not yet staged
+    int queuedCount;
+
+    LcdBand staging[LCD_FB_STAGING];    // Ring, oldest at stagedHead
+    int stagedHead;
+    int stagedCount;
+
+    void markDirty(int x, int y, int w, int h);
+    void span(int x, int y, int w, uint16_t swapped);
+    static void unite(LcdRect& a, const LcdRect& b);
+};
+
+#endif // LCD_FRAMEBUFFER_H
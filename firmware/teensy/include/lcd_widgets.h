@@ -0,0 +1,135 @@
+/**
+ * Oh My Ondas - LCD Widgets
+ * Retained widget state, dirty-rectangle coalescing and SPI byte metering
+ *
+ * Every element of an LCD screen (a step box, a text line, a knob) is a
+ * widget: a fixed id, its rectangle, and a key that hashes everything it
+ * shows. Each frame marks every widget with its current key; only those
+ * whose key changed since they were drawn are dirty and get repainted,
+ * so a running pattern repaints the old and new playhead boxes and
+ * nothing else.
+ *
+ * Opaque widgets (filled boxes, text with a background colour) cover
+ * their whole rectangle when drawn. The rest (outlines, knobs) have it
+ * cleared first; those clears are collected and coalesced, merging
+ * rectangles that together form a rectangle into one address window,
+ * before any widget is drawn.
+ *
+ * Hardware-free, so it builds and is tested on the host.
+ */
+
+#ifndef LCD_WIDGETS_H
+#define LCD_WIDGETS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+struct LcdRect {
+    int16_t x, y, w, h;
+
+    int32_t area() const { return (int32_t)w * h; }
+    bool empty() const { return w <= 0 || h <= 0; }
+    bool contains(const LcdRect& r) const {
+        return r.x >= x && r.y >= y && r.x + r.w <= x + w && r.y + r.h <= y + h;
+    }
+};
+
+// Bytes ILI9341_t3 sends for what LCDDisplay draws. A fill is one address
+// window (CASET + 4, PASET + 4, RAMWR: 11 bytes) and 2 bytes per RGB565
+// pixel; opaque text is one window per character cell. Outlines, circles
+// and triangles are counted from the lines and pixels the library draws
+// them with, to within a few percent.
+class LcdSpiMeter {
+public:
+    LcdSpiMeter();
+
+    static const uint32_t WINDOW_BYTES = 11;
+
+    void fill(int w, int h);
+    void text(int chars, int size);
+    void outline(int w, int h);
+    void circle(int r);                 // drawCircle: one window per pixel
+    void disc(int r);                   // fillCircle: vertical lines
+    void triangle(int w, int h);        // fillTriangle: horizontal lines
+
+    // A frame is one complete LCDDisplay::update() job
+    void endFrame();
+    void reset();
+
+    uint32_t getLastFrameBytes() const { return lastFrame; }
+    uint32_t getPeakFrameBytes() const { return peakFrame; }
+    uint32_t getAverageFrameBytes() const {
+        return frames ? (uint32_t)(totalBytes / frames) : 0;
+    }
+    uint32_t getFrames() const { return frames; }
+
+private:
+    uint32_t frameBytes;
+    uint32_t lastFrame;
+    uint32_t peakFrame;
+    uint32_t frames;
+    uint64_t totalBytes;
+
+    void window(uint32_t pixels) { frameBytes += WINDOW_BYTES + 2 * pixels; }
+};
+
+struct LcdWidget {
+    LcdRect rect;       // As last drawn
+    uint32_t key;
+    uint8_t shape;
+    bool drawn;
+    bool dirty;
+};
+
+class LcdWidgets {
+public:
+    LcdWidgets();
+
+    // Nothing is on screen: every widget is dirty on its next mark
+    void invalidate();
+    // false: every widget is dirty every frame (full repaints, for comparison)
+    void setRetained(bool on) { retained = on; }
+    bool isRetained() const { return retained; }
+
+    // Phase 1. True if the widget must be repainted this frame. A
+    // non-opaque widget's rectangle is queued for clearing, unless it was
+    // last drawn in the same nonzero shape in the same place (an outline
+    // box redrawn as an outline box covers the old one); so is its old
+    // rectangle if the new one does not cover it. Nothing is cleared for
+    // a widget's first draw after invalidate(): the screen is blank.
+    bool mark(int id, int x, int y, int w, int h, uint32_t key, bool opaque = true,
+              uint8_t shape = 0);
+
+    static const uint8_t OUTLINE = 1;   // shape of a box outline
+
+    // Phase 2: clear these (coalesced), then draw the dirty widgets. A
+    // screen may run several mark/clear/draw rounds, one per group of
+    // widgets; clearsIssued() starts the next round's list.
+    int getClearCount() const { return clearCount; }
+    const LcdRect& getClear(int i) const { return clears[i]; }
+    void clearsIssued() { clearCount = 0; }
+    bool isDirty(int id) const { return id >= 0 && id < LCD_MAX_WIDGETS && widgets[id].dirty; }
+    const LcdRect& getRect(int id) const { return widgets[id].rect; }
+    bool isDrawn(int id) const { return widgets[id].drawn; }
+
+    // Phase 3: the frame is on screen
+    void commit();
+    int getDirtyCount() const { return dirtyCount; }
+
+    // FNV-1a
+    static uint32_t hash(const void* data, size_t len, uint32_t seed = 2166136261u);
+    static uint32_t hashText(const char* s, uint32_t seed = 2166136261u);
+
+private:
+    LcdWidget widgets[LCD_MAX_WIDGETS];
+    // Each widget queues at most two rectangles a frame, so this never fills
+    LcdRect clears[2 * LCD_MAX_WIDGETS];
+    int clearCount;
+    int dirtyCount;
+    bool retained;
+
+    void addClear(LcdRect r);
+    static bool mergeExact(LcdRect& a, const LcdRect& b);
+};
+
+#endif // LCD_WIDGETS_H
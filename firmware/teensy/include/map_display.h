@@ -4,6 +4,12 @@
  *
  * NOTE: Adafruit_SSD1306.h is only included in map_display.cpp to avoid
  * Adafruit_GFX_Button class conflict with ILI9341_t3.
+ *
+ * A frame is composed in RAM in one slice, then pushed to the OLED one
+ * 128-byte page at a time instead of a single ~25ms display() call.
+ * After begin() the pages go through the shared I2cBus queue in 32-byte
+ * chunks, each queued from the previous one's completion callback, so at
+ * most one chunk (~0.8ms at 400kHz) is ever ahead of an input read.
  */
 
 #ifndef MAP_DISPLAY_H
@@ -11,6 +17,7 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "i2c_bus.h"
 
 #define MAP_TRAIL_SIZE 128
 
@@ -26,8 +33,9 @@ public:
     MapDisplay();
     ~MapDisplay();
 
-    void begin();
-    void update(float lat, float lon, bool gpsValid);
+    void begin(I2cBus* bus);
+    // One slice of a frame: true once the frame is on the OLED
+    bool update(float lat, float lon, bool gpsValid);
 
     void zoomIn();
     void zoomOut();
@@ -37,6 +45,7 @@ public:
 
 private:
     Adafruit_SSD1306* oled;
+    I2cBus* bus;
     bool ready;
 
     MapPoint trail[MAP_TRAIL_SIZE];
@@ -52,9 +61,14 @@ private:
     char statusLine1[32];
     char statusLine2[32];
 
-    unsigned long lastUpdate;
+    int8_t pushPage;        // Page being sent, -1 = compose a new frame
+    int8_t pushChunk;       // Next transfer of the page: -1 = address commands
+    bool chunkInFlight;
 
     void addPoint(float lat, float lon);
+    void compose(float lat, float lon, bool gpsValid);
+    void sendChunk();
+    static void onChunkSent(const I2cTransfer& t, void* ctx);
     void drawMap();
     void drawStatusScreen();
     int  lonToX(float lon);
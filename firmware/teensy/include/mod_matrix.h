@@ -0,0 +1,148 @@
+/**
+ * Oh My Ondas - Modulation Matrix
+ * Shared LFOs and envelope followers, routed to FX, synth and track levels
+ *
+ * Sources are MOD_LFO_COUNT LFOs (bipolar, -1..1) and MOD_ENV_COUNT
+ * envelope followers (unipolar, 0..1). Up to MOD_MAX_ROUTES routes each
+ * take a source to a destination at a depth of -1..1, and routes to the
+ * same destination add up. process() runs once per audio block from
+ * onAudioBlock() and leaves one value per destination:
+ *
+ *   FX param 1-3, FX mix   offset, ±MOD_FX_RANGE at depth 1
+ *   Synth cutoff           offset in octaves, ±MOD_CUTOFF_OCTAVES
+ *   Synth pitch            offset in semitones, ±MOD_PITCH_SEMITONES
+ *   Synth and track levels gain factor 0..1. At a positive depth the
+ *                          level dips as the source rises (tremolo,
+ *                          ducking); at a negative depth it dips as the
+ *                          source falls (gate)
+ *
+ * The matrix never writes a base value. The FX engine, the synth voice,
+ * the filter smoother and the amps keep what was set and combine it with
+ * value() as they write the audio object, so modulation cannot drift a
+ * parameter and clearing a route puts it back exactly.
+ *
+ * Route and LFO setters are for loop(); process() runs in the audio ISR.
+ * value() is safe from both.
+ */
+
+#ifndef MOD_MATRIX_H
+#define MOD_MATRIX_H
+
+#include <Arduino.h>
+#include <Audio.h>
+#include "config.h"
+#include "lfo_tables.h"
+
+enum ModSource : uint8_t {
+    MOD_SRC_NONE = 0,
+    MOD_SRC_LFO1,
+    MOD_SRC_ENV1 = MOD_SRC_LFO1 + MOD_LFO_COUNT,    // Input bus
+    MOD_SRC_COUNT = MOD_SRC_ENV1 + MOD_ENV_COUNT     // ENV2: sample bus
+};
+
+enum ModDest : uint8_t {
+    MOD_DST_FX_PARAM1 = 0,
+    MOD_DST_FX_PARAM2,
+    MOD_DST_FX_PARAM3,
+    MOD_DST_FX_MIX,
+    MOD_DST_SYNTH_CUTOFF,
+    MOD_DST_SYNTH_PITCH,
+    MOD_DST_SYNTH_LEVEL,
+    MOD_DST_TRACK_LEVEL,                            // + track
+    MOD_DST_COUNT = MOD_DST_TRACK_LEVEL + MAX_TRACKS
+};
+
+enum LfoShape : uint8_t {
+    LFO_SINE = 0,
+    LFO_TRIANGLE,
+    LFO_SAW,
+    LFO_SQUARE,
+    LFO_SAMPLE_HOLD,
+    LFO_SHAPE_COUNT
+};
+
+struct ModRoute {
+    uint8_t source;     // ModSource, MOD_SRC_NONE = unused
+    uint8_t dest;       // ModDest
+    float depth;        // -1..1
+};
+
+// ============================================
+// ENVELOPE FOLLOWER
+// ============================================
+
+// Block peak with attack/release smoothing, read by the matrix one block
+// later. Passes nothing on.
+class AudioAnalyzeEnvelope : public AudioStream {
+public:
+    AudioAnalyzeEnvelope();
+    virtual void update(void);
+
+    void attack(float ms);
+    void release(float ms);
+    float read() const { return level; }
+
+private:
+    volatile float level;           // 0..1
+    float attackCoef, releaseCoef;  // Per block
+    audio_block_t* inputQueueArray[1];
+};
+
+// ============================================
+// MATRIX
+// ============================================
+
+class ModMatrix {
+public:
+    ModMatrix();
+
+    // Envelope followers, one per MOD_SRC_ENV1 + i (optional)
+    void begin(AudioAnalyzeEnvelope* envelopes);
+
+    // LFOs
+    void setLFORate(int lfo, float hz);
+    void setLFOShape(int lfo, LfoShape shape);
+    float getLFORate(int lfo) const;
+    LfoShape getLFOShape(int lfo) const;
+
+    // Routes. setRoute() writes a slot; addRoute() takes the first free
+    // slot (or the one already joining source and dest) and returns it,
+    // -1 if full
+    void setRoute(int slot, ModSource source, ModDest dest, float depth);
+    int addRoute(ModSource source, ModDest dest, float depth);
+    void clearRoute(int slot);
+    void clearRoutes();
+    const ModRoute& getRoute(int slot) const { return routes[slot]; }
+    int getRouteCount() const;
+
+    // Audio ISR, once per block: steps the LFOs and evaluates the routes
+    void process(uint16_t blockSamples);
+
+    // Last source value, and the per-destination result (see the table above)
+    float source(ModSource src) const { return src < MOD_SRC_COUNT ? sources[src] : 0.0f; }
+    float value(ModDest dest) const { return dest < MOD_DST_COUNT ? values[dest] : 0.0f; }
+    // Offset of a 0..1 parameter: base + offset, clamped
+    float apply(ModDest dest, float base) const;
+    bool isGainDest(ModDest dest) const {
+        return dest == MOD_DST_SYNTH_LEVEL || dest >= MOD_DST_TRACK_LEVEL;
+    }
+
+private:
+    struct Lfo {
+        LfoPhase osc;               // Stepped per sample
+        float rate;
+        uint8_t shape;
+        uint16_t holdIndex;         // Sample & hold: point in lfoRandomTable
+    };
+
+    Lfo lfos[MOD_LFO_COUNT];
+    ModRoute routes[MOD_MAX_ROUTES];
+    AudioAnalyzeEnvelope* envelopes;
+
+    float sources[MOD_SRC_COUNT];
+    volatile float values[MOD_DST_COUNT];
+
+    float lfoValue(Lfo& lfo, bool wrapped);
+};
+
+#endif // MOD_MATRIX_H
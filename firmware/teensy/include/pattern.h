@@ -0,0 +1,305 @@
+/**
+ * Oh My Ondas - Pattern
+ * Pattern data structures and the binary pattern file format
+ *
+ * A pattern file (patternNN.bin) is a PatternFileHeader followed by the
+ * Pattern struct as it sits in RAM, cut after the last step page in use,
+ * so loading is one read plus a CRC check. The payload is only valid for
+ * the firmware layout it was written with: bump PATTERN_FILE_VERSION
+ * whenever Pattern, Track, StepPage or Step change. JSON (patternNN.json)
+ * remains the import/export format.
+ *
+ * Steps are paged: a track maps each run of STEPS_PER_PAGE steps to a
+ * page in the pattern's shared pool (Pattern::pages), allocated the first
+ * time a step in it is written. Pages a track never wrote read as empty
+ * steps and are not saved, so files stay small; the pool holds a page
+ * for every track at full length. The bank that keeps all MAX_PATTERNS
+ * in memory (PatternBank) stores only the pages in use, from a pool
+ * shared by every pattern that is smaller than that. Each
+ * track has its own length and speed (polymeter); Pattern::length is the
+ * master length used for pattern end and bar counting.
+ *
+ * Parameter locks are sparse: each Step has a bitmask of the ParamTypes it
+ * locks, and the values live in a per-track pool (Track::lockValues), in
+ * step order and ParamType order within a step, quantized to 16 bits over
+ * the parameter's range. Step::lockFirst is the pool index of the step's
+ * first value. Edit locks only through stepSetLock()/stepClearLock(),
+ * which keep the pool packed.
+ *
+ * A track plays its sample slot or, as a TRACK_SYNTH track, the
+ * PolySynth: each step is then a note (Step::note, transposed by
+ * pitchOffset) held for Step::gate. Filter and PARAM_SYNTH_ locks shape
+ * that note only; the sample-only locks are ignored.
+ *
+ * No Arduino dependencies, so the format can be exercised on the host.
+ */
+
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+// Parameter lock types
+enum ParamType {
+    PARAM_PITCH = 0,
+    PARAM_VOLUME,
+    PARAM_PAN,
+    PARAM_FILTER_FREQ,
+    PARAM_FILTER_RES,
+    PARAM_FX_SEND_1,
+    PARAM_FX_SEND_2,
+    PARAM_SAMPLE_START,
+    PARAM_SAMPLE_END,
+    PARAM_SYNTH_ATTACK,     // Synth tracks only
+    PARAM_SYNTH_DECAY,
+    PARAM_SYNTH_SUSTAIN,
+    PARAM_SYNTH_RELEASE,
+    PARAM_COUNT
+};
+
+static_assert(PARAM_COUNT <= 16, "Step::lockMask has a bit per ParamType");
+static_assert(TRACK_PARAM_LOCKS <= 255, "Step::lockFirst and Track::lockCount are 8-bit");
+
+// What a track's steps play
+enum TrackType : uint8_t {
+    TRACK_SAMPLE = 0,       // Its sample slot (SamplingEngine)
+    TRACK_SYNTH,            // Notes on the PolySynth
+    TRACK_TYPE_COUNT
+};
+
+// Track speed relative to the master step (polymeter)
+enum TrackSpeed : uint8_t {
+    SPEED_1_8 = 0,
+    SPEED_1_4,
+    SPEED_1_2,
+    SPEED_3_4,
+    SPEED_1,
+    SPEED_3_2,
+    SPEED_2,
+    SPEED_COUNT
+};
+
+// Sequencer ticks per track step at each speed (SEQ_TICKS_PER_STEP = 1x)
+extern const uint8_t trackSpeedTicks[SPEED_COUNT];
+
+// Step data structure
+struct Step {
+    bool active;
+    TrigCondition condition;
+    uint8_t velocity;
+    int8_t pitchOffset;     // Semitones
+    uint8_t sampleSlice;    // Which slice to play
+    uint8_t lockFirst;      // Index of this step's first value in Track::lockValues
+    uint16_t lockMask;      // Bit per ParamType that is locked
+    int8_t microTiming;     // Offset from the grid, 1/MICRO_TIMING_PER_STEP step
+    uint8_t ratchets;       // Extra hits spread evenly over the step, 0-MAX_RATCHETS
+    uint8_t ratchetDecay;   // Velocity lost per extra hit, 0-100%
+    uint8_t probability;    // TRIG_PROB chance, 0-100%
+    uint8_t note;           // MIDI note, synth tracks
+    uint8_t gate;           // Note length, 1/GATE_PER_STEP step, 1-GATE_MAX
+};
+
+#define STEP_PAGES (MAX_STEPS / STEPS_PER_PAGE)     // Pages per track
+#define NO_PAGE 0xFF
+
+static_assert(PATTERN_STEP_PAGES >= MAX_TRACKS * STEP_PAGES && PATTERN_STEP_PAGES < NO_PAGE,
+              "the page pool holds every track at MAX_STEPS");
+
+struct StepPage {
+    Step steps[STEPS_PER_PAGE];
+};
+
+// Track data structure
+struct Track {
+    bool muted;
+    bool soloed;
+    uint8_t sourceSlot;     // Which sample/input
+    uint8_t lockCount;      // Values in use in lockValues
+    uint8_t length;         // 1-64 steps, loops independently
+    TrackSpeed speed;
+    TrackType type;
+    uint8_t pages[STEP_PAGES];  // Index into Pattern::pages, or NO_PAGE
+    float volume;
+    float pan;
+    uint16_t lockValues[TRACK_PARAM_LOCKS];
+};
+
+// Pattern data structure. pages must stay last: files end after
+// pages[pagesUsed - 1]
+struct Pattern {
+    uint8_t length;         // 1-64 steps (master)
+    uint8_t swing;          // 0-100%
+    uint8_t pagesUsed;      // Allocated from the front of pages
+    float bpm;              // Pattern-specific tempo (or 0 for global)
+    uint32_t seed;          // Probability trig generators start from this
+    Track tracks[MAX_TRACKS];
+    StepPage pages[PATTERN_STEP_PAGES];
+};
+
+// Reset to an empty 16-step pattern
+void patternClear(Pattern& p);
+
+// What reads of a step in an unallocated page see
+extern const Step emptyStep;
+
+inline const Step& patternStep(const Pattern& p, int track, int step) {
+    uint8_t page = p.tracks[track].pages[step / STEPS_PER_PAGE];
+    if (page == NO_PAGE) return emptyStep;
+    return p.pages[page].steps[step % STEPS_PER_PAGE];
+}
+
+// Writable step, allocating its page. nullptr when the page pool is full.
+Step* patternStepForEdit(Pattern& p, int track, int step);
+
+// ============================================
+// Parameter locks
+// ============================================
+
+// Quantize a value to / restore it from the parameter's 16-bit range
+// (pitch in semitones, filter in Hz, sample start/end as a fraction of
+// the sample, synth envelope times in ms, the rest in their natural 0..1
+// or -1..1 units)
+struct ParamLockRange {
+    float min;
+    float step;             // (max - min) / 65535
+};
+
+extern const ParamLockRange paramLockRanges[PARAM_COUNT];
+
+uint16_t paramLockEncode(ParamType param, float value);
+
+inline float paramLockDecode(ParamType param, uint16_t q) {
+    return paramLockRanges[param].min + paramLockRanges[param].step * q;
+}
+
+// Read-only view of one step's locks: values[i] belongs to the i-th set
+// bit of mask, so walking the mask touches only the locks present
+struct StepLocks {
+    uint16_t mask;
+    const uint16_t* values;
+
+    bool has(ParamType param) const { return mask & (1u << param); }
+
+    // Only valid when has(param)
+    float get(ParamType param) const {
+        return paramLockDecode(param, values[__builtin_popcount(mask & ((1u << param) - 1))]);
+    }
+};
+
+inline StepLocks stepLocks(const Pattern& p, int track, int step) {
+    const Step& s = patternStep(p, track, step);
+    StepLocks l = { s.lockMask, &p.tracks[track].lockValues[s.lockFirst] };
+    return l;
+}
+
+// Set or replace a lock. False when the track's lock pool is full.
+bool stepSetLock(Pattern& p, int track, int step, ParamType param, float value);
+void stepClearLock(Pattern& p, int track, int step, ParamType param);
+void stepClearLocks(Pattern& p, int track, int step);
+
+// Lengths, speeds, page map and lock pool indices all in range and
+// consistent (checked on every file load)
+bool patternLayoutValid(const Pattern& p);
+
+// ============================================
+// Binary file format
+// ============================================
+
+#define PATTERN_FILE_MAGIC 0x504D4F4FUL     // "OOMP" little-endian
+#define PATTERN_FILE_VERSION 7         // 2: sparse locks, 3: paged steps, 4: micro-timing,
+                                       // 5: probability and seed, 6: synth tracks,
+                                       // 7: 128-value lock pool
+
+struct PatternFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;    // sizeof(PatternFileHeader)
+    uint32_t payloadSize;   // patternPayloadSize() of the pattern
+    uint32_t crc;           // CRC-32 of the payload
+};
+
+// Header + payload, laid out as on disk so a load is a single read.
+// Only headerSize + payloadSize bytes of it are in the file.
+struct PatternFile {
+    PatternFileHeader header;
+    Pattern pattern;
+};
+
+enum PatternFileStatus {
+    PATTERN_FILE_OK = 0,
+    PATTERN_FILE_BAD_MAGIC,
+    PATTERN_FILE_BAD_VERSION,   // Other firmware layout: re-import from JSON
+    PATTERN_FILE_BAD_SIZE,
+    PATTERN_FILE_BAD_CRC,
+    PATTERN_FILE_BAD_LAYOUT     // Page map or lock pool inconsistent
+};
+
+// CRC-32 (IEEE, as zlib); pass the previous result to continue a CRC
+uint32_t crc32(const void* data, size_t len, uint32_t crc = 0);
+
+// Bytes of p that go to disk: everything up to the last page in use
+size_t patternPayloadSize(const Pattern& p);
+
+// Fill in header for f.pattern
+void patternFileSeal(PatternFile& f);
+
+// Bytes to write / expect on disk for a sealed or read header
+inline size_t patternFileSize(const PatternFileHeader& h) {
+    return sizeof(PatternFileHeader) + h.payloadSize;
+}
+
+// Check a PatternFile just read from disk; zeroes the unused page tail
+PatternFileStatus patternFileCheck(PatternFile& f);
+
+// ============================================
+// Pattern bank
+// ============================================
+
+static_assert(BANK_STEP_PAGES >= PATTERN_STEP_PAGES && BANK_STEP_PAGES <= 0xFFFF,
+              "the bank pool holds at least one full pattern, indexed in 16 bits");
+
+// A banked pattern: everything before Pattern::pages, and where each of
+// its pages went in the bank's pool
+struct BankEntry {
+    uint8_t head[offsetof(Pattern, pages)];
+    uint16_t pages[PATTERN_STEP_PAGES];     // Pool index of Pattern::pages[i]
+    uint8_t pagesHeld;                      // = the stored pattern's pagesUsed
+    bool cleared;                           // Nothing stored: reads as patternClear()
+};
+
+struct PatternBankMemory {
+    StepPage pool[BANK_STEP_PAGES];
+    BankEntry entries[MAX_PATTERNS];
+    uint16_t freePages[BANK_STEP_PAGES];    // Stack of unused pool pages
+};
+
+// All MAX_PATTERNS patterns, their step pages drawn from one pool of
+// BANK_STEP_PAGES shared by the whole bank. That is less than every
+// pattern at full length would take, so store() can refuse a pattern;
+// the caller checks pagesFree() + pagesHeld() before growing one.
+class PatternBank {
+public:
+    PatternBank() : mem(nullptr), freeCount(0) {}
+
+    // memory: sizeof(PatternBankMemory) bytes; every entry starts cleared
+    void begin(PatternBankMemory* memory);
+    bool ready() const { return mem != nullptr; }
+
+    // False, and the entry unchanged, when the pool cannot take p's pages
+    bool store(int n, const Pattern& p);
+    void fetch(int n, Pattern& out) const;
+
+    // Return an entry's pages to the pool; it reads as cleared
+    void evict(int n);
+
+    int pagesHeld(int n) const { return mem->entries[n].pagesHeld; }
+    int pagesFree() const { return freeCount; }
+
+private:
+    PatternBankMemory* mem;
+    int freeCount;
+};
+
+#endif // PATTERN_H
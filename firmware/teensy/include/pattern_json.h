@@ -0,0 +1,92 @@
+/**
+ * Oh My Ondas - Pattern JSON
+ * patternNN.json import (export is streamed by Sequencer::exportPatternJSON)
+ *
+ * Header-only so the host benchmark can build it against ArduinoJson too.
+ */
+
+#ifndef PATTERN_JSON_H
+#define PATTERN_JSON_H
+
+#include <stdio.h>
+#include <ArduinoJson.h>
+#include "pattern.h"
+
+// Fill p from a parsed pattern document. Fields missing from the
+// document keep the values from patternClear(). Returns the number of
+// locks dropped because their track's pool was full.
+inline int patternFromJson(JsonDocument& doc, Pattern& p) {
+    patternClear(p);
+    int dropped = 0;
+
+    p.length = doc["length"] | STEPS_PER_PAGE;
+    p.swing = doc["swing"] | 0;
+    p.bpm = doc["bpm"] | 0.0f;
+    p.seed = doc["seed"] | (uint32_t)PATTERN_DEFAULT_SEED;
+    if (p.length < 1 || p.length > MAX_STEPS) p.length = STEPS_PER_PAGE;
+
+    JsonArray tracks = doc["tracks"];
+    for (int t = 0; t < MAX_TRACKS && t < (int)tracks.size(); t++) {
+        JsonObject trk = tracks[t];
+        p.tracks[t].muted = trk["muted"] | false;
+        p.tracks[t].sourceSlot = trk["src"] | t;
+        p.tracks[t].volume = trk["vol"] | 1.0f;
+        p.tracks[t].pan = trk["pan"] | 0.0f;
+
+        // Per-track length and speed; older files follow the pattern length
+        int len = trk["len"] | (int)p.length;
+        int speed = trk["spd"] | (int)SPEED_1;
+        p.tracks[t].length = (len >= 1 && len <= MAX_STEPS) ? len : p.length;
+        p.tracks[t].speed = (speed >= 0 && speed < SPEED_COUNT) ? (TrackSpeed)speed : SPEED_1;
+        int type = trk["type"] | (int)TRACK_SAMPLE;
+        p.tracks[t].type = (type >= 0 && type < TRACK_TYPE_COUNT) ? (TrackType)type : TRACK_SAMPLE;
+
+        JsonArray steps = trk["steps"];
+        for (int s = 0; s < MAX_STEPS && s < (int)steps.size(); s++) {
+            if (steps[s].is<int>() && steps[s].as<int>() == 0) {
+                // Inactive step (compact format): no page needed
+                continue;
+            }
+
+            // Page pool full: the rest of this page range is dropped
+            Step* step = patternStepForEdit(p, t, s);
+            if (!step) continue;
+
+            JsonObject st = steps[s];
+            step->active = true;
+            step->velocity = st["v"] | 127;
+            int cond = st["c"] | 0;
+            int prob = st["pr"] | 100;
+            step->condition = (cond >= 0 && cond < TRIG_COUNT) ? (TrigCondition)cond : TRIG_ALWAYS;
+            step->probability = (prob < 0) ? 0 : (prob > 100) ? 100 : prob;
+            step->pitchOffset = st["p"] | 0;
+
+            int micro = st["m"] | 0;
+            int ratchets = st["r"] | 0;
+            int decay = st["d"] | 0;
+            step->microTiming = (micro < -MICRO_TIMING_MAX) ? -MICRO_TIMING_MAX :
+                                (micro > MICRO_TIMING_MAX) ? MICRO_TIMING_MAX : micro;
+            step->ratchets = (ratchets < 0) ? 0 : (ratchets > MAX_RATCHETS) ? MAX_RATCHETS : ratchets;
+            step->ratchetDecay = (decay < 0) ? 0 : (decay > 100) ? 100 : decay;
+
+            // Synth note and length
+            int note = st["n"] | SEQ_DEFAULT_NOTE;
+            int gate = st["g"] | (GATE_PER_STEP / 2);
+            step->note = (note < 0) ? 0 : (note > 127) ? 127 : note;
+            step->gate = (gate < 1) ? 1 : (gate > GATE_MAX) ? GATE_MAX : gate;
+
+            // Parameter locks (L0..Ln)
+            for (int l = 0; l < PARAM_COUNT; l++) {
+                char key[4];
+                snprintf(key, sizeof(key), "L%d", l);
+                if (st.containsKey(key) &&
+                    !stepSetLock(p, t, s, (ParamType)l, st[key].as<float>())) {
+                    dropped++;
+                }
+            }
+        }
+    }
+    return dropped;
+}
+
+#endif // PATTERN_JSON_H
@@ -0,0 +1,155 @@
+/**
+ * Oh My Ondas - Poly Synth
+ * Pool of SYNTH_VOICES synth voices with voice stealing and a CPU budget
+ *
+ * noteOn() takes a free voice while fewer than the voice limit are
+ * sounding. Otherwise it steals, in this order:
+ *
+ *   1. a voice already being shed (fading out over SYNTH_STEAL_MS)
+ *   2. the released voice that let go longest ago, the quietest one
+ *   3. the held voice that started longest ago
+ *
+ * The same key again retriggers its own voice. Settings and the mod
+ * matrix's cutoff and pitch offsets (the shared modulation bus) go to
+ * every voice, so a chord moves as one. A note starts on the current
+ * filter and envelope settings, without the filter ramp.
+ *
+ * Sequenced notes (synth tracks) arrive as audio commands and are
+ * played from the ISR: lockNextNote() sets a step's locks for the
+ * playNote() that follows it at the same timestamp, and releaseNote()
+ * only lets go of the voice if it still plays the note that started at
+ * that sample, so the gate-off of a note that was retriggered since is
+ * ignored.
+ *
+ * Voice limit: every block update() adds up what each sounding voice's
+ * objects cost in the last audio update, keeps a per-voice figure
+ * (rises at once, falls slowly) and works out how many voices fit under
+ * SYNTH_CPU_CEILING next to everything else in the graph. The limit
+ * drops to that at once and the excess voices are shed in the same
+ * block, released ones first, before the audio pass can run into the
+ * block deadline. It rises one voice at a time, and only with
+ * SYNTH_CPU_HEADROOM to spare, so it does not flap. It never goes below
+ * one voice or above setPolyphony().
+ *
+ * Notes and settings are for loop(); modulate(), update() and the
+ * sequenced note calls run in the audio ISR.
+ */
+
+#ifndef POLY_SYNTH_H
+#define POLY_SYNTH_H
+
+#include <Arduino.h>
+#include <Audio.h>
+#include "config.h"
+#include "pattern.h"
+#include "smoothed_audio.h"
+#include "synth_voice.h"
+
+static_assert(SYNTH_VOICES >= 4 && SYNTH_VOICES <= 8, "SYNTH_VOICES is 4..8");
+
+class PolySynth {
+public:
+    PolySynth();
+
+    // One of each per voice; noise is shared
+    void begin(AudioSynthWavetableOsc* osc1,
+               AudioSynthWavetableOsc* osc2,
+               AudioSynthNoiseWhite* noise,
+               AudioMixer4Smooth* mixers,
+               LadderSmoother* filters,
+               AudioEffectEnvelope* envelopes);
+
+    // Notes, as MIDI note numbers
+    void noteOn(uint8_t note, float velocity);
+    void noteOff(uint8_t note);
+    void allNotesOff();
+
+    // Sequenced notes, audio ISR. when: the note's start sample
+    void lockNextNote(ParamType param, float value);    // Filter, PARAM_SYNTH_*
+    void playNote(uint8_t note, float velocity, uint32_t when);
+    void releaseNote(uint8_t note, uint32_t when);
+
+    // Oscillator settings (every voice)
+    void setOsc1Waveform(int waveform);
+    void setOsc2Waveform(int waveform);
+    // Osc 1 table (nullptr: the built-in shapes) and frame position
+    void setOsc1Wavetable(const Wavetable* table);
+    void setOsc1Morph(float position);
+    float getOsc1Morph() const { return osc1Morph; }
+    int getOsc1Frames() const;
+    void setOsc1Level(float level);
+    void setOsc2Level(float level);
+    void setNoiseLevel(float level);
+    void setOsc2Detune(float semitones);
+
+    // Filter
+    void setFilterFreq(float freq);
+    void setFilterRes(float res);
+    float getFilterFreq() const { return params.filterFreq; }
+    float getFilterRes() const { return params.filterRes; }
+
+    // ADSR envelope
+    void setAttack(float ms);
+    void setDecay(float ms);
+    void setSustain(float level);
+    void setRelease(float ms);
+    float getAttack() const { return params.attack; }
+    float getRelease() const { return params.release; }
+    const SynthNoteParams& getNoteParams() const { return params; }
+
+    // Voices noteOn() may use, 1..SYNTH_VOICES. The CPU budget can lower
+    // the limit further
+    void setPolyphony(int voices);
+    int getPolyphony() const { return polyphony; }
+
+    // Audio ISR, once per block: cutoff (octaves) and pitch (semitones)
+    // from the mod matrix, to every voice
+    void modulate(float cutoffOctaves, float pitchSemitones);
+    // Audio ISR, once per block after modulate(): updateVoices(), then
+    // allocateBudget() with the audio library's figures
+    void update();
+    void updateVoices();
+    // Total and per-voice usage, % of a block (voiceUsage[SYNTH_VOICES])
+    void allocateBudget(float totalUsage, const float* voiceUsage);
+
+    // State
+    bool isActive() const { return getActiveVoices() > 0; }
+    int getActiveVoices() const;                // Sounding, fading ones included
+    int getVoiceLimit() const { return voiceLimit; }
+    float getVoiceCost() const { return voiceCost; }
+    uint32_t getStolenCount() const { return stolen; }
+    uint32_t getShedCount() const { return shed; }
+    // Voice holding a note, -1 if none
+    int findVoice(uint8_t note) const;
+    SynthVoice& voice(int v) { return voices[v]; }
+
+    static float noteFrequency(uint8_t note) { return 440.0f * exp2f((note - 69) / 12.0f); }
+
+private:
+    SynthVoice voices[SYNTH_VOICES];
+    uint8_t notes[SYNTH_VOICES];
+    uint32_t stamps[SYNTH_VOICES];      // Order of the last noteOn or noteOff
+    uint32_t clock;
+    uint32_t starts[SYNTH_VOICES];      // playNote() start sample
+    bool sequenced[SYNTH_VOICES];       // Started by playNote(), not noteOn()
+
+    SynthNoteParams params;             // From the setters
+    SynthNoteParams locked;             // params plus the locks for playNote()
+    bool hasLocks;
+
+    AudioSynthNoiseWhite* noise;
+    const Wavetable* osc1Table;
+    float osc1Morph;
+    int polyphony;
+    volatile int voiceLimit;
+    float voiceCost;                    // % of a block per sounding voice
+    volatile uint32_t stolen;
+    volatile uint32_t shed;
+
+    int startNote(uint8_t note, float velocity, const SynthNoteParams& p);
+    int allocate(uint8_t note);
+    int pickVictim(bool fading) const;
+    int countSounding() const;          // Sounding and not being shed
+};
+
+#endif // POLY_SYNTH_H
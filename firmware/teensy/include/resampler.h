@@ -0,0 +1,60 @@
+/**
+ * Oh My Ondas - Resampler
+ * Variable-rate mono 16-bit playback kernels for AudioPlaySample
+ *
+ * The read position is a 32.32 fixed-point phase (integer frame index in
+ * the high word, fraction in the low word), advanced by a per-voice
+ * increment of rate * 2^32. Interpolation is selectable per voice:
+ *
+ *   INTERP_LINEAR     2 taps, cheapest, audible aliasing/dulling when pitched
+ *   INTERP_HERMITE    4-point cubic Hermite (Catmull-Rom), the default
+ *   INTERP_POLYPHASE  4-tap Lanczos (windowed-sinc) FIR, RESAMPLER_PHASES
+ *                     sub-phases; keeps more of the top octave than Hermite
+ *                     but is less exact on low frequencies
+ *
+ * A rate of exactly 1.0 on a whole-frame phase is a straight copy in
+ * every mode.
+ *
+ * No Arduino dependencies: the same code runs in the audio ISR and in
+ * the host benchmark (test/native/bench_resampler.cpp).
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+
+enum InterpMode : uint8_t {
+    INTERP_LINEAR = 0,
+    INTERP_HERMITE,
+    INTERP_POLYPHASE,
+    INTERP_MODE_COUNT
+};
+
+#define RESAMPLER_PHASE_BITS 8                      // Polyphase table rows = 2^bits
+#define RESAMPLER_PHASES (1 << RESAMPLER_PHASE_BITS)
+#define RESAMPLER_COEF_BITS 14                      // Q14 polyphase coefficients
+
+struct ResamplerVoice {
+    const int16_t* data;    // Whole sample, mono
+    uint32_t length;        // Frames in data
+    uint32_t end;           // Playback stops here (one-shot)
+    uint32_t loopStart;     // Loop region [loopStart, loopEnd)
+    uint32_t loopEnd;
+    bool loop;
+    InterpMode mode;
+    uint64_t phase;         // 32.32 read position in data
+    uint64_t increment;     // 32.32 frames per output sample
+};
+
+// Build the polyphase coefficient table (once, before the first render)
+void resamplerInit();
+
+// Playback rate → 32.32 increment (1.0 = one source frame per output sample)
+uint64_t resamplerIncrement(float rate);
+
+// Render up to n samples into out. Returns the number written; fewer than
+// n means the voice reached its end (the caller zero-fills the rest).
+int resamplerRender(ResamplerVoice& v, int16_t* out, int n);
+
+#endif // RESAMPLER_H
@@ -0,0 +1,101 @@
+/**
+ * Oh My Ondas - Sample Cache
+ * Decoded sample PCM held in PSRAM (EXTMEM) so pad hits never touch SD
+ *
+ * Samples are decoded once at load time to mono 16-bit PCM and kept by
+ * filename. Entries used by a loaded slot are pinned; unpinned entries
+ * stay resident (so flipping back to a recent bank is free) until their
+ * space is needed, then the least recently used goes first. Samples that
+ * cannot fit the budget are left for SD streaming. A trigger of one is a
+ * miss: SamplingEngine streams that hit and, if there is room by then,
+ * loads the sample for the next one a slice per loop() pass (reserve(),
+ * fill()), so no pass waits on a whole file.
+ *
+ * Without PSRAM fitted, extmem_malloc() falls back to the normal heap and
+ * the much smaller SAMPLE_CACHE_RAM_BUDGET applies.
+ */
+
+#ifndef SAMPLE_CACHE_H
+#define SAMPLE_CACHE_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+
+struct WavInfo {
+    uint16_t channels;
+    uint16_t bitsPerSample;
+    uint32_t sampleRate;
+    uint32_t dataOffset;    // File offset of the first PCM byte
+    uint32_t dataBytes;
+    uint32_t frames;
+};
+
+struct CachedSample {
+    char filename[64];
+    int16_t* pcm;           // Mono 16-bit, nullptr = free entry
+    uint32_t frames;
+    uint32_t framesLoaded;  // < frames while a sliced fill is under way
+    uint32_t sampleRate;    // Of the source file
+    uint8_t refs;           // Slots using it; pinned while > 0
+    uint32_t lastUsed;      // LRU stamp
+};
+
+class SampleCache {
+public:
+    SampleCache();
+
+    void begin();
+
+    // Returns a pinned entry, loading it if needed, or nullptr when the
+    // sample has to be streamed from SD instead
+    CachedSample* acquire(const char* filename, File& file, const WavInfo& info);
+    void release(CachedSample* entry);
+
+    // Sliced load: reserve() makes room and returns a pinned entry that
+    // acquire() does not see until it is complete; each fill() decodes
+    // up to maxFrames more (false on a read error); abandon() frees an
+    // entry that will not be finished
+    CachedSample* reserve(const char* filename, const WavInfo& info);
+    bool fill(CachedSample* entry, File& file, const WavInfo& info, uint32_t maxFrames);
+    void abandon(CachedSample* entry);
+    static bool isComplete(const CachedSample* entry) {
+        return entry->framesLoaded == entry->frames;
+    }
+
+    static bool readWavInfo(File& file, WavInfo& info);
+
+    // Whether acquire() could make room for the sample without touching
+    // pinned entries
+    bool canFit(const WavInfo& info);
+
+    // Trigger accounting (called from the audio ISR)
+    void recordHit()  { hits++; }
+    void recordMiss() { misses++; }
+
+    // Statistics
+    uint32_t getHits()          { return hits; }
+    uint32_t getMisses()        { return misses; }
+    float    getHitRate();
+    uint32_t getBytesResident() { return bytesResident; }
+    uint32_t getBudget()        { return budget; }
+    int      getEntryCount();
+    bool     hasPSRAM()         { return psram; }
+
+private:
+    CachedSample entries[SAMPLE_CACHE_ENTRIES];
+    uint32_t budget;
+    uint32_t bytesResident;
+    uint32_t useCounter;
+    volatile uint32_t hits;
+    volatile uint32_t misses;
+    bool psram;
+
+    CachedSample* find(const char* filename);
+    CachedSample* leastRecentlyUsed();
+    void evict(CachedSample* entry);
+    bool decodePCM(File& file, const WavInfo& info, int16_t* dest,
+                   uint32_t first, uint32_t count);
+};
+
+#endif // SAMPLE_CACHE_H
@@ -0,0 +1,55 @@
+/**
+ * Oh My Ondas - Sample Player
+ * Audio object that plays mono 16-bit PCM straight from memory
+ *
+ * Replaces AudioPlaySdWav for cached samples: play() only sets a pointer,
+ * so it is cheap enough to call from the audio ISR, and playback can start
+ * part-way into a block (startOffset) to keep sequencer timing exact.
+ * The PCM usually lives in PSRAM (see SampleCache).
+ *
+ * Playback is variable-rate (see resampler.h): setRate() takes the ratio
+ * of source frames per output sample, e.g. 2.0 = one octave up. The
+ * region [start, end) and an optional loop [loopStart, loopEnd) are in
+ * source frames.
+ *
+ * CPU budget: all MAX_TRACKS players together must stay under 10% of
+ * the audio CPU in the most expensive mode: a 128-sample block is ~1.74M
+ * cycles at 600 MHz, so ~21k cycles (~170 per sample) per voice. Check
+ * on hardware with processorUsageMax() on the players;
+ * test/native/bench_resampler.cpp gives cycles per block for each
+ * interpolation mode on the host.
+ */
+
+#ifndef SAMPLE_PLAYER_H
+#define SAMPLE_PLAYER_H
+
+#include <Arduino.h>
+#include <AudioStream.h>
+#include "resampler.h"
+
+class AudioPlaySample : public AudioStream {
+public:
+    AudioPlaySample();
+
+    // startOffset: silent samples before the first PCM frame in the next
+    // rendered block (0..AUDIO_BLOCK_SAMPLES-1)
+    void play(const int16_t* pcm, uint32_t frames, uint32_t start, uint32_t end,
+              uint16_t startOffset = 0);
+    void stop();
+    bool isPlaying() { return playing; }
+    uint32_t positionFrames() { return (uint32_t)(voice.phase >> 32); }
+
+    // Safe to call while playing (from loop() or the audio ISR)
+    void setRate(float rate);
+    void setLoop(bool loop, uint32_t loopStart, uint32_t loopEnd);
+    void setInterpolation(InterpMode mode);
+
+    virtual void update(void);
+
+private:
+    ResamplerVoice voice;
+    volatile uint16_t pendingOffset;
+    volatile bool playing;
+};
+
+#endif // SAMPLE_PLAYER_H
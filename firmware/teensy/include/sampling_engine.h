@@ -10,6 +10,9 @@
 #include <Audio.h>
 #include <SD.h>
 #include "config.h"
+#include "sample_cache.h"
+#include "sample_player.h"
+#include "smoothed_audio.h"
 
 struct Sample {
     char filename[64];
@@ -19,16 +22,25 @@ struct Sample {
     float pitch;
     float volume;
     float pan;
-    uint32_t startPos;
-    uint32_t endPos;
-    uint32_t length;
+    float filterFreq;       // Track filter on steps without a filter lock
+    float filterRes;
+    uint32_t startPos;      // Frames
+    uint32_t endPos;        // Frames
+    uint32_t length;        // Frames
+    uint32_t loopStart;     // Frames
+    uint32_t loopEnd;       // Frames, 0 = endPos
+    CachedSample* cached;   // Resident PCM, nullptr = stream from SD
+    bool cacheFailed;       // No room to cache it after a miss; stream from now on
 };
 
+static_assert(MAX_TRACKS <= 8, "SamplingEngine SD request masks hold a bit per slot");
+
 class SamplingEngine {
 public:
     SamplingEngine();
 
-    void begin(AudioPlaySdWav* players, AudioAmplifier* amps);
+    void begin(AudioPlaySdWav* players, AudioPlaySample* memPlayers,
+               AudioAmpSmooth* amps);
     void update();
 
     // Sample management
@@ -36,8 +48,16 @@ public:
     void unloadSample(int slot);
     bool isSampleLoaded(int slot);
 
-    // Playback control
-    void trigger(int slot);
+    // Playback control, safe from the audio ISR. offset = samples into
+    // the next audio block. Cached samples start on the memory player at
+    // once; AudioPlaySdWav opens and closes files, so SD starts and stops
+    // are only flagged here and carried out by the next update(). A
+    // trigger of an uncached slot is a cache miss: update() streams that
+    // hit from SD and, if the sample fits, loads it into the cache a
+    // SAMPLE_CACHE_FILL_FRAMES slice per call for the next hit. start/end
+    // pick this hit's region as fractions of the slot's startPos..endPos,
+    // so a locked region lasts one trigger (cached samples only)
+    void trigger(int slot, uint16_t offset = 0, float start = 0.0f, float end = 1.0f);
     void stop(int slot);
     void stopAll();
 
@@ -45,29 +65,66 @@ public:
     void setVolume(int slot, float volume);
     void setPitch(int slot, float pitch);
     void setPan(int slot, float pan);
+    void setFilter(int slot, float freq, float res);   // Base for unlocked steps
     void setLoop(int slot, bool loop);
     void setStartPos(int slot, uint32_t pos);
     void setEndPos(int slot, uint32_t pos);
+    void setLoopPoints(int slot, uint32_t start, uint32_t end);
+
+    // Per-note rate ratio on top of the slot pitch, reset by trigger()
+    // (cached samples only; AudioPlaySdWav is fixed-rate)
+    void setPlaybackRate(int slot, float ratio);
+    void setInterpolation(InterpMode mode);
+    InterpMode getInterpolation();
 
     // Queries
     bool isPlaying(int slot);
     bool isLooping(int slot);
     float getVolume(int slot);
     float getPitch(int slot);
+    float getFilterFreq(int slot);
+    float getFilterRes(int slot);
+    uint32_t getLength(int slot);   // Frames
 
     // Bank management
     void loadBank(int bankNumber);
     void saveBank(int bankNumber);
     int getCurrentBank();
 
+    // Sample cache
+    bool isCached(int slot);
+    float getCacheHitRate();
+    uint32_t getCacheBytesResident();
+    uint32_t getCacheBudget();
+    bool cacheUsesPSRAM();
+
 private:
     Sample samples[MAX_TRACKS];
     int currentBank;
+    InterpMode interpolation;
+
+    SampleCache cache;
 
     AudioPlaySdWav* players;
-    AudioAmplifier* amps;
+    AudioPlaySample* memPlayers;
+    AudioAmpSmooth* amps;
+
+    // SD player requests from trigger()/stop(), a bit per slot
+    volatile uint8_t sdStarts;
+    volatile uint8_t sdStops;
+
+    // Sliced cache load after a miss, one slot at a time (loop() only)
+    int fillSlot;               // -1 = idle
+    CachedSample* fillEntry;
+    File fillFile;
+    WavInfo fillInfo;
 
     void initializeSample(int slot);
+    void serviceSdPlayers();
+    void startCacheFill(int slot);
+    void serviceCacheFill();
+    void cancelCacheFill(int slot);
+    float baseRate(int slot);
     bool validateSlot(int slot);
 };
 
@@ -8,7 +8,6 @@
 
 #include <Arduino.h>
 #include <SD.h>
-#include <ArduinoJson.h>
 #include "config.h"
 
 struct Scene {
@@ -8,54 +8,47 @@
 
 #include <Arduino.h>
 #include <SD.h>
-#include <ArduinoJson.h>
 #include "config.h"
+#include "pattern.h"
+#include "spsc_queue.h"
+#include "trig_rng.h"
 
-// Parameter lock types
-enum ParamType {
-    PARAM_PITCH = 0,
-    PARAM_VOLUME,
-    PARAM_PAN,
-    PARAM_FILTER_FREQ,
-    PARAM_FILTER_RES,
-    PARAM_FX_SEND_1,
-    PARAM_FX_SEND_2,
-    PARAM_SAMPLE_START,
-    PARAM_SAMPLE_END,
-    PARAM_COUNT
+// Clock source driving step boundaries
+enum ClockSource {
+    CLOCK_MILLIS = 0,   // Legacy: millis() polled from loop()
+    CLOCK_AUDIO         // Sample counter advanced from the audio ISR
 };
 
-// Step data structure
-struct Step {
-    bool active;
-    TrigCondition condition;
-    uint8_t velocity;
-    int8_t pitchOffset;     // Semitones
-    uint8_t sampleSlice;    // Which slice to play
-    float paramLocks[PARAM_COUNT];
-    bool hasParamLock[PARAM_COUNT];
+// When a queued pattern change takes effect
+enum PatternSwitchMode {
+    SWITCH_IMMEDIATE = 0,   // Next step
+    SWITCH_NEXT_BAR,        // Next SEQ_STEPS_PER_BAR boundary
+    SWITCH_PATTERN_END      // When the playing pattern wraps
 };
 
-// Track data structure
-struct Track {
-    bool muted;
-    bool soloed;
-    uint8_t sourceSlot;     // Which sample/input
-    float volume;
-    float pan;
-    Step steps[MAX_STEPS];
+// A step trigger decided by the audio clock, waiting for loop() to dispatch
+struct StepEvent {
+    uint32_t sampleTime;    // Absolute sample the trigger belongs on
+    uint8_t track;
+    uint8_t step;
+    uint8_t buffer;         // Pattern buffer the step was read from
+    uint8_t ratchets;       // Extra hits after the first
+    uint32_t ratchetSpacing;    // Samples between hits
 };
 
-// Pattern data structure
-struct Pattern {
-    uint8_t length;         // 1-64 steps
-    uint8_t swing;          // 0-100%
-    float bpm;              // Pattern-specific tempo (or 0 for global)
-    Track tracks[MAX_TRACKS];
-};
+// Callback: called when a step triggers.
+// locks views the step's parameter locks (valid during the call only).
+// sampleTime is the absolute audio sample the trigger is scheduled for.
+// Each ratchet hit is a call of its own, with the decayed velocity.
+typedef void (*StepTriggerCallback)(int track, int step, const Step& stepData,
+                                    StepLocks locks, uint32_t sampleTime);
 
-// Callback: called when a step triggers
-typedef void (*StepTriggerCallback)(int track, int step, const Step& stepData);
+// Callback: a step on a TRACK_SYNTH track, in place of StepTriggerCallback.
+// gateSamples is how long the note is held: Step::gate of the track step,
+// or of the ratchet hit when the step ratchets.
+typedef void (*NoteTriggerCallback)(int track, int step, const Step& stepData,
+                                    StepLocks locks, uint32_t sampleTime,
+                                    uint32_t gateSamples);
 
 class Sequencer {
 public:
@@ -64,8 +57,16 @@ public:
     void begin(float initialBpm);
     void update();
 
-    // Trigger callback
+    // Audio clock: call from the audio ISR once per block (see AudioClock)
+    void processAudioBlock(uint32_t blockStart, uint16_t blockSamples);
+    void setClockSource(ClockSource source);
+    ClockSource getClockSource();
+    uint32_t getSamplePosition();
+    uint32_t getDroppedEvents();
+
+    // Trigger callbacks: sample tracks, synth tracks
     void setTriggerCallback(StepTriggerCallback callback);
+    void setNoteCallback(NoteTriggerCallback callback);
 
     // Transport
     void start();
@@ -80,10 +81,11 @@ public:
     void adjustSwing(int delta);
     uint8_t getSwing();
 
-    // Position
+    // Position (master step; each track also keeps its own)
     int getCurrentStep();
     int getCurrentBar();
     void setPosition(int step);
+    int getTrackStep(int track);        // Step the track is sounding
 
     // Track management
     void selectTrack(int track);
@@ -100,22 +102,78 @@ public:
     void setStep(int track, int step, bool active);
     bool hasStep(int step);
     bool getStep(int track, int step);
-    Step& getStepData(int track, int step);
+    const Step& getStepData(int track, int step);
+
+    // Per-track length and speed (polymeter); steps are valid up to the
+    // track's own length
+    void setTrackLength(int track, int length);
+    int getTrackLength(int track);
+    void setTrackSpeed(int track, TrackSpeed speed);
+    TrackSpeed getTrackSpeed(int track);
+    void setPatternLength(int length);  // Master; tracks at the old master length follow
+
+    // Track type: sample slot or synth notes
+    void setTrackType(int track, TrackType type);
+    TrackType getTrackType(int track);
+
+    // Synth steps: MIDI note and length (1/GATE_PER_STEP step, 1-GATE_MAX)
+    void setNote(int track, int step, int note);
+    int getNote(int track, int step);
+    void setGate(int track, int step, int gate);
+    int getGate(int track, int step);
 
     // Trig conditions
     void setTrigCondition(int track, int step, TrigCondition condition);
     TrigCondition getTrigCondition(int track, int step);
+    void setProbability(int track, int step, int percent);  // Used by TRIG_PROB
+    int getProbability(int track, int step);
+
+    // Probability seeds. Each track draws from its own generator, seeded
+    // from the pattern seed and a performance seed at every start and
+    // pattern restart. Normally start() picks a new performance seed;
+    // replay pins it, so a render of the pattern (or of a logged run)
+    // makes the same trig decisions as the live run did.
+    void setPatternSeed(uint32_t seed);
+    uint32_t getPatternSeed();
+    void setReplaySeed(uint32_t performanceSeed);
+    void clearReplaySeed();
+    bool isReplaySeed();
+    uint32_t getPerformanceSeed();      // Seed of the current run
+
+    // Micro-timing (1/MICRO_TIMING_PER_STEP of the track's step, ±MICRO_TIMING_MAX)
+    void setMicroTiming(int track, int step, int offset);
+    int getMicroTiming(int track, int step);
+
+    // Ratchets: count extra hits spread over the step, each decay% quieter
+    void setRatchet(int track, int step, int count, int decay);
+    int getRatchets(int track, int step);
+    int getRatchetDecay(int track, int step);
 
     // Parameter locks
-    void setParamLock(int track, int step, ParamType param, float value);
+    bool setParamLock(int track, int step, ParamType param, float value);  // False: pool full
     void clearParamLock(int track, int step, ParamType param);
     void clearAllParamLocks(int track, int step);
     bool hasParamLock(int track, int step, ParamType param);
     float getParamLock(int track, int step, ParamType param);
+    uint32_t getDroppedLocks();         // Sets refused and JSON locks lost since boot
+    uint32_t getRefusedSteps();         // Step edits refused since boot: bank page pool full
 
-    // Pattern management
-    void loadPattern(int patternNumber);
-    void savePattern(int patternNumber);
+    // Pattern management. All MAX_PATTERNS live in an in-RAM bank
+    // (PatternBank, see pattern.h); a step edit that needs a page the
+    // bank cannot hold is refused. Edits are written back to SD
+    // (patternNN.bin) from update()
+    void queuePattern(int patternNumber);   // Switch at the next boundary
+    void loadPattern(int patternNumber);    // Switch now
+    void savePattern(int patternNumber);    // Store the current pattern as N
+    void setPatternSwitchMode(PatternSwitchMode mode);
+    PatternSwitchMode getPatternSwitchMode();
+    int getQueuedPattern();                 // -1 if none
+    int getDirtyPatternCount();
+
+    // JSON import/export (patternNN.json)
+    bool importPatternJSON(int patternNumber);
+    bool exportPatternJSON(int patternNumber);
+    int convertJSONPatterns();      // Writes .bin for every .json lacking a valid one
     void copyPattern(int from, int to);
     void clearPattern();
     int getCurrentPattern();
@@ -126,24 +184,91 @@ public:
     bool isFillMode();
 
 private:
-    Pattern pattern;
+    // Double-buffered live pattern: the ISR flips `pattern` to the other
+    // buffer at a switch boundary; loop() only fills the inactive one
+    Pattern patternBuf[2];
+    Pattern* volatile pattern;
     int currentPatternNumber;
+    int queuedPatternNumber;
+    PatternSwitchMode switchMode;
+    volatile bool switchArmed;      // Inactive buffer ready, flip at boundary
+    volatile bool switchRestart;    // Flip restarts from step 0
+    volatile bool switchDone;       // Flipped; loop() has to finish up
+    uint32_t stepCount;             // Steps since start, for bar boundaries
+
+    // Pattern bank (EXTMEM, only when PSRAM is fitted); not ready = load from SD
+    PatternBank bank;
+    uint64_t dirtyMask;             // Bank slots newer than their SD file
+    uint64_t sdOnlyMask;            // Patterns whose pages did not fit the bank: load from SD
+    bool liveDirty;                 // Live buffer edited since last commit
+    unsigned long lastEditTime;
+
     int selectedTrack;
     int currentStep;
     bool running;
     bool fillMode;
     float globalBpm;
 
-    unsigned long lastStepTime;
-    unsigned long stepInterval;
-    unsigned long swingOffset;   // microseconds offset for even steps
+    unsigned long lastTickTime;     // micros(), millis clock only
+    unsigned long tickInterval;     // Microseconds
     uint8_t triggerCounts[MAX_TRACKS];
 
+    // Probability trigs (ISR-owned while running)
+    TrigRng trackRng[MAX_TRACKS];
+    uint32_t performanceSeed;
+    bool seedReplay;
+
+    // The clock ticks SEQ_TICKS_PER_STEP times per 1x step; each track
+    // steps every trackSpeedTicks[speed] ticks
+    uint8_t trackStep[MAX_TRACKS];  // Next step each track plays
+    uint8_t trackTicks[MAX_TRACKS]; // Ticks until that step
+    uint8_t masterTick;
+
+    // Audio clock state (samplesToNextTick is only touched by the ISR)
+    ClockSource clockSource;
+    volatile uint32_t samplePosition;
+    volatile float samplesPerStep;   // Fractional, from tempo
+    volatile float samplesPerTick;
+    double samplesToNextTick;
+    float leadSamples;              // Ticks are decided this far ahead of their time
+    volatile bool restartClock;
+
+    // ISR → loop ring of decided triggers
+    SPSCQueue<StepEvent, SEQ_EVENT_QUEUE_SIZE> pendingEvents;
+    volatile uint32_t droppedEvents;
+    uint32_t droppedLocks;          // Lock sets refused and JSON locks lost: pool full
+    uint32_t refusedSteps;          // Step edits refused: bank page pool full
+
     StepTriggerCallback triggerCallback;
+    NoteTriggerCallback noteCallback;
 
     void calculateStepInterval();
-    bool evaluateTrigCondition(int track, int step);
-    void triggerStep(int track, int step);
+    void markEdited();
+    Pattern& inactiveBuffer();
+    void prepareSwitch(int patternNumber);
+    void flipBuffers(bool restart);
+    void finishSwitch();
+    void commitLive();
+    void fetchPattern(int patternNumber, Pattern& out);
+    void storePattern(int patternNumber, const Pattern& p);
+    void loadBank();
+    void serviceWriteback();
+    bool readPatternFile(int patternNumber);
+    bool readPatternJSON(int patternNumber);
+    bool writePatternFile(int patternNumber, const Pattern& p);
+    bool validStep(int track, int step);
+    Step* editStep(int track, int step);
+    float swingDelaySamples(int track, int step);
+    void rewindTracks();
+    void seedTracks();
+    bool anyTrackSoloed();
+    void processTick(uint32_t sampleTime);
+    void dispatchEvent(const StepEvent& ev, const Pattern& src);
+    void dispatchPendingEvents();
+    void clearPendingEvents();
+    bool evaluateTrigCondition(int track, int step, uint32_t roll);
+    void triggerStep(const Pattern& src, int track, int step, uint32_t sampleTime, int hit,
+                     uint32_t hitSamples);
     void applyParamLocks(int track, int step);
 };
 
@@ -0,0 +1,233 @@
+/**
+ * Oh My Ondas - Smoothed Audio Objects
+ * Zipper-free gain and filter changes
+ *
+ * AudioAmplifier and AudioMixer4 take a new gain at once, and the state
+ * variable and ladder filters a new cutoff, so a control written from
+ * loop() every few ms (fader, FX mix, LFO) steps audibly. These
+ * interpolate instead:
+ *
+ *   AudioAmpSmooth, AudioMixer4Smooth  drop-in amplifier and mixer; a
+ *       new gain ramps linearly, sample by sample, over the slew time
+ *   FilterSmoother<F>  sits in front of a library filter; a new cutoff
+ *       ramps in octaves (resonance linearly) one audio block at a time,
+ *       from the audio clock's block callback (onAudioBlock)
+ *
+ * Slew times default to GAIN_SLEW_MS and FILTER_SLEW_MS. With the slew
+ * equal to the interval a control is written at, a stepped control comes
+ * out as a continuous piecewise-linear one, so a control can be written
+ * less often without stepping. gainNow(), frequencyNow() and
+ * resonanceNow() skip the ramp, for values that belong to a trigger
+ * (velocity, p-locks) and have to be in place as the note starts.
+ *
+ * modulate() scales a gain (or offsets a cutoff, in octaves) on top of
+ * what was set, for the modulation matrix (mod_matrix.h). It is written
+ * once per block and ramps over one block, while set values keep their
+ * own slew, and the set value itself is never changed.
+ *
+ * Every setter is safe from loop() and from the audio ISR: it only writes
+ * the target, and the audio update picks it up at its next block.
+ */
+
+#ifndef SMOOTHED_AUDIO_H
+#define SMOOTHED_AUDIO_H
+
+#include <Arduino.h>
+#include <Audio.h>
+#include <math.h>
+#include "config.h"
+
+// ============================================
+// GAIN RAMP
+// ============================================
+
+// One Q16 gain (65536 = unity), ramped per sample
+class GainRamp {
+public:
+    GainRamp();
+
+    void set(float gain);           // Ramp over the slew time
+    void setNow(float gain);        // At the next block, no ramp
+    void setMod(float factor);      // × the set gain, ramped over one block
+    void setSlew(float ms);
+
+    // Audio update, at the start of a block: picks up a new target.
+    // True if the gain is constant for the whole block.
+    bool beginBlock();
+    int32_t value() const { return current; }
+    // Gain for the next sample while ramping
+    int32_t next() {
+        if (remaining == 0) return current;
+        if (--remaining) {
+            acc += step;
+            current = (int32_t)(acc >> 16);
+        } else {
+            current = rampTarget;
+        }
+        return current;
+    }
+    // Advance over samples that were not rendered (no input)
+    void skip(uint32_t n) {
+        if (remaining > n) {
+            acc += step * n;
+            current = (int32_t)(acc >> 16);
+            remaining -= n;
+        } else {
+            current = rampTarget;
+            remaining = 0;
+        }
+    }
+
+    static int32_t toQ16(float gain);
+
+private:
+    volatile int32_t target;
+    volatile int32_t mod;           // Q16
+    volatile bool snap;
+    int32_t lastTarget;             // Set gain behind rampTarget
+    int32_t current;
+    int32_t rampTarget;
+    int64_t acc;                    // current, with 16 more fraction bits
+    int64_t step;
+    uint32_t remaining;             // Samples left in the ramp
+    uint32_t slewSamples;
+};
+
+// ============================================
+// AMPLIFIER AND MIXER
+// ============================================
+
+class AudioAmpSmooth : public AudioStream {
+public:
+    AudioAmpSmooth() : AudioStream(1, inputQueueArray) {}
+    virtual void update(void);
+
+    void gain(float n)    { ramp.set(n); }
+    void gainNow(float n) { ramp.setNow(n); }
+    void modulate(float factor) { ramp.setMod(factor); }
+    void slew(float ms)   { ramp.setSlew(ms); }
+
+private:
+    GainRamp ramp;
+    audio_block_t* inputQueueArray[1];
+};
+
+class AudioMixer4Smooth : public AudioStream {
+public:
+    AudioMixer4Smooth() : AudioStream(4, inputQueueArray) {}
+    virtual void update(void);
+
+    void gain(unsigned int channel, float n)    { if (channel < 4) ramp[channel].set(n); }
+    void gainNow(unsigned int channel, float n) { if (channel < 4) ramp[channel].setNow(n); }
+    void modulate(unsigned int channel, float factor) { if (channel < 4) ramp[channel].setMod(factor); }
+    void slew(float ms) {
+        for (int i = 0; i < 4; i++) ramp[i].setSlew(ms);
+    }
+
+private:
+    GainRamp ramp[4];
+    audio_block_t* inputQueueArray[4];
+};
+
+// ============================================
+// FILTER
+// ============================================
+
+// Cutoff and resonance ramps for a library filter with frequency() and
+// resonance() (AudioFilterStateVariable, AudioFilterLadder). begin()
+// sets both at once; update() runs once per audio block, before the
+// filter renders it.
+template <class Filter>
+class FilterSmoother {
+public:
+    FilterSmoother()
+        : filter(nullptr)
+        , targetOct(0.0f), targetRes(0.0f), modOct(0.0f), snap(false)
+        , octave(0.0f), res(0.0f), baseOct(0.0f), rampOct(0.0f), rampRes(0.0f)
+        , octStep(0.0f), resStep(0.0f), remaining(0)
+    {
+        setSlew(FILTER_SLEW_MS);
+    }
+
+    void begin(Filter* f, float freq, float q) {
+        filter = f;
+        frequencyNow(freq);
+        resonanceNow(q);
+        update();
+    }
+
+    void frequency(float freq)    { targetOct = log2f(freq > 1.0f ? freq : 1.0f); }
+    void frequencyNow(float freq) { frequency(freq); snap = true; }
+    void resonance(float q)       { targetRes = q; }
+    void resonanceNow(float q)    { targetRes = q; snap = true; }
+    void modulate(float octaves)  { modOct = octaves; }
+    void setSlew(float ms) {
+        float blocks = ms * AUDIO_SAMPLE_RATE_EXACT / (1000.0f * AUDIO_BLOCK_SAMPLES);
+        slewBlocks = blocks < 1.0f ? 1 : (uint16_t)(blocks + 0.5f);
+    }
+
+    float getFrequency() const { return exp2f(octave); }
+    float getResonance() const { return res; }
+    Filter* getFilter() const { return filter; }
+
+    void update() {
+        float base = targetOct;
+        float t = base + modOct;
+        float q = targetRes;
+        bool changed = false;
+
+        if (snap) {
+            snap = false;
+            octave = rampOct = t;
+            res = rampRes = q;
+            baseOct = base;
+            remaining = 0;
+            changed = true;
+        } else if (t != rampOct || q != rampRes) {
+            // Modulation alone moves in one block, or what is left of a
+            // ramp to a set value
+            if (base != baseOct || q != rampRes) remaining = slewBlocks;
+            else if (remaining == 0) remaining = 1;
+            baseOct = base;
+            rampOct = t;
+            rampRes = q;
+            octStep = (t - octave) / remaining;
+            resStep = (q - res) / remaining;
+        }
+
+        if (remaining) {
+            if (--remaining) {
+                octave += octStep;
+                res += resStep;
+            } else {
+                octave = rampOct;
+                res = rampRes;
+            }
+            changed = true;
+        }
+
+        if (changed && filter) {
+            filter->frequency(exp2f(octave));
+            filter->resonance(res);
+        }
+    }
+
+private:
+    Filter* filter;
+    volatile float targetOct;       // log2(Hz)
+    volatile float targetRes;
+    volatile float modOct;
+    volatile bool snap;
+    float octave, res;              // Last written to the filter
+    float baseOct;                  // targetOct behind rampOct
+    float rampOct, rampRes;         // Where the current ramp ends
+    float octStep, resStep;
+    uint16_t remaining;             // Blocks left in the ramp
+    uint16_t slewBlocks;
+};
+
+// Per-track filters and the synth filter
+typedef FilterSmoother<AudioFilterStateVariable> StateVariableSmoother;
+typedef FilterSmoother<AudioFilterLadder>        LadderSmoother;
+
+#endif // SMOOTHED_AUDIO_H
@@ -0,0 +1,85 @@
+/**
+ * Oh My Ondas - SPSC Queue
+ * Fixed-size, lock-free single-producer/single-consumer ring buffer
+ *
+ * One context may push (e.g. loop()), one other context may pop (e.g. the
+ * audio ISR). No locks and no interrupt masking: the producer only writes
+ * `head`, the consumer only writes `tail`, and acquire/release ordering
+ * makes an item visible before the index that publishes it.
+ *
+ * Header-only and free of Arduino includes so it also builds on the host
+ * (see test/native/test_spsc_queue.cpp).
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint16_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SPSCQueue capacity must be a power of 2");
+    static_assert(Capacity <= 32768, "SPSCQueue capacity must fit 16-bit indices");
+
+public:
+    SPSCQueue() : head(0), tail(0) {}
+
+    // ── Producer side ──
+
+    bool push(const T& item) {
+        uint16_t h = head.load(std::memory_order_relaxed);
+        uint16_t t = tail.load(std::memory_order_acquire);
+        if ((uint16_t)(h - t) >= Capacity) return false;  // Full
+        items[h & (Capacity - 1)] = item;
+        head.store((uint16_t)(h + 1), std::memory_order_release);
+        return true;
+    }
+
+    // ── Consumer side ──
+
+    bool pop(T& item) {
+        uint16_t t = tail.load(std::memory_order_relaxed);
+        uint16_t h = head.load(std::memory_order_acquire);
+        if (h == t) return false;  // Empty
+        item = items[t & (Capacity - 1)];
+        tail.store((uint16_t)(t + 1), std::memory_order_release);
+        return true;
+    }
+
+    // Oldest item without removing it, or nullptr when empty
+    const T* front() const {
+        uint16_t t = tail.load(std::memory_order_relaxed);
+        uint16_t h = head.load(std::memory_order_acquire);
+        if (h == t) return nullptr;
+        return &items[t & (Capacity - 1)];
+    }
+
+    // Remove the item returned by front()
+    void drop() {
+        uint16_t t = tail.load(std::memory_order_relaxed);
+        tail.store((uint16_t)(t + 1), std::memory_order_release);
+    }
+
+    // Discard everything currently queued
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // ── Either side (snapshot, may be stale by the time it is used) ──
+
+    uint16_t size() const {
+        return (uint16_t)(head.load(std::memory_order_acquire)
+                        - tail.load(std::memory_order_acquire));
+    }
+    bool empty() const { return size() == 0; }
+    static uint16_t capacity() { return Capacity; }
+
+private:
+    T items[Capacity];
+    std::atomic<uint16_t> head;   // Next slot to write (free-running)
+    std::atomic<uint16_t> tail;   // Next slot to read (free-running)
+};
+
+#endif // SPSC_QUEUE_H
@@ -1,6 +1,15 @@
 /**
  * Oh My Ondas - Synth Voice
  * Dual-oscillator synthesizer with Moog ladder filter and ADSR envelope
+ *
+ * Both oscillators are band-limited wavetable oscillators
+ * (wavetable_osc.h); a WAVEFORM_ type picks a built-in shape, and osc 1
+ * can also play a user wavetable and morph across its frames.
+ *
+ * One voice of the PolySynth pool (poly_synth.h). A voice sounds from
+ * noteOn() until its envelope has finished the release; then update()
+ * parks it: oscillators and noise off, so the mixer, filter and envelope
+ * get no input and cost next to nothing until the next note.
  */
 
 #ifndef SYNTH_VOICE_H
@@ -9,27 +18,45 @@
 #include <Arduino.h>
 #include <Audio.h>
 #include "config.h"
+#include "smoothed_audio.h"
+#include "wavetable_osc.h"
+
+// Filter and envelope a note starts with: the synth's settings, or a
+// sequencer step's locks on top of them
+struct SynthNoteParams {
+    float filterFreq;       // Hz
+    float filterRes;
+    float attack;           // ms
+    float decay;            // ms
+    float sustain;          // 0..1
+    float release;          // ms
+};
 
 class SynthVoice {
 public:
     SynthVoice();
 
-    void begin(AudioSynthWaveform* osc1,
-               AudioSynthWaveform* osc2,
-               AudioSynthNoiseWhite* noise,
-               AudioMixer4* mixer,
-               AudioFilterLadder* filter,
+    // noise is shared by every voice; the voice only sets its mixer channel
+    void begin(AudioSynthWavetableOsc* osc1,
+               AudioSynthWavetableOsc* osc2,
+               AudioMixer4Smooth* mixer,
+               LadderSmoother* filter,
                AudioEffectEnvelope* envelope);
 
-    void update();  // Call from main loop for LFO
-
-    // Note control
+    // Note control. noteOn() on a sounding voice retriggers it from where
+    // the envelope is
     void noteOn(float freq, float velocity);
     void noteOff();
+    // Release over SYNTH_STEAL_MS, for a voice being stolen or shed
+    void kill();
+    // Filter (no ramp) and envelope for the next noteOn()
+    void setNoteParams(const SynthNoteParams& params);
 
     // Oscillator settings
     void setOsc1Waveform(int waveform);
     void setOsc2Waveform(int waveform);
+    void setOsc1Wavetable(const Wavetable* table);
+    void setOsc1Morph(float position);         // Frames, 0 .. frames - 1
     void setOsc1Level(float level);
     void setOsc2Level(float level);
     void setNoiseLevel(float level);
@@ -45,33 +72,48 @@ public:
     void setSustain(float level);
     void setRelease(float ms);
 
-    // LFO
-    void setLFORate(float hz);
-    void setLFODepth(float depth);
-    void setLFOTarget(int target);  // 0=pitch, 1=filter, 2=amplitude
+    // Offsets from the mod matrix (MOD_DST_SYNTH_PITCH, _CUTOFF), from the
+    // audio ISR once per block
+    void modulatePitch(float semitones);
+    void modulateCutoff(float octaves);
+
+    // Audio ISR, once per block after the modulation: filter ramp, and
+    // parks the voice once the envelope has finished
+    void update();
 
     // State
-    bool isActive();
+    bool isActive() const { return sounding; }     // Held or releasing
+    bool isHeld() const { return held; }
+    bool isKilled() const { return killed; }
+    float getVelocity() const { return velocity; }
+    float getFilterFreq() const { return filterFreq; }
+    float getRelease() const { return releaseMs; }
+    float getOsc1Morph() const { return osc1 ? osc1->getMorph() : 0.0f; }
+    // This voice's objects in the last audio update, % of a block
+    float processorUsage();
 
 private:
-    AudioSynthWaveform* osc1;
-    AudioSynthWaveform* osc2;
-    AudioSynthNoiseWhite* noise;
-    AudioMixer4* mixer;
-    AudioFilterLadder* filter;
+    AudioSynthWavetableOsc* osc1;
+    AudioSynthWavetableOsc* osc2;
+    AudioMixer4Smooth* mixer;
+    LadderSmoother* filter;
     AudioEffectEnvelope* envelope;
 
     float baseFreq;
     float osc2DetuneRatio;
     float filterFreq;
-    bool active;
-
-    // LFO
-    float lfoRate;
-    float lfoDepth;
-    int lfoTarget;
-    float lfoPhase;
-    unsigned long lastLFOUpdate;
+    float noiseLevel;
+    float releaseMs;        // As initAudioGraph() sets it
+    float velocity;
+    volatile bool sounding;
+    volatile bool held;
+    volatile bool killed;
+
+    float pitchMod;         // Semitones
+    volatile float pitchRatio;
+
+    void setOscFrequencies();
+    void park();
 };
 
 #endif // SYNTH_VOICE_H
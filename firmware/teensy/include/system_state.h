@@ -22,6 +22,8 @@ struct SystemState {
     bool isRecording = false;
     bool shiftPressed = false;
     uint8_t currentPattern = 0;
+    int8_t queuedPattern = -1;      // Waiting for the bar/pattern boundary
+    uint8_t stepPage = 0;           // Pattern screen page (STEPS_PER_PAGE steps)
     uint8_t currentScene = 0;
     float masterVolume = 0.8f;
     float bpm = 120.0f;
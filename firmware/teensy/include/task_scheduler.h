@@ -0,0 +1,97 @@
+/**
+ * Oh My Ondas - Task Scheduler
+ * Cooperative main-loop scheduler with priorities, deadlines and per-task timing
+ *
+ * loop() calls run() and nothing else. Each pass runs every per-pass task
+ * (period 0: input, sequencer dispatch, audio parameters) in the order
+ * added, then exactly one slice of the most urgent ready periodic task:
+ * highest priority first, earliest release among equals. A periodic task
+ * is released every period; its job may take several slices, returning
+ * false from each one until the last returns true. Long jobs (an LCD
+ * frame, an OLED push, SD writes) are split that way, so the time from
+ * one input poll to the next is bounded by the longest slice, not the
+ * longest job. A higher-priority release takes over between slices.
+ *
+ * Timing comes from micros(). Per task: slice and job execution time
+ * (worst, average), release-to-completion response time, and deadline
+ * misses; per pass: the worst pass time, which is the input latency.
+ */
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// One slice of work: true when the job is finished, false to be
+// called again on a later pass
+typedef bool (*TaskFunction)();
+
+enum TaskPriority : uint8_t {
+    TASK_PRIO_HIGH = 0,     // Must keep up with audio (recorder drain)
+    TASK_PRIO_NORMAL,       // User-facing (LCD, LEDs, ESP32 link)
+    TASK_PRIO_LOW,          // Background (OLED map, logging)
+    TASK_PRIO_COUNT
+};
+
+struct TaskStats {
+    uint32_t jobs;              // Completed
+    uint32_t slices;
+    uint32_t worstSliceUs;
+    uint32_t worstJobUs;        // Execution time, all slices of one job
+    uint64_t totalUs;           // Execution time, all slices ever
+    uint32_t worstResponseUs;   // Release to completion
+    uint32_t deadlineMisses;
+    uint32_t skipped;           // Releases dropped after falling a period behind
+
+    uint32_t averageSliceUs() const { return slices ? (uint32_t)(totalUs / slices) : 0; }
+    uint32_t averageJobUs() const { return jobs ? (uint32_t)(totalUs / jobs) : 0; }
+};
+
+struct Task {
+    const char* name;
+    TaskFunction function;
+    uint32_t periodUs;          // 0: every pass
+    uint32_t deadlineUs;        // After release; 0: none
+    TaskPriority priority;
+
+    uint32_t release;           // micros() of the current or next release
+    bool inJob;                 // Sliced job in progress
+    uint32_t jobUs;             // Execution time of the job so far
+    TaskStats stats;
+};
+
+class TaskScheduler {
+public:
+    TaskScheduler();
+
+    // Period and deadline in ms; deadline 0 means the period. Returns
+    // the task id, or -1 if MAX_TASKS are already added.
+    int addEveryPass(const char* name, TaskFunction function);
+    int addPeriodic(const char* name, TaskFunction function, uint32_t periodMs,
+                    TaskPriority priority, uint32_t deadlineMs = 0);
+
+    // One pass of loop()
+    void run();
+
+    // Statistics
+    int getTaskCount() const { return count; }
+    const Task& getTask(int id) const { return tasks[id]; }
+    uint32_t getWorstPassUs() const { return worstPassUs; }
+    uint32_t getPasses() const { return passes; }
+    void resetStats();
+    void printStats(Print& out);
+
+private:
+    Task tasks[MAX_TASKS];
+    int count;
+    uint32_t worstPassUs;
+    uint32_t passes;
+
+    int add(const char* name, TaskFunction function, uint32_t periodUs,
+            TaskPriority priority, uint32_t deadlineUs);
+    int pickReady(uint32_t now);
+    void runSlice(Task& t);
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,45 @@
+/**
+ * Oh My Ondas - Trig RNG
+ * Small seedable generator for probability trig conditions
+ *
+ * xorshift32: three shifts and three XORs per draw, no division, and the
+ * whole state is one word, so each track can own a generator and a run is
+ * reproduced exactly from its seed. Seeds go through a splitmix32 finalizer
+ * first, so neighbouring seeds (track 0, 1, 2...) give unrelated streams
+ * and a zero seed cannot stall the generator.
+ *
+ * Header-only and free of Arduino includes so it also builds on the host.
+ */
+
+#ifndef TRIG_RNG_H
+#define TRIG_RNG_H
+
+#include <stdint.h>
+
+struct TrigRng {
+    uint32_t state;
+};
+
+inline void trigRngSeed(TrigRng& r, uint32_t seed) {
+    seed += 0x9E3779B9UL;
+    seed = (seed ^ (seed >> 16)) * 0x85EBCA6BUL;
+    seed = (seed ^ (seed >> 13)) * 0xC2B2AE35UL;
+    seed ^= seed >> 16;
+    r.state = seed ? seed : 0x6D2B79F5UL;
+}
+
+inline uint32_t trigRngNext(TrigRng& r) {
+    uint32_t x = r.state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    r.state = x;
+    return x;
+}
+
+// 0-99, evenly spread (multiply-shift instead of a modulo)
+inline uint8_t trigRngPercent(uint32_t draw) {
+    return (uint8_t)(((uint64_t)draw * 100) >> 32);
+}
+
+#endif // TRIG_RNG_H
@@ -0,0 +1,53 @@
+/**
+ * Oh My Ondas - Wavetable Bank
+ * User wavetables loaded from SD into PSRAM for the synth oscillators
+ *
+ * A user wavetable is a 16-bit PCM WAV of back-to-back single cycles,
+ * WT_TABLE_SIZE (2048) samples each, the layout most wavetable editors
+ * export; channel 0 is used. Each cycle is turned into a band-limited
+ * frame at load time: a forward FFT gives its harmonics, then
+ * wtBuildFrame() builds every mip level from them as it does for the
+ * built-in frames. Frames are normalized one by one to full scale.
+ *
+ * Frames live in PSRAM (extmem_malloc(), the heap without PSRAM) within
+ * WAVETABLE_PSRAM_BUDGET for all slots, up to WAVETABLE_MAX_FRAMES per
+ * table. Loading takes a few ms per frame and belongs in loop(), never
+ * the audio ISR. Reloading a slot that oscillators are playing is safe:
+ * the new frames are swapped in with the ISR held off before the old
+ * ones are freed.
+ */
+
+#ifndef WAVETABLE_BANK_H
+#define WAVETABLE_BANK_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "wavetables.h"
+
+class WavetableBank {
+public:
+    WavetableBank();
+
+    // /wavetables/wtNN.wav into slot NN for every slot; returns how many loaded
+    int begin();
+
+    bool load(int slot, const char* path);
+    void unload(int slot);
+
+    // nullptr if the slot is empty. The pointer stays valid across reloads
+    const Wavetable* get(int slot) const;
+    int getFrames(int slot) const;
+    uint32_t getBytesUsed() const { return bytesUsed; }
+
+    static void slotPath(int slot, char* path, size_t size);
+
+private:
+    Wavetable tables[WAVETABLE_SLOTS];
+    uint32_t bytesUsed;
+
+    bool buildFrames(File& file, uint32_t dataOffset, uint16_t channels,
+                     int frames, int16_t* dest);
+};
+
+#endif // WAVETABLE_BANK_H
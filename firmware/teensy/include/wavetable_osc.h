@@ -0,0 +1,60 @@
+/**
+ * Oh My Ondas - Wavetable Oscillator
+ * Band-limited wavetable oscillator with morphing, for the synth voices
+ *
+ * Replaces AudioSynthWaveform in the synth, whose naive saw and square
+ * alias badly at high pitches. It plays a Wavetable (wavetables.h): the
+ * mip level is picked from the frequency, so no harmonic above Nyquist
+ * is ever read, and morph() scans across the table's frames, crossfading
+ * between neighbours. A new morph position ramps over one block.
+ *
+ * Fixed point throughout: 32-bit phase (2^32 = one cycle), Q15 table
+ * points interpolated linearly with a 15-bit fraction, frame position in
+ * Q16. begin()/frequency()/amplitude() match AudioSynthWaveform; begin()
+ * with a WAVEFORM_ type selects that shape of wavetableBasic.
+ *
+ * test/native/bench_wavetable_osc.cpp gives cycles per block and the
+ * aliasing against the stock oscillator on the host.
+ */
+
+#ifndef WAVETABLE_OSC_H
+#define WAVETABLE_OSC_H
+
+#include <Arduino.h>
+#include <AudioStream.h>
+#include "wavetables.h"
+
+class AudioSynthWavetableOsc : public AudioStream {
+public:
+    AudioSynthWavetableOsc();
+
+    // As AudioSynthWaveform; type: WAVEFORM_SINE, _TRIANGLE, _SAWTOOTH or
+    // _SQUARE, anything else plays the saw
+    void begin(short type);
+    void begin(float amp, float freq, short type);
+    void frequency(float freq);
+    void amplitude(float n);
+
+    // Table to play (nullptr: silent). From loop(): once this returns the
+    // old table is no longer read
+    void setWavetable(const Wavetable* table);
+    const Wavetable* getWavetable() const { return table; }
+    // Frame position, 0 .. frames - 1 (fractions crossfade)
+    void morph(float position);
+    float getMorph() const { return morphTarget * (1.0f / 65536.0f); }
+
+    virtual void update(void);
+
+private:
+    const Wavetable* volatile table;
+    uint32_t phase;
+    volatile uint32_t increment;
+    volatile uint8_t level;             // Mip level for increment
+    volatile int32_t magnitude;         // Q16
+    volatile int32_t morphTarget;       // Q16 frame position
+    int32_t morphPos;                   // Where the last block ended
+
+    static uint8_t levelFor(float freq);
+};
+
+#endif // WAVETABLE_OSC_H
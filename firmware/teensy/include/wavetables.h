@@ -0,0 +1,199 @@
+/**
+ * Oh My Ondas - Wavetables
+ * Band-limited, mip-mapped wavetable frames for the synth oscillator
+ *
+ * A frame is one cycle of a waveform stored at WT_LEVELS band limits, one
+ * per octave of fundamental. Level L is played for fundamentals up to
+ * WT_BASE_HZ·2^L and holds only the harmonics that stay below Nyquist
+ * there, so nothing the oscillator reads can alias. The table for a level
+ * needs just over two points per harmonic, so level sizes halve with the
+ * harmonic count (2048, 1024, 512, then WT_MIN_BITS points) and a frame
+ * is WT_FRAME_POINTS Q15 values, each level followed by a guard point.
+ *
+ * The levels are built from the waveform's harmonic series by an inverse
+ * FFT (wtBuildFrame()), scaled once across all levels so the loudness
+ * does not change from octave to octave. The built-in frames (sine,
+ * triangle, saw, square) are computed by constexpr code at compile time
+ * and live in flash (wavetables.cpp). User frames go through the same
+ * code at load time (WavetableBank) after a forward FFT of the cycle.
+ *
+ * Below the top octave of its level a note has less than the full
+ * bandwidth: between Nyquist/2 and Nyquist at worst.
+ *
+ * Header free of Arduino includes so it also builds on the host.
+ */
+
+#ifndef WAVETABLES_H
+#define WAVETABLES_H
+
+#include <stdint.h>
+#include "lfo_tables.h"
+
+#define WT_TABLE_BITS 11            // Level 0: 2048 points, the user frame size
+#define WT_TABLE_SIZE (1 << WT_TABLE_BITS)
+#define WT_MIN_BITS 8               // Smallest level: 256 points
+#define WT_LEVELS 10                // Octaves of fundamental
+#define WT_BASE_HZ 40.0             // Top fundamental of level 0
+#define WT_NYQUIST 22050.0
+
+// Points per level, and where each starts in a frame
+constexpr int wtLevelBits(int level) {
+    return WT_TABLE_BITS - level > WT_MIN_BITS ? WT_TABLE_BITS - level : WT_MIN_BITS;
+}
+
+constexpr int wtLevelOffset(int level) {
+    int offset = 0;
+    for (int l = 0; l < level; l++) offset += (1 << wtLevelBits(l)) + 1;
+    return offset;
+}
+
+#define WT_FRAME_POINTS wtLevelOffset(WT_LEVELS)
+
+// Highest harmonic level L may hold
+constexpr int wtHarmonics(int level) {
+    return (int)(WT_NYQUIST / (WT_BASE_HZ * (1 << level)));
+}
+
+static_assert(2 * wtHarmonics(0) < WT_TABLE_SIZE, "level 0 too small for its harmonics");
+
+// A set of frames, morphed across by position. data points at frame 0;
+// frame f starts WT_FRAME_POINTS·f further on
+struct Wavetable {
+    const int16_t* data;
+    uint16_t frames;
+};
+
+// One frame, as the built-in tables are stored
+struct WtFrame {
+    int16_t v[WT_FRAME_POINTS];
+};
+
+enum WtShape : uint8_t {
+    WT_SHAPE_SINE,
+    WT_SHAPE_TRIANGLE,
+    WT_SHAPE_SAW,           // 0 at phase 0, rising, like WAVEFORM_SAWTOOTH
+    WT_SHAPE_SQUARE,
+    WT_SHAPE_COUNT
+};
+
+// Built-in frames in WtShape order, and the table morphing across them
+extern const WtFrame wtBasicFrames[WT_SHAPE_COUNT];
+extern const Wavetable wavetableBasic;
+
+// ============================================
+// FFT (compile time and load time)
+// ============================================
+
+// In-place radix-2 complex FFT of 2^bits points. inverse: e^{+i}, no 1/N
+template <class T>
+constexpr void wtFft(T* re, T* im, int bits, bool inverse) {
+    const int n = 1 << bits;
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            T t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        for (int k = 0; k < len / 2; k++) {
+            T wr = (T)lfoSinTurn(4 * k + len, 4 * len);     // cos(2πk/len)
+            T wi = (T)lfoSinTurn(k, len);
+            if (!inverse) wi = -wi;
+            for (int i = k; i < n; i += len) {
+                int j = i + len / 2;
+                T xr = re[j] * wr - im[j] * wi;
+                T xi = re[j] * wi + im[j] * wr;
+                re[j] = re[i] - xr;
+                im[j] = im[i] - xi;
+                re[i] += xr;
+                im[i] += xi;
+            }
+        }
+    }
+}
+
+// Work space for one frame: a level at a time, then the finished levels
+template <class T>
+struct WtScratch {
+    T re[WT_TABLE_SIZE];
+    T im[WT_TABLE_SIZE];
+    T frame[WT_FRAME_POINTS];
+};
+
+// Every level from harmonic coefficients: the waveform is
+// Σ a[k]·cos(2πk·t) + b[k]·sin(2πk·t), k = 1..WT_TABLE_SIZE/2 - 1.
+// Q15 out, peak at 32767 over the whole frame
+template <class T>
+constexpr void wtBuildFrame(const T* a, const T* b, WtScratch<T>& s, int16_t* out) {
+    T peak = 0;
+    for (int level = 0; level < WT_LEVELS; level++) {
+        const int bits = wtLevelBits(level);
+        const int n = 1 << bits;
+        const int kmax = wtHarmonics(level);
+        for (int k = 0; k < n; k++) {
+            bool keep = k >= 1 && k <= kmax && k < WT_TABLE_SIZE / 2;
+            s.re[k] = keep ? a[k] : 0;
+            s.im[k] = keep ? -b[k] : 0;
+        }
+        wtFft(s.re, s.im, bits, true);
+
+        T* dst = &s.frame[wtLevelOffset(level)];
+        for (int i = 0; i < n; i++) {
+            dst[i] = s.re[i];
+            T m = dst[i] < 0 ? -dst[i] : dst[i];
+            if (m > peak) peak = m;
+        }
+        dst[n] = dst[0];
+    }
+
+    T scale = peak > 0 ? (T)32767 / peak : 0;
+    for (int i = 0; i < WT_FRAME_POINTS; i++) {
+        T v = s.frame[i] * scale;
+        out[i] = (int16_t)(v >= 0 ? v + (T)0.5 : v - (T)0.5);
+    }
+}
+
+// ============================================
+// BUILT-IN FRAMES (compile time)
+// ============================================
+
+struct WtSeries {
+    double a[WT_TABLE_SIZE / 2];
+    double b[WT_TABLE_SIZE / 2];
+};
+
+constexpr WtSeries wtShapeSeries(WtShape shape) {
+    const double pi = 3.141592653589793;
+    WtSeries s{};
+    for (int k = 1; k < WT_TABLE_SIZE / 2; k++) {
+        bool odd = k & 1;
+        switch (shape) {
+            case WT_SHAPE_SINE:
+                s.b[k] = k == 1 ? 1.0 : 0.0;
+                break;
+            case WT_SHAPE_TRIANGLE:
+                s.b[k] = odd ? ((k & 2) ? -8.0 : 8.0) / (pi * pi * k * k) : 0.0;
+                break;
+            case WT_SHAPE_SAW:
+                s.b[k] = (odd ? 2.0 : -2.0) / (pi * k);
+                break;
+            default:
+                s.b[k] = odd ? 4.0 / (pi * k) : 0.0;
+                break;
+        }
+    }
+    return s;
+}
+
+constexpr WtFrame wtMakeFrame(WtShape shape) {
+    WtFrame f{};
+    WtSeries series = wtShapeSeries(shape);
+    WtScratch<double> scratch{};
+    wtBuildFrame(series.a, series.b, scratch, f.v);
+    return f;
+}
+
+#endif // WAVETABLES_H
@@ -16,30 +16,64 @@ static const int8_t QUAD_TABLE[4][4] = {
 // MCP23017 registers
 #define MCP_IODIRA   0x00
 #define MCP_IODIRB   0x01
+#define MCP_GPINTENA 0x04
+#define MCP_GPINTENB 0x05
+#define MCP_IOCON    0x0A
 #define MCP_GPPUA    0x0C
 #define MCP_GPPUB    0x0D
+#define MCP_INTFA    0x0E   // INTFA, INTFB, INTCAPA, INTCAPB, GPIOA, GPIOB
 #define MCP_GPIOA    0x12
 #define MCP_GPIOB    0x13
+#define MCP_IOCON_MIRROR 0x40   // INTA and INTB both signal either port
+#define MCP_IOCON_ODR    0x04   // Open drain, so both chips share one pin
 
 // ADS1115 registers and config
-#define ADS_REG_CONVERT  0x00
-#define ADS_REG_CONFIG   0x01
-#define ADS_CONFIG_OS     0x8000  // Start conversion
+#define ADS_REG_CONVERT   0x00
+#define ADS_REG_CONFIG    0x01
+#define ADS_REG_LO_THRESH 0x02
+#define ADS_REG_HI_THRESH 0x03
 #define ADS_CONFIG_MUX(c) ((uint16_t)(0x4000 | ((c) << 12)))  // Single-ended
 #define ADS_CONFIG_PGA_4V 0x0200  // +/-4.096V
-#define ADS_CONFIG_MODE   0x0100  // Single-shot
+#define ADS_CONFIG_CONT   0x0000  // Continuous conversion
 #define ADS_CONFIG_DR_860 0x00E0  // 860 SPS
-#define ADS_CONFIG_COMP   0x0003  // Disable comparator
+#define ADS_CONFIG_RDY    0x0000  // Comparator on, assert after one conversion:
+                                  // with Hi_thresh MSB 1 and Lo_thresh MSB 0,
+                                  // ALERT/RDY pulses low at every result
+#define ADS_CONVERT_US    1163    // 1 / 860 SPS
+
+// A pulse sooner than this after a channel switch still belongs to the
+// conversion that was running during the switch
+#define ADS_STALE_US       (ADS_CONVERT_US * 3 / 4)
+// No pulse by then (ALERT/RDY not wired): read on time instead
+#define ADS_RDY_TIMEOUT_US (ADS_CONVERT_US * 4)
+
+// MPR121 touch status (electrodes 0-11, low byte first)
+#define MPR121_TOUCHSTATUS 0x00
+
+// Round robin: switch to a channel, wait for its result, read it, next
+enum AdsPhase : uint8_t {
+    ADS_SELECT = 0,     // Channel switch to queue
+    ADS_CONFIG,         // Channel switch queued
+    ADS_CONVERTING,     // Waiting for ALERT/RDY
+    ADS_READING         // Result read queued
+};
+
+static volatile uint32_t adsAlertCount = 0;
+static volatile uint32_t adsAlertAt = 0;
 
 InputManager::InputManager()
     : encoderCB(nullptr), buttonCB(nullptr), faderCB(nullptr)
     , joystickCB(nullptr), touchCB(nullptr)
+    , faderReports(0), faderLatencySum(0), faderLatencyPeak(0)
     , joystickState(JOY_NONE), joystickLastState(JOY_NONE)
     , touchLast(0), touchReady(false)
-    , mcpAReady(false), mcpBReady(false)
-    , adsReady(false), adsCurrentChannel(0)
+    , mcpAReady(false), mcpBReady(false), mcpBRecheck(false), mcpBRecheckAt(0)
+    , adsReady(false), adsCurrentChannel(0), adsPhase(ADS_SELECT)
+    , adsMuxAt(0), adsSeenAlerts(0), adsSampleAt(0)
+    , bus(nullptr), mcpAPending(false), mcpBPending(false), touchPending(false)
     , i2cErrorCount(0), mcpALastGood(0xFFFF), mcpBLastGood(0xFFFF)
-    , lastEncoderPoll(0), lastButtonPoll(0), lastFaderPoll(0)
+    , lastEncoderPoll(0), lastButtonPoll(0), lastFaderPoll(0), lastTouchPoll(0)
+    , lastMcpPoll(0)
 {
     memset(directEncPositions, 0, sizeof(directEncPositions));
     memset(mcpEncLastState, 0, sizeof(mcpEncLastState));
@@ -48,7 +82,6 @@ InputManager::InputManager()
     memset(buttonLastStates, 0, sizeof(buttonLastStates));
     memset(buttonDebounce, 0, sizeof(buttonDebounce));
     memset(faderValues, 0, sizeof(faderValues));
-    memset(faderLastValues, 0, sizeof(faderLastValues));
 
     memset(adsLastGood, 0, sizeof(adsLastGood));
 
@@ -57,8 +90,9 @@ InputManager::InputManager()
     }
 }
 
-void InputManager::begin() {
+void InputManager::begin(I2cBus* i2c) {
     DEBUG_PRINTLN("InputManager: Initializing...");
+    bus = i2c;
 
     initDirectEncoders();
     initMCP23017();
@@ -73,27 +107,53 @@ void InputManager::begin() {
 void InputManager::update() {
     unsigned long now = millis();
 
-    // Touch pads: every loop (low latency)
-    pollTouch();
+    // Touch pads: every 1ms (low latency)
+    if (now - lastTouchPoll >= TOUCH_POLL_MS) {
+        if (touchReady) requestTouch();
+        lastTouchPoll = now;
+    }
 
-    // MCP encoders: fast polling (every 2ms)
+    // Direct encoders: every 2ms
     if (now - lastEncoderPoll >= ENCODER_POLL_MS) {
         pollDirectEncoders();
-        if (mcpAReady) pollMCPEncoders();
+#if MCP_INT_PIN < 0
+        if (mcpAReady) requestMCPEncoders();
+#endif
         lastEncoderPoll = now;
     }
 
+#if MCP_INT_PIN >= 0
+    // MCP expanders: only while one holds INT low. The encoder read shows
+    // which chip it was and queues the button read if it was not MCP#1.
+    if (digitalRead(MCP_INT_PIN) == LOW && !mcpAPending && !mcpBPending) {
+        if (mcpAReady) requestMCPEncoders();
+        else if (mcpBReady) requestMCPButtons();
+    }
+    if (now - lastMcpPoll >= MCP_SAFETY_POLL_MS) {
+        if (mcpAReady) requestMCPEncoders();
+        if (mcpBReady) requestMCPButtons();
+        lastMcpPoll = now;
+    }
+#endif
+    if (mcpBRecheck && (long)(now - mcpBRecheckAt) >= 0) {
+        mcpBRecheck = false;
+        if (mcpBReady) requestMCPButtons();
+    }
+
     // Buttons + joystick: every 10ms
     if (now - lastButtonPoll >= 10) {
         pollDirectButtons();
-        if (mcpBReady) pollMCPButtons();
+#if MCP_INT_PIN < 0
+        if (mcpBReady) requestMCPButtons();
+#endif
         pollJoystick();
         lastButtonPoll = now;
     }
 
-    // Faders: every 20ms (50Hz, smooth enough)
-    if (now - lastFaderPoll >= 20) {
-        pollFaders();
+    // Faders: whenever the ADS1115 has a result; crossfader every 5ms
+    if (adsReady) pollADS();
+    if (now - lastFaderPoll >= CROSSFADER_POLL_MS) {
+        pollCrossfader();
         lastFaderPoll = now;
     }
 }
@@ -133,6 +193,12 @@ void InputManager::initMCP23017() {
         mcpWrite8(ADDR_MCP23017A, MCP_IODIRB, 0xFF);  // Port B: all input
         mcpWrite8(ADDR_MCP23017A, MCP_GPPUA,  0xFF);  // Port A: pull-ups
         mcpWrite8(ADDR_MCP23017A, MCP_GPPUB,  0xFF);  // Port B: pull-ups
+#if MCP_INT_PIN >= 0
+        // Interrupt on any change of any pin (INTCON 0: against the last value)
+        mcpWrite8(ADDR_MCP23017A, MCP_IOCON,    MCP_IOCON_MIRROR | MCP_IOCON_ODR);
+        mcpWrite8(ADDR_MCP23017A, MCP_GPINTENA, 0xFF);
+        mcpWrite8(ADDR_MCP23017A, MCP_GPINTENB, 0xFF);
+#endif
         mcpAReady = true;
 
         // Read initial state for encoders
@@ -156,18 +222,39 @@ void InputManager::initMCP23017() {
         mcpWrite8(ADDR_MCP23017B, MCP_IODIRB, 0xFF);
         mcpWrite8(ADDR_MCP23017B, MCP_GPPUA,  0xFF);
         mcpWrite8(ADDR_MCP23017B, MCP_GPPUB,  0xFF);
+#if MCP_INT_PIN >= 0
+        mcpWrite8(ADDR_MCP23017B, MCP_IOCON,    MCP_IOCON_MIRROR | MCP_IOCON_ODR);
+        mcpWrite8(ADDR_MCP23017B, MCP_GPINTENA, 0xFF);
+        mcpWrite8(ADDR_MCP23017B, MCP_GPINTENB, 0xFF);
+#endif
         mcpBReady = true;
         DEBUG_PRINTLN("  MCP23017 #2 (buttons): OK");
     } else {
         DEBUG_PRINTLN("  MCP23017 #2 (buttons): NOT FOUND");
     }
+
+#if MCP_INT_PIN >= 0
+    // Both open-drain INT outputs on one pin; the first update() reads both
+    pinMode(MCP_INT_PIN, INPUT_PULLUP);
+#endif
 }
 
 void InputManager::initADS1115() {
     Wire.beginTransmission(ADDR_ADS1115);
     if (Wire.endTransmission() == 0) {
+        // Conversion-ready mode, then continuous conversion on channel 0
+        adsWrite16(ADS_REG_LO_THRESH, 0x0000);
+        adsWrite16(ADS_REG_HI_THRESH, 0x8000);
+        adsWrite16(ADS_REG_CONFIG, ADS_CONFIG_MUX(0) | ADS_CONFIG_PGA_4V | ADS_CONFIG_CONT
+                                 | ADS_CONFIG_DR_860 | ADS_CONFIG_RDY);
+        adsCurrentChannel = 0;
+        adsMuxAt = micros();
+        adsPhase = ADS_CONVERTING;
+
+        pinMode(ADS_ALERT_PIN, INPUT_PULLUP);   // Open drain
+        attachInterrupt(digitalPinToInterrupt(ADS_ALERT_PIN), onADSAlert, FALLING);
         adsReady = true;
-        DEBUG_PRINTLN("  ADS1115 (faders): OK");
+        DEBUG_PRINTLN("  ADS1115 (faders): OK, continuous");
     } else {
         DEBUG_PRINTLN("  ADS1115 (faders): NOT FOUND");
     }
@@ -225,34 +312,62 @@ void InputManager::pollDirectEncoders() {
     }
 }
 
-void InputManager::pollMCPEncoders() {
-    // Read all 16 pins in one I2C transaction
-    uint16_t pins;
-    if (!mcpRead16(ADDR_MCP23017A, MCP_GPIOA, pins)) {
-        pins = mcpALastGood;  // same state → quadrature decode yields 0 = safe
+void InputManager::requestMCPEncoders() {
+    // All 16 pins in one transfer; skip the read if the last is still queued.
+    // On interrupt: INTF and INTCAP (reading it releases INT) ahead of GPIO.
+    if (!bus || mcpAPending) return;
+#if MCP_INT_PIN >= 0
+    mcpAPending = bus->readReg(ADDR_MCP23017A, MCP_INTFA, 6, onMCPEncoders, this);
+#else
+    mcpAPending = bus->readReg(ADDR_MCP23017A, MCP_GPIOA, 2, onMCPEncoders, this);
+#endif
+}
+
+void InputManager::onMCPEncoders(const I2cTransfer& t, void* ctx) {
+    InputManager* self = (InputManager*)ctx;
+    self->mcpAPending = false;
+    if (!t.ok()) {
+        self->i2cErrorCount++;  // same state → quadrature decode yields 0 = safe
+        return;
+    }
+    if (t.rxLen == 6) {
+        uint16_t flags = t.rx[0] | (t.rx[1] << 8);
+        uint16_t captured = t.rx[2] | (t.rx[3] << 8);
+
+        // The pins as they were at the interrupt, for each port that raised
+        // one: a fast turn may have moved on by another transition since
+        uint16_t mask = ((flags & 0x00FF) ? 0x00FF : 0) | ((flags & 0xFF00) ? 0xFF00 : 0);
+        if (mask) self->handleMCPEncoders((self->mcpALastGood & ~mask) | (captured & mask));
+
+        // Nothing changed here: the interrupt is MCP#2's
+        if (!flags && self->mcpBReady) self->requestMCPButtons();
+        self->mcpALastGood = t.rx[4] | (t.rx[5] << 8);
     } else {
-        mcpALastGood = pins;
+        self->mcpALastGood = t.rx16le();
     }
+    self->handleMCPEncoders(self->mcpALastGood);
+}
 
+void InputManager::handleMCPEncoders(uint16_t pins) {
     for (int i = 0; i < NUM_MCP_ENCODERS; i++) {
         int bitPos = i * 2;
-        uint8_t newState = (pins >> bitPos) & 0x03;
-
-        if (newState != mcpEncLastState[i]) {
-            int8_t dir = decodeQuadrature(mcpEncLastState[i], newState);
-            mcpEncLastState[i] = newState;
-
-            if (dir != 0) {
-                mcpEncAccum[i] += dir;
-                // Report every 4 transitions (one detent)
-                if (mcpEncAccum[i] >= 4 || mcpEncAccum[i] <= -4) {
-                    int delta = (mcpEncAccum[i] > 0) ? 1 : -1;
-                    mcpEncAccum[i] = 0;
-                    // MCP encoder IDs start at NUM_DIRECT_ENCODERS
-                    if (encoderCB) encoderCB(NUM_DIRECT_ENCODERS + i, delta);
-                }
-            }
-        }
+        stepMCPEncoder(i, (pins >> bitPos) & 0x03);
+    }
+}
+
+void InputManager::stepMCPEncoder(int i, uint8_t newState) {
+    if (newState == mcpEncLastState[i]) return;
+    int8_t dir = decodeQuadrature(mcpEncLastState[i], newState);
+    mcpEncLastState[i] = newState;
+    if (dir == 0) return;
+
+    mcpEncAccum[i] += dir;
+    // Report every 4 transitions (one detent), scaled by turning speed
+    if (mcpEncAccum[i] >= 4 || mcpEncAccum[i] <= -4) {
+        int delta = mcpEncAccel[i].detent((mcpEncAccum[i] > 0) ? 1 : -1, millis());
+        mcpEncAccum[i] = 0;
+        // MCP encoder IDs start at NUM_DIRECT_ENCODERS
+        if (encoderCB) encoderCB(NUM_DIRECT_ENCODERS + i, delta);
     }
 }
 
@@ -274,14 +389,24 @@ void InputManager::pollDirectButtons() {
     }
 }
 
-void InputManager::pollMCPButtons() {
-    unsigned long now = millis();
-    uint16_t pins;
-    if (!mcpRead16(ADDR_MCP23017B, MCP_GPIOA, pins)) {
-        pins = mcpBLastGood;  // no state change → no spurious button events
+void InputManager::requestMCPButtons() {
+    if (!bus || mcpBPending) return;
+    mcpBPending = bus->readReg(ADDR_MCP23017B, MCP_GPIOA, 2, onMCPButtons, this);
+}
+
+void InputManager::onMCPButtons(const I2cTransfer& t, void* ctx) {
+    InputManager* self = (InputManager*)ctx;
+    self->mcpBPending = false;
+    if (t.ok()) {
+        self->mcpBLastGood = t.rx16le();
     } else {
-        mcpBLastGood = pins;
+        self->i2cErrorCount++;  // no state change → no spurious button events
     }
+    self->handleMCPButtons(self->mcpBLastGood);
+}
+
+void InputManager::handleMCPButtons(uint16_t pins) {
+    unsigned long now = millis();
 
     // MCP#2 Port A (bits 0-7): STOP, PIC, SND, INT, JRN, MENU, BACK, PAGE
     // MCP#2 Port B (bits 8-13): DUB, FILL, CLR, SCN, BANK, JOY_CENTER
@@ -298,6 +423,10 @@ void InputManager::pollMCPButtons() {
             // It's mapped to a button in the ButtonID enum, handled normally
 
             if (buttonCB) buttonCB(btnID, pressed);
+        } else if (pressed != buttonStates[btnID] && !mcpBRecheck) {
+            // No interrupt comes for a change the debounce held back
+            mcpBRecheck = true;
+            mcpBRecheckAt = buttonDebounce[btnID] + DEBOUNCE_MS + 1;
         }
     }
 
@@ -311,39 +440,112 @@ void InputManager::pollMCPButtons() {
             buttonStates[btnID] = pressed;
             buttonDebounce[btnID] = now;
             if (buttonCB) buttonCB(btnID, pressed);
+        } else if (pressed != buttonStates[btnID] && !mcpBRecheck) {
+            mcpBRecheck = true;
+            mcpBRecheckAt = buttonDebounce[btnID] + DEBOUNCE_MS + 1;
         }
     }
 }
 
-void InputManager::pollFaders() {
-    // ADS1115: 4 mixer faders (channels 0-3)
-    if (adsReady) {
-        for (int ch = 0; ch < NUM_FADERS; ch++) {
-            int16_t raw;
-            if (!adsReadChannel(ch, raw)) {
-                raw = adsLastGood[ch];  // hold last position on error
-            } else {
-                adsLastGood[ch] = raw;
-            }
-            float value = constrain((float)raw / 32767.0f, 0.0f, 1.0f);
+void InputManager::onADSAlert() {
+    adsAlertAt = micros();
+    adsAlertCount++;
+}
 
-            if (fabsf(value - faderLastValues[ch]) > FADER_THRESHOLD) {
-                faderValues[ch] = value;
-                faderLastValues[ch] = value;
-                if (faderCB) faderCB(ch, value);
+void InputManager::pollADS() {
+    switch (adsPhase) {
+        case ADS_SELECT:
+            adsSelectChannel();     // Queue was full last time
+            break;
+
+        case ADS_CONVERTING: {
+            uint32_t count = adsAlertCount;
+            uint32_t at = adsAlertAt;
+            bool pulse = count != adsSeenAlerts;
+            bool fresh = pulse && (int32_t)(at - adsMuxAt) >= ADS_STALE_US;
+            bool late = micros() - adsMuxAt >= ADS_RDY_TIMEOUT_US;
+            adsSeenAlerts = count;
+
+            if (fresh || late) {
+                adsSampleAt = fresh ? at : micros();
+                adsRequestResult();
             }
+            break;
         }
+
+        default:
+            break;  // A transfer is queued; its callback moves on
     }
+}
 
-    // Teensy ADC: crossfader (pin 39/A15)
-    int raw = analogRead(CROSSFADER_PIN);
-    float value = (float)raw / 4095.0f;  // 12-bit ADC
+void InputManager::adsSelectChannel() {
+    uint16_t config = ADS_CONFIG_MUX(adsCurrentChannel)
+                    | ADS_CONFIG_PGA_4V
+                    | ADS_CONFIG_CONT
+                    | ADS_CONFIG_DR_860
+                    | ADS_CONFIG_RDY;
+    uint8_t data[2] = { (uint8_t)(config >> 8), (uint8_t)(config & 0xFF) };
+
+    if (bus && bus->writeReg(ADDR_ADS1115, ADS_REG_CONFIG, data, 2, onADSConfig, this)) {
+        adsPhase = ADS_CONFIG;
+    } else {
+        adsPhase = ADS_SELECT;  // Queue full: try again next update
+    }
+}
 
-    if (fabsf(value - faderLastValues[FADER_XFADE]) > FADER_THRESHOLD) {
-        faderValues[FADER_XFADE] = value;
-        faderLastValues[FADER_XFADE] = value;
-        if (faderCB) faderCB(FADER_XFADE, value);
+void InputManager::onADSConfig(const I2cTransfer& t, void* ctx) {
+    InputManager* self = (InputManager*)ctx;
+    if (t.ok()) {
+        // The write restarts conversion on the new channel
+        self->adsMuxAt = t.finishedAt;
+        self->adsPhase = ADS_CONVERTING;
+    } else {
+        self->i2cErrorCount++;
+        self->adsPhase = ADS_SELECT;
+    }
+}
+
+void InputManager::adsRequestResult() {
+    if (bus && bus->readReg(ADDR_ADS1115, ADS_REG_CONVERT, 2, onADSResult, this)) {
+        adsPhase = ADS_READING;
+    }
+}
+
+void InputManager::onADSResult(const I2cTransfer& t, void* ctx) {
+    InputManager* self = (InputManager*)ctx;
+    int ch = self->adsCurrentChannel;
+
+    // Next channel first, so its conversion runs while this one is reported
+    self->adsCurrentChannel = (ch + 1) % NUM_FADERS;
+    self->adsSelectChannel();
+
+    if (!t.ok()) {
+        self->i2cErrorCount++;  // hold last position on error
+        return;
     }
+    self->adsLastGood[ch] = (int16_t)t.rx16be();
+    self->reportFader(ch, (float)self->adsLastGood[ch] / ADS_FADER_FULL_SCALE, self->adsSampleAt);
+}
+
+// Filters one reading; a change that leaves the hysteresis band is
+// reported, and its latency from the conversion measured
+void InputManager::reportFader(int id, float value, uint32_t sampledAt) {
+    if (!faderFilters[id].update(constrain(value, 0.0f, 1.0f))) return;
+
+    faderValues[id] = faderFilters[id].value();
+    if (faderCB) faderCB(id, faderValues[id]);
+
+    uint32_t latency = micros() - sampledAt;
+    faderReports++;
+    faderLatencySum += latency;
+    if (latency > faderLatencyPeak) faderLatencyPeak = latency;
+}
+
+void InputManager::pollCrossfader() {
+    // Teensy ADC: crossfader (pin 39/A15)
+    uint32_t at = micros();
+    int raw = analogRead(CROSSFADER_PIN);
+    reportFader(FADER_XFADE, (float)raw / 4095.0f, at);  // 12-bit ADC
 }
 
 void InputManager::pollJoystick() {
@@ -365,11 +567,22 @@ void InputManager::pollJoystick() {
     }
 }
 
-void InputManager::pollTouch() {
-    if (!touchReady) return;
+void InputManager::requestTouch() {
+    if (!bus || touchPending) return;
+    touchPending = bus->readReg(ADDR_MPR121, MPR121_TOUCHSTATUS, 2, onTouch, this);
+}
 
-    uint16_t current = touchSensor.touched();
+void InputManager::onTouch(const I2cTransfer& t, void* ctx) {
+    InputManager* self = (InputManager*)ctx;
+    self->touchPending = false;
+    if (!t.ok()) {
+        self->i2cErrorCount++;
+        return;
+    }
+    self->handleTouch(t.rx16le() & 0x0FFF);
+}
 
+void InputManager::handleTouch(uint16_t current) {
     for (int i = 0; i < MAX_PADS; i++) {
         bool wasPressed = (touchLast >> i) & 1;
         bool isPressed  = (current >> i) & 1;
@@ -407,7 +620,7 @@ uint8_t InputManager::getJoystickState() {
 }
 
 // ============================================
-// I2C HELPERS
+// I2C HELPERS (begin() only: blocking Wire)
 // ============================================
 
 bool InputManager::mcpRead16(uint8_t addr, uint8_t reg, uint16_t& outVal) {
@@ -437,43 +650,15 @@ bool InputManager::mcpWrite8(uint8_t addr, uint8_t reg, uint8_t value) {
     return true;
 }
 
-bool InputManager::adsReadChannel(uint8_t channel, int16_t& outVal) {
-    if (channel > 3) return false;
-
-    // Configure ADS1115 for single-ended read on specified channel
-    uint16_t config = ADS_CONFIG_OS
-                    | ADS_CONFIG_MUX(channel)
-                    | ADS_CONFIG_PGA_4V
-                    | ADS_CONFIG_MODE
-                    | ADS_CONFIG_DR_860
-                    | ADS_CONFIG_COMP;
-
-    // Write config
+bool InputManager::adsWrite16(uint8_t reg, uint16_t value) {
     Wire.beginTransmission(ADDR_ADS1115);
-    Wire.write(ADS_REG_CONFIG);
-    Wire.write((uint8_t)(config >> 8));
-    Wire.write((uint8_t)(config & 0xFF));
+    Wire.write(reg);
+    Wire.write((uint8_t)(value >> 8));
+    Wire.write((uint8_t)(value & 0xFF));
     if (Wire.endTransmission() != 0) {
         i2cErrorCount++;
         return false;
     }
-
-    // Wait for conversion (860 SPS ≈ 1.2ms)
-    delayMicroseconds(1200);
-
-    // Read result
-    Wire.beginTransmission(ADDR_ADS1115);
-    Wire.write(ADS_REG_CONVERT);
-    if (Wire.endTransmission(false) != 0) {
-        i2cErrorCount++;
-        return false;
-    }
-    if (Wire.requestFrom((uint8_t)ADDR_ADS1115, (uint8_t)2) < 2) {
-        i2cErrorCount++;
-        return false;
-    }
-    outVal = (int16_t)Wire.read() << 8;
-    outVal |= Wire.read();
     return true;
 }
 
@@ -3,29 +3,67 @@
  * ILI9488 5" 480×320 main UI display
  */
 
+#include <stdarg.h>
+#include <SPI.h>
+#include <EventResponder.h>
 #include <ILI9341_t3.h>
 #include "lcd_display.h"
 #include "system_state.h"
 #include "sequencer.h"
 #include "fx_engine.h"
 #include "sampling_engine.h"
-#include "synth_voice.h"
+#include "poly_synth.h"
 #include "scene_manager.h"
 #include "input_manager.h"
+#include "audio_profiler.h"
+
+// Widget ids. A screen change clears the LCD and invalidates them all,
+// so each screen numbers its own from W_BODY.
+enum {
+    W_HEADER = 0,
+    W_OVERLAY,
+    W_BODY
+};
+
+// Key of a widget that is not shown: its rectangle is cleared once
+static const uint32_t KEY_HIDDEN = 0xFFFFFFFFu;
+
+// ILI9341_t3's 5×7 font, also used to draw text into the framebuffer
+extern "C" const unsigned char glcdfont[];
+
+// Framebuffer flush: one band at a time. The SPI library signals the end
+// of a DMA transfer through an EventResponder, run from yield() between
+// loop() passes.
+static EventResponder lcdDmaEvent;
+static volatile bool lcdDmaBusy = false;
+
+static void onLcdDmaDone(EventResponderRef) {
+    digitalWriteFast(TFT_CS, HIGH);
+    SPI.endTransaction();
+    lcdDmaBusy = false;
+}
+
+static void lcdCommand(uint8_t cmd) {
+    digitalWriteFast(TFT_DC, LOW);
+    SPI.transfer(cmd);
+    digitalWriteFast(TFT_DC, HIGH);
+}
 
 LCDDisplay::LCDDisplay()
     : tft(nullptr)
+    , fb(nullptr)
+    , dmaBand(false)
     , currentScreen(LCD_MAIN)
     , lastScreen(LCD_COUNT)  // Force initial draw
     , needsFullRedraw(true)
+    , drawPhase(DRAW_BEGIN), clearBand(0)
     , msgStart(0), msgDuration(0), msgActive(false)
-    , lastBPM(0), lastVolume(0), lastStep(-1), lastMode(-1)
-    , lastPlaying(false), lastRecording(false)
 {
     msgBuffer[0] = '\0';
 }
 
 LCDDisplay::~LCDDisplay() {
+    delete fb;
     delete tft;
 }
 
@@ -50,49 +88,106 @@ void LCDDisplay::begin() {
     tft->setTextSize(1);
     tft->print("Location-aware instrument");
 
+    widgets.setRetained(LCD_DIFF_RENDER);
+
+#if LCD_FRAMEBUFFER
+    fb = new LcdFrameBuffer();
+    if (fb->begin()) {
+        fb->setFont(glcdfont);
+        // The flush drives CS and DC itself from here on
+        pinMode(TFT_CS, OUTPUT);
+        digitalWriteFast(TFT_CS, HIGH);
+        pinMode(TFT_DC, OUTPUT);
+        lcdDmaEvent.attach(onLcdDmaDone);
+        DEBUG_PRINTLN("LCDDisplay: Framebuffer, DMA flush");
+    } else {
+        delete fb;
+        fb = nullptr;
+        DEBUG_PRINTLN("LCDDisplay: No memory for a framebuffer, drawing directly");
+    }
+#endif
+
     DEBUG_PRINTLN("LCDDisplay: Initialized (480x320)");
 }
 
-void LCDDisplay::update(SystemState& state, Sequencer& seq, FXEngine& fx,
-                         SamplingEngine& sampler, SynthVoice& synth,
-                         SceneManager& scenes, InputManager& input) {
-    if (!tft) return;
-    // Check message timeout
-    if (msgActive && (millis() - msgStart > (unsigned long)msgDuration)) {
-        msgActive = false;
-        needsFullRedraw = true;
-    }
+bool LCDDisplay::update(SystemState& state, Sequencer& seq, FXEngine& fx,
+                         SamplingEngine& sampler, PolySynth& synth,
+                         SceneManager& scenes, InputManager& input,
+                         AudioProfiler& profiler) {
+    if (!tft) return true;
+
+    if (drawPhase == DRAW_BEGIN) {
+        // A streamed frame is still being copied out of the framebuffer:
+        // drawing now would tear it. Skip this frame.
+        if (fb && fb->isFlushing()) return true;
+
+        // Check message timeout
+        if (msgActive && (millis() - msgStart > (unsigned long)msgDuration)) {
+            msgActive = false;
+            needsFullRedraw = true;
+        }
 
-    // Detect screen change
-    if (currentScreen != lastScreen) {
-        needsFullRedraw = true;
-        lastScreen = currentScreen;
-    }
+        // Detect screen change
+        if (currentScreen != lastScreen) {
+            needsFullRedraw = true;
+            lastScreen = currentScreen;
+        }
 
-    if (needsFullRedraw) {
-        tft->fillScreen(COL_BG);
-        needsFullRedraw = false;
-        // Reset cached values to force full redraw
-        lastBPM = -1;
-        lastVolume = -1;
-        lastStep = -1;
-        lastMode = -1;
+        if (needsFullRedraw) {
+            needsFullRedraw = false;
+            // Nothing retained survives the clear
+            widgets.invalidate();
+            clearBand = 0;
+            drawPhase = DRAW_CLEAR;
+        } else {
+            drawPhase = DRAW_HEADER;
+        }
     }
 
-    drawHeader(state);
+    switch (drawPhase) {
+        case DRAW_CLEAR: {
+            // fillScreen() is the longest single SPI transfer: one band per slice
+            int bandH = (LCD_HEIGHT + LCD_CLEAR_BANDS - 1) / LCD_CLEAR_BANDS;
+            fill(0, clearBand * bandH, LCD_WIDTH, bandH, COL_BG);
+            if (++clearBand >= LCD_CLEAR_BANDS) drawPhase = DRAW_HEADER;
+            return false;
+        }
+
+        case DRAW_HEADER:
+            drawHeader(state);
+            drawPhase = DRAW_BODY;
+            return false;
+
+        case DRAW_BODY:
+            switch (currentScreen) {
+                case LCD_MAIN:     drawMainScreen(state, seq, sampler, fx); break;
+                case LCD_PATTERN:  drawPatternScreen(state, seq);           break;
+                case LCD_FX:       drawFXScreen(state, fx);                 break;
+                case LCD_SYNTH:    drawSynthScreen(state, synth);           break;
+                case LCD_SCENE:    drawSceneScreen(state, scenes);          break;
+                case LCD_MIXER:    drawMixerScreen(state, sampler, input);  break;
+                case LCD_SETTINGS: drawSettingsScreen(state, sampler, profiler); break;
+                default: break;
+            }
+
+            if (msgActive) {
+                // Anything repainted this frame may lie under the message box
+                bool damaged = widgets.getDirtyCount() > 0;
+                if (widgets.mark(W_OVERLAY, 0, 0, 0, 0, LcdWidgets::hashText(msgBuffer)) || damaged) {
+                    drawMessageOverlay();
+                }
+            }
+            widgets.commit();
+            if (fb) fb->publish();
+            meter.endFrame();
+            break;
 
-    switch (currentScreen) {
-        case LCD_MAIN:     drawMainScreen(state, seq, sampler, fx); break;
-        case LCD_PATTERN:  drawPatternScreen(state, seq);           break;
-        case LCD_FX:       drawFXScreen(state, fx);                 break;
-        case LCD_SYNTH:    drawSynthScreen(state, synth);           break;
-        case LCD_SCENE:    drawSceneScreen(state, scenes);          break;
-        case LCD_MIXER:    drawMixerScreen(state, sampler, input);  break;
-        case LCD_SETTINGS: drawSettingsScreen(state);               break;
-        default: break;
+        default:
+            break;
     }
 
-    if (msgActive) drawMessageOverlay();
+    drawPhase = DRAW_BEGIN;
+    return true;
 }
 
 void LCDDisplay::setScreen(LCDScreen screen) {
@@ -126,51 +221,33 @@ void LCDDisplay::invalidate() {
 // ============================================
 
 void LCDDisplay::drawHeader(SystemState& state) {
-    bool modeChanged = (state.mode != lastMode);
-    bool playChanged = (state.isPlaying != lastPlaying);
-    bool recChanged  = (state.isRecording != lastRecording);
-    bool bpmChanged  = (fabsf(state.bpm - lastBPM) > 0.1f);
-
-    if (!modeChanged && !playChanged && !recChanged && !bpmChanged) return;
+    int32_t k[] = { state.mode, state.isPlaying, state.isRecording,
+                    (int32_t)lroundf(state.bpm), currentScreen };
+    if (!widgets.mark(W_HEADER, 0, 0, LCD_WIDTH, 29, LcdWidgets::hash(k, sizeof(k)))) return;
 
     // Header background
-    tft->fillRect(0, 0, LCD_WIDTH, 28, COL_HEADER_BG);
+    fill(0, 0, LCD_WIDTH, 28, COL_HEADER_BG);
 
-    // Mode name (left)
-    tft->setCursor(8, 6);
-    tft->setTextSize(2);
-    tft->setTextColor(COL_ACCENT, COL_HEADER_BG);
-    tft->print(getModeString(state.mode));
-
-    // Screen name (center)
-    tft->setCursor(180, 6);
-    tft->setTextColor(COL_DIM, COL_HEADER_BG);
-    tft->setTextSize(2);
-    tft->print(getScreenName(currentScreen));
+    // Mode name (left), screen name (center)
+    text(8, 6, 2, COL_ACCENT, COL_HEADER_BG, getModeString(state.mode));
+    text(180, 6, 2, COL_DIM, COL_HEADER_BG, getScreenName(currentScreen));
 
     // BPM (right area)
-    tft->setCursor(330, 6);
-    tft->setTextColor(COL_TEXT, COL_HEADER_BG);
-    tft->setTextSize(2);
-    tft->printf("%.0f", state.bpm);
-    tft->setTextSize(1);
-    tft->print(" BPM");
+    char bpm[8];
+    snprintf(bpm, sizeof(bpm), "%.0f", state.bpm);
+    text(330, 6, 2, COL_TEXT, COL_HEADER_BG, bpm);
+    text(330 + strlen(bpm) * 12, 6, 1, COL_TEXT, COL_HEADER_BG, " BPM");
 
     // Transport indicators
     if (state.isRecording) {
-        tft->fillCircle(460, 14, 6, COL_REC);
+        disc(460, 14, 6, COL_REC);
     } else if (state.isPlaying) {
         // Play triangle
-        tft->fillTriangle(454, 8, 454, 20, 466, 14, COL_ACCENT);
+        triangle(454, 8, 454, 20, 466, 14, COL_ACCENT);
     }
 
     // Divider line
-    tft->drawFastHLine(0, 28, LCD_WIDTH, COL_DIM);
-
-    lastMode = state.mode;
-    lastPlaying = state.isPlaying;
-    lastRecording = state.isRecording;
-    lastBPM = state.bpm;
+    fill(0, 28, LCD_WIDTH, 1, COL_DIM);
 }
 
 // ============================================
@@ -179,46 +256,43 @@ void LCDDisplay::drawHeader(SystemState& state) {
 
 void LCDDisplay::drawMainScreen(SystemState& state, Sequencer& seq,
                                  SamplingEngine& sampler, FXEngine& fx) {
+    enum {
+        W_MASTER = W_BODY, W_MASTER_BAR, W_MASTER_PCT,
+        W_PATTERN, W_SCENE_NUM, W_STEP, W_FX_LABEL, W_FX,
+        W_TRACKS, W_GRID = W_TRACKS + MAX_TRACKS, W_GPS = W_GRID + MAX_STEPS
+    };
     int y = 36;
 
     // Volume bar
-    tft->setCursor(8, y);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->print("MASTER");
-    drawBar(70, y, 200, 12, state.masterVolume, COL_ACCENT, COL_FADER_BG);
-    tft->setCursor(280, y);
-    tft->setTextColor(COL_TEXT, COL_BG);
-    tft->printf("%d%%", (int)(state.masterVolume * 100));
+    label(W_MASTER, 8, y, 1, COL_DIM, COL_BG, "MASTER");
+    drawBar(W_MASTER_BAR, 70, y, 200, 12, state.masterVolume, COL_ACCENT, COL_FADER_BG);
+    label(W_MASTER_PCT, 280, y, 1, COL_TEXT, COL_BG, "%d%%", (int)(state.masterVolume * 100));
 
     y += 24;
 
     // Pattern/Scene info
-    tft->setCursor(8, y);
-    tft->setTextSize(2);
-    tft->setTextColor(COL_TEXT, COL_BG);
-    tft->printf("PAT %02d", state.currentPattern + 1);
-    tft->setCursor(150, y);
-    tft->printf("SCN %02d", state.currentScene + 1);
+    if (state.queuedPattern >= 0) {
+        label(W_PATTERN, 8, y, 2, COL_TEXT, COL_BG, "PAT %02d>%02d",
+              state.currentPattern + 1, state.queuedPattern + 1);
+    } else {
+        label(W_PATTERN, 8, y, 2, COL_TEXT, COL_BG, "PAT %02d", state.currentPattern + 1);
+    }
+    label(W_SCENE_NUM, 150, y, 2, COL_TEXT, COL_BG, "SCN %02d", state.currentScene + 1);
 
     // Step position
     if (state.isPlaying) {
-        int step = seq.getCurrentStep();
-        int len = seq.getPatternLength();
-        tft->setCursor(320, y);
-        tft->printf("STEP %2d/%d", step + 1, len);
+        label(W_STEP, 320, y, 2, COL_TEXT, COL_BG, "STEP %2d/%d",
+              seq.getCurrentStep() + 1, seq.getPatternLength());
+    } else {
+        label(W_STEP, 320, y, 2, COL_TEXT, COL_BG, "");
     }
 
     y += 32;
 
     // FX info
-    tft->setCursor(8, y);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_ACCENT, COL_BG);
-    tft->print("FX: ");
-    tft->setTextColor(COL_TEXT, COL_BG);
-    tft->print(fx.getEffectName(fx.getCurrentEffect()));
-    tft->printf("  MIX %d%%", (int)(fx.getMix() * 100));
+    label(W_FX_LABEL, 8, y, 1, COL_ACCENT, COL_BG, "FX: ");
+    label(W_FX, 32, y, 1, COL_TEXT, COL_BG, "%s  MIX %d%%",
+          fx.getEffectName(fx.getCurrentEffect()), (int)(fx.getMix() * 100));
 
     y += 20;
 
@@ -227,40 +301,34 @@ void LCDDisplay::drawMainScreen(SystemState& state, Sequencer& seq,
     int boxH = 30;
     int gap = 4;
     int startX = (LCD_WIDTH - (8 * boxW + 7 * gap)) / 2;
+    uint16_t colors[MAX_TRACKS];
 
     for (int i = 0; i < MAX_TRACKS; i++) {
+        int activity = sampler.isPlaying(i) ? 2 : sampler.isSampleLoaded(i) ? 1 : 0;
+        colors[i] = activity == 2 ? COL_ACCENT : activity == 1 ? COL_DIM : COL_STEP_OFF;
+        widgets.mark(W_TRACKS + i, startX + i * (boxW + gap), y, boxW, boxH,
+                     activity, activity == 2, LcdWidgets::OUTLINE);
+    }
+    flushClears();
+    for (int i = 0; i < MAX_TRACKS; i++) {
+        char name[4];
+        snprintf(name, sizeof(name), "T%d", i + 1);
+        bool playing = (colors[i] == COL_ACCENT);
         int bx = startX + i * (boxW + gap);
-
-        if (sampler.isPlaying(i)) {
-            tft->fillRect(bx, y, boxW, boxH, COL_ACCENT);
-            tft->setCursor(bx + 16, y + 10);
-            tft->setTextColor(COL_BG);
-        } else if (sampler.isSampleLoaded(i)) {
-            tft->drawRect(bx, y, boxW, boxH, COL_DIM);
-            tft->setCursor(bx + 16, y + 10);
-            tft->setTextColor(COL_DIM);
-        } else {
-            tft->drawRect(bx, y, boxW, boxH, COL_STEP_OFF);
-            tft->setCursor(bx + 16, y + 10);
-            tft->setTextColor(COL_STEP_OFF);
-        }
-        tft->setTextSize(1);
-        tft->printf("T%d", i + 1);
+        drawBox(W_TRACKS + i, bx, y, boxW, boxH, playing, colors[i],
+                bx + 16, y + 10, 1, playing ? COL_BG : colors[i], name);
     }
 
     y += boxH + 16;
 
-    // Mini step view at bottom
-    if (state.isPlaying) {
-        drawStepGrid(8, y, seq, seq.getSelectedTrack());
-    }
+    // Mini step view at bottom: while playing, only the playhead moves
+    drawStepGrid(W_GRID, 8, y, seq, seq.getSelectedTrack(), state.isPlaying);
 
     // GPS indicator (bottom right)
     if (state.gps.valid) {
-        tft->setCursor(340, 300);
-        tft->setTextSize(1);
-        tft->setTextColor(COL_DIM, COL_BG);
-        tft->printf("GPS %.4f,%.4f", state.gps.lat, state.gps.lon);
+        label(W_GPS, 340, 300, 1, COL_DIM, COL_BG, "GPS %.4f,%.4f", state.gps.lat, state.gps.lon);
+    } else {
+        label(W_GPS, 340, 300, 1, COL_DIM, COL_BG, "");
     }
 }
 
@@ -268,97 +336,116 @@ void LCDDisplay::drawMainScreen(SystemState& state, Sequencer& seq,
 // PATTERN SCREEN
 // ============================================
 
+static const char* const speedNames[SPEED_COUNT] = {
+    "1/8x", "1/4x", "1/2x", "3/4x", "1x", "3/2x", "2x"
+};
+
 void LCDDisplay::drawPatternScreen(SystemState& state, Sequencer& seq) {
+    enum {
+        W_TABS = W_BODY, W_MUTED = W_TABS + MAX_TRACKS, W_SOLO, W_INFO, W_SWING,
+        W_STEPS
+    };
     int selTrack = seq.getSelectedTrack();
-    int curStep = seq.getCurrentStep();
-    int len = seq.getPatternLength();
+    int curStep = seq.getTrackStep(selTrack);
+    int len = seq.getTrackLength(selTrack);
+
+    // Keep the page inside the selected track
+    int pages = (len + STEPS_PER_PAGE - 1) / STEPS_PER_PAGE;
+    if (state.stepPage >= pages) state.stepPage = pages - 1;
+    int first = state.stepPage * STEPS_PER_PAGE;
 
     // Track selector
     int y = 36;
-    tft->setTextSize(2);
     for (int i = 0; i < MAX_TRACKS; i++) {
-        int tx = 8 + i * 56;
-        if (i == selTrack) {
-            tft->fillRect(tx, y, 50, 22, COL_ACCENT);
-            tft->setCursor(tx + 12, y + 3);
-            tft->setTextColor(COL_BG, COL_ACCENT);
-        } else {
-            tft->drawRect(tx, y, 50, 22, seq.isTrackMuted(i) ? COL_REC : COL_DIM);
-            tft->setCursor(tx + 12, y + 3);
-            tft->setTextColor(seq.isTrackMuted(i) ? COL_REC : COL_TEXT, COL_BG);
-        }
-        tft->printf("T%d", i + 1);
-    }
-
-    // Mute/Solo indicators
-    y += 28;
-    tft->setTextSize(1);
-    tft->setCursor(8, y);
-    if (seq.isTrackMuted(selTrack)) {
-        tft->setTextColor(COL_REC, COL_BG);
-        tft->print("MUTED");
-    }
-    if (seq.isTrackSoloed(selTrack)) {
-        tft->setTextColor(COL_WARN, COL_BG);
-        tft->print("  SOLO");
+        int tab = (i == selTrack) ? 2 : seq.isTrackMuted(i) ? 1 : 0;
+        widgets.mark(W_TABS + i, 8 + i * 56, y, 50, 22, tab, tab == 2, LcdWidgets::OUTLINE);
     }
 
-    // 16-step grid (2 rows of 8)
-    y += 16;
+    // One page: 16-step grid (2 rows of 8). A step's key is everything
+    // its box shows, so a running pattern dirties the old and the new
+    // playhead box and nothing else.
+    int gridY = y + 44;
     int boxW = 54;
     int boxH = 40;
     int gap = 4;
 
-    for (int row = 0; row < 2; row++) {
-        for (int col = 0; col < 8; col++) {
-            int step = row * 8 + col;
-            if (step >= len) break;
+    for (int i = 0; i < STEPS_PER_PAGE; i++) {
+        int step = first + i;
+        int bx = 8 + (i % 8) * (boxW + gap);
+        int by = gridY + (i / 8) * (boxH + gap);
+
+        if (step >= len) {
+            // Past the track's end on its last page
+            hide(W_STEPS + i);
+            continue;
+        }
 
-            int bx = 8 + col * (boxW + gap);
-            int by = y + row * (boxH + gap);
+        bool active = seq.getStep(selTrack, step);
+        int32_t k[] = { step, active, step == curStep && state.isPlaying,
+                        active ? (int32_t)seq.getTrigCondition(selTrack, step) : 0,
+                        active ? seq.getProbability(selTrack, step) : 0 };
+        widgets.mark(W_STEPS + i, bx, by, boxW, boxH, LcdWidgets::hash(k, sizeof(k)),
+                     active, active ? 0 : LcdWidgets::OUTLINE);
+    }
 
-            bool active = seq.getStep(selTrack, step);
-            TrigCondition cond = seq.getTrigCondition(selTrack, step);
+    flushClears();
 
-            // Step box
-            if (active) {
-                uint16_t col16 = COL_STEP_ON;
-                if (step == curStep && state.isPlaying) col16 = COL_STEP_CUR;
-                tft->fillRect(bx, by, boxW, boxH, col16);
-
-                // Trig condition label
-                if (cond != TRIG_ALWAYS) {
-                    tft->setCursor(bx + 4, by + 4);
-                    tft->setTextSize(1);
-                    tft->setTextColor(COL_BG, col16);
-                    tft->printf("C%d", (int)cond);
-                }
+    for (int i = 0; i < MAX_TRACKS; i++) {
+        char name[4];
+        snprintf(name, sizeof(name), "T%d", i + 1);
+        bool sel = (i == selTrack);
+        uint16_t col16 = sel ? COL_ACCENT : seq.isTrackMuted(i) ? COL_REC : COL_DIM;
+        drawBox(W_TABS + i, 8 + i * 56, y, 50, 22, sel, col16, 8 + i * 56 + 12, y + 3, 2,
+                sel ? COL_BG : (seq.isTrackMuted(i) ? COL_REC : COL_TEXT), name);
+    }
+
+    for (int i = 0; i < STEPS_PER_PAGE; i++) {
+        int id = W_STEPS + i;
+        int step = first + i;
+        if (step >= len || !widgets.isDirty(id)) continue;
+
+        int bx = 8 + (i % 8) * (boxW + gap);
+        int by = gridY + (i / 8) * (boxH + gap);
+        bool cur = (step == curStep && state.isPlaying);
+        char num[4];
+        snprintf(num, sizeof(num), "%d", step + 1);
 
-                // Step number
-                tft->setCursor(bx + 18, by + 26);
-                tft->setTextSize(1);
-                tft->setTextColor(COL_BG, col16);
-                tft->printf("%d", step + 1);
-            } else {
-                uint16_t col16 = COL_STEP_OFF;
-                if (step == curStep && state.isPlaying) {
-                    tft->drawRect(bx, by, boxW, boxH, COL_STEP_CUR);
+        if (seq.getStep(selTrack, step)) {
+            uint16_t col16 = cur ? COL_STEP_CUR : COL_STEP_ON;
+            fill(bx, by, boxW, boxH, col16);
+
+            // Trig condition label
+            TrigCondition cond = seq.getTrigCondition(selTrack, step);
+            if (cond != TRIG_ALWAYS) {
+                char c[8];
+                if (cond == TRIG_PROB) {
+                    snprintf(c, sizeof(c), "%d%%", seq.getProbability(selTrack, step));
                 } else {
-                    tft->drawRect(bx, by, boxW, boxH, col16);
+                    snprintf(c, sizeof(c), "C%d", (int)cond);
                 }
-                tft->setCursor(bx + 18, by + 16);
-                tft->setTextSize(1);
-                tft->setTextColor(COL_DIM, COL_BG);
-                tft->printf("%d", step + 1);
+                text(bx + 4, by + 4, 1, COL_BG, col16, c);
             }
+
+            // Step number
+            text(bx + 18, by + 26, 1, COL_BG, col16, num);
+        } else {
+            outline(bx, by, boxW, boxH, cur ? COL_STEP_CUR : COL_STEP_OFF);
+            text(bx + 18, by + 16, 1, COL_DIM, COL_BG, num);
         }
     }
 
+    // Mute/Solo indicators
+    y += 28;
+    label(W_MUTED, 8, y, 1, COL_REC, COL_BG, seq.isTrackMuted(selTrack) ? "MUTED" : "");
+    label(W_SOLO, 38, y, 1, COL_WARN, COL_BG, seq.isTrackSoloed(selTrack) ? "  SOLO" : "");
+
+    // Page and track timing
+    label(W_INFO, 200, y, 1, COL_TEXT, COL_BG, "PAGE %d/%d  LEN %2d  %-4s",
+          state.stepPage + 1, pages, len, speedNames[seq.getTrackSpeed(selTrack)]);
+
     // Swing indicator
-    tft->setCursor(8, 290);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->printf("SWING: %d%%  LEN: %d", seq.getSwing(), len);
+    label(W_SWING, 8, 290, 1, COL_DIM, COL_BG, "SWING: %d%%  LEN: %d/%d",
+          seq.getSwing(), len, seq.getPatternLength());
 }
 
 // ============================================
@@ -366,93 +453,73 @@ void LCDDisplay::drawPatternScreen(SystemState& state, Sequencer& seq) {
 // ============================================
 
 void LCDDisplay::drawFXScreen(SystemState& state, FXEngine& fx) {
+    enum { W_NAME = W_BODY, W_ENABLED, W_KNOBS, W_VALUES = W_KNOBS + 4, W_LFO = W_VALUES + 4 };
+
     // Effect name (large)
-    tft->setCursor(8, 40);
-    tft->setTextSize(3);
-    tft->setTextColor(COL_ACCENT, COL_BG);
-    tft->print(fx.getEffectName(fx.getCurrentEffect()));
+    label(W_NAME, 8, 40, 3, COL_ACCENT, COL_BG, "%s", fx.getEffectName(fx.getCurrentEffect()));
 
     // Enabled indicator
     if (fx.isEnabled()) {
-        tft->setCursor(350, 44);
-        tft->setTextSize(2);
-        tft->setTextColor(COL_ACCENT, COL_BG);
-        tft->print("ON");
+        label(W_ENABLED, 350, 44, 2, COL_ACCENT, COL_BG, "ON");
     } else {
-        tft->setCursor(350, 44);
-        tft->setTextSize(2);
-        tft->setTextColor(COL_REC, COL_BG);
-        tft->print("OFF");
+        label(W_ENABLED, 350, 44, 2, COL_REC, COL_BG, "OFF");
     }
 
     // Parameter knobs
     int knobY = 120;
-    drawKnob(80, knobY, 35, fx.getParam(0), "PARAM 1");
-    drawKnob(200, knobY, 35, fx.getParam(1), "PARAM 2");
-    drawKnob(320, knobY, 35, fx.getParam(2), "PARAM 3");
-    drawKnob(440, knobY, 35, fx.getMix(), "MIX");
+    drawKnob(W_KNOBS + 0, 80, knobY, 35, fx.getParam(0), "PARAM 1");
+    drawKnob(W_KNOBS + 1, 200, knobY, 35, fx.getParam(1), "PARAM 2");
+    drawKnob(W_KNOBS + 2, 320, knobY, 35, fx.getParam(2), "PARAM 3");
+    drawKnob(W_KNOBS + 3, 440, knobY, 35, fx.getMix(), "MIX");
 
     // Parameter values
-    tft->setTextSize(2);
-    tft->setTextColor(COL_TEXT, COL_BG);
-    tft->setCursor(60, knobY + 50);
-    tft->printf("%d", (int)(fx.getParam(0) * 100));
-    tft->setCursor(180, knobY + 50);
-    tft->printf("%d", (int)(fx.getParam(1) * 100));
-    tft->setCursor(300, knobY + 50);
-    tft->printf("%d", (int)(fx.getParam(2) * 100));
-    tft->setCursor(420, knobY + 50);
-    tft->printf("%d%%", (int)(fx.getMix() * 100));
-
-    // LFO info
-    tft->setCursor(8, 240);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->printf("LFO: %.1f Hz  Depth: %d%%", 0.0f, 0);  // TODO: expose LFO getters
+    label(W_VALUES + 0, 60, knobY + 50, 2, COL_TEXT, COL_BG, "%d", (int)(fx.getParam(0) * 100));
+    label(W_VALUES + 1, 180, knobY + 50, 2, COL_TEXT, COL_BG, "%d", (int)(fx.getParam(1) * 100));
+    label(W_VALUES + 2, 300, knobY + 50, 2, COL_TEXT, COL_BG, "%d", (int)(fx.getParam(2) * 100));
+    label(W_VALUES + 3, 420, knobY + 50, 2, COL_TEXT, COL_BG, "%d%%", (int)(fx.getMix() * 100));
+
+    // Mod matrix: LFO1 (SHIFT+FILT) and the routes in use
+    const ModMatrix* mod = fx.getModMatrix();
+    if (mod) {
+        label(W_LFO, 8, 240, 1, COL_DIM, COL_BG, "LFO1: %.1f Hz  Routes: %d/%d",
+              mod->getLFORate(0), mod->getRouteCount(), MOD_MAX_ROUTES);
+    }
 }
 
 // ============================================
 // SYNTH SCREEN
 // ============================================
 
-void LCDDisplay::drawSynthScreen(SystemState& state, SynthVoice& synth) {
-    tft->setCursor(8, 40);
-    tft->setTextSize(3);
-    tft->setTextColor(COL_ACCENT, COL_BG);
-    tft->print("SYNTH");
+void LCDDisplay::drawSynthScreen(SystemState& state, PolySynth& synth) {
+    enum {
+        W_TITLE = W_BODY, W_STATUS, W_OSC1, W_OSC2, W_ENV_LABEL, W_ENV, W_ADSR,
+        W_CUTOFF, W_RES
+    };
 
-    tft->setCursor(8, 80);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->print(synth.isActive() ? "ACTIVE" : "IDLE");
+    label(W_TITLE, 8, 40, 3, COL_ACCENT, COL_BG, "SYNTH");
+    // Sounding voices / what the CPU budget allows
+    char status[24];
+    snprintf(status, sizeof(status), "VOICES %d/%d", synth.getActiveVoices(), synth.getVoiceLimit());
+    label(W_STATUS, 8, 80, 1, COL_DIM, COL_BG, status);
 
     // Oscillator section
     int y = 100;
-    tft->setCursor(8, y);
-    tft->setTextSize(2);
-    tft->setTextColor(COL_TEXT, COL_BG);
-    tft->print("OSC 1");
-    tft->setCursor(200, y);
-    tft->print("OSC 2");
+    label(W_OSC1, 8, y, 2, COL_TEXT, COL_BG, "OSC 1");
+    label(W_OSC2, 200, y, 2, COL_TEXT, COL_BG, "OSC 2");
 
     // ADSR visual
     y = 180;
-    tft->setCursor(8, y);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_ACCENT, COL_BG);
-    tft->print("ENVELOPE");
+    label(W_ENV_LABEL, 8, y, 1, COL_ACCENT, COL_BG, "ENVELOPE");
 
     // Draw ADSR shape (simplified)
     int envX = 8, envY = 200, envW = 200, envH = 60;
-    tft->drawRect(envX, envY, envW, envH, COL_DIM);
+    if (widgets.mark(W_ENV, envX, envY, envW, envH, 0)) outline(envX, envY, envW, envH, COL_DIM);
     // A-D-S-R labels
-    tft->setCursor(envX + 10, envY + envH + 4);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->print("A    D    S    R");
+    label(W_ADSR, envX + 10, envY + envH + 4, 1, COL_DIM, COL_BG, "A    D    S    R");
 
     // Filter knobs
-    drawKnob(300, 220, 30, 0.5, "CUTOFF");
-    drawKnob(400, 220, 30, 0.5, "RES");
+    drawKnob(W_CUTOFF, 300, 220, 30, 0.5, "CUTOFF");
+    drawKnob(W_RES, 400, 220, 30, 0.5, "RES");
 }
 
 // ============================================
@@ -460,10 +527,9 @@ void LCDDisplay::drawSynthScreen(SystemState& state, SynthVoice& synth) {
 // ============================================
 
 void LCDDisplay::drawSceneScreen(SystemState& state, SceneManager& scenes) {
-    tft->setCursor(8, 40);
-    tft->setTextSize(2);
-    tft->setTextColor(COL_ACCENT, COL_BG);
-    tft->print("SCENES");
+    enum { W_TITLE = W_BODY, W_HELP, W_SLOTS };
+
+    label(W_TITLE, 8, 40, 2, COL_ACCENT, COL_BG, "SCENES");
 
     // 16 scene slots in 4×4 grid
     int boxW = 100;
@@ -473,31 +539,29 @@ void LCDDisplay::drawSceneScreen(SystemState& state, SceneManager& scenes) {
     int startY = 70;
 
     for (int i = 0; i < MAX_SCENES; i++) {
-        int col = i % 4;
-        int row = i / 4;
-        int bx = startX + col * (boxW + gap);
-        int by = startY + row * (boxH + gap);
+        int slot = !scenes.isSceneSaved(i) ? 0 : (i == state.currentScene) ? 2 : 1;
+        widgets.mark(W_SLOTS + i, startX + (i % 4) * (boxW + gap), startY + (i / 4) * (boxH + gap),
+                     boxW, boxH, slot, slot != 0, LcdWidgets::OUTLINE);
+    }
+    flushClears();
+
+    for (int i = 0; i < MAX_SCENES; i++) {
+        int bx = startX + (i % 4) * (boxW + gap);
+        int by = startY + (i / 4) * (boxH + gap);
+        char name[4];
+        snprintf(name, sizeof(name), "S%02d", i + 1);
 
         if (scenes.isSceneSaved(i)) {
-            uint16_t bgCol = (i == state.currentScene) ? COL_ACCENT : COL_HEADER_BG;
-            tft->fillRect(bx, by, boxW, boxH, bgCol);
-            tft->setCursor(bx + 30, by + 16);
-            tft->setTextSize(2);
-            tft->setTextColor((i == state.currentScene) ? COL_BG : COL_TEXT, bgCol);
-            tft->printf("S%02d", i + 1);
+            bool cur = (i == state.currentScene);
+            drawBox(W_SLOTS + i, bx, by, boxW, boxH, true, cur ? COL_ACCENT : COL_HEADER_BG,
+                    bx + 30, by + 16, 2, cur ? COL_BG : COL_TEXT, name);
         } else {
-            tft->drawRect(bx, by, boxW, boxH, COL_DIM);
-            tft->setCursor(bx + 30, by + 16);
-            tft->setTextSize(2);
-            tft->setTextColor(COL_DIM, COL_BG);
-            tft->printf("S%02d", i + 1);
+            drawBox(W_SLOTS + i, bx, by, boxW, boxH, false, COL_DIM,
+                    bx + 30, by + 16, 2, COL_DIM, name);
         }
     }
 
-    tft->setCursor(8, 300);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->print("PAD = recall   SHIFT+PAD = save   ENC = morph");
+    label(W_HELP, 8, 300, 1, COL_DIM, COL_BG, "PAD = recall   SHIFT+PAD = save   ENC = morph");
 }
 
 // ============================================
@@ -506,10 +570,13 @@ void LCDDisplay::drawSceneScreen(SystemState& state, SceneManager& scenes) {
 
 void LCDDisplay::drawMixerScreen(SystemState& state, SamplingEngine& sampler,
                                   InputManager& input) {
-    tft->setCursor(8, 40);
-    tft->setTextSize(2);
-    tft->setTextColor(COL_ACCENT, COL_BG);
-    tft->print("MIXER");
+    enum {
+        W_TITLE = W_BODY, W_MASTER, W_MASTER_BAR, W_MASTER_PCT,
+        W_FADERS, W_FADER_LABELS = W_FADERS + FADER_COUNT,
+        W_FADER_VALUES = W_FADER_LABELS + FADER_COUNT
+    };
+
+    label(W_TITLE, 8, 40, 2, COL_ACCENT, COL_BG, "MIXER");
 
     // 4 channel faders + crossfader
     const char* faderLabels[] = {"MIC", "SMP", "SYN", "RAD", "X-FADE"};
@@ -522,68 +589,120 @@ void LCDDisplay::drawMixerScreen(SystemState& state, SamplingEngine& sampler,
     for (int i = 0; i < FADER_COUNT; i++) {
         int fx = startX + i * (faderW + gap);
         float val = input.getFaderValue(i);
-        drawFader(fx, startY, faderW, faderH, val, faderLabels[i]);
+        drawFader(W_FADERS + i, fx, startY, faderW, faderH, val, faderLabels[i]);
+
+        int labelLen = strlen(faderLabels[i]);
+        label(W_FADER_LABELS + i, fx + (faderW - labelLen * 6) / 2, startY - 14, 1,
+              COL_DIM, COL_BG, "%s", faderLabels[i]);
+        label(W_FADER_VALUES + i, fx + 4, startY + faderH + 8, 1, COL_TEXT, COL_BG,
+              "%d", (int)(val * 100));
     }
 
     // Master volume
-    tft->setCursor(8, 280);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->print("MASTER: ");
-    drawBar(60, 280, 150, 10, state.masterVolume, COL_ACCENT, COL_FADER_BG);
-    tft->printf(" %d%%", (int)(state.masterVolume * 100));
+    label(W_MASTER, 8, 280, 1, COL_DIM, COL_BG, "MASTER: ");
+    drawBar(W_MASTER_BAR, 60, 280, 150, 10, state.masterVolume, COL_ACCENT, COL_FADER_BG);
+    label(W_MASTER_PCT, 216, 280, 1, COL_TEXT, COL_BG, "%d%%", (int)(state.masterVolume * 100));
 }
 
 // ============================================
 // SETTINGS SCREEN
 // ============================================
 
-void LCDDisplay::drawSettingsScreen(SystemState& state) {
+void LCDDisplay::drawSettingsScreen(SystemState& state, SamplingEngine& sampler,
+                                    AudioProfiler& profiler) {
+    enum {
+        W_TITLE = W_BODY, W_CPU, W_MEM, W_SAMPLES, W_PATTERN, W_SCENE_NUM,
+        W_GPS, W_GPS_AGE, W_SPI, W_VERSION
+    };
     int y = 40;
     int lineH = 24;
-    tft->setTextSize(2);
 
-    tft->setCursor(8, y);
-    tft->setTextColor(COL_ACCENT, COL_BG);
-    tft->print("SETTINGS");
+    label(W_TITLE, 8, y, 2, COL_ACCENT, COL_BG, "SETTINGS");
 
     y += lineH + 8;
-    tft->setTextSize(1);
-    tft->setTextColor(COL_TEXT, COL_BG);
+    label(W_CPU, 8, y, 1, COL_TEXT, COL_BG, "CPU Usage:  %.1f%%", AudioProcessorUsage());
+    y += lineH;
 
-    tft->setCursor(8, y);
-    tft->printf("CPU Usage:  %.1f%%", AudioProcessorUsage());
+    label(W_MEM, 8, y, 1, COL_TEXT, COL_BG, "Audio Mem:  %d / %d blocks",
+          AudioMemoryUsage(), AUDIO_MEMORY_BLOCKS);
     y += lineH;
 
-    tft->setCursor(8, y);
-    tft->printf("Audio Mem:  %d / %d blocks", AudioMemoryUsage(), AUDIO_MEMORY_BLOCKS);
+    label(W_SAMPLES, 8, y, 1, COL_TEXT, COL_BG, "Samples:    %lu / %lu KB %s, %.0f%% hit",
+          sampler.getCacheBytesResident() / 1024, sampler.getCacheBudget() / 1024,
+          sampler.cacheUsesPSRAM() ? "PSRAM" : "RAM",
+          sampler.getCacheHitRate() * 100.0f);
     y += lineH;
 
-    tft->setCursor(8, y);
-    tft->printf("Pattern:    %d", state.currentPattern + 1);
+    label(W_PATTERN, 8, y, 1, COL_TEXT, COL_BG, "Pattern:    %d", state.currentPattern + 1);
     y += lineH;
 
-    tft->setCursor(8, y);
-    tft->printf("Scene:      %d", state.currentScene + 1);
+    label(W_SCENE_NUM, 8, y, 1, COL_TEXT, COL_BG, "Scene:      %d", state.currentScene + 1);
     y += lineH;
 
     if (state.gps.valid) {
-        tft->setCursor(8, y);
-        tft->printf("GPS:        %.6f, %.6f", state.gps.lat, state.gps.lon);
-        y += lineH;
-        tft->setCursor(8, y);
+        label(W_GPS, 8, y, 1, COL_TEXT, COL_BG, "GPS:        %.6f, %.6f",
+              state.gps.lat, state.gps.lon);
         unsigned long age = (millis() - state.gps.lastUpdate) / 1000;
-        tft->printf("GPS Age:    %lu sec", age);
+        label(W_GPS_AGE, 8, y + lineH, 1, COL_TEXT, COL_BG, "GPS Age:    %lu sec", age);
     } else {
-        tft->setCursor(8, y);
-        tft->setTextColor(COL_WARN, COL_BG);
-        tft->print("GPS:        No Fix");
+        label(W_GPS, 8, y, 1, COL_WARN, COL_BG, "GPS:        No Fix");
+        label(W_GPS_AGE, 8, y + lineH, 1, COL_TEXT, COL_BG, "");
     }
+    y += 2 * lineH;
+
+    label(W_SPI, 8, y, 1, COL_TEXT, COL_BG, "LCD SPI:    %lu B/frame, peak %lu",
+          (unsigned long)meter.getAverageFrameBytes(), (unsigned long)meter.getPeakFrameBytes());
 
     y += lineH + 8;
-    tft->setCursor(8, y);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->print("Oh My Ondas v" VERSION);
+    label(W_VERSION, 8, y, 1, COL_DIM, COL_BG, "Oh My Ondas v" VERSION);
+
+    drawProfilePanel(300, 72, profiler);
+}
+
+// Right-hand column of SETTINGS: heaviest audio objects, last window
+void LCDDisplay::drawProfilePanel(int x, int y, AudioProfiler& profiler) {
+    enum { W_PROF_TITLE = W_BODY + 16, W_PROF_ROWS };
+    int lineH = 14;
+
+    label(W_PROF_TITLE, x, y, 1, COL_ACCENT, COL_BG, "AUDIO PROFILE");
+    y += lineH + 4;
+
+    // Rows: total, overruns, memory, then the objects
+    char row[3 + PROFILER_TOP_N][48];
+    uint16_t color[3 + PROFILER_TOP_N];
+    for (int i = 0; i < 3 + PROFILER_TOP_N; i++) {
+        row[i][0] = '\0';
+        color[i] = COL_TEXT;
+    }
+
+    if (!profiler.isEnabled()) {
+        snprintf(row[0], sizeof(row[0]), "Off (SHIFT+MENU)");
+        color[0] = COL_DIM;
+    } else {
+        snprintf(row[0], sizeof(row[0]), "Total %5.1f%%  pk %5.1f%%",
+                 profiler.getTotal(), profiler.getTotalPeak());
+
+        uint32_t overruns = profiler.getOverruns();
+        snprintf(row[1], sizeof(row[1]), "Overruns %-8lu", (unsigned long)overruns);
+        if (overruns) color[1] = COL_WARN;
+
+        snprintf(row[2], sizeof(row[2]), "Mem peak %3u / %d",
+                 (unsigned)profiler.getMemoryPeak(), AUDIO_MEMORY_BLOCKS);
+
+        // Object, worst block this window, worst since enabled
+        char name[16];
+        for (int i = 0; i < profiler.getTopCount() && i < PROFILER_TOP_N; i++) {
+            const ProfiledObject& o = profiler.getTop(i);
+            AudioProfiler::formatName(o, name, sizeof(name));
+            snprintf(row[3 + i], sizeof(row[3 + i]), "%-12s %5.1f%% %5.1f%%",
+                     name, o.windowMax, o.peak);
+        }
+    }
+
+    for (int i = 0; i < 3 + PROFILER_TOP_N; i++) {
+        label(W_PROF_ROWS + i, x, y, 1, color[i], COL_BG, "%s", row[i]);
+        y += lineH + (i == 2 ? 4 : 0);
+    }
 }
 
 // ============================================
@@ -598,92 +717,258 @@ void LCDDisplay::drawMessageOverlay() {
     int bx = (LCD_WIDTH - boxW) / 2;
     int by = (LCD_HEIGHT - boxH) / 2;
 
-    tft->fillRect(bx, by, boxW, boxH, COL_HEADER_BG);
-    tft->drawRect(bx, by, boxW, boxH, COL_ACCENT);
-    tft->setCursor(bx + 20, by + 14);
-    tft->setTextSize(2);
-    tft->setTextColor(COL_ACCENT, COL_HEADER_BG);
-    tft->print(msgBuffer);
+    fill(bx, by, boxW, boxH, COL_HEADER_BG);
+    outline(bx, by, boxW, boxH, COL_ACCENT);
+    text(bx + 20, by + 14, 2, COL_ACCENT, COL_HEADER_BG, msgBuffer);
 }
 
 // ============================================
 // UI ELEMENT HELPERS
 // ============================================
 
-void LCDDisplay::drawBar(int x, int y, int w, int h, float value,
+void LCDDisplay::drawBar(int id, int x, int y, int w, int h, float value,
                           uint16_t fg, uint16_t bg) {
-    tft->fillRect(x, y, w, h, bg);
     int fillW = (int)(value * w);
-    if (fillW > 0) {
-        tft->fillRect(x, y, fillW, h, fg);
-    }
+    if (fillW < 0) fillW = 0;
+    if (fillW > w) fillW = w;
+    if (!widgets.mark(id, x, y, w, h, fillW)) return;
+
+    // Filled part and the rest, without overdraw
+    fill(x, y, fillW, h, fg);
+    fill(x + fillW, y, w - fillW, h, bg);
 }
 
-void LCDDisplay::drawStepGrid(int x, int y, Sequencer& seq, int track) {
-    int len = seq.getPatternLength();
-    int curStep = seq.getCurrentStep();
-    int boxW = (LCD_WIDTH - 16) / len;
+void LCDDisplay::drawStepGrid(int id, int x, int y, Sequencer& seq, int track, bool visible) {
+    int len = visible ? seq.getTrackLength(track) : 0;
+    int curStep = seq.getTrackStep(track);
+    int boxW = len ? (LCD_WIDTH - 16) / len : 0;
     if (boxW < 4) boxW = 4;
 
+    // Cell key: 2 playhead, 1 on, 0 off
+    for (int i = 0; i < MAX_STEPS; i++) {
+        if (i >= len) {
+            hide(id + i);
+            continue;
+        }
+        int cell = (i == curStep) ? 2 : seq.getStep(track, i) ? 1 : 0;
+        widgets.mark(id + i, x + i * boxW, y, boxW - 1, 12, cell, cell != 0, LcdWidgets::OUTLINE);
+    }
+    flushClears();
+
     for (int i = 0; i < len; i++) {
+        if (!widgets.isDirty(id + i)) continue;
         int bx = x + i * boxW;
-        bool active = seq.getStep(track, i);
 
         if (i == curStep) {
-            tft->fillRect(bx, y, boxW - 1, 12, COL_STEP_CUR);
-        } else if (active) {
-            tft->fillRect(bx, y, boxW - 1, 12, COL_STEP_ON);
+            fill(bx, y, boxW - 1, 12, COL_STEP_CUR);
+        } else if (seq.getStep(track, i)) {
+            fill(bx, y, boxW - 1, 12, COL_STEP_ON);
         } else {
-            tft->drawRect(bx, y, boxW - 1, 12, COL_STEP_OFF);
+            outline(bx, y, boxW - 1, 12, COL_STEP_OFF);
         }
     }
 }
 
-void LCDDisplay::drawKnob(int cx, int cy, int r, float value, const char* label) {
-    // Knob circle
-    tft->drawCircle(cx, cy, r, COL_DIM);
-    tft->drawCircle(cx, cy, r - 1, COL_DIM);
-
+void LCDDisplay::drawKnob(int id, int cx, int cy, int r, float value, const char* label) {
     // Position indicator (arc from 7 o'clock to 5 o'clock = 225° to -45° = 270° range)
     float angle = (225.0f - value * 270.0f) * PI / 180.0f;
     int ix = cx + (int)((r - 4) * cos(angle));
     int iy = cy - (int)((r - 4) * sin(angle));
-    tft->fillCircle(ix, iy, 3, COL_ACCENT);
 
-    // Label below
+    // The circle, the indicator and the label below
     int labelLen = strlen(label);
-    tft->setCursor(cx - labelLen * 3, cy + r + 6);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->print(label);
-}
+    int halfW = max(r, labelLen * 3);
+    int32_t k[] = { ix, iy };
+    if (!widgets.mark(id, cx - halfW, cy - r, 2 * halfW + 1, 2 * r + 14,
+                      LcdWidgets::hash(k, sizeof(k), LcdWidgets::hashText(label)), false)) {
+        return;
+    }
+    flushClears();
 
-void LCDDisplay::drawFader(int x, int y, int w, int h, float value, const char* label) {
-    // Track
-    tft->fillRect(x, y, w, h, COL_FADER_BG);
+    circle(cx, cy, r, COL_DIM);
+    circle(cx, cy, r - 1, COL_DIM);
+    disc(ix, iy, 3, COL_ACCENT);
 
+    text(cx - labelLen * 3, cy + r + 6, 1, COL_DIM, COL_BG, label);
+}
+
+void LCDDisplay::drawFader(int id, int x, int y, int w, int h, float value, const char* label) {
     // Fill from bottom
     int fillH = (int)(value * h);
-    if (fillH > 0) {
-        tft->fillRect(x, y + h - fillH, w, fillH, COL_FADER_FG);
-    }
+    if (fillH < 0) fillH = 0;
+    if (fillH > h) fillH = h;
+
+    // The handle overhangs the track by 4 px a side and 2 below
+    if (!widgets.mark(id, x - 4, y, w + 8, h + 2, fillH)) return;
+
+    // Everything in the rectangle is painted once: sides, track, fill
+    fill(x - 4, y, 4, h + 2, COL_BG);
+    fill(x + w, y, 4, h + 2, COL_BG);
+    fill(x, y, w, h - fillH, COL_FADER_BG);
+    fill(x, y + h - fillH, w, fillH, COL_FADER_FG);
+    fill(x, y + h, w, 2, COL_BG);
 
     // Handle line
     int handleY = y + h - fillH - 2;
     if (handleY < y) handleY = y;
-    tft->fillRect(x - 4, handleY, w + 8, 4, COL_TEXT);
+    fill(x - 4, handleY, w + 8, 4, COL_TEXT);
+}
 
-    // Value
-    tft->setCursor(x + 4, y + h + 8);
-    tft->setTextSize(1);
-    tft->setTextColor(COL_TEXT, COL_BG);
-    tft->printf("%d", (int)(value * 100));
+void LCDDisplay::drawBox(int id, int x, int y, int w, int h, bool filled, uint16_t color,
+                          int tx, int ty, uint8_t size, uint16_t textColor, const char* s) {
+    if (!widgets.isDirty(id)) return;
+    if (filled) {
+        fill(x, y, w, h, color);
+        text(tx, ty, size, textColor, color, s);
+    } else {
+        outline(x, y, w, h, color);
+        text(tx, ty, size, textColor, COL_BG, s);
+    }
+}
 
-    // Label
-    int labelLen = strlen(label);
-    tft->setCursor(x + (w - labelLen * 6) / 2, y - 14);
-    tft->setTextColor(COL_DIM, COL_BG);
-    tft->print(label);
+// ============================================
+// WIDGETS
+// ============================================
+
+void LCDDisplay::label(int id, int x, int y, uint8_t size, uint16_t fg, uint16_t bg,
+                        const char* fmt, ...) {
+    char buf[64];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    uint32_t colors[] = { fg, bg, size };
+    uint32_t key = LcdWidgets::hashText(buf, LcdWidgets::hash(colors, sizeof(colors)));
+
+    // Spaces over the tail of a longer string drawn here before
+    int len = strlen(buf);
+    int cellW = 6 * size;
+    if (widgets.isDrawn(id)) {
+        const LcdRect& old = widgets.getRect(id);
+        if (old.x == x && old.y == y && old.h == 8 * size) {
+            int oldLen = old.w / cellW;
+            while (len < oldLen && len < (int)sizeof(buf) - 1) buf[len++] = ' ';
+            buf[len] = '\0';
+        }
+    }
+
+    if (!widgets.mark(id, x, y, len * cellW, 8 * size, key)) return;
+    text(x, y, size, fg, bg, buf);
+}
+
+// Clears a widget's last rectangle once, if it was ever drawn
+void LCDDisplay::hide(int id) {
+    if (!widgets.isDrawn(id)) return;
+    const LcdRect& r = widgets.getRect(id);
+    widgets.mark(id, r.x, r.y, r.w, r.h, KEY_HIDDEN, false);
+}
+
+void LCDDisplay::flushClears() {
+    for (int i = 0; i < widgets.getClearCount(); i++) {
+        const LcdRect& r = widgets.getClear(i);
+        fill(r.x, r.y, r.w, r.h, COL_BG);
+    }
+    widgets.clearsIssued();
+}
+
+// With a framebuffer these only touch RAM; the flush meters what it sends
+
+void LCDDisplay::fill(int x, int y, int w, int h, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    if (fb) {
+        fb->fillRect(x, y, w, h, color);
+        return;
+    }
+    tft->fillRect(x, y, w, h, color);
+    meter.fill(w, h);
+}
+
+void LCDDisplay::outline(int x, int y, int w, int h, uint16_t color) {
+    if (fb) {
+        fb->drawRect(x, y, w, h, color);
+        return;
+    }
+    tft->drawRect(x, y, w, h, color);
+    meter.outline(w, h);
+}
+
+void LCDDisplay::text(int x, int y, uint8_t size, uint16_t fg, uint16_t bg, const char* s) {
+    if (fb) {
+        fb->drawText(x, y, size, fg, bg, s);
+        return;
+    }
+    tft->setCursor(x, y);
+    tft->setTextSize(size);
+    tft->setTextColor(fg, bg);
+    tft->print(s);
+    meter.text(strlen(s), size);
+}
+
+void LCDDisplay::circle(int cx, int cy, int r, uint16_t color) {
+    if (fb) {
+        fb->drawCircle(cx, cy, r, color);
+        return;
+    }
+    tft->drawCircle(cx, cy, r, color);
+    meter.circle(r);
+}
+
+void LCDDisplay::disc(int cx, int cy, int r, uint16_t color) {
+    if (fb) {
+        fb->fillCircle(cx, cy, r, color);
+        return;
+    }
+    tft->fillCircle(cx, cy, r, color);
+    meter.disc(r);
+}
+
+void LCDDisplay::triangle(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color) {
+    if (fb) {
+        fb->fillTriangle(x0, y0, x1, y1, x2, y2, color);
+        return;
+    }
+    tft->fillTriangle(x0, y0, x1, y1, x2, y2, color);
+    meter.triangle(max(max(x0, x1), x2) - min(min(x0, x1), x2),
+                   max(max(y0, y1), y2) - min(min(y0, y1), y2));
+}
+
+// ============================================
+// FRAMEBUFFER FLUSH (SPI DMA)
+// ============================================
+
+bool LCDDisplay::flush() {
+    if (!fb || lcdDmaBusy) return true;
+
+    // The last band is on the panel: free its buffer, copy the next one in
+    if (dmaBand) {
+        fb->sent();
+        dmaBand = false;
+    }
+    fb->service();
+
+    const LcdBand* band = fb->front();
+    if (!band) return true;
+
+    const LcdRect& r = band->rect;
+    SPI.beginTransaction(SPISettings(LCD_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+    digitalWriteFast(TFT_CS, LOW);
+    lcdCommand(ILI9341_CASET);
+    SPI.transfer16(r.x);
+    SPI.transfer16(r.x + r.w - 1);
+    lcdCommand(ILI9341_PASET);
+    SPI.transfer16(r.y);
+    SPI.transfer16(r.y + r.h - 1);
+    lcdCommand(ILI9341_RAMWR);
+
+    // RAM2 is cached: write the copy back before the DMA reads it
+    arm_dcache_flush((void*)band->pixels, band->bytes());
+    lcdDmaBusy = true;
+    dmaBand = true;
+    SPI.transfer(band->pixels, nullptr, band->bytes(), lcdDmaEvent);
+
+    meter.fill(r.w, r.h);
+    return true;
 }
 
 // ============================================
@@ -0,0 +1,277 @@
+/**
+ * Oh My Ondas - LCD Framebuffer Implementation
+ * RAM copy of the LCD, flushed to the panel in bands by SPI DMA
+ */
+
+#include "lcd_framebuffer.h"
+
+static inline uint16_t swap16(uint16_t c) {
+    return (uint16_t)((c << 8) | (c >> 8));
+}
+
+LcdFrameBuffer::LcdFrameBuffer()
+    : pixels(nullptr)
+    , stagingPixels(nullptr)
+    , font(nullptr)
+    , queuedCount(0)
+    , stagedHead(0)
+    , stagedCount(0)
+{
+    memset(dirty, 0, sizeof(dirty));
+    memset(queued, 0, sizeof(queued));
+    memset(staging, 0, sizeof(staging));
+}
+
+LcdFrameBuffer::~LcdFrameBuffer() {
+    extmem_free(pixels);
+    free(stagingPixels);
+}
+
+bool LcdFrameBuffer::begin() {
+    const uint32_t bandPixels = (uint32_t)LCD_FB_BAND_ROWS * LCD_WIDTH;
+
+    // 300 KB: PSRAM when fitted (inside SAMPLE_CACHE_PSRAM_RESERVE, with
+    // the pattern bank), otherwise the RAM2 heap, which the bank then
+    // leaves to it. The staging buffers are DMA sources: RAM2.
+    pixels = (uint16_t*)extmem_malloc((size_t)LCD_WIDTH * LCD_HEIGHT * 2);
+    stagingPixels = (uint16_t*)malloc((size_t)LCD_FB_STAGING * bandPixels * 2);
+    if (!pixels || !stagingPixels) {
+        extmem_free(pixels);
+        free(stagingPixels);
+        pixels = nullptr;
+        stagingPixels = nullptr;
+        return false;
+    }
+
+    memset(pixels, 0, (size_t)LCD_WIDTH * LCD_HEIGHT * 2);
+    for (int i = 0; i < LCD_FB_STAGING; i++) {
+        staging[i].pixels = stagingPixels + i * bandPixels;
+    }
+    return true;
+}
+
+// ============================================
+// DRAWING
+// ============================================
+
+void LcdFrameBuffer::span(int x, int y, int w, uint16_t swapped) {
+    uint16_t* p = pixels + y * LCD_WIDTH + x;
+    for (int i = 0; i < w; i++) p[i] = swapped;
+}
+
+void LcdFrameBuffer::fillRect(int x, int y, int w, int h, uint16_t color) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
+    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    uint16_t sw = swap16(color);
+    for (int row = y; row < y + h; row++) span(x, row, w, sw);
+    markDirty(x, y, w, h);
+}
+
+void LcdFrameBuffer::drawRect(int x, int y, int w, int h, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+    fillRect(x, y + h - 1, w, 1, color);
+    fillRect(x, y, 1, h, color);
+    fillRect(x + w - 1, y, 1, h, color);
+}
+
+void LcdFrameBuffer::drawCircle(int cx, int cy, int r, uint16_t color) {
+    // Midpoint circle, as Adafruit_GFX draws it
+    int f = 1 - r;
+    int ddx = 1;
+    int ddy = -2 * r;
+    int x = 0;
+    int y = r;
+
+    fillRect(cx, cy + r, 1, 1, color);
+    fillRect(cx, cy - r, 1, 1, color);
+    fillRect(cx + r, cy, 1, 1, color);
+    fillRect(cx - r, cy, 1, 1, color);
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddy += 2;
+            f += ddy;
+        }
+        x++;
+        ddx += 2;
+        f += ddx;
+
+        fillRect(cx + x, cy + y, 1, 1, color);
+        fillRect(cx - x, cy + y, 1, 1, color);
+        fillRect(cx + x, cy - y, 1, 1, color);
+        fillRect(cx - x, cy - y, 1, 1, color);
+        fillRect(cx + y, cy + x, 1, 1, color);
+        fillRect(cx - y, cy + x, 1, 1, color);
+        fillRect(cx + y, cy - x, 1, 1, color);
+        fillRect(cx - y, cy - x, 1, 1, color);
+    }
+}
+
+void LcdFrameBuffer::fillCircle(int cx, int cy, int r, uint16_t color) {
+    int f = 1 - r;
+    int ddx = 1;
+    int ddy = -2 * r;
+    int x = 0;
+    int y = r;
+
+    fillRect(cx, cy - r, 1, 2 * r + 1, color);
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddy += 2;
+            f += ddy;
+        }
+        x++;
+        ddx += 2;
+        f += ddx;
+
+        fillRect(cx + x, cy - y, 1, 2 * y + 1, color);
+        fillRect(cx - x, cy - y, 1, 2 * y + 1, color);
+        fillRect(cx + y, cy - x, 1, 2 * x + 1, color);
+        fillRect(cx - y, cy - x, 1, 2 * x + 1, color);
+    }
+}
+
+void LcdFrameBuffer::fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2,
+                                  uint16_t color) {
+    // Sort by y, then fill one span per row between the long edge (0-2)
+    // and the short ones (0-1, 1-2)
+    if (y0 > y1) { int t = y0; y0 = y1; y1 = t; t = x0; x0 = x1; x1 = t; }
+    if (y1 > y2) { int t = y1; y1 = y2; y2 = t; t = x1; x1 = x2; x2 = t; }
+    if (y0 > y1) { int t = y0; y0 = y1; y1 = t; t = x0; x0 = x1; x1 = t; }
+
+    for (int y = y0; y <= y2; y++) {
+        int a = (y2 == y0) ? x0 : x0 + (x2 - x0) * (y - y0) / (y2 - y0);
+        int b;
+        if (y < y1) {
+            b = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
+        } else {
+            b = (y2 == y1) ? x1 : x1 + (x2 - x1) * (y - y1) / (y2 - y1);
+        }
+        if (y2 == y0) {
+            // Flat: one row from the leftmost to the rightmost point
+            a = min(x0, min(x1, x2));
+            b = max(x0, max(x1, x2));
+        }
+        if (a > b) { int t = a; a = b; b = t; }
+        fillRect(a, y, b - a + 1, 1, color);
+    }
+}
+
+void LcdFrameBuffer::drawText(int x, int y, uint8_t size, uint16_t fg, uint16_t bg,
+                              const char* s) {
+    if (size < 1) size = 1;
+    uint16_t sfg = swap16(fg);
+    uint16_t sbg = swap16(bg);
+    int cellW = 6 * size;
+    int cellH = 8 * size;
+
+    for (; *s; s++, x += cellW) {
+        if (x >= LCD_WIDTH) break;
+        if (x + cellW <= 0 || y + cellH <= 0 || y >= LCD_HEIGHT) continue;
+        const uint8_t* glyph = font ? font + (uint8_t)*s * 5 : nullptr;
+
+        for (int py = 0; py < cellH; py++) {
+            int row = y + py;
+            if (row < 0 || row >= LCD_HEIGHT) continue;
+            uint16_t* p = pixels + row * LCD_WIDTH;
+            for (int px = 0; px < cellW; px++) {
+                int col = x + px;
+                if (col < 0 || col >= LCD_WIDTH) continue;
+                int c = px / size;
+                bool on = glyph && c < 5 && (glyph[c] >> (py / size)) & 1;
+                p[col] = on ? sfg : sbg;
+            }
+        }
+
+        int cx = x < 0 ? 0 : x;
+        int cy = y < 0 ? 0 : y;
+        int cw = min(x + cellW, LCD_WIDTH) - cx;
+        int ch = min(y + cellH, LCD_HEIGHT) - cy;
+        markDirty(cx, cy, cw, ch);
+    }
+}
+
+uint16_t LcdFrameBuffer::getPixel(int x, int y) const {
+    if (!pixels || x < 0 || y < 0 || x >= LCD_WIDTH || y >= LCD_HEIGHT) return 0;
+    return swap16(pixels[y * LCD_WIDTH + x]);
+}
+
+// ============================================
+// DIRTY BANDS AND STAGING
+// ============================================
+
+void LcdFrameBuffer::unite(LcdRect& a, const LcdRect& b) {
+    if (a.w <= 0) {
+        a = b;
+        return;
+    }
+    int16_t x0 = min(a.x, b.x);
+    int16_t y0 = min(a.y, b.y);
+    int16_t x1 = max(a.x + a.w, b.x + b.w);
+    int16_t y1 = max(a.y + a.h, b.y + b.h);
+    a.x = x0;
+    a.y = y0;
+    a.w = x1 - x0;
+    a.h = y1 - y0;
+}
+
+void LcdFrameBuffer::markDirty(int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    int first = y / LCD_FB_BAND_ROWS;
+    int last = (y + h - 1) / LCD_FB_BAND_ROWS;
+    for (int b = first; b <= last; b++) {
+        int top = max(y, b * LCD_FB_BAND_ROWS);
+        int bottom = min(y + h, (b + 1) * LCD_FB_BAND_ROWS);
+        LcdRect r = { (int16_t)x, (int16_t)top, (int16_t)w, (int16_t)(bottom - top) };
+        unite(dirty[b], r);
+    }
+}
+
+int LcdFrameBuffer::getDirtyBands() const {
+    int n = 0;
+    for (int b = 0; b < BANDS; b++) n += (dirty[b].w > 0);
+    return n;
+}
+
+void LcdFrameBuffer::publish() {
+    for (int b = 0; b < BANDS; b++) {
+        if (dirty[b].w <= 0) continue;
+        if (queued[b].w <= 0) queuedCount++;
+        unite(queued[b], dirty[b]);
+        dirty[b].w = 0;
+    }
+    service();
+}
+
+void LcdFrameBuffer::service() {
+    if (!pixels) return;
+
+    // Top to bottom, into the free slots after the staged ones
+    for (int b = 0; b < BANDS && queuedCount > 0 && stagedCount < LCD_FB_STAGING; b++) {
+        if (queued[b].w <= 0) continue;
+
+        LcdBand& band = staging[(stagedHead + stagedCount) % LCD_FB_STAGING];
+        band.rect = queued[b];
+        for (int row = 0; row < band.rect.h; row++) {
+            memcpy(band.pixels + row * band.rect.w,
+                   pixels + (band.rect.y + row) * LCD_WIDTH + band.rect.x,
+                   band.rect.w * 2);
+        }
+
+        queued[b].w = 0;
+        queuedCount--;
+        stagedCount++;
+    }
+}
+
+void LcdFrameBuffer::sent() {
+    if (stagedCount == 0) return;
+    stagedHead = (stagedHead + 1) % LCD_FB_STAGING;
+    stagedCount--;
+}
@@ -0,0 +1,164 @@
+/**
+ * Oh My Ondas - LCD Widgets Implementation
+ * Retained widget state, dirty-rectangle coalescing and SPI byte metering
+ */
+
+#include "lcd_widgets.h"
+
+// ============================================
+// SPI METER
+// ============================================
+
+LcdSpiMeter::LcdSpiMeter() {
+    reset();
+}
+
+void LcdSpiMeter::reset() {
+    frameBytes = 0;
+    lastFrame = 0;
+    peakFrame = 0;
+    frames = 0;
+    totalBytes = 0;
+}
+
+void LcdSpiMeter::fill(int w, int h) {
+    if (w > 0 && h > 0) window((uint32_t)w * h);
+}
+
+void LcdSpiMeter::text(int chars, int size) {
+    for (int i = 0; i < chars; i++) window(48u * size * size);
+}
+
+void LcdSpiMeter::outline(int w, int h) {
+    fill(w, 1);
+    fill(w, 1);
+    fill(1, h);
+    fill(1, h);
+}
+
+void LcdSpiMeter::circle(int r) {
+    // Bresenham octants: about 4√2·r pixels plus the four axis points
+    uint32_t pixels = (uint32_t)r * 566 / 100 + 4;
+    for (uint32_t i = 0; i < pixels; i++) window(1);
+}
+
+void LcdSpiMeter::disc(int r) {
+    // The centre column, then four columns per octant step
+    uint32_t lines = (uint32_t)r * 283 / 100 + 1;
+    frameBytes += lines * WINDOW_BYTES + 2 * ((uint32_t)r * r * 314 / 100);
+}
+
+void LcdSpiMeter::triangle(int w, int h) {
+    if (h < 0) h = 0;
+    frameBytes += (uint32_t)(h + 1) * WINDOW_BYTES + (uint32_t)w * h;
+}
+
+void LcdSpiMeter::endFrame() {
+    lastFrame = frameBytes;
+    if (frameBytes > peakFrame) peakFrame = frameBytes;
+    totalBytes += frameBytes;
+    frames++;
+    frameBytes = 0;
+}
+
+// ============================================
+// WIDGETS
+// ============================================
+
+LcdWidgets::LcdWidgets()
+    : clearCount(0)
+    , dirtyCount(0)
+    , retained(true)
+{
+    invalidate();
+}
+
+void LcdWidgets::invalidate() {
+    memset(widgets, 0, sizeof(widgets));
+    clearCount = 0;
+    dirtyCount = 0;
+}
+
+bool LcdWidgets::mark(int id, int x, int y, int w, int h, uint32_t key, bool opaque,
+                      uint8_t shape) {
+    if (id < 0 || id >= LCD_MAX_WIDGETS) return false;
+    LcdWidget& wd = widgets[id];
+    LcdRect r = { (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h };
+
+    bool moved = wd.drawn && (r.x != wd.rect.x || r.y != wd.rect.y ||
+                              r.w != wd.rect.w || r.h != wd.rect.h);
+    if (retained && wd.drawn && !moved && key == wd.key) return false;
+
+    bool covers = shape != 0 && wd.drawn && !moved && shape == wd.shape;
+    if (moved && !r.contains(wd.rect)) addClear(wd.rect);
+    if (!opaque && wd.drawn && !covers) addClear(r);
+
+    if (!wd.dirty) dirtyCount++;
+    wd.rect = r;
+    wd.key = key;
+    wd.shape = shape;
+    wd.drawn = true;
+    wd.dirty = true;
+    return true;
+}
+
+void LcdWidgets::commit() {
+    for (int i = 0; i < LCD_MAX_WIDGETS; i++) widgets[i].dirty = false;
+    clearCount = 0;
+    dirtyCount = 0;
+}
+
+// Merges b into a if together they are exactly a rectangle (one holds the
+// other, or they share a full edge and touch or overlap): the union then
+// clears nothing that was not already queued.
+bool LcdWidgets::mergeExact(LcdRect& a, const LcdRect& b) {
+    if (a.contains(b)) return true;
+    if (b.contains(a)) {
+        a = b;
+        return true;
+    }
+    if (a.x == b.x && a.w == b.w && b.y <= a.y + a.h && a.y <= b.y + b.h) {
+        int16_t top = a.y < b.y ? a.y : b.y;
+        int16_t bottom = (a.y + a.h) > (b.y + b.h) ? (a.y + a.h) : (b.y + b.h);
+        a.y = top;
+        a.h = bottom - top;
+        return true;
+    }
+    if (a.y == b.y && a.h == b.h && b.x <= a.x + a.w && a.x <= b.x + b.w) {
+        int16_t left = a.x < b.x ? a.x : b.x;
+        int16_t right = (a.x + a.w) > (b.x + b.w) ? (a.x + a.w) : (b.x + b.w);
+        a.x = left;
+        a.w = right - left;
+        return true;
+    }
+    return false;
+}
+
+void LcdWidgets::addClear(LcdRect r) {
+    if (r.empty()) return;
+
+    // Merge, then retry the grown rectangle against the rest
+    for (int i = 0; i < clearCount; ) {
+        if (mergeExact(r, clears[i])) {
+            clears[i] = clears[--clearCount];
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    if (clearCount < 2 * LCD_MAX_WIDGETS) clears[clearCount++] = r;
+}
+
+uint32_t LcdWidgets::hash(const void* data, size_t len, uint32_t seed) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t h = seed;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t LcdWidgets::hashText(const char* s, uint32_t seed) {
+    return hash(s, strlen(s), seed);
+}
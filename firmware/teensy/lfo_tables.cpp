@@ -0,0 +1,18 @@
+/**
+ * Oh My Ondas - LFO Tables
+ * The tables themselves, computed at compile time (see lfo_tables.h)
+ */
+
+#include "lfo_tables.h"
+
+constexpr LfoTable lfoSineTable = lfoMakeSine();
+constexpr LfoTable lfoTriangleTable = lfoMakeTriangle();
+constexpr LfoTable lfoSawTable = lfoMakeSaw();
+constexpr LfoTable lfoRandomTable = lfoMakeRandom(0x4F4D4F21u);
+
+// Fail the build rather than ship a wrong table
+static_assert(lfoSineTable.v[0] == 0 && lfoSineTable.v[LFO_TABLE_SIZE / 4] == 32767 &&
+              lfoSineTable.v[3 * LFO_TABLE_SIZE / 4] == -32767, "sine table");
+static_assert(lfoTriangleTable.v[LFO_TABLE_SIZE / 4] == 32767 &&
+              lfoTriangleTable.v[3 * LFO_TABLE_SIZE / 4] == -32767, "triangle table");
+static_assert(lfoSawTable.v[0] == -32767 && lfoSawTable.v[LFO_TABLE_SIZE] == 32767, "saw table");
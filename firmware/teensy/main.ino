@@ -17,12 +17,18 @@
 
 #include "config.h"
 #include "system_state.h"
+#include "audio_clock.h"
+#include "audio_commands.h"
 #include "sampling_engine.h"
 #include "sequencer.h"
 #include "fx_engine.h"
-#include "synth_voice.h"
+#include "poly_synth.h"
+#include "wavetable_bank.h"
 #include "scene_manager.h"
 #include "audio_recorder.h"
+#include "audio_profiler.h"
+#include "task_scheduler.h"
+#include "i2c_bus.h"
 #include "input_manager.h"
 #include "lcd_display.h"
 #include "map_display.h"
@@ -31,45 +37,7 @@
 // AUDIO OBJECTS
 // ============================================
 
-AudioInputI2S            audioInput;
-AudioAnalyzeFFT1024      fft;
-AudioAnalyzePeak         peakL, peakR;
-
-AudioPlaySdWav           player[MAX_TRACKS];
-AudioFilterStateVariable filter[MAX_TRACKS];
-AudioAmplifier           amp[MAX_TRACKS];
-
-AudioMixer4              playerMixL;
-AudioMixer4              playerMixR;
-AudioMixer4              sampleSum;
-
-AudioSynthWaveform       synthWave1;
-AudioSynthWaveform       synthWave2;
-AudioSynthNoiseWhite     synthNoise;
-AudioMixer4              synthMixer;
-AudioFilterLadder        synthFilter;
-AudioEffectEnvelope      synthEnv;
-
-AudioMixer4              inputMixer;
-AudioMixer4              masterMix;
-
-AudioMixer4              fxSend;
-AudioEffectFreeverb      reverb;
-AudioEffectDelay         delayL;
-AudioEffectBitcrusher    crusher;
-AudioEffectGranular      granular;
-AudioEffectChorus        chorus;
-AudioMixer4              fxReturn;
-AudioMixer4              fxReturn2;
-
-AudioMixer4              outputMixer;
-AudioOutputI2S           audioOutput;
-AudioRecordQueue         recorder;
-
-int16_t granularBuffer[GRANULAR_BUFFER_SIZE];
-short chorusDelayLine[CHORUS_DELAY_LENGTH];
-
-#include "audio_connections.h"
+#include "audio_objects.h"
 
 // ============================================
 // HARDWARE OBJECTS
@@ -84,6 +52,9 @@ AudioControlSGTL5000 audioShield;
 
 SystemState state;
 
+// loop() → audio ISR parameter/trigger commands
+AudioCommandQueue audioCommands;
+
 // ============================================
 // SUBSYSTEMS
 // ============================================
@@ -91,22 +62,43 @@ SystemState state;
 SamplingEngine samplingEngine;
 Sequencer      sequencer;
 FXEngine       fxEngine;
-SynthVoice     synthVoice;
+PolySynth      polySynth;
+WavetableBank  wavetables;
 SceneManager   sceneManager;
 AudioRecorder  audioRecorder;
+AudioProfiler  audioProfiler;
+TaskScheduler  scheduler;
+I2cBus         i2cBus;
 InputManager   inputManager;
 LCDDisplay     lcdDisplay;
 MapDisplay     mapDisplay;
 
+// Trigger callback, audio block callback and command handler
+#include "audio_dispatch.h"
+
 // ============================================
 // FORWARD DECLARATIONS
 // ============================================
 
 void updateAudio();
-void updateDisplay();
+bool updateDisplay();
 void updateLEDs();
 void handleESP32Communication();
 
+// Main loop tasks
+bool taskInput();
+bool taskAudio();
+bool taskSequencer();
+bool taskProfiler();
+bool taskRecorder();
+bool taskDisplay();
+bool taskDisplayFlush();
+bool taskLEDs();
+bool taskESP32();
+bool taskMap();
+bool taskGPSLog();
+bool taskStats();
+
 // Input callbacks
 void onEncoderChange(int encoderID, int delta);
 void onButtonEvent(int buttonID, bool pressed);
@@ -120,7 +112,6 @@ void onRecPressed();
 void onPlayPressed();
 void onStopPressed();
 
-void onSequencerTrigger(int track, int step, const Step& stepData);
 void processESP32Message(String message);
 void sendToESP32(const char* type, JsonObject data);
 void initSDDirectories();
@@ -144,7 +135,8 @@ void setup() {
         initSDDirectories();
     }
 
-    // I2C (shared: OLED, MPR121, MCP23017×2, ADS1115)
+    // I2C (shared: OLED, MPR121, MCP23017×2, ADS1115). Wire until the
+    // displays are up, then i2cBus takes over (below)
     Wire.begin();
     Wire.setClock(400000);
     Wire.setTimeout(1000);  // 1ms I2C timeout — prevents bus hangs
@@ -166,82 +158,29 @@ void setup() {
     audioShield.lineInLevel(5);
     audioShield.lineOutLevel(13);
 
-    // Per-track filters
-    for (int i = 0; i < MAX_TRACKS; i++) {
-        filter[i].frequency(10000);
-        filter[i].resonance(0.7);
-        amp[i].gain(1.0);
-    }
-
-    // Player sub-mixer gains
-    for (int i = 0; i < 4; i++) {
-        playerMixL.gain(i, 0.25);
-        playerMixR.gain(i, 0.25);
-    }
-    sampleSum.gain(0, 1.0);
-    sampleSum.gain(1, 1.0);
-
-    // Synth voice init
-    synthWave1.begin(0.5, 440, WAVEFORM_SAWTOOTH);
-    synthWave1.amplitude(0.0);
-    synthWave2.begin(0.5, 440, WAVEFORM_SQUARE);
-    synthWave2.amplitude(0.0);
-    synthNoise.amplitude(0.0);
-    synthMixer.gain(0, 0.5);
-    synthMixer.gain(1, 0.3);
-    synthMixer.gain(2, 0.0);
-    synthFilter.frequency(8000);
-    synthFilter.resonance(0.7);
-    synthEnv.attack(10);
-    synthEnv.decay(100);
-    synthEnv.sustain(0.7);
-    synthEnv.release(200);
-
-    // Input mixer
-    inputMixer.gain(0, 0.5);
-    inputMixer.gain(1, 0.5);
-
-    // Master mix
-    masterMix.gain(0, 0.8);
-    masterMix.gain(1, 0.5);
-    masterMix.gain(2, 0.3);
-
-    // FX send/return
-    fxSend.gain(0, 1.0);
-    fxSend.gain(1, 0.3);
-    fxReturn.gain(0, 0.0);
-    fxReturn.gain(1, 0.0);
-    fxReturn.gain(2, 0.0);
-    fxReturn.gain(3, 0.0);
-    fxReturn2.gain(0, 0.0);
-
-    // Output mixer
-    outputMixer.gain(0, 0.8);
-    outputMixer.gain(1, 0.5);
-    outputMixer.gain(2, 0.5);
-
-    // Effects init
-    reverb.roomsize(0.7);
-    reverb.damping(0.5);
-    delayL.delay(0, 250);
-    crusher.bits(12);
-    crusher.sampleRate(22050);
-    granular.begin(granularBuffer, GRANULAR_BUFFER_SIZE);
-    chorus.begin(chorusDelayLine, CHORUS_DELAY_LENGTH, 2);
+    // Mixer, filter and effect levels
+    initAudioGraph();
 
     // Subsystem init
-    samplingEngine.begin(player, amp);
+    samplingEngine.begin(player, memPlayer, amp);
     sequencer.begin(state.bpm);
     sequencer.setTriggerCallback(onSequencerTrigger);
+    sequencer.setNoteCallback(onSequencerNote);
+    sequencer.setClockSource(CLOCK_AUDIO);
+    audioCommands.setHandler(applyAudioCommand);
+    audioClock.setBlockCallback(onAudioBlock);
     fxEngine.begin(&reverb, &delayL, &crusher, &granular, &chorus,
-                   filter, &fxReturn, &fxReturn2, &fxSend);
-    synthVoice.begin(&synthWave1, &synthWave2, &synthNoise,
-                     &synthMixer, &synthFilter, &synthEnv);
+                   filterCtl, &fxReturn, &fxReturn2, &fxSend, &modMatrix);
+    polySynth.begin(synthWave1, synthWave2, &synthNoise,
+                    synthMixer, synthFilterCtl, synthEnv);
+    wavetables.begin();
     sceneManager.begin();
     audioRecorder.begin(&recorder);
+    audioProfiler.begin(&audioClock);
+    addProfiledObjects(audioProfiler);
 
     // Input manager (MCP23017, ADS1115, direct GPIO, touch)
-    inputManager.begin();
+    inputManager.begin(&i2cBus);
     inputManager.setEncoderCallback(onEncoderChange);
     inputManager.setButtonCallback(onButtonEvent);
     inputManager.setFaderCallback(onFaderChange);
@@ -250,11 +189,29 @@ void setup() {
 
     // Displays
     lcdDisplay.begin();
-    mapDisplay.begin();
+    mapDisplay.begin(&i2cBus);
+
+    // From here on no I2C transfer blocks the loop
+    i2cBus.begin();
 
     // ESP32 UART
     Serial2.begin(115200);
 
+    // Main loop tasks. Every pass: the latency-critical work. Periodic:
+    // one slice per pass, most urgent first (task_scheduler.h)
+    scheduler.addEveryPass("input", taskInput);
+    scheduler.addEveryPass("audio", taskAudio);
+    scheduler.addEveryPass("sequencer", taskSequencer);
+    scheduler.addEveryPass("profiler", taskProfiler);
+    scheduler.addEveryPass("lcdflush", taskDisplayFlush);   // Starts DMA, never waits
+    scheduler.addPeriodic("recorder", taskRecorder, 10, TASK_PRIO_HIGH);
+    scheduler.addPeriodic("lcd", taskDisplay, 50, TASK_PRIO_NORMAL);
+    scheduler.addPeriodic("leds", taskLEDs, 50, TASK_PRIO_NORMAL);
+    scheduler.addPeriodic("esp32", taskESP32, 100, TASK_PRIO_NORMAL);
+    scheduler.addPeriodic("map", taskMap, 200, TASK_PRIO_LOW);      // OLED is slow
+    scheduler.addPeriodic("gpslog", taskGPSLog, 10000, TASK_PRIO_LOW);
+    scheduler.addPeriodic("stats", taskStats, 10000, TASK_PRIO_LOW);
+
     Serial.println("Initialization complete!");
     Serial.printf("Audio CPU: %.2f%%, Memory: %d blocks\n",
                   AudioProcessorUsage(), AudioMemoryUsage());
@@ -265,7 +222,7 @@ void setup() {
 // ============================================
 
 void initSDDirectories() {
-    const char* dirs[] = { "/samples", "/patterns", "/recordings", "/presets" };
+    const char* dirs[] = { "/samples", "/patterns", "/recordings", "/presets", "/wavetables" };
     for (auto dir : dirs) {
         if (!SD.exists(dir)) {
             SD.mkdir(dir);
@@ -279,84 +236,134 @@ void initSDDirectories() {
 // ============================================
 
 void loop() {
-    // High priority: input + audio (every loop)
+    scheduler.run();
+}
+
+// ============================================
+// MAIN LOOP TASKS
+// ============================================
+
+bool taskInput() {
+    // Completion callbacks first: they deliver the reads queued last pass
+    i2cBus.service();
     inputManager.update();
+    return true;
+}
+
+bool taskAudio() {
     updateAudio();
-    audioRecorder.update();
-
-    // Display updates (every 50ms)
-    static unsigned long lastDisplay = 0;
-    if (millis() - lastDisplay >= 50) {
-        updateDisplay();
-        updateLEDs();
-        lastDisplay = millis();
-    }
+    return true;
+}
 
-    // ESP32 communication (every 100ms)
-    static unsigned long lastSerial = 0;
-    if (millis() - lastSerial >= 100) {
-        handleESP32Communication();
-        lastSerial = millis();
+bool taskSequencer() {
+    // Sequencer (millis clock, dispatch of audio-clock triggers, pattern
+    // switches and SD writeback: runs while stopped too)
+    sequencer.update();
+    state.currentPattern = sequencer.getCurrentPattern();
+    state.queuedPattern = sequencer.getQueuedPattern();
+
+    // A full lock pool refused an edit or an import
+    static uint32_t droppedLocksSeen = 0;
+    uint32_t droppedLocks = sequencer.getDroppedLocks();
+    if (droppedLocks != droppedLocksSeen) {
+        droppedLocksSeen = droppedLocks;
+        lcdDisplay.showError("LOCKS FULL");
     }
 
-    // Map display update (every 200ms — OLED is slow)
-    static unsigned long lastMap = 0;
-    if (millis() - lastMap >= 200) {
-        mapDisplay.update(state.gps.lat, state.gps.lon, state.gps.valid);
-        lastMap = millis();
+    // The bank's shared step pages ran out under a step edit
+    static uint32_t refusedStepsSeen = 0;
+    uint32_t refusedSteps = sequencer.getRefusedSteps();
+    if (refusedSteps != refusedStepsSeen) {
+        refusedStepsSeen = refusedSteps;
+        lcdDisplay.showError("PATTERN FULL");
     }
+    return true;
+}
 
-    // GPS breadcrumb logging (every 10s)
-    static unsigned long lastGPSLog = 0;
-    if (state.gps.valid && millis() - lastGPSLog >= 10000) {
-        File gpsFile = SD.open("/gps_log.csv", FILE_WRITE);
-        if (gpsFile) {
-            gpsFile.printf("%lu,%.6f,%.6f\n", millis(), state.gps.lat, state.gps.lon);
-            gpsFile.close();
-        }
-        lastGPSLog = millis();
-    }
+bool taskProfiler() {
+    audioProfiler.update();
+    return true;
+}
 
-    // Sequencer (tempo-synced)
-    if (state.isPlaying) {
-        sequencer.update();
-    }
+bool taskRecorder() {
+    return audioRecorder.update();
+}
 
-    // Synth LFO
-    synthVoice.update();
+bool taskDisplay() {
+    return updateDisplay();
 }
 
-// ============================================
-// SEQUENCER TRIGGER CALLBACK
-// ============================================
+bool taskDisplayFlush() {
+    return lcdDisplay.flush();
+}
 
-void onSequencerTrigger(int track, int step, const Step& stepData) {
-    float vel = stepData.velocity / 127.0f;
-    amp[track].gain(vel);
+bool taskLEDs() {
+    updateLEDs();
+    return true;
+}
 
-    if (stepData.hasParamLock[PARAM_FILTER_FREQ]) {
-        filter[track].frequency(stepData.paramLocks[PARAM_FILTER_FREQ]);
-    }
-    if (stepData.hasParamLock[PARAM_FILTER_RES]) {
-        filter[track].resonance(stepData.paramLocks[PARAM_FILTER_RES]);
-    }
-    if (stepData.hasParamLock[PARAM_VOLUME]) {
-        amp[track].gain(stepData.paramLocks[PARAM_VOLUME] * vel);
-    }
-    if (stepData.hasParamLock[PARAM_PITCH]) {
-        samplingEngine.setPitch(track, powf(2.0f, stepData.paramLocks[PARAM_PITCH] / 12.0f));
-    } else if (stepData.pitchOffset != 0) {
-        samplingEngine.setPitch(track, powf(2.0f, stepData.pitchOffset / 12.0f));
+bool taskESP32() {
+    handleESP32Communication();
+    return true;
+}
+
+bool taskMap() {
+    return mapDisplay.update(state.gps.lat, state.gps.lon, state.gps.valid);
+}
+
+bool taskGPSLog() {
+    // GPS breadcrumb
+    if (!state.gps.valid) return true;
+    File gpsFile = SD.open("/gps_log.csv", FILE_WRITE);
+    if (gpsFile) {
+        gpsFile.printf("%lu,%.6f,%.6f\n", millis(), state.gps.lat, state.gps.lon);
+        gpsFile.close();
     }
+    return true;
+}
 
-    samplingEngine.trigger(track);
-    DEBUG_PRINTF("Trigger: T%d S%d vel=%.2f\n", track, step, vel);
+bool taskStats() {
+    // Alongside the audio profiler's rows
+    if (!audioProfiler.isEnabled()) return true;
+    scheduler.printStats(Serial);
+
+    const LcdSpiMeter& spi = lcdDisplay.getSpiMeter();
+    Serial.println("lcd,frames,avg_bytes,peak_bytes,last_bytes");
+    Serial.printf("lcd,%lu,%lu,%lu,%lu\n", (unsigned long)spi.getFrames(),
+                  (unsigned long)spi.getAverageFrameBytes(),
+                  (unsigned long)spi.getPeakFrameBytes(),
+                  (unsigned long)spi.getLastFrameBytes());
+
+    // Bus utilization: share of the time since the last row that a
+    // transfer was on the bus
+    static uint32_t lastBusy = 0;
+    static uint32_t lastAt = 0;
+    const I2cQueue& i2c = i2cBus.getQueue();
+    uint32_t busy = i2c.getBusyMicros();
+    uint32_t at = micros();
+    float busyPct = lastAt ? 100.0f * (busy - lastBusy) / (at - lastAt) : 0.0f;
+    lastBusy = busy;
+    lastAt = at;
+    Serial.println("i2c,completed,failed,dropped,timeouts,peak_depth,busy_pct");
+    Serial.printf("i2c,%lu,%lu,%lu,%lu,%d,%.1f\n", (unsigned long)i2c.getCompleted(),
+                  (unsigned long)i2c.getFailed(), (unsigned long)i2c.getDropped(),
+                  (unsigned long)i2cBus.getTimeouts(), i2c.getPeakDepth(), busyPct);
+
+    Serial.println("fader,reports,avg_latency_us,peak_latency_us");
+    Serial.printf("fader,%lu,%lu,%lu\n", (unsigned long)inputManager.getFaderReports(),
+                  (unsigned long)inputManager.getFaderLatencyAvgMicros(),
+                  (unsigned long)inputManager.getFaderLatencyPeakMicros());
+    return true;
 }
 
 // ============================================
 // ENCODER CALLBACK — All 13 encoders
 // ============================================
 
+// SHIFT+REL: 0 = built-in shapes, 1.. = wavetable slot + 1 (an empty
+// slot plays the built-in shapes)
+static int osc1Table = 0;
+
 void onEncoderChange(int encoderID, int delta) {
     DEBUG_PRINTF("Encoder %d: %+d (shift: %d)\n", encoderID, delta, state.shiftPressed);
 
@@ -390,7 +397,7 @@ void onEncoderChange(int encoderID, int delta) {
 
         case ENC_FILT:
             if (state.shiftPressed) {
-                fxEngine.setLFORate(fxEngine.getLFOValue() + delta * 0.1f);
+                modMatrix.setLFORate(0, modMatrix.getLFORate(0) + delta * 0.1f);
             } else {
                 fxEngine.adjustParam(0, delta * 0.01f);
             }
@@ -415,16 +422,51 @@ void onEncoderChange(int encoderID, int delta) {
 
         // ── MCP Encoders (synth/FX) ──
         case ENC_CUT:
-            synthVoice.setFilterFreq(constrain(100.0f + delta * 100.0f, 20.0f, 20000.0f));
+            if (state.mode == MODE_PATTERN && state.shiftPressed) {
+                // Selected track length
+                int t = sequencer.getSelectedTrack();
+                sequencer.setTrackLength(t, sequencer.getTrackLength(t) + delta);
+                break;
+            }
+            // A semitone a step, so an accelerated turn sweeps octaves
+            polySynth.setFilterFreq(constrain(polySynth.getFilterFreq() * exp2f(delta / 12.0f),
+                                              20.0f, 15000.0f));
             break;
         case ENC_RES:
-            synthVoice.setFilterRes(constrain(0.7f + delta * 0.1f, 0.1f, 5.0f));
+            if (state.mode == MODE_PATTERN && state.shiftPressed) {
+                // Selected track speed
+                int t = sequencer.getSelectedTrack();
+                int speed = constrain((int)sequencer.getTrackSpeed(t) + delta, 0, SPEED_COUNT - 1);
+                sequencer.setTrackSpeed(t, (TrackSpeed)speed);
+                break;
+            }
+            polySynth.setFilterRes(constrain(polySynth.getFilterRes() + delta * 0.1f, 0.1f, 5.0f));
             break;
         case ENC_ATK:
-            synthVoice.setAttack(constrain(10.0f + delta * 5.0f, 1.0f, 5000.0f));
+            if (state.mode == MODE_PATTERN && state.shiftPressed) {
+                // Selected track: up = synth notes, down = its sample slot
+                int t = sequencer.getSelectedTrack();
+                sequencer.setTrackType(t, delta > 0 ? TRACK_SYNTH : TRACK_SAMPLE);
+                lcdDisplay.showMessage(delta > 0 ? "SYNTH TRACK" : "SAMPLE TRACK");
+                break;
+            }
+            if (state.shiftPressed) {
+                // Scan osc 1 across its wavetable frames
+                polySynth.setOsc1Morph(polySynth.getOsc1Morph() + delta * 0.05f);
+                break;
+            }
+            // Envelope times: ~9% a step, 1ms to 5s in under 100 steps
+            polySynth.setAttack(constrain(polySynth.getAttack() * exp2f(delta / 8.0f), 1.0f, 5000.0f));
             break;
         case ENC_REL:
-            synthVoice.setRelease(constrain(200.0f + delta * 20.0f, 1.0f, 10000.0f));
+            if (state.shiftPressed) {
+                // Osc 1 table: built-in shapes, then each loaded user slot
+                const int tables = WAVETABLE_SLOTS + 1;
+                osc1Table = (((osc1Table + delta) % tables) + tables) % tables;
+                polySynth.setOsc1Wavetable(osc1Table ? wavetables.get(osc1Table - 1) : nullptr);
+                break;
+            }
+            polySynth.setRelease(constrain(polySynth.getRelease() * exp2f(delta / 8.0f), 1.0f, 10000.0f));
             break;
         case ENC_DLY:
             fxEngine.adjustParam(0, delta * 0.01f);  // Delay time
@@ -479,6 +521,11 @@ void onButtonEvent(int buttonID, bool pressed) {
             onRecPressed();
             break;
         case BTN_MENU:
+            if (state.shiftPressed) {
+                // Audio profiler: top-N on SETTINGS, CSV on serial
+                audioProfiler.setEnabled(!audioProfiler.isEnabled());
+                lcdDisplay.showMessage(audioProfiler.isEnabled() ? "PROFILE ON" : "PROFILE OFF");
+            }
             lcdDisplay.setScreen(LCD_SETTINGS);
             break;
         case BTN_BACK:
@@ -504,7 +551,7 @@ void onButtonEvent(int buttonID, bool pressed) {
             } else {
                 // Clear current step
                 int sel = sequencer.getSelectedTrack();
-                int step = sequencer.getCurrentStep();
+                int step = sequencer.getTrackStep(sel);
                 sequencer.setStep(sel, step, false);
             }
             break;
@@ -524,11 +571,15 @@ void onButtonEvent(int buttonID, bool pressed) {
             }
             break;
         case BTN_PREV:
-            if (state.mode == MODE_PATTERN) {
-                int pat = sequencer.getCurrentPattern();
+            if (state.mode == MODE_PATTERN && state.shiftPressed) {
+                // Step page
+                if (state.stepPage > 0) state.stepPage--;
+            } else if (state.mode == MODE_PATTERN) {
+                // Step from the queued pattern so repeated presses walk on
+                int pat = sequencer.getQueuedPattern();
+                if (pat < 0) pat = sequencer.getCurrentPattern();
                 if (pat > 0) {
-                    sequencer.loadPattern(pat - 1);
-                    state.currentPattern = pat - 1;
+                    sequencer.queuePattern(pat - 1);
                 }
             } else {
                 // Navigate tracks
@@ -537,11 +588,15 @@ void onButtonEvent(int buttonID, bool pressed) {
             }
             break;
         case BTN_NEXT:
-            if (state.mode == MODE_PATTERN) {
-                int pat = sequencer.getCurrentPattern();
+            if (state.mode == MODE_PATTERN && state.shiftPressed) {
+                int len = sequencer.getTrackLength(sequencer.getSelectedTrack());
+                if ((state.stepPage + 1) * STEPS_PER_PAGE < len) state.stepPage++;
+            } else if (state.mode == MODE_PATTERN) {
+                // Step from the queued pattern so repeated presses walk on
+                int pat = sequencer.getQueuedPattern();
+                if (pat < 0) pat = sequencer.getCurrentPattern();
                 if (pat < MAX_PATTERNS - 1) {
-                    sequencer.loadPattern(pat + 1);
-                    state.currentPattern = pat + 1;
+                    sequencer.queuePattern(pat + 1);
                 }
             } else {
                 int t = sequencer.getSelectedTrack();
@@ -611,6 +666,11 @@ void onJoystickChange(uint8_t directions) {
 // TOUCH PAD CALLBACK
 // ============================================
 
+// SHIFT+pad synth notes: C major from middle C
+static const uint8_t padNotes[] = { 60, 62, 64, 65, 67, 69, 71, 72 };
+// DUB pads holding a synth note, released with the pad whatever SHIFT does
+static bool dubNoteHeld[MAX_PADS];
+
 void onTouchEvent(int pad, bool pressed) {
     if (pressed) {
         DEBUG_PRINTF("Pad %d pressed\n", pad);
@@ -618,19 +678,15 @@ void onTouchEvent(int pad, bool pressed) {
         switch (state.mode) {
             case MODE_LIVE:
                 if (state.shiftPressed) {
-                    static const float noteFreqs[] = {
-                        261.63, 293.66, 329.63, 349.23,
-                        392.00, 440.00, 493.88, 523.25
-                    };
-                    synthVoice.noteOn(noteFreqs[pad], 0.8);
+                    polySynth.noteOn(padNotes[pad], 0.8);
                 } else {
-                    samplingEngine.trigger(pad);
+                    audioCommands.post(CMD_TRIGGER, pad, 0.0f, audioNow());
                 }
                 break;
 
             case MODE_PATTERN:
                 if (state.shiftPressed) {
-                    sequencer.toggleStep(pad);
+                    sequencer.toggleStep(state.stepPage * STEPS_PER_PAGE + pad);
                 } else {
                     sequencer.selectTrack(pad);
                 }
@@ -675,9 +731,24 @@ void onTouchEvent(int pad, bool pressed) {
                 break;
 
             case MODE_DUB:
-                samplingEngine.trigger(pad);
+                if (state.shiftPressed &&
+                    sequencer.getTrackType(sequencer.getSelectedTrack()) == TRACK_SYNTH) {
+                    // SHIFT+pad: a note on the selected synth track
+                    int t = sequencer.getSelectedTrack();
+                    polySynth.noteOn(padNotes[pad], 0.8);
+                    dubNoteHeld[pad] = true;
+                    if (state.isPlaying) {
+                        int step = sequencer.getTrackStep(t);
+                        sequencer.setStep(t, step, true);
+                        sequencer.setNote(t, step, padNotes[pad]);
+                        DEBUG_PRINTF("DUB: recorded note %d on T%d at step %d\n",
+                                     padNotes[pad], t, step);
+                    }
+                    break;
+                }
+                audioCommands.post(CMD_TRIGGER, pad, 0.0f, audioNow());
                 if (state.isPlaying) {
-                    int step = sequencer.getCurrentStep();
+                    int step = sequencer.getTrackStep(pad);
                     sequencer.setStep(pad, step, true);
                     DEBUG_PRINTF("DUB: recorded pad %d at step %d\n", pad, step);
                 }
@@ -691,11 +762,16 @@ void onTouchEvent(int pad, bool pressed) {
         ledRing.show();
     } else {
         // Release
+        if (dubNoteHeld[pad]) {
+            polySynth.noteOff(padNotes[pad]);
+            dubNoteHeld[pad] = false;
+        }
         if (state.mode == MODE_LIVE) {
-            if (state.shiftPressed) {
-                synthVoice.noteOff();
-            } else if (!samplingEngine.isLooping(pad)) {
-                samplingEngine.stop(pad);
+            // Whether or not SHIFT is still down: it may have been let go
+            // before the pad
+            polySynth.noteOff(padNotes[pad]);
+            if (!state.shiftPressed && !samplingEngine.isLooping(pad)) {
+                audioCommands.post(CMD_STOP, pad, 0.0f, audioNow());
             }
         }
         ledRing.setPixelColor(pad, ledRing.Color(0, 0, 0));
@@ -783,9 +859,9 @@ void updateAudio() {
 // DISPLAY UPDATE
 // ============================================
 
-void updateDisplay() {
-    lcdDisplay.update(state, sequencer, fxEngine, samplingEngine,
-                      synthVoice, sceneManager, inputManager);
+bool updateDisplay() {
+    return lcdDisplay.update(state, sequencer, fxEngine, samplingEngine,
+                             polySynth, sceneManager, inputManager, audioProfiler);
 }
 
 // ============================================
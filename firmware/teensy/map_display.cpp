@@ -9,12 +9,15 @@
 
 MapDisplay::MapDisplay()
     : oled(nullptr)
+    , bus(nullptr)
     , ready(false)
     , trailHead(0), trailCount(0)
     , curLat(0), curLon(0), hasPosition(false)
     , zoom(5.0f)
     , statusMode(true)
-    , lastUpdate(0)
+    , pushPage(-1)
+    , pushChunk(-1)
+    , chunkInFlight(false)
 {
     statusLine1[0] = '\0';
     statusLine2[0] = '\0';
@@ -24,7 +27,8 @@ MapDisplay::~MapDisplay() {
     delete oled;
 }
 
-void MapDisplay::begin() {
+void MapDisplay::begin(I2cBus* i2c) {
+    bus = i2c;
     oled = new Adafruit_SSD1306(OLED_WIDTH, OLED_HEIGHT, &Wire, OLED_RESET);
     if (oled->begin(SSD1306_SWITCHCAPVCC, ADDR_SSD1306)) {
         ready = true;
@@ -42,13 +46,28 @@ void MapDisplay::begin() {
     }
 }
 
-void MapDisplay::update(float lat, float lon, bool gpsValid) {
-    if (!ready || !oled) return;
+bool MapDisplay::update(float lat, float lon, bool gpsValid) {
+    if (!ready || !oled) return true;
+
+    if (pushPage < 0) {
+        compose(lat, lon, gpsValid);
+        pushPage = 0;
+        pushChunk = -1;
+        return false;
+    }
 
-    unsigned long now = millis();
-    if (now - lastUpdate < 200) return;
-    lastUpdate = now;
+    // The chunks of a page chain through their callbacks; a slice starts
+    // each page (or retries a chunk the full queue refused)
+    if (chunkInFlight) return false;
+    if (pushPage < OLED_HEIGHT / 8) {
+        sendChunk();
+        return false;
+    }
+    pushPage = -1;
+    return true;
+}
 
+void MapDisplay::compose(float lat, float lon, bool gpsValid) {
     if (gpsValid) {
         statusMode = false;
         if (!hasPosition || haversineMeters(curLat, curLon, lat, lon) > 1.0f) {
@@ -66,7 +85,46 @@ void MapDisplay::update(float lat, float lon, bool gpsValid) {
         oled->setCursor(0, 0);
         oled->setTextColor(SSD1306_WHITE, SSD1306_BLACK);
         oled->print("NO FIX");
-        oled->display();
+    }
+}
+
+// One 8-pixel row of the frame buffer, as display() sends the whole of
+// it: the page and column window, then the row in 32-byte chunks
+void MapDisplay::sendChunk() {
+    const int chunk = I2C_MAX_WRITE - 1;    // Less the control byte
+    uint8_t tx[I2C_MAX_WRITE];
+    int len;
+
+    if (pushChunk < 0) {
+        tx[0] = 0x00;   // Co = 0, D/C = 0: commands
+        tx[1] = SSD1306_PAGEADDR;
+        tx[2] = pushPage;
+        tx[3] = pushPage;
+        tx[4] = SSD1306_COLUMNADDR;
+        tx[5] = 0;
+        tx[6] = OLED_WIDTH - 1;
+        len = 7;
+    } else {
+        const uint8_t* data = oled->getBuffer() + pushPage * OLED_WIDTH + pushChunk * chunk;
+        int n = min(chunk, OLED_WIDTH - pushChunk * chunk);
+        tx[0] = 0x40;   // Co = 0, D/C = 1: data
+        memcpy(tx + 1, data, n);
+        len = n + 1;
+    }
+    chunkInFlight = bus && bus->submit(ADDR_SSD1306, tx, len, 0, onChunkSent, this);
+}
+
+void MapDisplay::onChunkSent(const I2cTransfer& t, void* ctx) {
+    MapDisplay* self = (MapDisplay*)ctx;
+    const int chunks = (OLED_WIDTH + I2C_MAX_WRITE - 2) / (I2C_MAX_WRITE - 1);
+    (void)t;    // A lost chunk is redrawn with the next frame
+
+    self->chunkInFlight = false;
+    if (++self->pushChunk < chunks) {
+        self->sendChunk();
+    } else {
+        self->pushPage++;
+        self->pushChunk = -1;
     }
 }
 
@@ -144,8 +202,6 @@ void MapDisplay::drawMap() {
 
     oled->setCursor(OLED_WIDTH - 8, 10);
     oled->print("N");
-
-    oled->display();
 }
 
 void MapDisplay::drawStatusScreen() {
@@ -164,8 +220,6 @@ void MapDisplay::drawStatusScreen() {
     int dots = (millis() / 500) % 4;
     oled->setCursor(16, 50);
     for (int i = 0; i < dots; i++) oled->print(".");
-
-    oled->display();
 }
 
 int MapDisplay::lonToX(float lon) {
@@ -0,0 +1,209 @@
+/**
+ * Oh My Ondas - Modulation Matrix Implementation
+ * LFOs, envelope followers and route evaluation, once per audio block
+ */
+
+#include "mod_matrix.h"
+
+// ============================================
+// ENVELOPE FOLLOWER
+// ============================================
+
+static float blockCoef(float ms) {
+    const float blockMs = AUDIO_BLOCK_SAMPLES * 1000.0f / AUDIO_SAMPLE_RATE_EXACT;
+    if (ms <= blockMs) return 1.0f;
+    return 1.0f - expf(-blockMs / ms);
+}
+
+AudioAnalyzeEnvelope::AudioAnalyzeEnvelope()
+    : AudioStream(1, inputQueueArray)
+    , level(0.0f)
+{
+    attack(MOD_ENV_ATTACK_MS);
+    release(MOD_ENV_RELEASE_MS);
+}
+
+void AudioAnalyzeEnvelope::attack(float ms) {
+    attackCoef = blockCoef(ms);
+}
+
+void AudioAnalyzeEnvelope::release(float ms) {
+    releaseCoef = blockCoef(ms);
+}
+
+void AudioAnalyzeEnvelope::update(void) {
+    int32_t peak = 0;
+    audio_block_t* block = receiveReadOnly();
+    if (block) {
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+            int32_t v = block->data[i];
+            if (v < 0) v = -v;
+            if (v > peak) peak = v;
+        }
+        AudioStream::release(block);    // release(ms) hides it
+    }
+
+    // No block is silence: fall at the release rate
+    float p = peak * (1.0f / 32768.0f);
+    float l = level;
+    l += (p > l ? attackCoef : releaseCoef) * (p - l);
+    level = l;
+}
+
+// ============================================
+// MATRIX
+// ============================================
+
+ModMatrix::ModMatrix()
+    : envelopes(nullptr)
+{
+    for (int i = 0; i < MOD_LFO_COUNT; i++) {
+        lfos[i].shape = LFO_SINE;
+        lfos[i].holdIndex = (uint16_t)(i * (LFO_TABLE_SIZE / MOD_LFO_COUNT));   // Apart
+        setLFORate(i, 1.0f);
+    }
+    clearRoutes();
+    for (int i = 0; i < MOD_SRC_COUNT; i++) sources[i] = 0.0f;
+    for (int i = 0; i < MOD_DST_COUNT; i++) {
+        values[i] = isGainDest((ModDest)i) ? 1.0f : 0.0f;
+    }
+}
+
+void ModMatrix::begin(AudioAnalyzeEnvelope* envs) {
+    envelopes = envs;
+    DEBUG_PRINTF("ModMatrix: %d LFOs, %d envelopes, %d routes\n",
+                 MOD_LFO_COUNT, envs ? MOD_ENV_COUNT : 0, MOD_MAX_ROUTES);
+}
+
+// LFOs
+void ModMatrix::setLFORate(int lfo, float hz) {
+    if (lfo < 0 || lfo >= MOD_LFO_COUNT) return;
+    hz = constrain(hz, 0.01f, 20.0f);
+    lfos[lfo].rate = hz;
+    lfos[lfo].osc.setFrequency(hz, AUDIO_SAMPLE_RATE_EXACT);
+}
+
+void ModMatrix::setLFOShape(int lfo, LfoShape shape) {
+    if (lfo < 0 || lfo >= MOD_LFO_COUNT || shape >= LFO_SHAPE_COUNT) return;
+    lfos[lfo].shape = shape;
+}
+
+float ModMatrix::getLFORate(int lfo) const {
+    return (lfo >= 0 && lfo < MOD_LFO_COUNT) ? lfos[lfo].rate : 0.0f;
+}
+
+LfoShape ModMatrix::getLFOShape(int lfo) const {
+    return (lfo >= 0 && lfo < MOD_LFO_COUNT) ? (LfoShape)lfos[lfo].shape : LFO_SINE;
+}
+
+// Routes
+void ModMatrix::setRoute(int slot, ModSource source, ModDest dest, float depth) {
+    if (slot < 0 || slot >= MOD_MAX_ROUTES) return;
+    if (source >= MOD_SRC_COUNT || dest >= MOD_DST_COUNT) return;
+    // One consistent route for the ISR
+    __disable_irq();
+    routes[slot].source = source;
+    routes[slot].dest = dest;
+    routes[slot].depth = constrain(depth, -1.0f, 1.0f);
+    __enable_irq();
+}
+
+int ModMatrix::addRoute(ModSource source, ModDest dest, float depth) {
+    int slot = -1;
+    for (int i = 0; i < MOD_MAX_ROUTES; i++) {
+        if (routes[i].source == source && routes[i].dest == dest) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && routes[i].source == MOD_SRC_NONE) slot = i;
+    }
+    if (slot >= 0) setRoute(slot, source, dest, depth);
+    return slot;
+}
+
+void ModMatrix::clearRoute(int slot) {
+    if (slot < 0 || slot >= MOD_MAX_ROUTES) return;
+    routes[slot].source = MOD_SRC_NONE;
+}
+
+void ModMatrix::clearRoutes() {
+    for (int i = 0; i < MOD_MAX_ROUTES; i++) {
+        routes[i].source = MOD_SRC_NONE;
+        routes[i].dest = 0;
+        routes[i].depth = 0.0f;
+    }
+}
+
+int ModMatrix::getRouteCount() const {
+    int n = 0;
+    for (int i = 0; i < MOD_MAX_ROUTES; i++) {
+        if (routes[i].source != MOD_SRC_NONE) n++;
+    }
+    return n;
+}
+
+float ModMatrix::apply(ModDest dest, float base) const {
+    return constrain(base + value(dest), 0.0f, 1.0f);
+}
+
+// ============================================
+// PER BLOCK
+// ============================================
+
+float ModMatrix::lfoValue(Lfo& lfo, bool wrapped) {
+    uint32_t phase = lfo.osc.phase;
+    switch (lfo.shape) {
+        case LFO_TRIANGLE:
+            return lfoRead(lfoTriangleTable, phase);
+        case LFO_SAW:
+            return lfoRead(lfoSawTable, phase);
+        case LFO_SQUARE:
+            return phase < 0x80000000u ? 1.0f : -1.0f;
+        case LFO_SAMPLE_HOLD:
+            // A new value each cycle
+            if (wrapped) lfo.holdIndex++;
+            return lfoStep(lfoRandomTable, lfo.holdIndex);
+        case LFO_SINE:
+        default:
+            return lfoRead(lfoSineTable, phase);
+    }
+}
+
+void ModMatrix::process(uint16_t blockSamples) {
+    // Sources, at the end of this block's phase step
+    for (int i = 0; i < MOD_LFO_COUNT; i++) {
+        bool wrapped = lfos[i].osc.advance(blockSamples);
+        sources[MOD_SRC_LFO1 + i] = lfoValue(lfos[i], wrapped);
+    }
+    for (int i = 0; i < MOD_ENV_COUNT; i++) {
+        sources[MOD_SRC_ENV1 + i] = envelopes ? envelopes[i].read() : 0.0f;
+    }
+
+    // Routes. Gain destinations sum how far each route pulls the level
+    // down: depth × the source as 0..1, or × its complement below 0
+    float sum[MOD_DST_COUNT];
+    for (int d = 0; d < MOD_DST_COUNT; d++) sum[d] = 0.0f;
+
+    for (int r = 0; r < MOD_MAX_ROUTES; r++) {
+        const ModRoute& route = routes[r];
+        if (route.source == MOD_SRC_NONE || route.source >= MOD_SRC_COUNT) continue;
+        float s = sources[route.source];
+        if (isGainDest((ModDest)route.dest)) {
+            float u = route.source < MOD_SRC_ENV1 ? 0.5f + 0.5f * s : s;
+            sum[route.dest] += route.depth >= 0.0f ? route.depth * u : -route.depth * (1.0f - u);
+        } else {
+            sum[route.dest] += route.depth * s;
+        }
+    }
+
+    values[MOD_DST_FX_PARAM1] = sum[MOD_DST_FX_PARAM1] * MOD_FX_RANGE;
+    values[MOD_DST_FX_PARAM2] = sum[MOD_DST_FX_PARAM2] * MOD_FX_RANGE;
+    values[MOD_DST_FX_PARAM3] = sum[MOD_DST_FX_PARAM3] * MOD_FX_RANGE;
+    values[MOD_DST_FX_MIX] = sum[MOD_DST_FX_MIX] * MOD_FX_RANGE;
+    values[MOD_DST_SYNTH_CUTOFF] = sum[MOD_DST_SYNTH_CUTOFF] * MOD_CUTOFF_OCTAVES;
+    values[MOD_DST_SYNTH_PITCH] = sum[MOD_DST_SYNTH_PITCH] * MOD_PITCH_SEMITONES;
+    // The rest are gain destinations
+    for (int d = MOD_DST_SYNTH_LEVEL; d < MOD_DST_COUNT; d++) {
+        values[d] = constrain(1.0f - sum[d], 0.0f, 1.0f);
+    }
+}
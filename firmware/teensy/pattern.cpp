@@ -0,0 +1,306 @@
+/**
+ * Oh My Ondas - Pattern Implementation
+ * Pattern data structures, the binary pattern file format and the
+ * pattern bank
+ */
+
+#include "pattern.h"
+#include <string.h>
+
+const uint8_t trackSpeedTicks[SPEED_COUNT] = {
+    SEQ_TICKS_PER_STEP * 8,         // 1/8x
+    SEQ_TICKS_PER_STEP * 4,         // 1/4x
+    SEQ_TICKS_PER_STEP * 2,         // 1/2x
+    SEQ_TICKS_PER_STEP * 4 / 3,     // 3/4x
+    SEQ_TICKS_PER_STEP,             // 1x
+    SEQ_TICKS_PER_STEP * 2 / 3,     // 3/2x
+    SEQ_TICKS_PER_STEP / 2          // 2x
+};
+
+const Step emptyStep = { false, TRIG_ALWAYS, 127, 0, 0, 0, 0, 0, 0, 0, 100,
+                         SEQ_DEFAULT_NOTE, GATE_PER_STEP / 2 };
+
+void patternClear(Pattern& p) {
+    // Zero first so padding bytes are deterministic in saved files
+    memset(&p, 0, sizeof(Pattern));
+
+    p.length = STEPS_PER_PAGE;
+    p.swing = 0;
+    p.bpm = 0;
+    p.pagesUsed = 0;
+    p.seed = PATTERN_DEFAULT_SEED;
+
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        p.tracks[t].sourceSlot = t;
+        p.tracks[t].length = STEPS_PER_PAGE;
+        p.tracks[t].speed = SPEED_1;
+        p.tracks[t].type = TRACK_SAMPLE;
+        p.tracks[t].volume = 1.0f;
+        p.tracks[t].pan = 0.0f;
+        memset(p.tracks[t].pages, NO_PAGE, sizeof(p.tracks[t].pages));
+    }
+}
+
+// Step in an allocated page, or nullptr (no allocation)
+static inline Step* stepIfPaged(Pattern& p, int track, int step) {
+    uint8_t page = p.tracks[track].pages[step / STEPS_PER_PAGE];
+    if (page == NO_PAGE) return nullptr;
+    return &p.pages[page].steps[step % STEPS_PER_PAGE];
+}
+
+Step* patternStepForEdit(Pattern& p, int track, int step) {
+    Track& t = p.tracks[track];
+    int pageIdx = step / STEPS_PER_PAGE;
+
+    if (t.pages[pageIdx] == NO_PAGE) {
+        if (p.pagesUsed >= PATTERN_STEP_PAGES) return nullptr;
+
+        // The new page holds no locks: its steps point where the next
+        // allocated page's locks start
+        int lockFirst = t.lockCount;
+        for (int i = pageIdx + 1; i < STEP_PAGES; i++) {
+            if (t.pages[i] != NO_PAGE) {
+                lockFirst = p.pages[t.pages[i]].steps[0].lockFirst;
+                break;
+            }
+        }
+
+        StepPage& page = p.pages[p.pagesUsed];
+        for (int s = 0; s < STEPS_PER_PAGE; s++) {
+            page.steps[s] = emptyStep;
+            page.steps[s].lockFirst = lockFirst;
+        }
+        // Page contents before the index: the audio ISR may be reading
+        __sync_synchronize();
+        t.pages[pageIdx] = p.pagesUsed++;
+    }
+
+    return &p.pages[t.pages[pageIdx]].steps[step % STEPS_PER_PAGE];
+}
+
+#define LOCK_RANGE(lo, hi) { (lo), ((hi) - (lo)) / 65535.0f }
+
+const ParamLockRange paramLockRanges[PARAM_COUNT] = {
+    LOCK_RANGE(-48.0f, 48.0f),      // PARAM_PITCH (semitones)
+    LOCK_RANGE(0.0f, 2.0f),         // PARAM_VOLUME
+    LOCK_RANGE(-1.0f, 1.0f),        // PARAM_PAN
+    LOCK_RANGE(20.0f, 20000.0f),    // PARAM_FILTER_FREQ (Hz)
+    LOCK_RANGE(0.7f, 5.0f),         // PARAM_FILTER_RES
+    LOCK_RANGE(0.0f, 1.0f),         // PARAM_FX_SEND_1
+    LOCK_RANGE(0.0f, 1.0f),         // PARAM_FX_SEND_2
+    LOCK_RANGE(0.0f, 1.0f),         // PARAM_SAMPLE_START (fraction of sample)
+    LOCK_RANGE(0.0f, 1.0f),         // PARAM_SAMPLE_END
+    LOCK_RANGE(0.0f, 5000.0f),      // PARAM_SYNTH_ATTACK (ms)
+    LOCK_RANGE(0.0f, 5000.0f),      // PARAM_SYNTH_DECAY (ms)
+    LOCK_RANGE(0.0f, 1.0f),         // PARAM_SYNTH_SUSTAIN
+    LOCK_RANGE(0.0f, 10000.0f)      // PARAM_SYNTH_RELEASE (ms)
+};
+
+uint16_t paramLockEncode(ParamType param, float value) {
+    const ParamLockRange& r = paramLockRanges[param];
+    float x = (value - r.min) / r.step;
+    if (!(x > 0.0f)) return 0;
+    if (x >= 65535.0f) return 65535;
+    return (uint16_t)(x + 0.5f);
+}
+
+// Move the pool index of every step after `step` by delta
+static void shiftLockFirst(Pattern& p, int track, int step, int delta) {
+    for (int i = step + 1; i < MAX_STEPS; i++) {
+        Step* st = stepIfPaged(p, track, i);
+        if (st) {
+            st->lockFirst += delta;
+        } else {
+            i |= STEPS_PER_PAGE - 1;    // Skip the rest of an empty page
+        }
+    }
+}
+
+bool stepSetLock(Pattern& p, int track, int step, ParamType param, float value) {
+    Track& t = p.tracks[track];
+    uint16_t bit = 1u << param;
+
+    Step* s = stepIfPaged(p, track, step);
+    if (s && (s->lockMask & bit)) {
+        t.lockValues[s->lockFirst + __builtin_popcount(s->lockMask & (bit - 1))] =
+            paramLockEncode(param, value);
+        return true;
+    }
+    if (t.lockCount >= TRACK_PARAM_LOCKS) return false;
+
+    s = patternStepForEdit(p, track, step);
+    if (!s) return false;
+
+    int idx = s->lockFirst + __builtin_popcount(s->lockMask & (bit - 1));
+    memmove(&t.lockValues[idx + 1], &t.lockValues[idx],
+            (t.lockCount - idx) * sizeof(uint16_t));
+    t.lockValues[idx] = paramLockEncode(param, value);
+    t.lockCount++;
+    s->lockMask |= bit;
+
+    shiftLockFirst(p, track, step, 1);
+    return true;
+}
+
+// Drop count values at idx and pull the later steps back
+static void removeLocks(Pattern& p, int track, int step, int idx, int count) {
+    Track& t = p.tracks[track];
+    memmove(&t.lockValues[idx], &t.lockValues[idx + count],
+            (t.lockCount - idx - count) * sizeof(uint16_t));
+    t.lockCount -= count;
+    shiftLockFirst(p, track, step, -count);
+}
+
+void stepClearLock(Pattern& p, int track, int step, ParamType param) {
+    Step* s = stepIfPaged(p, track, step);
+    uint16_t bit = 1u << param;
+    if (!s || !(s->lockMask & bit)) return;
+
+    removeLocks(p, track, step, s->lockFirst + __builtin_popcount(s->lockMask & (bit - 1)), 1);
+    s->lockMask &= ~bit;
+}
+
+void stepClearLocks(Pattern& p, int track, int step) {
+    Step* s = stepIfPaged(p, track, step);
+    if (!s || !s->lockMask) return;
+
+    removeLocks(p, track, step, s->lockFirst, __builtin_popcount(s->lockMask));
+    s->lockMask = 0;
+}
+
+bool patternLayoutValid(const Pattern& p) {
+    if (p.length < 1 || p.length > MAX_STEPS) return false;
+    if (p.pagesUsed > PATTERN_STEP_PAGES) return false;
+
+    uint32_t pageOwned = 0;
+
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        const Track& trk = p.tracks[t];
+        if (trk.length < 1 || trk.length > MAX_STEPS) return false;
+        if (trk.speed >= SPEED_COUNT || trk.type >= TRACK_TYPE_COUNT) return false;
+        if (trk.lockCount > TRACK_PARAM_LOCKS) return false;
+
+        // Every page index in range and owned by one track only
+        for (int i = 0; i < STEP_PAGES; i++) {
+            uint8_t page = trk.pages[i];
+            if (page == NO_PAGE) continue;
+            if (page >= p.pagesUsed || (pageOwned & (1UL << page))) return false;
+            pageOwned |= 1UL << page;
+        }
+
+        int next = 0;
+        for (int s = 0; s < MAX_STEPS; s++) {
+            if (trk.pages[s / STEPS_PER_PAGE] == NO_PAGE) continue;
+            const Step& st = patternStep(p, t, s);
+            if (st.lockFirst != next || (st.lockMask >> PARAM_COUNT)) return false;
+            if (st.microTiming < -MICRO_TIMING_MAX || st.microTiming > MICRO_TIMING_MAX ||
+                st.ratchets > MAX_RATCHETS || st.ratchetDecay > 100) return false;
+            if (st.condition >= TRIG_COUNT || st.probability > 100) return false;
+            if (st.note > 127 || st.gate < 1 || st.gate > GATE_MAX) return false;
+            next += __builtin_popcount(st.lockMask);
+        }
+        if (next != trk.lockCount) return false;
+    }
+    return true;
+}
+
+// Nibble-wide table: 64 bytes of flash, two lookups per byte
+static const uint32_t crcNibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+uint32_t crc32(const void* data, size_t len, uint32_t crc) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crcNibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crcNibble[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+size_t patternPayloadSize(const Pattern& p) {
+    return offsetof(Pattern, pages) + p.pagesUsed * sizeof(StepPage);
+}
+
+void patternFileSeal(PatternFile& f) {
+    f.header.magic = PATTERN_FILE_MAGIC;
+    f.header.version = PATTERN_FILE_VERSION;
+    f.header.headerSize = sizeof(PatternFileHeader);
+    f.header.payloadSize = patternPayloadSize(f.pattern);
+    f.header.crc = crc32(&f.pattern, f.header.payloadSize);
+}
+
+PatternFileStatus patternFileCheck(PatternFile& f) {
+    if (f.header.magic != PATTERN_FILE_MAGIC) return PATTERN_FILE_BAD_MAGIC;
+    if (f.header.version != PATTERN_FILE_VERSION) return PATTERN_FILE_BAD_VERSION;
+    if (f.header.headerSize != sizeof(PatternFileHeader) ||
+        f.header.payloadSize < offsetof(Pattern, pages) ||
+        f.header.payloadSize > sizeof(Pattern) ||
+        f.header.payloadSize != patternPayloadSize(f.pattern)) {
+        return PATTERN_FILE_BAD_SIZE;
+    }
+    if (f.header.crc != crc32(&f.pattern, f.header.payloadSize)) return PATTERN_FILE_BAD_CRC;
+    if (!patternLayoutValid(f.pattern)) return PATTERN_FILE_BAD_LAYOUT;
+
+    // Whatever the staging buffer held past the file is not part of it
+    uint8_t* tail = (uint8_t*)&f.pattern + f.header.payloadSize;
+    memset(tail, 0, sizeof(Pattern) - f.header.payloadSize);
+    return PATTERN_FILE_OK;
+}
+
+void PatternBank::begin(PatternBankMemory* memory) {
+    mem = memory;
+    for (int i = 0; i < BANK_STEP_PAGES; i++) {
+        mem->freePages[i] = BANK_STEP_PAGES - 1 - i;
+    }
+    freeCount = BANK_STEP_PAGES;
+    for (int n = 0; n < MAX_PATTERNS; n++) {
+        mem->entries[n].pagesHeld = 0;
+        mem->entries[n].cleared = true;
+    }
+}
+
+bool PatternBank::store(int n, const Pattern& p) {
+    BankEntry& e = mem->entries[n];
+    if (p.pagesUsed > freeCount + e.pagesHeld) return false;
+
+    evict(n);
+    memcpy(e.head, &p, sizeof(e.head));
+    for (int i = 0; i < p.pagesUsed; i++) {
+        uint16_t page = mem->freePages[--freeCount];
+        mem->pool[page] = p.pages[i];
+        e.pages[i] = page;
+    }
+    e.pagesHeld = p.pagesUsed;
+    e.cleared = false;
+    return true;
+}
+
+void PatternBank::fetch(int n, Pattern& out) const {
+    const BankEntry& e = mem->entries[n];
+    if (e.cleared) {
+        patternClear(out);
+        return;
+    }
+
+    memcpy(&out, e.head, sizeof(e.head));
+    for (int i = 0; i < e.pagesHeld; i++) {
+        out.pages[i] = mem->pool[e.pages[i]];
+    }
+    // As patternFileCheck() leaves a loaded pattern
+    memset(&out.pages[e.pagesHeld], 0, (PATTERN_STEP_PAGES - e.pagesHeld) * sizeof(StepPage));
+}
+
+void PatternBank::evict(int n) {
+    BankEntry& e = mem->entries[n];
+    for (int i = 0; i < e.pagesHeld; i++) {
+        mem->freePages[freeCount++] = e.pages[i];
+    }
+    e.pagesHeld = 0;
+    e.cleared = true;
+}
@@ -0,0 +1,323 @@
+/**
+ * Oh My Ondas - Poly Synth Implementation
+ * Pool of SYNTH_VOICES synth voices with voice stealing and a CPU budget
+ */
+
+#include "poly_synth.h"
+
+PolySynth::PolySynth()
+    : clock(0)
+    , params{ 8000.0f, 0.7f, 10.0f, 100.0f, 0.7f, 200.0f }    // As initAudioGraph()
+    , locked(params)
+    , hasLocks(false)
+    , noise(nullptr)
+    , osc1Table(&wavetableBasic)
+    , osc1Morph(WT_SHAPE_SAW)
+    , polyphony(SYNTH_VOICES)
+    , voiceLimit(SYNTH_VOICES)
+    , voiceCost(SYNTH_VOICE_COST)
+    , stolen(0)
+    , shed(0)
+{
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        notes[v] = 0;
+        stamps[v] = 0;
+        starts[v] = 0;
+        sequenced[v] = false;
+    }
+}
+
+void PolySynth::begin(AudioSynthWavetableOsc* osc1,
+                      AudioSynthWavetableOsc* osc2,
+                      AudioSynthNoiseWhite* n,
+                      AudioMixer4Smooth* mixers,
+                      LadderSmoother* filters,
+                      AudioEffectEnvelope* envelopes) {
+    noise = n;
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        voices[v].begin(&osc1[v], &osc2[v], &mixers[v], &filters[v], &envelopes[v]);
+    }
+
+    DEBUG_PRINTF("PolySynth: Ready, %d voices\n", SYNTH_VOICES);
+}
+
+// ============================================
+// NOTES
+// ============================================
+
+void PolySynth::noteOn(uint8_t note, float velocity) {
+    // With the ISR held off, so update() cannot park or shed the voice
+    // halfway through
+    __disable_irq();
+    int v = startNote(note, velocity, params);
+    if (v >= 0) sequenced[v] = false;
+    __enable_irq();
+
+    DEBUG_PRINTF("PolySynth: noteOn %d vel=%.2f voice %d\n", note, velocity, v);
+}
+
+void PolySynth::noteOff(uint8_t note) {
+    __disable_irq();
+    int v = findVoice(note);
+    if (v >= 0) {
+        voices[v].noteOff();
+        stamps[v] = ++clock;
+    }
+    __enable_irq();
+}
+
+void PolySynth::allNotesOff() {
+    __disable_irq();
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        if (!voices[v].isHeld()) continue;
+        voices[v].noteOff();
+        stamps[v] = ++clock;
+    }
+    __enable_irq();
+}
+
+int PolySynth::startNote(uint8_t note, float velocity, const SynthNoteParams& p) {
+    int v = allocate(note);
+    if (v >= 0) {
+        voices[v].setNoteParams(p);
+        voices[v].noteOn(noteFrequency(note), velocity);
+        notes[v] = note;
+        stamps[v] = ++clock;
+    }
+    return v;
+}
+
+void PolySynth::lockNextNote(ParamType param, float value) {
+    if (!hasLocks) {
+        locked = params;
+        hasLocks = true;
+    }
+    switch (param) {
+        case PARAM_FILTER_FREQ:   locked.filterFreq = value;  break;
+        case PARAM_FILTER_RES:    locked.filterRes = value;   break;
+        case PARAM_SYNTH_ATTACK:  locked.attack = value;      break;
+        case PARAM_SYNTH_DECAY:   locked.decay = value;       break;
+        case PARAM_SYNTH_SUSTAIN: locked.sustain = value;     break;
+        case PARAM_SYNTH_RELEASE: locked.release = value;     break;
+        default:                                              break;
+    }
+}
+
+void PolySynth::playNote(uint8_t note, float velocity, uint32_t when) {
+    int v = startNote(note, velocity, hasLocks ? locked : params);
+    hasLocks = false;
+    if (v >= 0) {
+        starts[v] = when;
+        sequenced[v] = true;
+    }
+}
+
+void PolySynth::releaseNote(uint8_t note, uint32_t when) {
+    int v = findVoice(note);
+    if (v < 0 || !sequenced[v] || starts[v] != when) return;
+    voices[v].noteOff();
+    stamps[v] = ++clock;
+}
+
+int PolySynth::findVoice(uint8_t note) const {
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        if (voices[v].isHeld() && notes[v] == note) return v;
+    }
+    return -1;
+}
+
+int PolySynth::allocate(uint8_t note) {
+    int v = findVoice(note);
+    if (v >= 0) return v;
+
+    if (countSounding() < voiceLimit) {
+        for (v = 0; v < polyphony; v++) {
+            if (!voices[v].isActive()) return v;
+        }
+    }
+
+    v = pickVictim(true);
+    if (v >= 0) stolen++;
+    return v;
+}
+
+// Stealing order from the header. fading: voices already being shed count
+// (first) - yes for a new note, no when shedding
+int PolySynth::pickVictim(bool fading) const {
+    int best = -1;
+    int bestRank = 0;
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        const SynthVoice& voice = voices[v];
+        if (!voice.isActive()) continue;
+        if (voice.isKilled() && !fading) continue;
+
+        int rank = voice.isKilled() ? 0 : voice.isHeld() ? 2 : 1;
+        if (best < 0 || rank < bestRank ||
+            (rank == bestRank && (int32_t)(stamps[v] - stamps[best]) < 0)) {
+            best = v;
+            bestRank = rank;
+        }
+    }
+    return best;
+}
+
+int PolySynth::countSounding() const {
+    int n = 0;
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        if (voices[v].isActive() && !voices[v].isKilled()) n++;
+    }
+    return n;
+}
+
+int PolySynth::getActiveVoices() const {
+    int n = 0;
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        if (voices[v].isActive()) n++;
+    }
+    return n;
+}
+
+// ============================================
+// SETTINGS
+// ============================================
+
+void PolySynth::setPolyphony(int count) {
+    polyphony = constrain(count, 1, SYNTH_VOICES);
+    if (voiceLimit > polyphony) voiceLimit = polyphony;
+}
+
+void PolySynth::setOsc1Waveform(int waveform) {
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setOsc1Waveform(waveform);
+    osc1Table = &wavetableBasic;
+    osc1Morph = voices[0].getOsc1Morph();
+}
+
+void PolySynth::setOsc2Waveform(int waveform) {
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setOsc2Waveform(waveform);
+}
+
+void PolySynth::setOsc1Wavetable(const Wavetable* table) {
+    osc1Table = table ? table : &wavetableBasic;
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setOsc1Wavetable(osc1Table);
+    setOsc1Morph(osc1Morph);
+}
+
+void PolySynth::setOsc1Morph(float position) {
+    osc1Morph = constrain(position, 0.0f, (float)(getOsc1Frames() - 1));
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setOsc1Morph(osc1Morph);
+}
+
+int PolySynth::getOsc1Frames() const {
+    return osc1Table->frames;
+}
+
+void PolySynth::setOsc1Level(float level) {
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setOsc1Level(level);
+}
+
+void PolySynth::setOsc2Level(float level) {
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setOsc2Level(level);
+}
+
+void PolySynth::setNoiseLevel(float level) {
+    if (noise) noise->amplitude(constrain(level, 0.0f, 1.0f));
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setNoiseLevel(level);
+}
+
+void PolySynth::setOsc2Detune(float semitones) {
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setOsc2Detune(semitones);
+}
+
+void PolySynth::setFilterFreq(float freq) {
+    params.filterFreq = freq;
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setFilterFreq(freq);
+}
+
+void PolySynth::setFilterRes(float res) {
+    params.filterRes = res;
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setFilterRes(res);
+}
+
+void PolySynth::setAttack(float ms) {
+    params.attack = ms;
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setAttack(ms);
+}
+
+void PolySynth::setDecay(float ms) {
+    params.decay = ms;
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setDecay(ms);
+}
+
+void PolySynth::setSustain(float level) {
+    params.sustain = level;
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setSustain(level);
+}
+
+void PolySynth::setRelease(float ms) {
+    params.release = ms;
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].setRelease(ms);
+}
+
+// ============================================
+// AUDIO ISR
+// ============================================
+
+void PolySynth::modulate(float cutoffOctaves, float pitchSemitones) {
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        voices[v].modulateCutoff(cutoffOctaves);
+        voices[v].modulatePitch(pitchSemitones);
+    }
+}
+
+void PolySynth::update() {
+    float usage[SYNTH_VOICES];
+    updateVoices();
+    for (int v = 0; v < SYNTH_VOICES; v++) usage[v] = voices[v].processorUsage();
+    allocateBudget(AudioProcessorUsage(), usage);
+}
+
+void PolySynth::updateVoices() {
+    for (int v = 0; v < SYNTH_VOICES; v++) voices[v].update();
+}
+
+void PolySynth::allocateBudget(float totalUsage, const float* voiceUsage) {
+    // Parked voices cost next to nothing, but what they do cost is the
+    // synth's, not the rest of the graph's
+    float synthUsage = 0.0f;
+    float soundingUsage = 0.0f;
+    int measured = 0;
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        synthUsage += voiceUsage[v];
+        if (voices[v].isActive()) {
+            soundingUsage += voiceUsage[v];
+            measured++;
+        }
+    }
+    if (measured) {
+        float perVoice = soundingUsage / measured;
+        if (perVoice > voiceCost) voiceCost = perVoice;
+        else voiceCost += 0.05f * (perVoice - voiceCost);
+        if (voiceCost < 0.01f) voiceCost = 0.01f;
+    }
+
+    float others = totalUsage - synthUsage;
+    float room = SYNTH_CPU_CEILING - (others > 0.0f ? others : 0.0f);
+    int fit = room > 0.0f ? (int)(room / voiceCost) : 0;
+
+    int limit = voiceLimit;
+    if (fit < limit) {
+        limit = fit;
+    } else if (fit > limit && room - (limit + 1) * voiceCost >= SYNTH_CPU_HEADROOM) {
+        limit++;
+    }
+    limit = constrain(limit, 1, polyphony);
+    voiceLimit = limit;
+
+    // Over the limit: shed now, released voices first
+    for (int n = countSounding(); n > limit; n--) {
+        int v = pickVictim(false);
+        if (v < 0) break;
+        voices[v].kill();
+        shed++;
+    }
+}
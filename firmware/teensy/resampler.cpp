@@ -0,0 +1,169 @@
+/**
+ * Oh My Ondas - Resampler Implementation
+ * Variable-rate mono 16-bit playback kernels for AudioPlaySample
+ */
+
+#include "resampler.h"
+#include <math.h>
+#include <string.h>
+
+// Q14 taps for x[-1], x[0], x[1], x[2]; each row sums to exactly 1.0
+static int16_t polyphaseTable[RESAMPLER_PHASES][4];
+static bool polyphaseReady = false;
+
+// Lanczos kernel, a = 2: sinc windowed by a wider sinc, zero beyond ±2
+static double lanczos2(double x) {
+    if (x == 0.0) return 1.0;
+    if (x <= -2.0 || x >= 2.0) return 0.0;
+    double px = M_PI * x;
+    return 2.0 * sin(px) * sin(px / 2.0) / (px * px);
+}
+
+void resamplerInit() {
+    if (polyphaseReady) return;
+
+    const int unity = 1 << RESAMPLER_COEF_BITS;
+
+    for (int p = 0; p < RESAMPLER_PHASES; p++) {
+        double frac = (double)p / RESAMPLER_PHASES;
+        double w[4];
+        double sum = 0.0;
+        for (int k = 0; k < 4; k++) {
+            w[k] = lanczos2((k - 1) - frac);
+            sum += w[k];
+        }
+
+        int total = 0;
+        for (int k = 0; k < 4; k++) {
+            polyphaseTable[p][k] = (int16_t)lround(w[k] / sum * unity);
+            total += polyphaseTable[p][k];
+        }
+        // Put the rounding error on the nearest tap so DC passes unchanged
+        polyphaseTable[p][frac < 0.5 ? 1 : 2] += unity - total;
+    }
+
+    polyphaseReady = true;
+}
+
+uint64_t resamplerIncrement(float rate) {
+    if (!(rate > 0.0f)) return 0;
+    return (uint64_t)((double)rate * 4294967296.0);
+}
+
+static inline int16_t clip16(int32_t v) {
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+// p points at x[0]; p[-1]..p[2] must be readable
+template<InterpMode M>
+static inline int16_t interpolate(const int16_t* p, uint32_t frac);
+
+template<>
+inline int16_t interpolate<INTERP_LINEAR>(const int16_t* p, uint32_t frac) {
+    int32_t t = frac >> 17;     // Q15
+    return (int16_t)(p[0] + (((int32_t)(p[1] - p[0]) * t) >> 15));
+}
+
+template<>
+inline int16_t interpolate<INTERP_HERMITE>(const int16_t* p, uint32_t frac) {
+    int32_t xm1 = p[-1], x0 = p[0], x1 = p[1], x2 = p[2];
+    int32_t t = frac >> 17;     // Q15
+
+    // Catmull-Rom coefficients, all scaled by 2 to stay integer
+    int32_t c1 = x1 - xm1;
+    int32_t c2 = 2 * xm1 - 5 * x0 + 4 * x1 - x2;
+    int32_t c3 = 3 * (x0 - x1) + x2 - xm1;
+
+    int32_t y = (int32_t)(((int64_t)c3 * t) >> 15);
+    y = (int32_t)(((int64_t)(y + c2) * t) >> 15);
+    y = (int32_t)(((int64_t)(y + c1) * t) >> 15);
+    return clip16(x0 + (y >> 1));
+}
+
+template<>
+inline int16_t interpolate<INTERP_POLYPHASE>(const int16_t* p, uint32_t frac) {
+    const int16_t* h = polyphaseTable[frac >> (32 - RESAMPLER_PHASE_BITS)];
+    int32_t y = p[-1] * h[0] + p[0] * h[1] + p[1] * h[2] + p[2] * h[3];
+    return clip16(y >> RESAMPLER_COEF_BITS);
+}
+
+// Tap fetch for the edges of the sample / loop (slow path only)
+static inline int16_t tapAt(const ResamplerVoice& v, int64_t j) {
+    if (v.loop && j >= (int64_t)v.loopEnd && v.loopEnd > v.loopStart) {
+        j -= v.loopEnd - v.loopStart;
+    }
+    if (j < 0) j = 0;
+    if (j >= (int64_t)v.length) j = v.length - 1;
+    return v.data[j];
+}
+
+template<InterpMode M>
+static int renderMode(ResamplerVoice& v, int16_t* out, int n) {
+    const int16_t* data = v.data;
+    const uint64_t inc = v.increment;
+    const uint32_t limit = v.loop ? v.loopEnd : v.end;
+    const uint32_t loopLen = v.loopEnd - v.loopStart;
+    uint64_t phase = v.phase;
+    int i = 0;
+
+    while (i < n) {
+        uint32_t idx = (uint32_t)(phase >> 32);
+
+        if (idx >= limit) {
+            if (v.loop && v.loopEnd > v.loopStart) {
+                uint32_t wraps = (idx - v.loopStart) / loopLen;
+                phase -= (uint64_t)(wraps * loopLen) << 32;
+                continue;
+            }
+            break;
+        }
+
+        // Unity rate on a whole frame: plain copy
+        if (inc == (1ULL << 32) && (uint32_t)phase == 0) {
+            uint32_t run = limit - idx;
+            if (run > (uint32_t)(n - i)) run = n - i;
+            memcpy(&out[i], &data[idx], run * sizeof(int16_t));
+            i += run;
+            phase += (uint64_t)run << 32;
+            continue;
+        }
+
+        // Fast path: the whole 4-tap window stays inside [0, limit)
+        if (idx >= 1 && idx + 2 < limit) {
+            uint64_t safeEnd = (uint64_t)(limit - 2) << 32;
+            int run = n - i;
+            if (phase + inc * (uint64_t)(run - 1) >= safeEnd) {
+                run = (int)((safeEnd - phase + inc - 1) / inc);
+            }
+            for (int k = 0; k < run; k++) {
+                out[i++] = interpolate<M>(&data[phase >> 32], (uint32_t)phase);
+                phase += inc;
+            }
+            continue;
+        }
+
+        // Edge: gather taps one sample at a time
+        int16_t taps[4];
+        for (int k = 0; k < 4; k++) {
+            taps[k] = tapAt(v, (int64_t)idx + k - 1);
+        }
+        out[i++] = interpolate<M>(&taps[1], (uint32_t)phase);
+        phase += inc;
+    }
+
+    v.phase = phase;
+    return i;
+}
+
+int resamplerRender(ResamplerVoice& v, int16_t* out, int n) {
+    if (!v.data || v.length == 0 || v.increment == 0) return 0;
+
+    switch (v.mode) {
+        case INTERP_LINEAR:    return renderMode<INTERP_LINEAR>(v, out, n);
+        case INTERP_POLYPHASE: return renderMode<INTERP_POLYPHASE>(v, out, n);
+        case INTERP_HERMITE:
+        default:               return renderMode<INTERP_HERMITE>(v, out, n);
+    }
+}
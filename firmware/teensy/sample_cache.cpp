@@ -0,0 +1,260 @@
+/**
+ * Oh My Ondas - Sample Cache Implementation
+ * Decoded sample PCM held in PSRAM (EXTMEM) so pad hits never touch SD
+ */
+
+#include "sample_cache.h"
+
+// Set by the Teensy 4.1 startup code: PSRAM fitted, in MB (0 = none)
+extern "C" uint8_t external_psram_size;
+
+SampleCache::SampleCache()
+    : budget(0)
+    , bytesResident(0)
+    , useCounter(0)
+    , hits(0)
+    , misses(0)
+    , psram(false)
+{
+    for (int i = 0; i < SAMPLE_CACHE_ENTRIES; i++) {
+        entries[i].filename[0] = '\0';
+        entries[i].pcm = nullptr;
+        entries[i].frames = 0;
+        entries[i].framesLoaded = 0;
+        entries[i].sampleRate = 0;
+        entries[i].refs = 0;
+        entries[i].lastUsed = 0;
+    }
+}
+
+void SampleCache::begin() {
+    psram = (external_psram_size > 0);
+    if (psram) {
+        budget = (uint32_t)external_psram_size * 1024 * 1024 - SAMPLE_CACHE_PSRAM_RESERVE;
+    } else {
+        budget = SAMPLE_CACHE_RAM_BUDGET;
+    }
+
+    DEBUG_PRINTF("SampleCache: %lu KB budget (%s)\n",
+                 (unsigned long)(budget / 1024), psram ? "PSRAM" : "RAM, no PSRAM fitted");
+}
+
+CachedSample* SampleCache::acquire(const char* filename, File& file, const WavInfo& info) {
+    CachedSample* entry = find(filename);
+    if (entry) {
+        entry->refs++;
+        entry->lastUsed = ++useCounter;
+        return entry;
+    }
+
+    entry = reserve(filename, info);
+    if (!entry) return nullptr;
+
+    if (!fill(entry, file, info, info.frames)) {
+        abandon(entry);
+        DEBUG_PRINTF("SampleCache: Read error on %s\n", filename);
+        return nullptr;
+    }
+    return entry;
+}
+
+CachedSample* SampleCache::reserve(const char* filename, const WavInfo& info) {
+    // Only 16-bit PCM is decoded; anything else is left to the SD player
+    if (info.bitsPerSample != 16 || info.channels == 0 || info.frames == 0) {
+        return nullptr;
+    }
+
+    uint32_t bytes = info.frames * sizeof(int16_t);
+    if (bytes > budget) {
+        DEBUG_PRINTF("SampleCache: %s too long to cache (%lu KB), streaming\n",
+                     filename, (unsigned long)(bytes / 1024));
+        return nullptr;
+    }
+
+    // Make room: drop unpinned entries, oldest first
+    while (bytesResident + bytes > budget) {
+        CachedSample* victim = leastRecentlyUsed();
+        if (!victim) return nullptr;
+        evict(victim);
+    }
+
+    // Free entry, or recycle the oldest unpinned one
+    CachedSample* entry = nullptr;
+    for (int i = 0; i < SAMPLE_CACHE_ENTRIES; i++) {
+        if (!entries[i].pcm) {
+            entry = &entries[i];
+            break;
+        }
+    }
+    if (!entry) {
+        entry = leastRecentlyUsed();
+        if (!entry) return nullptr;
+        evict(entry);
+    }
+
+    int16_t* pcm = (int16_t*)extmem_malloc(bytes);
+    if (!pcm) {
+        DEBUG_PRINTF("SampleCache: Out of memory for %s\n", filename);
+        return nullptr;
+    }
+
+    strncpy(entry->filename, filename, sizeof(entry->filename) - 1);
+    entry->filename[sizeof(entry->filename) - 1] = '\0';
+    entry->pcm = pcm;
+    entry->frames = info.frames;
+    entry->framesLoaded = 0;
+    entry->sampleRate = info.sampleRate;
+    entry->refs = 1;
+    entry->lastUsed = ++useCounter;
+    bytesResident += bytes;
+
+    return entry;
+}
+
+bool SampleCache::fill(CachedSample* entry, File& file, const WavInfo& info, uint32_t maxFrames) {
+    uint32_t n = entry->frames - entry->framesLoaded;
+    if (n > maxFrames) n = maxFrames;
+    if (!decodePCM(file, info, entry->pcm, entry->framesLoaded, n)) return false;
+    entry->framesLoaded += n;
+    return true;
+}
+
+void SampleCache::abandon(CachedSample* entry) {
+    if (!entry) return;
+    entry->refs = 0;
+    evict(entry);
+}
+
+bool SampleCache::canFit(const WavInfo& info) {
+    if (info.bitsPerSample != 16 || info.channels == 0 || info.frames == 0) return false;
+
+    uint32_t pinned = 0;
+    bool freeEntry = false;
+    for (int i = 0; i < SAMPLE_CACHE_ENTRIES; i++) {
+        if (entries[i].pcm && entries[i].refs > 0) pinned += entries[i].frames * sizeof(int16_t);
+        else freeEntry = true;
+    }
+    return freeEntry && pinned + info.frames * sizeof(int16_t) <= budget;
+}
+
+void SampleCache::release(CachedSample* entry) {
+    if (entry && entry->refs > 0) {
+        entry->refs--;
+    }
+}
+
+CachedSample* SampleCache::find(const char* filename) {
+    for (int i = 0; i < SAMPLE_CACHE_ENTRIES; i++) {
+        if (entries[i].pcm && isComplete(&entries[i]) &&
+            strcmp(entries[i].filename, filename) == 0) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+CachedSample* SampleCache::leastRecentlyUsed() {
+    CachedSample* oldest = nullptr;
+    for (int i = 0; i < SAMPLE_CACHE_ENTRIES; i++) {
+        CachedSample& e = entries[i];
+        if (!e.pcm || e.refs > 0) continue;
+        if (!oldest || e.lastUsed < oldest->lastUsed) oldest = &e;
+    }
+    return oldest;
+}
+
+void SampleCache::evict(CachedSample* entry) {
+    if (!entry || !entry->pcm) return;
+
+    extmem_free(entry->pcm);
+    bytesResident -= entry->frames * sizeof(int16_t);
+
+    entry->pcm = nullptr;
+    entry->frames = 0;
+    entry->framesLoaded = 0;
+    entry->filename[0] = '\0';
+}
+
+// Frames first..first+count-1 of the data chunk into dest[first..]
+bool SampleCache::decodePCM(File& file, const WavInfo& info, int16_t* dest,
+                            uint32_t first, uint32_t count) {
+    uint32_t frameBytes = info.channels * sizeof(int16_t);
+    if (!file.seek(info.dataOffset + first * frameBytes)) return false;
+
+    // Read in chunks, keep channel 0 (the SD player path only ever
+    // patched its left output into the track filter)
+    const int chunkFrames = 256;
+    int16_t buf[chunkFrames * 2];
+    uint32_t framesPerChunk = sizeof(buf) / frameBytes;
+    if (framesPerChunk == 0) return false;
+
+    uint32_t done = first;
+    uint32_t end = first + count;
+    while (done < end) {
+        uint32_t n = end - done;
+        if (n > framesPerChunk) n = framesPerChunk;
+
+        int got = file.read(buf, n * frameBytes);
+        if (got < (int)(n * frameBytes)) return false;
+
+        if (info.channels == 1) {
+            memcpy(&dest[done], buf, n * sizeof(int16_t));
+        } else {
+            for (uint32_t f = 0; f < n; f++) {
+                dest[done + f] = buf[f * info.channels];
+            }
+        }
+        done += n;
+    }
+    return true;
+}
+
+bool SampleCache::readWavInfo(File& file, WavInfo& info) {
+    uint8_t hdr[12];
+    if (!file.seek(0) || file.read(hdr, 12) != 12) return false;
+    if (memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0) return false;
+
+    bool haveFmt = false;
+    uint32_t pos = 12;
+
+    // Walk the chunk list until "data"
+    while (true) {
+        uint8_t ch[8];
+        if (!file.seek(pos) || file.read(ch, 8) != 8) return false;
+        uint32_t size = ch[4] | (ch[5] << 8) | (ch[6] << 16) | ((uint32_t)ch[7] << 24);
+
+        if (memcmp(ch, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < 16 || file.read(fmt, 16) != 16) return false;
+            uint16_t format = fmt[0] | (fmt[1] << 8);
+            if (format != 1) return false;  // PCM only
+            info.channels = fmt[2] | (fmt[3] << 8);
+            info.sampleRate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+            info.bitsPerSample = fmt[14] | (fmt[15] << 8);
+            haveFmt = true;
+        } else if (memcmp(ch, "data", 4) == 0) {
+            if (!haveFmt || info.channels == 0 || info.bitsPerSample == 0) return false;
+            info.dataOffset = pos + 8;
+            info.dataBytes = size;
+            info.frames = size / (info.channels * (info.bitsPerSample / 8));
+            return true;
+        }
+
+        // Chunks are padded to an even length
+        pos += 8 + size + (size & 1);
+    }
+}
+
+float SampleCache::getHitRate() {
+    uint32_t total = hits + misses;
+    if (total == 0) return 0.0f;
+    return (float)hits / (float)total;
+}
+
+int SampleCache::getEntryCount() {
+    int n = 0;
+    for (int i = 0; i < SAMPLE_CACHE_ENTRIES; i++) {
+        if (entries[i].pcm) n++;
+    }
+    return n;
+}
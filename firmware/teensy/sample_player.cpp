@@ -0,0 +1,94 @@
+/**
+ * Oh My Ondas - Sample Player Implementation
+ * Audio object that plays mono 16-bit PCM straight from memory
+ */
+
+#include "sample_player.h"
+
+AudioPlaySample::AudioPlaySample()
+    : AudioStream(0, NULL)
+    , pendingOffset(0)
+    , playing(false)
+{
+    voice.data = nullptr;
+    voice.length = 0;
+    voice.end = 0;
+    voice.loopStart = 0;
+    voice.loopEnd = 0;
+    voice.loop = false;
+    voice.mode = INTERP_HERMITE;
+    voice.phase = 0;
+    voice.increment = 1ULL << 32;
+
+    resamplerInit();
+}
+
+void AudioPlaySample::play(const int16_t* pcm, uint32_t frames, uint32_t start, uint32_t end,
+                           uint16_t startOffset) {
+    if (end > frames) end = frames;
+    if (!pcm || start >= end) {
+        stop();
+        return;
+    }
+    if (startOffset >= AUDIO_BLOCK_SAMPLES) startOffset = AUDIO_BLOCK_SAMPLES - 1;
+
+    __disable_irq();
+    voice.data = pcm;
+    voice.length = frames;
+    voice.end = end;
+    if (voice.loopEnd > frames) voice.loopEnd = frames;
+    voice.phase = (uint64_t)start << 32;
+    pendingOffset = startOffset;
+    playing = true;
+    __enable_irq();
+}
+
+void AudioPlaySample::stop() {
+    __disable_irq();
+    playing = false;
+    voice.data = nullptr;
+    __enable_irq();
+}
+
+void AudioPlaySample::setRate(float rate) {
+    uint64_t inc = resamplerIncrement(rate);
+    __disable_irq();
+    voice.increment = inc;
+    __enable_irq();
+}
+
+void AudioPlaySample::setLoop(bool loop, uint32_t loopStart, uint32_t loopEnd) {
+    __disable_irq();
+    if (voice.data && loopEnd > voice.length) loopEnd = voice.length;
+    voice.loopStart = loopStart;
+    voice.loopEnd = loopEnd;
+    voice.loop = loop && loopEnd > loopStart;
+    __enable_irq();
+}
+
+void AudioPlaySample::setInterpolation(InterpMode mode) {
+    if (mode >= INTERP_MODE_COUNT) return;
+    voice.mode = mode;
+}
+
+void AudioPlaySample::update(void) {
+    if (!playing) return;
+
+    audio_block_t* block = allocate();
+    if (!block) return;
+
+    int i = pendingOffset;
+    memset(block->data, 0, i * sizeof(int16_t));
+    pendingOffset = 0;
+
+    int n = resamplerRender(voice, &block->data[i], AUDIO_BLOCK_SAMPLES - i);
+    i += n;
+
+    if (i < AUDIO_BLOCK_SAMPLES) {
+        memset(&block->data[i], 0, (AUDIO_BLOCK_SAMPLES - i) * sizeof(int16_t));
+        playing = false;
+    }
+
+    transmit(block);
+    release(block);
+}
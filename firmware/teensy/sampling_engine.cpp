@@ -7,20 +7,31 @@
 
 SamplingEngine::SamplingEngine()
     : currentBank(0)
+    , interpolation(SAMPLE_INTERP_DEFAULT)
     , players(nullptr)
+    , memPlayers(nullptr)
     , amps(nullptr)
+    , sdStarts(0)
+    , sdStops(0)
+    , fillSlot(-1)
+    , fillEntry(nullptr)
 {
     for (int i = 0; i < MAX_TRACKS; i++) {
         initializeSample(i);
     }
 }
 
-void SamplingEngine::begin(AudioPlaySdWav* playerArray, AudioAmplifier* ampArray) {
+void SamplingEngine::begin(AudioPlaySdWav* playerArray, AudioPlaySample* memPlayerArray,
+                           AudioAmpSmooth* ampArray) {
     players = playerArray;
+    memPlayers = memPlayerArray;
     amps = ampArray;
 
     DEBUG_PRINTLN("SamplingEngine: Initializing...");
 
+    cache.begin();
+    setInterpolation(interpolation);
+
     // Load default bank (bank 0)
     loadBank(0);
 
@@ -33,17 +44,103 @@ void SamplingEngine::update() {
     // Poll player states — detect finished playback, re-trigger loops
     for (int i = 0; i < MAX_TRACKS; i++) {
         if (samples[i].playing) {
-            if (!players[i].isPlaying()) {
+            if (!isPlaying(i)) {
                 if (samples[i].looping && samples[i].loaded) {
                     // Re-trigger looping sample
-                    players[i].play(samples[i].filename);
-                    amps[i].gain(samples[i].volume);
+                    trigger(i);
                 } else {
                     samples[i].playing = false;
                 }
             }
         }
     }
+
+    serviceSdPlayers();
+    serviceCacheFill();
+}
+
+// SD starts and stops the ISR asked for, in loop() where SD access is safe
+void SamplingEngine::serviceSdPlayers() {
+    if (!players) return;
+
+    __disable_irq();
+    uint8_t starts = sdStarts;
+    uint8_t stops = sdStops;
+    sdStarts = 0;
+    sdStops = 0;
+    __enable_irq();
+
+    for (int i = 0; i < MAX_TRACKS; i++) {
+        uint8_t bit = 1u << i;
+        if (stops & bit) {
+            players[i].stop();
+        }
+        if (!(starts & bit) || !samples[i].loaded) continue;
+
+        // A miss streams, and starts loading the sample for the next hit
+        players[i].play(samples[i].filename);
+        if (!samples[i].cached && !samples[i].cacheFailed && fillSlot < 0) {
+            startCacheFill(i);
+        }
+    }
+}
+
+// Reserve cache room for an uncached slot's sample and open it for
+// serviceCacheFill(); no room means it streams from now on
+void SamplingEngine::startCacheFill(int slot) {
+    File file = SD.open(samples[slot].filename);
+    if (!file) return;
+
+    WavInfo info;
+    CachedSample* entry = nullptr;
+    if (SampleCache::readWavInfo(file, info) && info.frames == samples[slot].length &&
+        cache.canFit(info)) {
+        entry = cache.reserve(samples[slot].filename, info);
+    }
+    if (!entry) {
+        file.close();
+        samples[slot].cacheFailed = true;
+        return;
+    }
+
+    fillSlot = slot;
+    fillEntry = entry;
+    fillFile = file;
+    fillInfo = info;
+}
+
+// One slice of the load started by startCacheFill(); the slot switches
+// to the memory player once the whole sample is in
+void SamplingEngine::serviceCacheFill() {
+    if (fillSlot < 0) return;
+
+    int slot = fillSlot;
+    if (!cache.fill(fillEntry, fillFile, fillInfo, SAMPLE_CACHE_FILL_FRAMES)) {
+        DEBUG_PRINTF("SamplingEngine: Read error caching slot %d\n", slot);
+        cancelCacheFill(slot);
+        samples[slot].cacheFailed = true;
+        return;
+    }
+    if (!SampleCache::isComplete(fillEntry)) return;
+
+    fillFile.close();
+    __disable_irq();
+    samples[slot].cached = fillEntry;
+    __enable_irq();
+    fillSlot = -1;
+    fillEntry = nullptr;
+
+    DEBUG_PRINTF("SamplingEngine: Slot %d cached after a miss\n", slot);
+}
+
+// Drop an unfinished load of slot's sample (it is being replaced)
+void SamplingEngine::cancelCacheFill(int slot) {
+    if (fillSlot != slot) return;
+
+    fillFile.close();
+    cache.abandon(fillEntry);
+    fillSlot = -1;
+    fillEntry = nullptr;
 }
 
 void SamplingEngine::initializeSample(int slot) {
@@ -56,9 +153,15 @@ void SamplingEngine::initializeSample(int slot) {
     samples[slot].pitch = 1.0f;
     samples[slot].volume = 1.0f;
     samples[slot].pan = 0.0f;
+    samples[slot].filterFreq = TRACK_FILTER_FREQ;
+    samples[slot].filterRes = TRACK_FILTER_RES;
     samples[slot].startPos = 0;
     samples[slot].endPos = 0;
     samples[slot].length = 0;
+    samples[slot].loopStart = 0;
+    samples[slot].loopEnd = 0;
+    samples[slot].cached = nullptr;
+    samples[slot].cacheFailed = false;
 }
 
 bool SamplingEngine::validateSlot(int slot) {
@@ -78,19 +181,42 @@ bool SamplingEngine::loadSample(int slot, const char* filename) {
         DEBUG_PRINTF("SamplingEngine: Cannot open file: %s\n", filename);
         return false;
     }
+    cancelCacheFill(slot);
+
+    // Decode into the cache; unparseable or non-16-bit files still load
+    // and simply stream from SD
+    WavInfo info;
+    CachedSample* cached = nullptr;
+    uint32_t frames = 0;
+    if (SampleCache::readWavInfo(file, info)) {
+        frames = info.frames;
+        cached = cache.acquire(filename, file, info);
+    }
+
+    file.close();
+
+    // Swap under the ISR lock: trigger() runs in the audio ISR and must
+    // never see the old PCM once its player has been stopped
+    CachedSample* old = samples[slot].cached;
 
+    __disable_irq();
+    if (memPlayers) memPlayers[slot].stop();
     strncpy(samples[slot].filename, filename, 63);
     samples[slot].filename[63] = '\0';
-
-    samples[slot].length = file.size();
+    samples[slot].length = frames;
     samples[slot].startPos = 0;
-    samples[slot].endPos = samples[slot].length;
+    samples[slot].endPos = frames;
+    samples[slot].loopStart = 0;
+    samples[slot].loopEnd = 0;
+    samples[slot].cached = cached;
+    samples[slot].cacheFailed = false;
     samples[slot].loaded = true;
+    __enable_irq();
 
-    file.close();
+    cache.release(old);
 
-    DEBUG_PRINTF("SamplingEngine: Loaded slot %d: %s (%lu bytes)\n",
-                 slot, filename, samples[slot].length);
+    DEBUG_PRINTF("SamplingEngine: Loaded slot %d: %s (%lu frames, %s)\n",
+                 slot, filename, (unsigned long)frames, cached ? "cached" : "SD");
 
     return true;
 }
@@ -99,7 +225,14 @@ void SamplingEngine::unloadSample(int slot) {
     if (!validateSlot(slot)) return;
 
     stop(slot);
+    serviceSdPlayers();
+    cancelCacheFill(slot);
+
+    CachedSample* old = samples[slot].cached;
+    __disable_irq();
     initializeSample(slot);
+    __enable_irq();
+    cache.release(old);
 
     DEBUG_PRINTF("SamplingEngine: Unloaded slot %d\n", slot);
 }
@@ -109,39 +242,63 @@ bool SamplingEngine::isSampleLoaded(int slot) {
     return samples[slot].loaded;
 }
 
-void SamplingEngine::trigger(int slot) {
+// trigger()/stop() are called from the audio ISR (via AudioCommandQueue),
+// so they must not print or touch SD
+void SamplingEngine::trigger(int slot, uint16_t offset, float start, float end) {
     if (!validateSlot(slot)) return;
-    if (!samples[slot].loaded) {
-        DEBUG_PRINTF("SamplingEngine: Slot %d not loaded\n", slot);
-        return;
+    if (!samples[slot].loaded) return;
+
+    Sample& s = samples[slot];
+
+    if (s.cached && memPlayers) {
+        if (s.startPos >= s.endPos) return;
+
+        float span = (float)(s.endPos - s.startPos);
+        uint32_t first = s.startPos + (uint32_t)(constrain(start, 0.0f, 1.0f) * span);
+        uint32_t last = s.startPos + (uint32_t)(constrain(end, 0.0f, 1.0f) * span);
+        if (first >= last) return;
+
+        uint32_t loopEnd = s.loopEnd ? s.loopEnd : last;
+        memPlayers[slot].setRate(baseRate(slot));
+        memPlayers[slot].setLoop(s.looping, s.loopStart, loopEnd);
+        memPlayers[slot].play(s.cached->pcm, s.length, first, last, offset);
+        cache.recordHit();
+    } else if (players) {
+        // No SD access here: update() starts the stream
+        uint8_t bit = 1u << slot;
+        sdStarts |= bit;
+        sdStops &= ~bit;
+        cache.recordMiss();
     }
 
-    if (players) {
-        players[slot].play(samples[slot].filename);
-        amps[slot].gain(samples[slot].volume);
+    if (amps) {
+        amps[slot].gainNow(s.volume);     // With the note, not ramped in
     }
 
     samples[slot].playing = true;
-
-    DEBUG_PRINTF("SamplingEngine: Triggered slot %d\n", slot);
 }
 
 void SamplingEngine::stop(int slot) {
     if (!validateSlot(slot)) return;
 
     if (players) {
-        players[slot].stop();
+        // Closing the file is SD access: left to update()
+        uint8_t bit = 1u << slot;
+        sdStops |= bit;
+        sdStarts &= ~bit;
+    }
+    if (memPlayers) {
+        memPlayers[slot].stop();
     }
 
     samples[slot].playing = false;
-
-    DEBUG_PRINTF("SamplingEngine: Stopped slot %d\n", slot);
 }
 
 void SamplingEngine::stopAll() {
     for (int i = 0; i < MAX_TRACKS; i++) {
         stop(i);
     }
+    serviceSdPlayers();
     DEBUG_PRINTLN("SamplingEngine: Stopped all");
 }
 
@@ -156,8 +313,42 @@ void SamplingEngine::setVolume(int slot, float volume) {
 void SamplingEngine::setPitch(int slot, float pitch) {
     if (!validateSlot(slot)) return;
     samples[slot].pitch = constrain(pitch, 0.1f, 4.0f);
-    // Note: AudioPlaySdWav doesn't support variable-rate playback.
-    // Pitch changes take effect on next trigger.
+    // Cached samples follow immediately; AudioPlaySdWav is fixed-rate,
+    // so SD-streamed samples ignore pitch
+    if (memPlayers && samples[slot].cached) {
+        memPlayers[slot].setRate(baseRate(slot));
+    }
+}
+
+void SamplingEngine::setPlaybackRate(int slot, float ratio) {
+    if (!validateSlot(slot)) return;
+    if (memPlayers && samples[slot].cached) {
+        memPlayers[slot].setRate(baseRate(slot) * constrain(ratio, 0.0625f, 16.0f));
+    }
+}
+
+// Slot pitch, corrected for source files not recorded at SAMPLE_RATE
+float SamplingEngine::baseRate(int slot) {
+    float rate = samples[slot].pitch;
+    CachedSample* c = samples[slot].cached;
+    if (c && c->sampleRate > 0 && c->sampleRate != SAMPLE_RATE) {
+        rate *= (float)c->sampleRate / SAMPLE_RATE;
+    }
+    return rate;
+}
+
+void SamplingEngine::setInterpolation(InterpMode mode) {
+    if (mode >= INTERP_MODE_COUNT) return;
+    interpolation = mode;
+    if (memPlayers) {
+        for (int i = 0; i < MAX_TRACKS; i++) {
+            memPlayers[i].setInterpolation(mode);
+        }
+    }
+}
+
+InterpMode SamplingEngine::getInterpolation() {
+    return interpolation;
 }
 
 void SamplingEngine::setPan(int slot, float pan) {
@@ -165,9 +356,29 @@ void SamplingEngine::setPan(int slot, float pan) {
     samples[slot].pan = constrain(pan, -1.0f, 1.0f);
 }
 
+void SamplingEngine::setFilter(int slot, float freq, float res) {
+    if (!validateSlot(slot)) return;
+    samples[slot].filterFreq = constrain(freq, 20.0f, 20000.0f);
+    samples[slot].filterRes = constrain(res, 0.7f, 5.0f);
+}
+
 void SamplingEngine::setLoop(int slot, bool loop) {
     if (!validateSlot(slot)) return;
     samples[slot].looping = loop;
+    if (memPlayers && samples[slot].cached) {
+        Sample& s = samples[slot];
+        memPlayers[slot].setLoop(loop, s.loopStart, s.loopEnd ? s.loopEnd : s.endPos);
+    }
+}
+
+void SamplingEngine::setLoopPoints(int slot, uint32_t start, uint32_t end) {
+    if (!validateSlot(slot)) return;
+    Sample& s = samples[slot];
+    s.loopEnd = min(end, s.length);
+    s.loopStart = min(start, s.loopEnd);
+    if (memPlayers && s.cached) {
+        memPlayers[slot].setLoop(s.looping, s.loopStart, s.loopEnd ? s.loopEnd : s.endPos);
+    }
 }
 
 void SamplingEngine::setStartPos(int slot, uint32_t pos) {
@@ -183,6 +394,12 @@ void SamplingEngine::setEndPos(int slot, uint32_t pos) {
 bool SamplingEngine::isPlaying(int slot) {
     if (!validateSlot(slot)) return false;
     // Check actual player state if available
+    if (memPlayers && memPlayers[slot].isPlaying()) {
+        return true;
+    }
+    if (sdStarts & (1u << slot)) {
+        return true;                // Starts on the next update()
+    }
     if (players) {
         return players[slot].isPlaying();
     }
@@ -204,6 +421,21 @@ float SamplingEngine::getPitch(int slot) {
     return samples[slot].pitch;
 }
 
+float SamplingEngine::getFilterFreq(int slot) {
+    if (!validateSlot(slot)) return TRACK_FILTER_FREQ;
+    return samples[slot].filterFreq;
+}
+
+float SamplingEngine::getFilterRes(int slot) {
+    if (!validateSlot(slot)) return TRACK_FILTER_RES;
+    return samples[slot].filterRes;
+}
+
+uint32_t SamplingEngine::getLength(int slot) {
+    if (!validateSlot(slot)) return 0;
+    return samples[slot].length;
+}
+
 void SamplingEngine::loadBank(int bankNumber) {
     DEBUG_PRINTF("SamplingEngine: Loading bank %d\n", bankNumber);
 
@@ -227,7 +459,9 @@ void SamplingEngine::loadBank(int bankNumber) {
     }
 
     currentBank = bankNumber;
-    DEBUG_PRINTF("SamplingEngine: Bank %d loaded\n", bankNumber);
+    DEBUG_PRINTF("SamplingEngine: Bank %d loaded, cache %lu / %lu KB (%d samples)\n",
+                 bankNumber, (unsigned long)(cache.getBytesResident() / 1024),
+                 (unsigned long)(cache.getBudget() / 1024), cache.getEntryCount());
 }
 
 void SamplingEngine::saveBank(int bankNumber) {
@@ -268,3 +502,24 @@ void SamplingEngine::saveBank(int bankNumber) {
 int SamplingEngine::getCurrentBank() {
     return currentBank;
 }
+
+bool SamplingEngine::isCached(int slot) {
+    if (!validateSlot(slot)) return false;
+    return samples[slot].cached != nullptr;
+}
+
+float SamplingEngine::getCacheHitRate() {
+    return cache.getHitRate();
+}
+
+uint32_t SamplingEngine::getCacheBytesResident() {
+    return cache.getBytesResident();
+}
+
+uint32_t SamplingEngine::getCacheBudget() {
+    return cache.getBudget();
+}
+
+bool SamplingEngine::cacheUsesPSRAM() {
+    return cache.hasPSRAM();
+}
@@ -4,6 +4,9 @@
  */
 
 #include "scene_manager.h"
+#if HAVE_ARDUINOJSON
+#include <ArduinoJson.h>
+#endif
 
 SceneManager::SceneManager() {
     memset(saved, 0, sizeof(saved));
@@ -129,6 +132,7 @@ void SceneManager::saveAllToSD() {
 }
 
 void SceneManager::loadAllFromSD() {
+#if HAVE_ARDUINOJSON
     if (!SD.exists("/presets/scenes.json")) {
         DEBUG_PRINTLN("SceneManager: No scenes.json found");
         return;
@@ -179,4 +183,5 @@ void SceneManager::loadAllFromSD() {
     }
 
     DEBUG_PRINTLN("SceneManager: Loaded from SD");
+#endif
 }
@@ -4,23 +4,55 @@
  */
 
 #include "sequencer.h"
+#if HAVE_ARDUINOJSON
+#include "pattern_json.h"
+#endif
+#include <AudioStream.h>  // AUDIO_SAMPLE_RATE_EXACT, AUDIO_BLOCK_SAMPLES
 
-static Step dummyStep;
+// Staging for pattern file I/O: a load is read here and checked before it
+// replaces the live pattern the audio ISR is reading
+static PatternFile patternIO;
 
 Sequencer::Sequencer()
-    : currentPatternNumber(0)
+    : pattern(&patternBuf[0])
+    , currentPatternNumber(0)
+    , queuedPatternNumber(-1)
+    , switchMode(SWITCH_NEXT_BAR)
+    , switchArmed(false)
+    , switchRestart(false)
+    , switchDone(false)
+    , stepCount(0)
+    , dirtyMask(0)
+    , sdOnlyMask(0)
+    , liveDirty(false)
+    , lastEditTime(0)
     , selectedTrack(0)
     , currentStep(0)
     , running(false)
     , fillMode(false)
     , globalBpm(120.0f)
-    , lastStepTime(0)
-    , stepInterval(125)
-    , swingOffset(0)
+    , lastTickTime(0)
+    , tickInterval(125000 / SEQ_TICKS_PER_STEP)
+    , performanceSeed(0)
+    , seedReplay(false)
+    , masterTick(0)
+    , clockSource(CLOCK_MILLIS)
+    , samplePosition(0)
+    , samplesPerStep(AUDIO_SAMPLE_RATE_EXACT * 60.0f / 120.0f / 4.0f)
+    , samplesPerTick(AUDIO_SAMPLE_RATE_EXACT * 60.0f / 120.0f / 4.0f / SEQ_TICKS_PER_STEP)
+    , samplesToNextTick(0.0)
+    , leadSamples(0.0f)
+    , restartClock(true)
+    , droppedEvents(0)
+    , droppedLocks(0)
+    , refusedSteps(0)
     , triggerCallback(nullptr)
+    , noteCallback(nullptr)
 {
-    clearPattern();
+    patternClear(patternBuf[0]);
+    patternClear(patternBuf[1]);
     memset(triggerCounts, 0, sizeof(triggerCounts));
+    rewindTracks();
 }
 
 void Sequencer::begin(float initialBpm) {
@@ -29,6 +61,8 @@ void Sequencer::begin(float initialBpm) {
     globalBpm = initialBpm;
     calculateStepInterval();
 
+    convertJSONPatterns();
+    loadBank();
     loadPattern(0);
 
     DEBUG_PRINTLN("Sequencer: Ready");
@@ -38,56 +72,226 @@ void Sequencer::setTriggerCallback(StepTriggerCallback callback) {
     triggerCallback = callback;
 }
 
+void Sequencer::setNoteCallback(NoteTriggerCallback callback) {
+    noteCallback = callback;
+}
+
 void Sequencer::update() {
-    if (!running) return;
+    if (clockSource == CLOCK_AUDIO) {
+        // Step boundaries were decided in the audio ISR; hand them on
+        dispatchPendingEvents();
+    } else if (running) {
+        // Legacy clock: poll for due ticks (swing and micro-timing still
+        // land on the audio timeline through the trigger timestamps). A
+        // tick is due leadSamples before it sounds; how late loop() got to
+        // it comes off the lead.
+        unsigned long now = micros();
+        while (running && now - lastTickTime >= tickInterval) {
+            lastTickTime += tickInterval;
+            if (now - lastTickTime > 2 * SEQ_TICKS_PER_STEP * tickInterval) {
+                lastTickTime = now;     // Stalled: resync
+            }
+            float late = (now - lastTickTime) * (AUDIO_SAMPLE_RATE_EXACT / 1000000.0f);
+            processTick(samplePosition + (int32_t)(leadSamples - late));
+        }
+    }
+
+    finishSwitch();
+    serviceWriteback();
+}
+
+// ============================================
+// AUDIO CLOCK (runs in the audio ISR)
+// ============================================
+
+void Sequencer::processAudioBlock(uint32_t blockStart, uint16_t blockSamples) {
+    samplePosition = blockStart;
 
-    unsigned long now = millis();
+    if (clockSource != CLOCK_AUDIO || !running) return;
 
-    // Calculate effective interval for this step (swing offsets even steps)
-    unsigned long effectiveInterval = stepInterval;
-    if (pattern.swing > 0 && (currentStep % 2 == 1)) {
-        // Swing delays odd steps (the "and" beats)
-        effectiveInterval += (stepInterval * pattern.swing) / 200;
+    // Schedule a fixed window ahead of the block being rendered, so the
+    // timestamps are still in the future when loop() posts them on
+    uint32_t scheduleStart = blockStart + SEQ_LOOKAHEAD_BLOCKS * AUDIO_BLOCK_SAMPLES;
+
+    if (restartClock) {
+        // Ticks are decided one step ahead of their timestamps, so
+        // micro-timing can pull a trigger early. Start a lead's worth back
+        // so the first step still lands on the first sample of this block.
+        leadSamples = samplesPerStep;
+        samplesToNextTick = -leadSamples;
+        restartClock = false;
     }
 
-    if (now - lastStepTime >= effectiveInterval) {
-        lastStepTime = now;
+    // Fire every tick that falls inside this block, each at its own
+    // sub-block offset. The countdown stays fractional so tempo never
+    // accumulates rounding error.
+    while (samplesToNextTick < blockSamples) {
+        processTick(scheduleStart + (int32_t)(samplesToNextTick + leadSamples));
+        samplesToNextTick += samplesPerTick;
+    }
 
-        // Check if any track is soloed
-        bool anySoloed = false;
-        for (int t = 0; t < MAX_TRACKS; t++) {
-            if (pattern.tracks[t].soloed) {
-                anySoloed = true;
-                break;
-            }
-        }
+    samplesToNextTick -= blockSamples;
+}
 
-        // Process all tracks for current step
-        for (int track = 0; track < MAX_TRACKS; track++) {
-            if (pattern.tracks[track].muted) continue;
-            if (anySoloed && !pattern.tracks[track].soloed) continue;
+float Sequencer::swingDelaySamples(int track, int step) {
+    // Swing delays odd steps (the "and" beats) by up to half a track step
+    if (pattern->swing == 0 || (step % 2) == 0) return 0.0f;
+    float trackStepSamples = samplesPerTick * trackSpeedTicks[pattern->tracks[track].speed];
+    return trackStepSamples * pattern->swing / 200.0f;
+}
 
-            if (evaluateTrigCondition(track, currentStep)) {
-                triggerStep(track, currentStep);
-            }
+void Sequencer::rewindTracks() {
+    memset(trackStep, 0, sizeof(trackStep));
+    memset(trackTicks, 1, sizeof(trackTicks));     // All fire on the next tick
+    masterTick = 0;
+    seedTracks();
+}
+
+void Sequencer::seedTracks() {
+    uint32_t seed = pattern->seed ^ performanceSeed;
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        trigRngSeed(trackRng[t], seed + t);
+    }
+}
+
+bool Sequencer::anyTrackSoloed() {
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        if (pattern->tracks[t].soloed) return true;
+    }
+    return false;
+}
+
+void Sequencer::processTick(uint32_t sampleTime) {
+    int soloed = -1;    // Looked up once, only if a track fires
+
+    // Each track counts down its own step length in ticks (polymeter):
+    // a tick costs a decrement per track, and only tracks reaching a
+    // step boundary do any more work
+    for (int track = 0; track < MAX_TRACKS; track++) {
+        if (--trackTicks[track] > 0) continue;
+
+        const Track& trk = pattern->tracks[track];
+        trackTicks[track] = trackSpeedTicks[trk.speed];
+
+        int step = trackStep[track];
+        if (step >= trk.length) step = 0;    // Length shortened while playing
+        trackStep[track] = (step + 1) % trk.length;
+
+        // One draw per track step, used or not, so mutes and edits on
+        // other steps never change what a seed lets through
+        uint32_t roll = trigRngNext(trackRng[track]);
+
+        if (trk.muted) continue;
+        if (soloed < 0) soloed = anyTrackSoloed();
+        if (soloed && !trk.soloed) continue;
+
+        if (!evaluateTrigCondition(track, step, roll)) continue;
+
+        // Swing and micro-timing move the trigger off the grid; early is
+        // bounded by the lead (only reachable on tracks slower than 1x)
+        const Step& st = patternStep(*pattern, track, step);
+        float trackStepSamples = samplesPerTick * trackSpeedTicks[trk.speed];
+        float offset = swingDelaySamples(track, step) +
+                       st.microTiming * trackStepSamples / MICRO_TIMING_PER_STEP;
+        if (offset < -leadSamples) offset = -leadSamples;
+
+        StepEvent ev;
+        ev.sampleTime = sampleTime + (int32_t)offset;
+        ev.track = track;
+        ev.step = step;
+        ev.buffer = (pattern == &patternBuf[0]) ? 0 : 1;
+        ev.ratchets = st.ratchets;
+        ev.ratchetSpacing = (uint32_t)(trackStepSamples / (st.ratchets + 1));
+
+        if (clockSource == CLOCK_AUDIO) {
+            // In the ISR: defer the callback to loop()
+            if (!pendingEvents.push(ev)) droppedEvents++;
+        } else {
+            dispatchEvent(ev, *pattern);
         }
+    }
+
+    // Master step: pattern end, bars and queued switches
+    if (++masterTick < SEQ_TICKS_PER_STEP) return;
+    masterTick = 0;
 
-        // Advance step
-        currentStep = (currentStep + 1) % pattern.length;
+    currentStep = (currentStep + 1) % pattern->length;
+
+    if (currentStep == 0) {
+        memset(triggerCounts, 0, sizeof(triggerCounts));
+    }
 
-        if (currentStep == 0) {
-            memset(triggerCounts, 0, sizeof(triggerCounts));
+    // Queued pattern change: the inactive buffer is already filled, so
+    // the switch itself is a pointer flip
+    stepCount++;
+    if (switchArmed) {
+        bool boundary;
+        switch (switchMode) {
+            case SWITCH_PATTERN_END: boundary = (currentStep == 0);                     break;
+            case SWITCH_NEXT_BAR:    boundary = (stepCount % SEQ_STEPS_PER_BAR == 0);   break;
+            default:                 boundary = true;                                   break;
         }
+        if (boundary) flipBuffers(switchRestart);
+    }
+}
+
+// Ratchet hits all go out now with future timestamps; the audio command
+// queue holds them until their sample comes round
+void Sequencer::dispatchEvent(const StepEvent& ev, const Pattern& src) {
+    for (int hit = 0; hit <= ev.ratchets; hit++) {
+        triggerStep(src, ev.track, ev.step, ev.sampleTime + hit * ev.ratchetSpacing, hit,
+                    ev.ratchetSpacing);
+    }
+}
+
+void Sequencer::dispatchPendingEvents() {
+    StepEvent ev;
+    while (pendingEvents.pop(ev)) {
+        dispatchEvent(ev, patternBuf[ev.buffer]);
     }
 }
 
+void Sequencer::clearPendingEvents() {
+    pendingEvents.clear();
+}
+
+void Sequencer::setClockSource(ClockSource source) {
+    running = false;
+    clockSource = source;
+    clearPendingEvents();
+    restartClock = true;
+    DEBUG_PRINTF("Sequencer: Clock = %s\n", source == CLOCK_AUDIO ? "AUDIO" : "MILLIS");
+}
+
+ClockSource Sequencer::getClockSource() {
+    return clockSource;
+}
+
+uint32_t Sequencer::getSamplePosition() {
+    return samplePosition;
+}
+
+uint32_t Sequencer::getDroppedEvents() {
+    return droppedEvents;
+}
+
+uint32_t Sequencer::getDroppedLocks() {
+    return droppedLocks;
+}
+
+uint32_t Sequencer::getRefusedSteps() {
+    return refusedSteps;
+}
+
 void Sequencer::calculateStepInterval() {
-    float bpm = (pattern.bpm > 0) ? pattern.bpm : globalBpm;
-    stepInterval = (unsigned long)(60000.0f / bpm / 4.0f);
+    float bpm = (pattern->bpm > 0) ? pattern->bpm : globalBpm;
+    tickInterval = (unsigned long)(60000000.0f / bpm / 4.0f / SEQ_TICKS_PER_STEP);
+    samplesPerStep = AUDIO_SAMPLE_RATE_EXACT * 60.0f / bpm / 4.0f;
+    samplesPerTick = samplesPerStep / SEQ_TICKS_PER_STEP;
 }
 
-bool Sequencer::evaluateTrigCondition(int track, int step) {
-    Step& s = pattern.tracks[track].steps[step];
+bool Sequencer::evaluateTrigCondition(int track, int step, uint32_t roll) {
+    const Step& s = patternStep(*pattern, track, step);
 
     if (!s.active) return false;
 
@@ -99,16 +303,18 @@ bool Sequencer::evaluateTrigCondition(int track, int step) {
         case TRIG_NOT_FILL:
             return !fillMode;
         case TRIG_PRE:
-            return (step > 0) && pattern.tracks[track].steps[step - 1].active;
+            return (step > 0) && patternStep(*pattern, track, step - 1).active;
         case TRIG_NEI:
             if (step == 0) return false;
-            return pattern.tracks[track].steps[step - 1].active;
+            return patternStep(*pattern, track, step - 1).active;
         case TRIG_PROB_25:
-            return (random(100) < 25);
+            return (trigRngPercent(roll) < 25);
         case TRIG_PROB_50:
-            return (random(100) < 50);
+            return (trigRngPercent(roll) < 50);
         case TRIG_PROB_75:
-            return (random(100) < 75);
+            return (trigRngPercent(roll) < 75);
+        case TRIG_PROB:
+            return (trigRngPercent(roll) < s.probability);
         case TRIG_1ST:
             triggerCounts[track]++;
             return (triggerCounts[track] == 1);
@@ -126,11 +332,31 @@ bool Sequencer::evaluateTrigCondition(int track, int step) {
     }
 }
 
-void Sequencer::triggerStep(int track, int step) {
-    Step& s = pattern.tracks[track].steps[step];
+void Sequencer::triggerStep(const Pattern& src, int track, int step,
+                            uint32_t sampleTime, int hit, uint32_t hitSamples) {
+    const Step& s = patternStep(src, track, step);
+
+    // Ratchet hits after the first lose ratchetDecay% of velocity each
+    Step decayed;
+    const Step* out = &s;
+    if (hit > 0 && s.ratchetDecay > 0) {
+        decayed = s;
+        int velocity = s.velocity;
+        for (int i = 0; i < hit; i++) {
+            velocity = velocity * (100 - s.ratchetDecay) / 100;
+        }
+        decayed.velocity = velocity;
+        out = &decayed;
+    }
 
-    if (triggerCallback) {
-        triggerCallback(track, step, s);
+    if (src.tracks[track].type == TRACK_SYNTH) {
+        if (noteCallback) {
+            uint32_t gate = (uint32_t)((uint64_t)hitSamples * s.gate / GATE_PER_STEP);
+            noteCallback(track, step, *out, stepLocks(src, track, step), sampleTime,
+                         gate > 0 ? gate : 1);
+        }
+    } else if (triggerCallback) {
+        triggerCallback(track, step, *out, stepLocks(src, track, step), sampleTime);
     } else {
         DEBUG_PRINTF("Seq: Trigger T%d S%d (vel:%d pitch:%+d)\n",
                      track, step, s.velocity, s.pitchOffset);
@@ -138,26 +364,47 @@ void Sequencer::triggerStep(int track, int step) {
 }
 
 void Sequencer::applyParamLocks(int track, int step) {
-    Step& s = pattern.tracks[track].steps[step];
+    StepLocks locks = stepLocks(*pattern, track, step);
 
-    for (int p = 0; p < PARAM_COUNT; p++) {
-        if (s.hasParamLock[p]) {
-            DEBUG_PRINTF("  P-Lock: param %d = %.2f\n", p, s.paramLocks[p]);
-        }
+    for (uint16_t m = locks.mask; m; m &= m - 1) {
+        ParamType p = (ParamType)__builtin_ctz(m);
+        DEBUG_PRINTF("  P-Lock: param %d = %.2f\n", p, locks.get(p));
     }
 }
 
 // Transport controls
 void Sequencer::start() {
+    restartClock = true;
+    stepCount = 0;
+
+    // A new run: new trig outcomes unless replaying a seed
+    if (!seedReplay) performanceSeed = micros() * 0x2C1B3C6DUL + performanceSeed;
+    seedTracks();
+
+    // Millis clock: the first tick is due a lead's worth back, so it is
+    // taken at once and sounds now
+    leadSamples = samplesPerStep;
+    lastTickTime = micros() - SEQ_TICKS_PER_STEP * tickInterval;
     running = true;
-    lastStepTime = millis();
     DEBUG_PRINTLN("Sequencer: Started");
 }
 
 void Sequencer::stop() {
     running = false;
+
+    // A queued pattern would never reach its boundary now: switch at once
+    if (switchArmed) {
+        __disable_irq();
+        flipBuffers(true);
+        __enable_irq();
+    }
+    finishSwitch();
+
     currentStep = 0;
+    stepCount = 0;
+    rewindTracks();
     memset(triggerCounts, 0, sizeof(triggerCounts));
+    clearPendingEvents();
     DEBUG_PRINTLN("Sequencer: Stopped");
 }
 
@@ -168,7 +415,11 @@ void Sequencer::pause() {
 
 void Sequencer::reset() {
     currentStep = 0;
+    stepCount = 0;
+    rewindTracks();
     memset(triggerCounts, 0, sizeof(triggerCounts));
+    clearPendingEvents();
+    restartClock = true;
     DEBUG_PRINTLN("Sequencer: Reset");
 }
 
@@ -184,21 +435,24 @@ void Sequencer::setTempo(float bpm) {
 }
 
 float Sequencer::getTempo() {
-    return (pattern.bpm > 0) ? pattern.bpm : globalBpm;
+    return (pattern->bpm > 0) ? pattern->bpm : globalBpm;
 }
 
 void Sequencer::adjustSwing(int delta) {
-    pattern.swing = constrain(pattern.swing + delta, 0, 100);
-    DEBUG_PRINTF("Sequencer: Swing = %d%%\n", pattern.swing);
+    pattern->swing = constrain(pattern->swing + delta, 0, 100);
+    markEdited();
+    DEBUG_PRINTF("Sequencer: Swing = %d%%\n", pattern->swing);
 }
 
 uint8_t Sequencer::getSwing() {
-    return pattern.swing;
+    return pattern->swing;
 }
 
-// Position
+// Position. While running, ticks are decided one step ahead of the audio,
+// so what is sounding is one master step behind
 int Sequencer::getCurrentStep() {
-    return currentStep;
+    if (!running) return currentStep;
+    return (currentStep + pattern->length - 1) % pattern->length;
 }
 
 int Sequencer::getCurrentBar() {
@@ -206,7 +460,22 @@ int Sequencer::getCurrentBar() {
 }
 
 void Sequencer::setPosition(int step) {
-    currentStep = step % pattern.length;
+    currentStep = step % pattern->length;
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        trackStep[t] = step % pattern->tracks[t].length;
+        trackTicks[t] = 1;
+    }
+    masterTick = 0;
+}
+
+int Sequencer::getTrackStep(int track) {
+    if (track < 0 || track >= MAX_TRACKS) return 0;
+    // trackStep is the next step to decide; while running, the track also
+    // has the lead's worth of its own steps decided but not yet sounding
+    int len = pattern->tracks[track].length;
+    int behind = 1;
+    if (running) behind += SEQ_TICKS_PER_STEP / trackSpeedTicks[pattern->tracks[track].speed];
+    return (trackStep[track] + len - behind % len) % len;
 }
 
 // Track management
@@ -223,62 +492,93 @@ int Sequencer::getSelectedTrack() {
 
 void Sequencer::muteTrack(int track) {
     if (track >= 0 && track < MAX_TRACKS) {
-        pattern.tracks[track].muted = true;
+        pattern->tracks[track].muted = true;
+        markEdited();
     }
 }
 
 void Sequencer::unmuteTrack(int track) {
     if (track >= 0 && track < MAX_TRACKS) {
-        pattern.tracks[track].muted = false;
+        pattern->tracks[track].muted = false;
+        markEdited();
     }
 }
 
 void Sequencer::soloTrack(int track) {
     if (track >= 0 && track < MAX_TRACKS) {
-        pattern.tracks[track].soloed = true;
+        pattern->tracks[track].soloed = true;
+        markEdited();
     }
 }
 
 void Sequencer::unsoloTrack(int track) {
     if (track >= 0 && track < MAX_TRACKS) {
-        pattern.tracks[track].soloed = false;
+        pattern->tracks[track].soloed = false;
+        markEdited();
     }
 }
 
 bool Sequencer::isTrackMuted(int track) {
     if (track >= 0 && track < MAX_TRACKS) {
-        return pattern.tracks[track].muted;
+        return pattern->tracks[track].muted;
     }
     return false;
 }
 
 bool Sequencer::isTrackSoloed(int track) {
     if (track >= 0 && track < MAX_TRACKS) {
-        return pattern.tracks[track].soloed;
+        return pattern->tracks[track].soloed;
     }
     return false;
 }
 
 // Step editing
+bool Sequencer::validStep(int track, int step) {
+    return track >= 0 && track < MAX_TRACKS &&
+           step >= 0 && step < pattern->tracks[track].length;
+}
+
+Step* Sequencer::editStep(int track, int step) {
+    if (!validStep(track, step)) return nullptr;
+
+    // A new page has to fit the bank's pool when this pattern is stored
+    bool newPage = pattern->tracks[track].pages[step / STEPS_PER_PAGE] == NO_PAGE;
+    if (newPage && bank.ready() && !(sdOnlyMask & (1ULL << currentPatternNumber)) &&
+        pattern->pagesUsed >= bank.pagesFree() + bank.pagesHeld(currentPatternNumber)) {
+        DEBUG_PRINTLN("Sequencer: Bank page pool full");
+        refusedSteps++;
+        return nullptr;
+    }
+
+    Step* s = patternStepForEdit(*pattern, track, step);
+    if (!s) {
+        DEBUG_PRINTLN("Sequencer: Step page pool full");
+        return nullptr;
+    }
+    markEdited();
+    return s;
+}
+
 void Sequencer::toggleStep(int step) {
-    if (step >= 0 && step < pattern.length) {
-        pattern.tracks[selectedTrack].steps[step].active =
-            !pattern.tracks[selectedTrack].steps[step].active;
+    Step* s = editStep(selectedTrack, step);
+    if (s) {
+        s->active = !s->active;
         DEBUG_PRINTF("Sequencer: T%d S%d = %s\n",
-                     selectedTrack, step,
-                     pattern.tracks[selectedTrack].steps[step].active ? "ON" : "OFF");
+                     selectedTrack, step, s->active ? "ON" : "OFF");
     }
 }
 
 void Sequencer::setStep(int track, int step, bool active) {
-    if (track >= 0 && track < MAX_TRACKS && step >= 0 && step < pattern.length) {
-        pattern.tracks[track].steps[step].active = active;
-    }
+    // Clearing a step that was never written needs no page
+    if (!active && !getStep(track, step)) return;
+
+    Step* s = editStep(track, step);
+    if (s) s->active = active;
 }
 
 bool Sequencer::hasStep(int step) {
     for (int t = 0; t < MAX_TRACKS; t++) {
-        if (pattern.tracks[t].steps[step].active) {
+        if (getStep(t, step)) {
             return true;
         }
     }
@@ -286,184 +586,330 @@ bool Sequencer::hasStep(int step) {
 }
 
 bool Sequencer::getStep(int track, int step) {
-    if (track >= 0 && track < MAX_TRACKS && step >= 0 && step < pattern.length) {
-        return pattern.tracks[track].steps[step].active;
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step).active;
     }
     return false;
 }
 
-Step& Sequencer::getStepData(int track, int step) {
-    if (track >= 0 && track < MAX_TRACKS && step >= 0 && step < pattern.length) {
-        return pattern.tracks[track].steps[step];
+const Step& Sequencer::getStepData(int track, int step) {
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step);
     }
-    return dummyStep;
+    return emptyStep;
 }
 
 // Trig conditions
 void Sequencer::setTrigCondition(int track, int step, TrigCondition condition) {
-    if (track >= 0 && track < MAX_TRACKS && step >= 0 && step < pattern.length) {
-        pattern.tracks[track].steps[step].condition = condition;
-    }
+    Step* s = editStep(track, step);
+    if (s) s->condition = condition;
 }
 
 TrigCondition Sequencer::getTrigCondition(int track, int step) {
-    if (track >= 0 && track < MAX_TRACKS && step >= 0 && step < pattern.length) {
-        return pattern.tracks[track].steps[step].condition;
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step).condition;
     }
     return TRIG_ALWAYS;
 }
 
+void Sequencer::setProbability(int track, int step, int percent) {
+    Step* s = editStep(track, step);
+    if (s) s->probability = constrain(percent, 0, 100);
+}
+
+int Sequencer::getProbability(int track, int step) {
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step).probability;
+    }
+    return 100;
+}
+
+// Probability seeds
+void Sequencer::setPatternSeed(uint32_t seed) {
+    pattern->seed = seed;
+    markEdited();
+}
+
+uint32_t Sequencer::getPatternSeed() {
+    return pattern->seed;
+}
+
+void Sequencer::setReplaySeed(uint32_t seed) {
+    performanceSeed = seed;
+    seedReplay = true;
+    DEBUG_PRINTF("Sequencer: Replaying seed %08lX\n", (unsigned long)seed);
+}
+
+void Sequencer::clearReplaySeed() {
+    seedReplay = false;
+}
+
+bool Sequencer::isReplaySeed() {
+    return seedReplay;
+}
+
+uint32_t Sequencer::getPerformanceSeed() {
+    return performanceSeed;
+}
+
+// Micro-timing and ratchets
+void Sequencer::setMicroTiming(int track, int step, int offset) {
+    Step* s = editStep(track, step);
+    if (s) s->microTiming = constrain(offset, -MICRO_TIMING_MAX, MICRO_TIMING_MAX);
+}
+
+int Sequencer::getMicroTiming(int track, int step) {
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step).microTiming;
+    }
+    return 0;
+}
+
+void Sequencer::setRatchet(int track, int step, int count, int decay) {
+    Step* s = editStep(track, step);
+    if (s) {
+        s->ratchets = constrain(count, 0, MAX_RATCHETS);
+        s->ratchetDecay = constrain(decay, 0, 100);
+    }
+}
+
+int Sequencer::getRatchets(int track, int step) {
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step).ratchets;
+    }
+    return 0;
+}
+
+int Sequencer::getRatchetDecay(int track, int step) {
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step).ratchetDecay;
+    }
+    return 0;
+}
+
+// Track length and speed (polymeter)
+void Sequencer::setTrackLength(int track, int length) {
+    if (track < 0 || track >= MAX_TRACKS) return;
+    pattern->tracks[track].length = constrain(length, 1, MAX_STEPS);
+    markEdited();
+}
+
+int Sequencer::getTrackLength(int track) {
+    if (track < 0 || track >= MAX_TRACKS) return 0;
+    return pattern->tracks[track].length;
+}
+
+void Sequencer::setTrackSpeed(int track, TrackSpeed speed) {
+    if (track < 0 || track >= MAX_TRACKS || speed >= SPEED_COUNT) return;
+    pattern->tracks[track].speed = speed;
+    markEdited();
+}
+
+TrackSpeed Sequencer::getTrackSpeed(int track) {
+    if (track < 0 || track >= MAX_TRACKS) return SPEED_1;
+    return pattern->tracks[track].speed;
+}
+
+// Track type and synth steps
+void Sequencer::setTrackType(int track, TrackType type) {
+    if (track < 0 || track >= MAX_TRACKS || type >= TRACK_TYPE_COUNT) return;
+    pattern->tracks[track].type = type;
+    markEdited();
+}
+
+TrackType Sequencer::getTrackType(int track) {
+    if (track < 0 || track >= MAX_TRACKS) return TRACK_SAMPLE;
+    return pattern->tracks[track].type;
+}
+
+void Sequencer::setNote(int track, int step, int note) {
+    Step* s = editStep(track, step);
+    if (s) s->note = constrain(note, 0, 127);
+}
+
+int Sequencer::getNote(int track, int step) {
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step).note;
+    }
+    return SEQ_DEFAULT_NOTE;
+}
+
+void Sequencer::setGate(int track, int step, int gate) {
+    Step* s = editStep(track, step);
+    if (s) s->gate = constrain(gate, 1, GATE_MAX);
+}
+
+int Sequencer::getGate(int track, int step) {
+    if (validStep(track, step)) {
+        return patternStep(*pattern, track, step).gate;
+    }
+    return GATE_PER_STEP / 2;
+}
+
+void Sequencer::setPatternLength(int length) {
+    length = constrain(length, 1, MAX_STEPS);
+
+    // Tracks that followed the master length keep following it
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        if (pattern->tracks[t].length == pattern->length) {
+            pattern->tracks[t].length = length;
+        }
+    }
+    pattern->length = length;
+    markEdited();
+}
+
 // Parameter locks
-void Sequencer::setParamLock(int track, int step, ParamType param, float value) {
-    if (track >= 0 && track < MAX_TRACKS &&
-        step >= 0 && step < pattern.length &&
-        param >= 0 && param < PARAM_COUNT) {
-        pattern.tracks[track].steps[step].paramLocks[param] = value;
-        pattern.tracks[track].steps[step].hasParamLock[param] = true;
+bool Sequencer::setParamLock(int track, int step, ParamType param, float value) {
+    if (validStep(track, step) && param >= 0 && param < PARAM_COUNT) {
+        if (!stepSetLock(*pattern, track, step, param, value)) {
+            DEBUG_PRINTF("Sequencer: T%d lock pool full\n", track);
+            droppedLocks++;
+            return false;
+        }
+        markEdited();
+        return true;
     }
+    return false;
 }
 
 void Sequencer::clearParamLock(int track, int step, ParamType param) {
-    if (track >= 0 && track < MAX_TRACKS &&
-        step >= 0 && step < pattern.length &&
-        param >= 0 && param < PARAM_COUNT) {
-        pattern.tracks[track].steps[step].hasParamLock[param] = false;
+    if (validStep(track, step) && param >= 0 && param < PARAM_COUNT) {
+        stepClearLock(*pattern, track, step, param);
+        markEdited();
     }
 }
 
 void Sequencer::clearAllParamLocks(int track, int step) {
-    if (track >= 0 && track < MAX_TRACKS && step >= 0 && step < pattern.length) {
-        for (int p = 0; p < PARAM_COUNT; p++) {
-            pattern.tracks[track].steps[step].hasParamLock[p] = false;
-        }
+    if (validStep(track, step)) {
+        stepClearLocks(*pattern, track, step);
+        markEdited();
     }
 }
 
 bool Sequencer::hasParamLock(int track, int step, ParamType param) {
-    if (track >= 0 && track < MAX_TRACKS &&
-        step >= 0 && step < pattern.length &&
-        param >= 0 && param < PARAM_COUNT) {
-        return pattern.tracks[track].steps[step].hasParamLock[param];
+    if (validStep(track, step) && param >= 0 && param < PARAM_COUNT) {
+        return stepLocks(*pattern, track, step).has(param);
     }
     return false;
 }
 
 float Sequencer::getParamLock(int track, int step, ParamType param) {
-    if (track >= 0 && track < MAX_TRACKS &&
-        step >= 0 && step < pattern.length &&
-        param >= 0 && param < PARAM_COUNT) {
-        return pattern.tracks[track].steps[step].paramLocks[param];
+    if (validStep(track, step) && param >= 0 && param < PARAM_COUNT) {
+        StepLocks locks = stepLocks(*pattern, track, step);
+        if (locks.has(param)) return locks.get(param);
     }
     return 0.0f;
 }
 
 // Pattern management
-void Sequencer::loadPattern(int patternNumber) {
-    DEBUG_PRINTF("Sequencer: Loading pattern %d\n", patternNumber);
 
-    char path[64];
-    snprintf(path, sizeof(path), "%spattern%02d.json", PATTERNS_DIR, patternNumber);
+static void patternPath(char* path, size_t size, int patternNumber, const char* ext) {
+    snprintf(path, size, "%spattern%02d.%s", PATTERNS_DIR, patternNumber, ext);
+}
 
-    if (!SD.exists(path)) {
-        DEBUG_PRINTF("Sequencer: Pattern file not found, using empty pattern\n");
-        currentPatternNumber = patternNumber;
-        return;
-    }
+void Sequencer::queuePattern(int patternNumber) {
+    if (patternNumber < 0 || patternNumber >= MAX_PATTERNS) return;
 
-    File file = SD.open(path);
-    if (!file) {
-        currentPatternNumber = patternNumber;
+    // Stopped, or not quantized: nothing to wait for
+    if (!running || switchMode == SWITCH_IMMEDIATE) {
+        loadPattern(patternNumber);
         return;
     }
 
-    DynamicJsonDocument doc(8192);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
+    prepareSwitch(patternNumber);
+    switchRestart = true;
+    switchArmed = true;
+    DEBUG_PRINTF("Sequencer: Pattern %d queued\n", patternNumber);
+}
 
-    if (error) {
-        DEBUG_PRINTF("Sequencer: JSON parse error: %s\n", error.c_str());
-        currentPatternNumber = patternNumber;
-        return;
-    }
+void Sequencer::loadPattern(int patternNumber) {
+    if (patternNumber < 0 || patternNumber >= MAX_PATTERNS) return;
 
-    pattern.length = doc["length"] | MAX_STEPS;
-    pattern.swing = doc["swing"] | 0;
-    pattern.bpm = doc["bpm"] | 0.0f;
+    prepareSwitch(patternNumber);
+    __disable_irq();
+    flipBuffers(false);
+    __enable_irq();
+    finishSwitch();
 
-    JsonArray tracks = doc["tracks"];
-    for (int t = 0; t < MAX_TRACKS && t < (int)tracks.size(); t++) {
-        JsonObject trk = tracks[t];
-        pattern.tracks[t].muted = trk["muted"] | false;
-        pattern.tracks[t].sourceSlot = trk["src"] | t;
-        pattern.tracks[t].volume = trk["vol"] | 1.0f;
-        pattern.tracks[t].pan = trk["pan"] | 0.0f;
+    DEBUG_PRINTF("Sequencer: Pattern %d loaded (%d steps)\n", patternNumber, pattern->length);
+}
 
-        JsonArray steps = trk["steps"];
-        for (int s = 0; s < MAX_STEPS && s < (int)steps.size(); s++) {
-            if (steps[s].is<int>() && steps[s].as<int>() == 0) {
-                // Inactive step (compact format)
-                pattern.tracks[t].steps[s].active = false;
-                continue;
-            }
+void Sequencer::savePattern(int patternNumber) {
+    if (patternNumber < 0 || patternNumber >= MAX_PATTERNS) return;
 
-            JsonObject st = steps[s];
-            pattern.tracks[t].steps[s].active = true;
-            pattern.tracks[t].steps[s].velocity = st["v"] | 127;
-            pattern.tracks[t].steps[s].condition = (TrigCondition)(st["c"] | 0);
-            pattern.tracks[t].steps[s].pitchOffset = st["p"] | 0;
-
-            // Load parameter locks (L0..Ln)
-            for (int p = 0; p < PARAM_COUNT; p++) {
-                char key[4];
-                snprintf(key, sizeof(key), "L%d", p);
-                if (st.containsKey(key)) {
-                    pattern.tracks[t].steps[s].paramLocks[p] = st[key];
-                    pattern.tracks[t].steps[s].hasParamLock[p] = true;
-                }
-            }
-        }
-    }
+    storePattern(patternNumber, *pattern);
+    if (patternNumber == currentPatternNumber) liveDirty = false;
+    DEBUG_PRINTF("Sequencer: Pattern %d saved\n", patternNumber);
+}
 
-    currentPatternNumber = patternNumber;
-    calculateStepInterval();
-    DEBUG_PRINTF("Sequencer: Pattern %d loaded (%d steps)\n", patternNumber, pattern.length);
+void Sequencer::setPatternSwitchMode(PatternSwitchMode mode) {
+    switchMode = mode;
 }
 
-void Sequencer::savePattern(int patternNumber) {
-    DEBUG_PRINTF("Sequencer: Saving pattern %d\n", patternNumber);
+PatternSwitchMode Sequencer::getPatternSwitchMode() {
+    return switchMode;
+}
+
+int Sequencer::getQueuedPattern() {
+    return switchArmed ? queuedPatternNumber : -1;
+}
 
+int Sequencer::getDirtyPatternCount() {
+    uint64_t mask = dirtyMask;
+    if (liveDirty) mask |= 1ULL << currentPatternNumber;
+    return __builtin_popcountll(mask);
+}
+
+bool Sequencer::importPatternJSON(int patternNumber) {
+    if (!readPatternJSON(patternNumber)) return false;
+
+    // The import replaces any unsaved edits to that pattern
+    if (patternNumber == currentPatternNumber) liveDirty = false;
+    storePattern(patternNumber, patternIO.pattern);
+    loadPattern(patternNumber);
+    DEBUG_PRINTF("Sequencer: Pattern %d imported from JSON\n", patternNumber);
+    return true;
+}
+
+bool Sequencer::exportPatternJSON(int patternNumber) {
     char path[64];
-    snprintf(path, sizeof(path), "%spattern%02d.json", PATTERNS_DIR, patternNumber);
+    patternPath(path, sizeof(path), patternNumber, "json");
 
     // Streaming JSON write for memory efficiency
+    SD.remove(path);
     File file = SD.open(path, FILE_WRITE);
     if (!file) {
         DEBUG_PRINTF("Sequencer: Cannot open %s for writing\n", path);
-        return;
+        return false;
     }
 
     file.print("{\"length\":");
-    file.print(pattern.length);
+    file.print(pattern->length);
     file.print(",\"swing\":");
-    file.print(pattern.swing);
+    file.print(pattern->swing);
     file.print(",\"bpm\":");
-    file.print(pattern.bpm);
+    file.print(pattern->bpm);
+    file.print(",\"seed\":");
+    file.print(pattern->seed);
     file.print(",\"tracks\":[");
 
     for (int t = 0; t < MAX_TRACKS; t++) {
         if (t > 0) file.print(",");
-        Track& trk = pattern.tracks[t];
+        Track& trk = pattern->tracks[t];
 
         file.print("{\"muted\":");
         file.print(trk.muted ? "true" : "false");
         file.print(",\"src\":");
         file.print(trk.sourceSlot);
         file.printf(",\"vol\":%.2f,\"pan\":%.2f", trk.volume, trk.pan);
+        file.printf(",\"len\":%d,\"spd\":%d", trk.length, (int)trk.speed);
+        if (trk.type != TRACK_SAMPLE) file.printf(",\"type\":%d", (int)trk.type);
         file.print(",\"steps\":[");
 
-        for (int s = 0; s < pattern.length; s++) {
+        for (int s = 0; s < trk.length; s++) {
             if (s > 0) file.print(",");
-            Step& st = trk.steps[s];
+            const Step& st = patternStep(*pattern, t, s);
 
             if (!st.active) {
                 file.print("0");
@@ -476,11 +922,15 @@ void Sequencer::savePattern(int patternNumber) {
             file.print((int)st.condition);
             file.print(",\"p\":");
             file.print(st.pitchOffset);
-
-            for (int p = 0; p < PARAM_COUNT; p++) {
-                if (st.hasParamLock[p]) {
-                    file.printf(",\"L%d\":%.2f", p, st.paramLocks[p]);
-                }
+            if (st.probability != 100) file.printf(",\"pr\":%d", st.probability);
+            if (st.microTiming) file.printf(",\"m\":%d", st.microTiming);
+            if (st.ratchets) file.printf(",\"r\":%d,\"d\":%d", st.ratchets, st.ratchetDecay);
+            if (trk.type == TRACK_SYNTH) file.printf(",\"n\":%d,\"g\":%d", st.note, st.gate);
+
+            StepLocks locks = stepLocks(*pattern, t, s);
+            for (uint16_t m = locks.mask; m; m &= m - 1) {
+                ParamType p = (ParamType)__builtin_ctz(m);
+                file.printf(",\"L%d\":%.4f", p, locks.get(p));
             }
 
             file.print("}");
@@ -492,41 +942,285 @@ void Sequencer::savePattern(int patternNumber) {
     file.print("]}");
     file.close();
 
-    DEBUG_PRINTF("Sequencer: Pattern %d saved\n", patternNumber);
+    DEBUG_PRINTF("Sequencer: Pattern %d exported to %s\n", patternNumber, path);
+    return true;
 }
 
-void Sequencer::copyPattern(int from, int to) {
-    DEBUG_PRINTF("Sequencer: Copy pattern %d to %d\n", from, to);
-    loadPattern(from);
-    savePattern(to);
+int Sequencer::convertJSONPatterns() {
+    int converted = 0;
+
+    for (int n = 0; n < MAX_PATTERNS; n++) {
+        // Missing, or written by another firmware layout
+        if (readPatternFile(n)) continue;
+
+        if (readPatternJSON(n) && writePatternFile(n, patternIO.pattern)) {
+            converted++;
+        }
+    }
+
+    if (converted > 0) {
+        DEBUG_PRINTF("Sequencer: Converted %d JSON patterns to binary\n", converted);
+    }
+    return converted;
 }
 
-void Sequencer::clearPattern() {
-    pattern.length = MAX_STEPS;
-    pattern.swing = 0;
-    pattern.bpm = 0;
+void Sequencer::markEdited() {
+    liveDirty = true;
+    lastEditTime = millis();
+}
 
-    for (int t = 0; t < MAX_TRACKS; t++) {
-        pattern.tracks[t].muted = false;
-        pattern.tracks[t].soloed = false;
-        pattern.tracks[t].sourceSlot = t;
-        pattern.tracks[t].volume = 1.0f;
-        pattern.tracks[t].pan = 0.0f;
-
-        for (int s = 0; s < MAX_STEPS; s++) {
-            pattern.tracks[t].steps[s].active = false;
-            pattern.tracks[t].steps[s].condition = TRIG_ALWAYS;
-            pattern.tracks[t].steps[s].velocity = 127;
-            pattern.tracks[t].steps[s].pitchOffset = 0;
-            pattern.tracks[t].steps[s].sampleSlice = 0;
-
-            for (int p = 0; p < PARAM_COUNT; p++) {
-                pattern.tracks[t].steps[s].paramLocks[p] = 0.0f;
-                pattern.tracks[t].steps[s].hasParamLock[p] = false;
-            }
+Pattern& Sequencer::inactiveBuffer() {
+    return (pattern == &patternBuf[0]) ? patternBuf[1] : patternBuf[0];
+}
+
+// Fill the inactive buffer with the next pattern (loop only)
+void Sequencer::prepareSwitch(int patternNumber) {
+    // Take back a switch that is still waiting; if the ISR got there
+    // first, finish it so the old buffer is free again
+    switchArmed = false;
+    finishSwitch();
+
+    commitLive();
+    fetchPattern(patternNumber, inactiveBuffer());
+    queuedPatternNumber = patternNumber;
+}
+
+// Make the inactive buffer live. Audio ISR, or loop with IRQs off.
+void Sequencer::flipBuffers(bool restart) {
+    pattern = &inactiveBuffer();
+    if (restart || currentStep >= pattern->length) {
+        currentStep = 0;
+        rewindTracks();
+        memset(triggerCounts, 0, sizeof(triggerCounts));
+    } else {
+        for (int t = 0; t < MAX_TRACKS; t++) {
+            trackStep[t] %= pattern->tracks[t].length;
         }
     }
+    calculateStepInterval();    // The new pattern may carry its own tempo
+    switchArmed = false;
+    switchDone = true;
+}
+
+void Sequencer::finishSwitch() {
+    if (!switchDone) return;
+
+    // Triggers already taken from the old buffer go out before it is reused
+    dispatchPendingEvents();
+
+    // Edits that landed on the old buffer while the switch was queued
+    if (liveDirty) {
+        storePattern(currentPatternNumber, inactiveBuffer());
+        liveDirty = false;
+    }
+
+    currentPatternNumber = queuedPatternNumber;
+    queuedPatternNumber = -1;
+    switchDone = false;
+}
+
+void Sequencer::commitLive() {
+    if (!liveDirty) return;
+    storePattern(currentPatternNumber, *pattern);
+    liveDirty = false;
+}
 
+void Sequencer::fetchPattern(int patternNumber, Pattern& out) {
+    if (bank.ready() && !(sdOnlyMask & (1ULL << patternNumber))) {
+        bank.fetch(patternNumber, out);
+        return;
+    }
+
+    // Not in the bank: straight from SD
+    if (readPatternFile(patternNumber)) {
+        memcpy(&out, &patternIO.pattern, sizeof(Pattern));
+    } else if (readPatternJSON(patternNumber)) {
+        writePatternFile(patternNumber, patternIO.pattern);
+        memcpy(&out, &patternIO.pattern, sizeof(Pattern));
+    } else {
+        DEBUG_PRINTF("Sequencer: Pattern file not found, using empty pattern\n");
+        patternClear(out);
+    }
+}
+
+void Sequencer::storePattern(int patternNumber, const Pattern& p) {
+    uint64_t bit = 1ULL << patternNumber;
+    if (bank.ready()) {
+        if (bank.store(patternNumber, p)) {
+            sdOnlyMask &= ~bit;
+            dirtyMask |= bit;
+            return;
+        }
+
+        // A copy or import bigger than the pool has left: it stays on SD
+        DEBUG_PRINTF("Sequencer: Bank page pool full, pattern %d loads from SD\n", patternNumber);
+        bank.evict(patternNumber);
+        sdOnlyMask |= bit;
+        dirtyMask &= ~bit;
+    }
+    writePatternFile(patternNumber, p);
+}
+
+// The bank and the LCD framebuffer both come out of the PSRAM the sample
+// cache leaves free
+static_assert(sizeof(PatternBankMemory) + (size_t)LCD_WIDTH * LCD_HEIGHT * 2 +
+              WAVETABLE_PSRAM_BUDGET <= SAMPLE_CACHE_PSRAM_RESERVE,
+              "SAMPLE_CACHE_PSRAM_RESERVE too small for the pattern bank and framebuffer");
+
+void Sequencer::loadBank() {
+    // Without PSRAM, extmem_malloc() would take the bank out of RAM2,
+    // which cannot hold it next to the framebuffer and its DMA staging
+    // (~950 KB together): the LCD keeps RAM2 and patterns load from SD
+    if (external_psram_size == 0) {
+        DEBUG_PRINTLN("Sequencer: No PSRAM, patterns load from SD");
+        return;
+    }
+
+    PatternBankMemory* memory = (PatternBankMemory*)extmem_malloc(sizeof(PatternBankMemory));
+    if (!memory) {
+        DEBUG_PRINTLN("Sequencer: No room for pattern bank, patterns load from SD");
+        return;
+    }
+    bank.begin(memory);
+
+    int found = 0;
+    for (int n = 0; n < MAX_PATTERNS; n++) {
+        if (!readPatternFile(n)) continue;
+        if (bank.store(n, patternIO.pattern)) {
+            found++;
+        } else {
+            sdOnlyMask |= 1ULL << n;
+        }
+    }
+    dirtyMask = 0;
+
+    DEBUG_PRINTF("Sequencer: Pattern bank ready (%d from SD, %d on SD only, %lu KB)\n",
+                 found, __builtin_popcountll(sdOnlyMask),
+                 (unsigned long)(sizeof(PatternBankMemory) / 1024));
+}
+
+// Fold live edits into the bank once editing pauses, then write one dirty
+// pattern per call so a burst of saves never holds up loop() for long
+void Sequencer::serviceWriteback() {
+    if (!bank.ready()) return;
+    if (millis() - lastEditTime < PATTERN_WRITEBACK_DELAY_MS) return;
+
+    commitLive();
+    if (dirtyMask == 0) return;
+
+    int n = __builtin_ctzll(dirtyMask);
+    bank.fetch(n, patternIO.pattern);
+    if (writePatternFile(n, patternIO.pattern)) {
+        dirtyMask &= ~(1ULL << n);
+    } else {
+        lastEditTime = millis();    // Back off before retrying
+    }
+}
+
+bool Sequencer::readPatternFile(int patternNumber) {
+    char path[64];
+    patternPath(path, sizeof(path), patternNumber, "bin");
+
+    File file = SD.open(path);
+    if (!file) return false;
+
+    // One read of at most a full PatternFile; the file itself ends after
+    // the last page in use, as its header says
+    int got = file.read(&patternIO, sizeof(PatternFile));
+    file.close();
+
+    if (got < (int)sizeof(PatternFileHeader) ||
+        got != (int)patternFileSize(patternIO.header)) {
+        DEBUG_PRINTF("Sequencer: %s wrong size (%d bytes)\n", path, got);
+        return false;
+    }
+
+    PatternFileStatus status = patternFileCheck(patternIO);
+    if (status != PATTERN_FILE_OK) {
+        DEBUG_PRINTF("Sequencer: %s rejected (status %d)\n", path, (int)status);
+        return false;
+    }
+    return true;
+}
+
+bool Sequencer::readPatternJSON(int patternNumber) {
+#if HAVE_ARDUINOJSON
+    char path[64];
+    patternPath(path, sizeof(path), patternNumber, "json");
+
+    File file = SD.open(path);
+    if (!file) return false;
+
+    DynamicJsonDocument doc(8192);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+
+    if (error) {
+        DEBUG_PRINTF("Sequencer: JSON parse error: %s\n", error.c_str());
+        return false;
+    }
+
+    int dropped = patternFromJson(doc, patternIO.pattern);
+    if (dropped > 0) {
+        DEBUG_PRINTF("Sequencer: %s dropped %d locks, pool full\n", path, dropped);
+        droppedLocks += dropped;
+    }
+    return true;
+#else
+    (void)patternNumber;
+    return false;
+#endif
+}
+
+bool Sequencer::writePatternFile(int patternNumber, const Pattern& p) {
+    char path[64];
+    patternPath(path, sizeof(path), patternNumber, "bin");
+
+    if (&patternIO.pattern != &p) {
+        memcpy(&patternIO.pattern, &p, sizeof(Pattern));
+    }
+    patternFileSeal(patternIO);
+
+    SD.remove(path);
+    File file = SD.open(path, FILE_WRITE);
+    if (!file) {
+        DEBUG_PRINTF("Sequencer: Cannot open %s for writing\n", path);
+        return false;
+    }
+
+    size_t size = patternFileSize(patternIO.header);
+    size_t written = file.write((const uint8_t*)&patternIO, size);
+    file.close();
+
+    if (written != size) {
+        DEBUG_PRINTF("Sequencer: Short write on %s\n", path);
+        SD.remove(path);
+        return false;
+    }
+    return true;
+}
+
+void Sequencer::copyPattern(int from, int to) {
+    if (from < 0 || from >= MAX_PATTERNS || to < 0 || to >= MAX_PATTERNS) return;
+    if (from == to) return;
+
+    DEBUG_PRINTF("Sequencer: Copy pattern %d to %d\n", from, to);
+    commitLive();
+
+    fetchPattern(from, patternIO.pattern);
+    storePattern(to, patternIO.pattern);
+
+    // Overwrote the pattern on screen: show the copy
+    if (to == currentPatternNumber) loadPattern(to);
+}
+
+void Sequencer::clearPattern() {
+    __disable_irq();
+    patternClear(*pattern);
+    __enable_irq();
+
+    calculateStepInterval();
+    markEdited();
     DEBUG_PRINTLN("Sequencer: Pattern cleared");
 }
 
@@ -535,7 +1229,7 @@ int Sequencer::getCurrentPattern() {
 }
 
 uint8_t Sequencer::getPatternLength() {
-    return pattern.length;
+    return pattern->length;
 }
 
 // Fill mode
@@ -0,0 +1,155 @@
+/**
+ * Oh My Ondas - Smoothed Audio Objects Implementation
+ * Per-sample gain ramps for the amplifier and mixer
+ */
+
+#include "smoothed_audio.h"
+
+static inline int16_t clip16(int32_t v) {
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+// ============================================
+// GAIN RAMP
+// ============================================
+
+GainRamp::GainRamp()
+    : target(65536)
+    , mod(65536)
+    , snap(false)
+    , lastTarget(65536)
+    , current(65536)
+    , rampTarget(65536)
+    , acc(65536LL << 16)
+    , step(0)
+    , remaining(0)
+{
+    setSlew(GAIN_SLEW_MS);
+}
+
+int32_t GainRamp::toQ16(float gain) {
+    // Same range as the library's mixer
+    if (gain > 32767.0f) gain = 32767.0f;
+    if (gain < -32767.0f) gain = -32767.0f;
+    return (int32_t)(gain * 65536.0f);
+}
+
+void GainRamp::set(float gain) {
+    target = toQ16(gain);
+}
+
+void GainRamp::setNow(float gain) {
+    target = toQ16(gain);
+    snap = true;
+}
+
+void GainRamp::setMod(float factor) {
+    mod = toQ16(factor);
+}
+
+void GainRamp::setSlew(float ms) {
+    uint32_t n = (uint32_t)(ms * AUDIO_SAMPLE_RATE_EXACT / 1000.0f);
+    slewSamples = n ? n : 1;
+}
+
+bool GainRamp::beginBlock() {
+    int32_t set = target;
+    int32_t m = mod;
+    int32_t t = m == 65536 ? set : (int32_t)(((int64_t)set * m) >> 16);
+    if (snap) {
+        snap = false;
+        current = rampTarget = t;
+        lastTarget = set;
+        remaining = 0;
+    } else if (t != rampTarget) {
+        // A new set gain takes the slew time. Modulation alone takes one
+        // block, or what is left of a ramp to a set gain
+        if (set != lastTarget) remaining = slewSamples;
+        else if (remaining < AUDIO_BLOCK_SAMPLES) remaining = AUDIO_BLOCK_SAMPLES;
+        lastTarget = set;
+        rampTarget = t;
+        acc = (int64_t)current << 16;
+        step = (((int64_t)t - current) << 16) / (int64_t)remaining;
+    }
+    return remaining == 0;
+}
+
+// ============================================
+// AudioAmpSmooth
+// ============================================
+
+void AudioAmpSmooth::update(void) {
+    bool steady = ramp.beginBlock();
+    int32_t g = ramp.value();
+
+    if (steady && g == 0) {
+        audio_block_t* block = receiveReadOnly();
+        if (block) release(block);
+        return;
+    }
+    if (steady && g == 65536) {
+        audio_block_t* block = receiveReadOnly();
+        if (block) {
+            transmit(block);
+            release(block);
+        }
+        return;
+    }
+
+    audio_block_t* block = receiveWritable();
+    if (!block) {
+        ramp.skip(AUDIO_BLOCK_SAMPLES);     // Keep the ramp on time through silence
+        return;
+    }
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        g = ramp.next();
+        block->data[i] = clip16((int32_t)(((int64_t)block->data[i] * g) >> 16));
+    }
+    transmit(block);
+    release(block);
+}
+
+// ============================================
+// AudioMixer4Smooth
+// ============================================
+
+void AudioMixer4Smooth::update(void) {
+    int32_t sum[AUDIO_BLOCK_SAMPLES];
+    bool any = false;
+
+    for (int ch = 0; ch < 4; ch++) {
+        bool steady = ramp[ch].beginBlock();
+        audio_block_t* in = receiveReadOnly(ch);
+
+        if (!in || (steady && ramp[ch].value() == 0)) {
+            ramp[ch].skip(AUDIO_BLOCK_SAMPLES);
+            if (in) release(in);
+            continue;
+        }
+
+        const int16_t* src = in->data;
+        if (steady) {
+            int32_t g = ramp[ch].value();
+            for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+                int32_t v = (int32_t)(((int64_t)src[i] * g) >> 16);
+                sum[i] = any ? sum[i] + v : v;
+            }
+        } else {
+            for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+                int32_t v = (int32_t)(((int64_t)src[i] * ramp[ch].next()) >> 16);
+                sum[i] = any ? sum[i] + v : v;
+            }
+        }
+        any = true;
+        release(in);
+    }
+
+    if (!any) return;
+    audio_block_t* out = allocate();
+    if (!out) return;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) out->data[i] = clip16(sum[i]);
+    transmit(out);
+    release(out);
+}
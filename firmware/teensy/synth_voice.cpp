@@ -8,106 +8,121 @@
 SynthVoice::SynthVoice()
     : osc1(nullptr)
     , osc2(nullptr)
-    , noise(nullptr)
     , mixer(nullptr)
     , filter(nullptr)
     , envelope(nullptr)
     , baseFreq(440.0f)
     , osc2DetuneRatio(1.0f)
     , filterFreq(8000.0f)
-    , active(false)
-    , lfoRate(2.0f)
-    , lfoDepth(0.0f)
-    , lfoTarget(0)
-    , lfoPhase(0.0f)
-    , lastLFOUpdate(0)
+    , noiseLevel(0.0f)
+    , releaseMs(200.0f)
+    , velocity(0.0f)
+    , sounding(false)
+    , held(false)
+    , killed(false)
+    , pitchMod(0.0f)
+    , pitchRatio(1.0f)
 {
 }
 
-void SynthVoice::begin(AudioSynthWaveform* o1,
-                       AudioSynthWaveform* o2,
-                       AudioSynthNoiseWhite* n,
-                       AudioMixer4* mix,
-                       AudioFilterLadder* filt,
+void SynthVoice::begin(AudioSynthWavetableOsc* o1,
+                       AudioSynthWavetableOsc* o2,
+                       AudioMixer4Smooth* mix,
+                       LadderSmoother* filt,
                        AudioEffectEnvelope* env) {
     osc1 = o1;
     osc2 = o2;
-    noise = n;
     mixer = mix;
     filter = filt;
     envelope = env;
+}
 
-    DEBUG_PRINTLN("SynthVoice: Ready");
+void SynthVoice::modulatePitch(float semitones) {
+    if (semitones == pitchMod) return;
+    pitchMod = semitones;
+    pitchRatio = semitones == 0.0f ? 1.0f : exp2f(semitones / 12.0f);
+    if (sounding) setOscFrequencies();
 }
 
-void SynthVoice::update() {
-    if (!active) return;
-
-    unsigned long now = millis();
-    if (now - lastLFOUpdate < 10) return;
-
-    float dt = (now - lastLFOUpdate) / 1000.0f;
-    lfoPhase += lfoRate * dt;
-    if (lfoPhase >= 1.0f) lfoPhase -= 1.0f;
-    lastLFOUpdate = now;
-
-    if (lfoDepth <= 0.0f) return;
-
-    float lfoVal = sinf(lfoPhase * 2.0f * PI) * lfoDepth;
-
-    switch (lfoTarget) {
-        case 0: {
-            // Pitch modulation (vibrato)
-            float pitchMod = baseFreq * (1.0f + lfoVal * 0.05f);
-            if (osc1) osc1->frequency(pitchMod);
-            if (osc2) osc2->frequency(pitchMod * osc2DetuneRatio);
-            break;
-        }
-        case 1: {
-            // Filter modulation (wah)
-            float filterMod = filterFreq * (1.0f + lfoVal * 0.5f);
-            if (filter) filter->frequency(constrain(filterMod, 20.0f, 15000.0f));
-            break;
-        }
-        case 2: {
-            // Amplitude modulation (tremolo)
-            float ampMod = 0.5f + lfoVal * 0.5f;
-            if (mixer) mixer->gain(0, ampMod * 0.5f);
-            break;
-        }
-    }
+void SynthVoice::modulateCutoff(float octaves) {
+    if (filter) filter->modulate(octaves);
+}
+
+void SynthVoice::setOscFrequencies() {
+    float freq = baseFreq * pitchRatio;
+    if (osc1) osc1->frequency(freq);
+    if (osc2) osc2->frequency(freq * osc2DetuneRatio);
 }
 
-void SynthVoice::noteOn(float freq, float velocity) {
+void SynthVoice::noteOn(float freq, float vel) {
     baseFreq = freq;
+    velocity = vel;
 
-    if (osc1) {
-        osc1->frequency(freq);
-        osc1->amplitude(velocity);
-    }
-    if (osc2) {
-        osc2->frequency(freq * osc2DetuneRatio);
-        osc2->amplitude(velocity * 0.6f);
-    }
+    setOscFrequencies();
+    if (osc1) osc1->amplitude(vel);
+    if (osc2) osc2->amplitude(vel * 0.6f);
+    if (mixer) mixer->gainNow(2, noiseLevel);
     if (envelope) {
+        if (killed) envelope->release(releaseMs);
         envelope->noteOn();
     }
 
-    active = true;
-    lastLFOUpdate = millis();
-
-    DEBUG_PRINTF("SynthVoice: noteOn freq=%.1f vel=%.2f\n", freq, velocity);
+    killed = false;
+    held = true;
+    sounding = true;
 }
 
 void SynthVoice::noteOff() {
     if (envelope) {
         envelope->noteOff();
     }
+    held = false;
+}
+
+void SynthVoice::kill() {
+    if (!sounding) return;
+    if (envelope) {
+        envelope->release(SYNTH_STEAL_MS);
+        envelope->noteOff();
+    }
+    held = false;
+    killed = true;
+}
+
+void SynthVoice::setNoteParams(const SynthNoteParams& p) {
+    filterFreq = constrain(p.filterFreq, 20.0f, 15000.0f);
+    if (filter) {
+        filter->frequencyNow(filterFreq);
+        filter->resonanceNow(constrain(p.filterRes, 0.0f, 5.0f));
+    }
+    if (envelope) {
+        envelope->attack(p.attack);
+        envelope->decay(p.decay);
+        envelope->sustain(constrain(p.sustain, 0.0f, 1.0f));
+    }
+    setRelease(p.release);
+}
+
+void SynthVoice::update() {
+    if (filter) filter->update();
+    if (sounding && !held && envelope && !envelope->isActive()) park();
+}
+
+void SynthVoice::park() {
     if (osc1) osc1->amplitude(0.0);
     if (osc2) osc2->amplitude(0.0);
-    active = false;
+    if (mixer) mixer->gainNow(2, 0.0f);
+    sounding = false;
+}
 
-    DEBUG_PRINTLN("SynthVoice: noteOff");
+float SynthVoice::processorUsage() {
+    float usage = 0.0f;
+    if (osc1) usage += osc1->processorUsage();
+    if (osc2) usage += osc2->processorUsage();
+    if (mixer) usage += mixer->processorUsage();
+    if (filter && filter->getFilter()) usage += filter->getFilter()->processorUsage();
+    if (envelope) usage += envelope->processorUsage();
+    return usage;
 }
 
 void SynthVoice::setOsc1Waveform(int waveform) {
@@ -118,6 +133,14 @@ void SynthVoice::setOsc2Waveform(int waveform) {
     if (osc2) osc2->begin(waveform);
 }
 
+void SynthVoice::setOsc1Wavetable(const Wavetable* table) {
+    if (osc1) osc1->setWavetable(table);
+}
+
+void SynthVoice::setOsc1Morph(float position) {
+    if (osc1) osc1->morph(position);
+}
+
 void SynthVoice::setOsc1Level(float level) {
     if (mixer) mixer->gain(0, constrain(level, 0.0f, 1.0f));
 }
@@ -127,14 +150,14 @@ void SynthVoice::setOsc2Level(float level) {
 }
 
 void SynthVoice::setNoiseLevel(float level) {
-    if (noise) noise->amplitude(constrain(level, 0.0f, 1.0f));
-    if (mixer) mixer->gain(2, constrain(level, 0.0f, 1.0f));
+    noiseLevel = constrain(level, 0.0f, 1.0f);
+    if (mixer && sounding) mixer->gain(2, noiseLevel);
 }
 
 void SynthVoice::setOsc2Detune(float semitones) {
     osc2DetuneRatio = powf(2.0f, semitones / 12.0f);
-    if (osc2 && active) {
-        osc2->frequency(baseFreq * osc2DetuneRatio);
+    if (osc2 && sounding) {
+        osc2->frequency(baseFreq * pitchRatio * osc2DetuneRatio);
     }
 }
 
@@ -160,21 +183,6 @@ void SynthVoice::setSustain(float level) {
 }
 
 void SynthVoice::setRelease(float ms) {
-    if (envelope) envelope->release(ms);
-}
-
-void SynthVoice::setLFORate(float hz) {
-    lfoRate = constrain(hz, 0.01f, 20.0f);
-}
-
-void SynthVoice::setLFODepth(float depth) {
-    lfoDepth = constrain(depth, 0.0f, 1.0f);
-}
-
-void SynthVoice::setLFOTarget(int target) {
-    lfoTarget = constrain(target, 0, 2);
-}
-
-bool SynthVoice::isActive() {
-    return active;
+    releaseMs = ms;
+    if (envelope && !killed) envelope->release(ms);
 }
@@ -0,0 +1,140 @@
+/**
+ * Oh My Ondas - Task Scheduler Implementation
+ * Cooperative main-loop scheduler with priorities, deadlines and per-task timing
+ */
+
+#include "task_scheduler.h"
+
+TaskScheduler::TaskScheduler()
+    : count(0)
+    , worstPassUs(0)
+    , passes(0)
+{
+    memset(tasks, 0, sizeof(tasks));
+}
+
+int TaskScheduler::addEveryPass(const char* name, TaskFunction function) {
+    return add(name, function, 0, TASK_PRIO_HIGH, 0);
+}
+
+int TaskScheduler::addPeriodic(const char* name, TaskFunction function, uint32_t periodMs,
+                               TaskPriority priority, uint32_t deadlineMs) {
+    if (periodMs == 0) periodMs = 1;
+    return add(name, function, periodMs * 1000UL, priority,
+               (deadlineMs ? deadlineMs : periodMs) * 1000UL);
+}
+
+int TaskScheduler::add(const char* name, TaskFunction function, uint32_t periodUs,
+                       TaskPriority priority, uint32_t deadlineUs) {
+    if (count >= MAX_TASKS || !function) {
+        DEBUG_PRINTF("TaskScheduler: Cannot add %s\n", name);
+        return -1;
+    }
+    Task& t = tasks[count];
+    memset(&t, 0, sizeof(t));
+    t.name = name;
+    t.function = function;
+    t.periodUs = periodUs;
+    t.deadlineUs = deadlineUs;
+    t.priority = priority;
+    t.release = micros();       // First release: the next pass
+    return count++;
+}
+
+// ============================================
+// DISPATCH
+// ============================================
+
+void TaskScheduler::run() {
+    uint32_t passStart = micros();
+
+    for (int i = 0; i < count; i++) {
+        if (tasks[i].periodUs == 0) runSlice(tasks[i]);
+    }
+
+    int next = pickReady(micros());
+    if (next >= 0) runSlice(tasks[next]);
+
+    uint32_t passUs = micros() - passStart;
+    if (passUs > worstPassUs) worstPassUs = passUs;
+    passes++;
+}
+
+int TaskScheduler::pickReady(uint32_t now) {
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        const Task& t = tasks[i];
+        if (t.periodUs == 0) continue;
+        if (!t.inJob && (int32_t)(now - t.release) < 0) continue;
+
+        if (best < 0 || t.priority < tasks[best].priority ||
+            (t.priority == tasks[best].priority &&
+             (int32_t)(t.release - tasks[best].release) < 0)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void TaskScheduler::runSlice(Task& t) {
+    uint32_t start = micros();
+    bool done = t.function();
+    uint32_t end = micros();
+    uint32_t elapsed = end - start;
+
+    TaskStats& s = t.stats;
+    s.slices++;
+    s.totalUs += elapsed;
+    if (elapsed > s.worstSliceUs) s.worstSliceUs = elapsed;
+    t.jobUs += elapsed;
+
+    if (!done) {
+        t.inJob = true;
+        return;
+    }
+
+    s.jobs++;
+    if (t.jobUs > s.worstJobUs) s.worstJobUs = t.jobUs;
+    t.jobUs = 0;
+    t.inJob = false;
+    if (t.periodUs == 0) return;
+
+    uint32_t response = end - t.release;
+    if (response > s.worstResponseUs) s.worstResponseUs = response;
+    if (t.deadlineUs && response > t.deadlineUs) s.deadlineMisses++;
+
+    // Keep the phase; a task a whole period behind skips rather than
+    // running back to back to catch up
+    t.release += t.periodUs;
+    if ((int32_t)(end - t.release) >= (int32_t)t.periodUs) {
+        t.release = end + t.periodUs;
+        s.skipped++;
+    }
+}
+
+// ============================================
+// STATISTICS
+// ============================================
+
+void TaskScheduler::resetStats() {
+    for (int i = 0; i < count; i++) {
+        memset(&tasks[i].stats, 0, sizeof(TaskStats));
+    }
+    worstPassUs = 0;
+    passes = 0;
+}
+
+void TaskScheduler::printStats(Print& out) {
+    out.println("task,name,period_ms,jobs,avg_us,worst_us,worst_slice_us,worst_response_us,"
+                "deadline_misses,skipped");
+    for (int i = 0; i < count; i++) {
+        const Task& t = tasks[i];
+        const TaskStats& s = t.stats;
+        out.printf("task,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", t.name,
+                   (unsigned long)(t.periodUs / 1000), (unsigned long)s.jobs,
+                   (unsigned long)s.averageJobUs(), (unsigned long)s.worstJobUs,
+                   (unsigned long)s.worstSliceUs, (unsigned long)s.worstResponseUs,
+                   (unsigned long)s.deadlineMisses, (unsigned long)s.skipped);
+    }
+    out.printf("task,pass,0,%lu,,%lu,,,,\n", (unsigned long)passes, (unsigned long)worstPassUs);
+}
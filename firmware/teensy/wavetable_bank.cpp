@@ -0,0 +1,147 @@
+/**
+ * Oh My Ondas - Wavetable Bank Implementation
+ * User wavetables loaded from SD into PSRAM for the synth oscillators
+ */
+
+#include "wavetable_bank.h"
+#include "sample_cache.h"
+
+static const uint32_t FRAME_BYTES = WT_FRAME_POINTS * sizeof(int16_t);
+
+// Load-time work space: one cycle's samples and harmonics, and the FFT
+struct WtLoadScratch {
+    int16_t pcm[WT_TABLE_SIZE * 2];     // Room for a stereo cycle
+    float a[WT_TABLE_SIZE / 2];
+    float b[WT_TABLE_SIZE / 2];
+    WtScratch<float> fft;
+};
+
+WavetableBank::WavetableBank()
+    : bytesUsed(0)
+{
+    for (int i = 0; i < WAVETABLE_SLOTS; i++) {
+        tables[i].data = nullptr;
+        tables[i].frames = 0;
+    }
+}
+
+int WavetableBank::begin() {
+    int loaded = 0;
+    for (int i = 0; i < WAVETABLE_SLOTS; i++) {
+        char path[32];
+        slotPath(i, path, sizeof(path));
+        if (SD.exists(path) && load(i, path)) loaded++;
+    }
+
+    DEBUG_PRINTF("WavetableBank: %d tables, %lu KB\n", loaded,
+                 (unsigned long)(bytesUsed / 1024));
+    return loaded;
+}
+
+void WavetableBank::slotPath(int slot, char* path, size_t size) {
+    snprintf(path, size, "/wavetables/wt%02d.wav", slot);
+}
+
+bool WavetableBank::load(int slot, const char* path) {
+    if (slot < 0 || slot >= WAVETABLE_SLOTS) return false;
+
+    File file = SD.open(path);
+    if (!file) return false;
+
+    WavInfo info;
+    if (!SampleCache::readWavInfo(file, info) || info.bitsPerSample != 16 ||
+        info.channels == 0 || info.channels > 2) {
+        DEBUG_PRINTF("WavetableBank: %s is not 16-bit mono/stereo PCM\n", path);
+        file.close();
+        return false;
+    }
+
+    int frames = info.frames / WT_TABLE_SIZE;
+    if (frames > WAVETABLE_MAX_FRAMES) frames = WAVETABLE_MAX_FRAMES;
+    uint32_t bytes = frames * FRAME_BYTES;
+    uint32_t freed = tables[slot].frames * FRAME_BYTES;
+    if (frames == 0 || bytesUsed - freed + bytes > WAVETABLE_PSRAM_BUDGET) {
+        DEBUG_PRINTF("WavetableBank: %s: %d frames do not fit\n", path, frames);
+        file.close();
+        return false;
+    }
+
+    int16_t* data = (int16_t*)extmem_malloc(bytes);
+    if (!data) {
+        file.close();
+        return false;
+    }
+    bool ok = buildFrames(file, info.dataOffset, info.channels, frames, data);
+    file.close();
+    if (!ok) {
+        extmem_free(data);
+        return false;
+    }
+
+    // Oscillators read data and frames at the start of a block
+    int16_t* old = (int16_t*)tables[slot].data;
+    __disable_irq();
+    tables[slot].data = data;
+    tables[slot].frames = frames;
+    __enable_irq();
+    extmem_free(old);
+    bytesUsed += bytes - freed;
+
+    DEBUG_PRINTF("WavetableBank: %s -> slot %d, %d frames\n", path, slot, frames);
+    return true;
+}
+
+void WavetableBank::unload(int slot) {
+    if (slot < 0 || slot >= WAVETABLE_SLOTS || !tables[slot].data) return;
+
+    int16_t* old = (int16_t*)tables[slot].data;
+    bytesUsed -= tables[slot].frames * FRAME_BYTES;
+    __disable_irq();
+    tables[slot].data = nullptr;
+    tables[slot].frames = 0;
+    __enable_irq();
+    extmem_free(old);
+}
+
+const Wavetable* WavetableBank::get(int slot) const {
+    if (slot < 0 || slot >= WAVETABLE_SLOTS || !tables[slot].data) return nullptr;
+    return &tables[slot];
+}
+
+int WavetableBank::getFrames(int slot) const {
+    if (slot < 0 || slot >= WAVETABLE_SLOTS) return 0;
+    return tables[slot].frames;
+}
+
+bool WavetableBank::buildFrames(File& file, uint32_t dataOffset, uint16_t channels,
+                                int frames, int16_t* dest) {
+    // ~50 KB: too much for the stack, only needed while loading
+    WtLoadScratch* s = (WtLoadScratch*)malloc(sizeof(WtLoadScratch));
+    if (!s) return false;
+
+    bool ok = file.seek(dataOffset);
+    const uint32_t cycleBytes = WT_TABLE_SIZE * channels * sizeof(int16_t);
+    for (int f = 0; ok && f < frames; f++) {
+        if (file.read(s->pcm, cycleBytes) != (int)cycleBytes) {
+            ok = false;
+            break;
+        }
+
+        // Harmonics: X[k] = N/2·(a[k] - i·b[k])
+        for (int i = 0; i < WT_TABLE_SIZE; i++) {
+            s->fft.re[i] = s->pcm[i * channels];
+            s->fft.im[i] = 0.0f;
+        }
+        wtFft(s->fft.re, s->fft.im, WT_TABLE_BITS, false);
+        const float norm = 2.0f / WT_TABLE_SIZE;
+        for (int k = 0; k < WT_TABLE_SIZE / 2; k++) {
+            s->a[k] = s->fft.re[k] * norm;
+            s->b[k] = -s->fft.im[k] * norm;
+        }
+
+        wtBuildFrame(s->a, s->b, s->fft, dest + f * WT_FRAME_POINTS);
+    }
+
+    free(s);
+    return ok;
+}
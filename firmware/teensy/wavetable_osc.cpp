@@ -0,0 +1,134 @@
+/**
+ * Oh My Ondas - Wavetable Oscillator Implementation
+ * Band-limited wavetable oscillator with morphing, for the synth voices
+ */
+
+#include "wavetable_osc.h"
+#include <Audio.h>
+
+AudioSynthWavetableOsc::AudioSynthWavetableOsc()
+    : AudioStream(0, NULL)
+    , table(&wavetableBasic)
+    , phase(0)
+    , increment(0)
+    , level(0)
+    , magnitude(0)
+    , morphTarget(WT_SHAPE_SAW << 16)
+    , morphPos(WT_SHAPE_SAW << 16)
+{
+}
+
+void AudioSynthWavetableOsc::begin(short type) {
+    WtShape shape;
+    switch (type) {
+        case WAVEFORM_SINE:     shape = WT_SHAPE_SINE;      break;
+        case WAVEFORM_TRIANGLE: shape = WT_SHAPE_TRIANGLE;  break;
+        case WAVEFORM_SQUARE:   shape = WT_SHAPE_SQUARE;    break;
+        default:                shape = WT_SHAPE_SAW;       break;
+    }
+    setWavetable(&wavetableBasic);
+    morph(shape);
+}
+
+void AudioSynthWavetableOsc::begin(float amp, float freq, short type) {
+    amplitude(amp);
+    frequency(freq);
+    begin(type);
+}
+
+void AudioSynthWavetableOsc::frequency(float freq) {
+    if (freq < 0.0f) freq = 0.0f;
+    if (freq > AUDIO_SAMPLE_RATE_EXACT / 2.0f) freq = AUDIO_SAMPLE_RATE_EXACT / 2.0f;
+    uint32_t inc = (uint32_t)(freq * (4294967296.0f / AUDIO_SAMPLE_RATE_EXACT));
+    uint8_t l = levelFor(freq);
+    __disable_irq();
+    increment = inc;
+    level = l;
+    __enable_irq();
+}
+
+void AudioSynthWavetableOsc::amplitude(float n) {
+    magnitude = (int32_t)(constrain(n, 0.0f, 1.0f) * 65536.0f);
+}
+
+void AudioSynthWavetableOsc::setWavetable(const Wavetable* t) {
+    table = t;
+}
+
+void AudioSynthWavetableOsc::morph(float position) {
+    if (position < 0.0f) position = 0.0f;
+    morphTarget = (int32_t)(position * 65536.0f);
+}
+
+// Lowest level whose top fundamental is at or above freq
+uint8_t AudioSynthWavetableOsc::levelFor(float freq) {
+    float top = WT_BASE_HZ;
+    uint8_t l = 0;
+    while (l < WT_LEVELS - 1 && freq > top) {
+        top *= 2.0f;
+        l++;
+    }
+    return l;
+}
+
+void AudioSynthWavetableOsc::update(void) {
+    const Wavetable* t = table;
+    uint32_t inc = increment;
+    int32_t mag = magnitude;
+    if (!t || !t->data || !t->frames || mag == 0) {
+        phase += inc * AUDIO_BLOCK_SAMPLES;
+        return;
+    }
+
+    audio_block_t* block = allocate();
+    if (!block) {
+        phase += inc * AUDIO_BLOCK_SAMPLES;
+        return;
+    }
+
+    // Frame position, ramped from where the last block left it
+    int32_t last = (int32_t)(t->frames - 1) << 16;
+    int32_t target = morphTarget;
+    if (target > last) target = last;
+    int32_t pos = morphPos > last ? last : morphPos;
+    int32_t step = (target - pos) / AUDIO_BLOCK_SAMPLES;
+
+    const int bits = wtLevelBits(level);
+    const int16_t* base = t->data + wtLevelOffset(level);
+    uint32_t p = phase;
+
+    if (step == 0 && (target & 0xFFFF) == 0) {
+        // On one frame: one read per sample
+        const int16_t* a = base + (target >> 16) * WT_FRAME_POINTS;
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+            uint32_t idx = p >> (32 - bits);
+            int32_t frac = (int32_t)((p >> (17 - bits)) & 0x7FFF);
+            int32_t s = a[idx] + (((a[idx + 1] - a[idx]) * frac + 0x4000) >> 15);
+            block->data[i] = (int16_t)((s * mag) >> 16);
+            p += inc;
+        }
+    } else {
+        // Between frames: read both neighbours and crossfade
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+            int32_t at = i == AUDIO_BLOCK_SAMPLES - 1 ? target : pos;
+            int32_t frame = at >> 16;
+            int32_t mix = (at >> 1) & 0x7FFF;
+            const int16_t* a = base + frame * WT_FRAME_POINTS;
+            const int16_t* b = frame < (int32_t)t->frames - 1 ? a + WT_FRAME_POINTS : a;
+
+            uint32_t idx = p >> (32 - bits);
+            int32_t frac = (int32_t)((p >> (17 - bits)) & 0x7FFF);
+            int32_t sa = a[idx] + (((a[idx + 1] - a[idx]) * frac + 0x4000) >> 15);
+            int32_t sb = b[idx] + (((b[idx + 1] - b[idx]) * frac + 0x4000) >> 15);
+            int32_t s = sa + (((sb - sa) * mix + 0x4000) >> 15);
+            block->data[i] = (int16_t)((s * mag) >> 16);
+            p += inc;
+            pos += step;
+        }
+    }
+
+    phase = p;
+    morphPos = target;
+    transmit(block);
+    release(block);
+}
@@ -0,0 +1,31 @@
+/**
+ * Oh My Ondas - Wavetables
+ * The built-in frames, computed at compile time (see wavetables.h)
+ */
+
+#include <Arduino.h>
+#include "wavetables.h"
+
+// PROGMEM: the Teensy 4 otherwise copies const data into RAM1 at boot
+constexpr WtFrame wtBasicFrames[WT_SHAPE_COUNT] PROGMEM = {
+    wtMakeFrame(WT_SHAPE_SINE),
+    wtMakeFrame(WT_SHAPE_TRIANGLE),
+    wtMakeFrame(WT_SHAPE_SAW),
+    wtMakeFrame(WT_SHAPE_SQUARE),
+};
+
+const Wavetable wavetableBasic = { wtBasicFrames[0].v, WT_SHAPE_COUNT };
+
+// Fail the build rather than ship a wrong table. The sine peaks at a
+// quarter cycle on every level. A frame is scaled to its loudest level:
+// level 0's overshoot for the saw, the top level's fundamental alone (4/π)
+// for the square
+static_assert(wtBasicFrames[WT_SHAPE_SINE].v[WT_TABLE_SIZE / 4] == 32767 &&
+              wtBasicFrames[WT_SHAPE_SINE].v[0] == 0, "sine frame");
+static_assert(wtBasicFrames[WT_SHAPE_SINE].v[wtLevelOffset(WT_LEVELS - 1) +
+                                             (1 << wtLevelBits(WT_LEVELS - 1)) / 4] == 32767,
+              "sine frame, top level");
+static_assert(wtBasicFrames[WT_SHAPE_SAW].v[0] == 0 &&
+              wtBasicFrames[WT_SHAPE_SAW].v[WT_TABLE_SIZE / 4] > 12000 &&
+              wtBasicFrames[WT_SHAPE_SAW].v[WT_TABLE_SIZE / 4] < 16000, "saw frame");
+static_assert(wtBasicFrames[WT_SHAPE_SQUARE].v[WT_TABLE_SIZE / 4] > 24000, "square frame");
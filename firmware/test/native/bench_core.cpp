@@ -0,0 +1,220 @@
+/**
+ * Oh My Ondas - Core Host Benchmarks
+ *
+ * Runs on the development machine, not the Teensy, against the host HAL
+ * (native/). Times the firmware's own code paths, in the style of Google
+ * Benchmark: each case runs with a growing iteration count until it has
+ * taken at least the minimum time, then reports wall time per operation.
+ *
+ *   StepEvaluation     one audio block of sequencer clock (processAudioBlock)
+ *                      plus the loop() dispatch of its triggers, on a busy
+ *                      pattern: every step on, two locks each, ratchets
+ *   PatternSwitch      loadPattern() from the in-RAM bank
+ *   PatternSaveSD      savePattern() into the bank and its writeback to SD
+ *   PatternLoadSD      reading, checking and staging all 64 .bin files
+ *   SceneMorph         one SceneManager::morphTo() interpolation
+ *
+ * Host numbers are for comparing changes to these paths against each
+ * other, not for the Teensy's budget; SD is the host filesystem (page
+ * cache), so the SD cases mostly measure the code around the I/O.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target bench_core
+ *   ./build/bench_core [--quick] [--filter=<substring>]
+ * or with PlatformIO:
+ *   pio run -e native -t exec
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <filesystem>
+#include "host_hal.h"
+#include "sequencer.h"
+#include "scene_manager.h"
+
+// ============================================
+// HARNESS
+// ============================================
+
+typedef void (*BenchFn)(uint64_t iterations);
+
+struct Benchmark {
+    const char* name;
+    BenchFn run;
+    int itemsPerOp;         // >1: also report time per item
+    const char* item;
+};
+
+static double minSeconds = 0.5;
+static volatile float sink;
+
+static void runBenchmark(const Benchmark& b) {
+    uint64_t n = 1;
+    double elapsed = 0.0;
+
+    while (true) {
+        auto t0 = std::chrono::steady_clock::now();
+        b.run(n);
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (elapsed >= minSeconds || n >= 1000000000ULL) break;
+
+        // Aim past the minimum, growing at most 10x per round
+        double grow = elapsed > 0.0 ? 1.4 * minSeconds / elapsed : 10.0;
+        if (grow < 2.0) grow = 2.0;
+        if (grow > 10.0) grow = 10.0;
+        n = (uint64_t)(n * grow);
+    }
+
+    double ns = elapsed * 1e9 / n;
+    printf("%-24s %12.1f ns %12llu", b.name, ns, (unsigned long long)n);
+    if (b.itemsPerOp > 1) printf("   %.1f ns/%s", ns / b.itemsPerOp, b.item);
+    printf("\n");
+}
+
+// ============================================
+// FIXTURES
+// ============================================
+
+static Sequencer seq;
+static SceneManager scenes;
+static uint32_t blockStart = 0;
+static uint64_t blocks = 0;
+static uint64_t triggers = 0;
+
+// Same shape of work as onSequencerTrigger(): visit the step's locks
+static void onTrigger(int track, int step, const Step& stepData,
+                      StepLocks locks, uint32_t sampleTime) {
+    (void)track; (void)step; (void)sampleTime;
+    float acc = stepData.velocity;
+    for (int p = 0; p < PARAM_COUNT; p++) {
+        if (locks.has((ParamType)p)) acc += locks.get((ParamType)p);
+    }
+    sink = acc;
+    triggers++;
+}
+
+static void buildBusyPattern() {
+    seq.clearPattern();
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        for (int s = 0; s < 16; s++) {
+            seq.setStep(t, s, true);
+            seq.setParamLock(t, s, PARAM_FILTER_FREQ, 400.0f + 100.0f * s);
+            seq.setParamLock(t, s, PARAM_VOLUME, 0.5f + 0.03f * t);
+            if (s % 4 == 3) seq.setRatchet(t, s, 2, 25);
+            if (s % 2) seq.setMicroTiming(t, s, (t % 3) - 1);
+        }
+    }
+}
+
+// Write the whole bank back so every pattern has a file
+static void drainWriteback() {
+    for (int i = 0; i <= MAX_PATTERNS && seq.getDirtyPatternCount() > 0; i++) {
+        hostClockAdvance((PATTERN_WRITEBACK_DELAY_MS + 1) * 1000UL);
+        seq.update();
+    }
+}
+
+// ============================================
+// BENCHMARKS
+// ============================================
+
+static void benchStepEvaluation(uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+        seq.processAudioBlock(blockStart, AUDIO_BLOCK_SAMPLES);
+        blockStart += AUDIO_BLOCK_SAMPLES;
+        seq.update();
+    }
+    blocks += n;
+}
+
+static void benchPatternSwitch(uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+        seq.loadPattern((int)(i & 7));
+    }
+}
+
+static void benchPatternSaveSD(uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+        seq.savePattern((int)(i % MAX_PATTERNS));
+        hostClockAdvance((PATTERN_WRITEBACK_DELAY_MS + 1) * 1000UL);
+        seq.update();
+    }
+}
+
+static void benchPatternLoadSD(uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+        // Every .bin is valid, so this only reads and checks them
+        sink = (float)seq.convertJSONPatterns();
+    }
+}
+
+static void benchSceneMorph(uint64_t n) {
+    Scene result;
+    for (uint64_t i = 0; i < n; i++) {
+        scenes.morphTo(1, (i & 1023) / 1023.0f, result);
+        sink = result.trackVolumes[i & (MAX_TRACKS - 1)];
+    }
+}
+
+static const Benchmark benchmarks[] = {
+    { "StepEvaluation",  benchStepEvaluation,  1,           nullptr   },
+    { "PatternSwitch",   benchPatternSwitch,   1,           nullptr   },
+    { "PatternSaveSD",   benchPatternSaveSD,   1,           nullptr   },
+    { "PatternLoadSD",   benchPatternLoadSD,   MAX_PATTERNS, "pattern" },
+    { "SceneMorph",      benchSceneMorph,      1,           nullptr   },
+};
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) minSeconds = 0.02;
+        else if (strncmp(argv[i], "--filter=", 9) == 0) filter = argv[i] + 9;
+    }
+
+    char dir[] = "/tmp/omo_bench_XXXXXX";
+    if (!mkdtemp(dir) || !hostSdMount(dir)) {
+        printf("Cannot create a temporary SD directory\n");
+        return 1;
+    }
+    hostSerialEcho(false);
+    SD.begin(BUILTIN_SDCARD);
+    SD.mkdir(PATTERNS_DIR);
+
+    seq.begin(120.0f);
+    seq.setTriggerCallback(onTrigger);
+    buildBusyPattern();
+    for (int n = 0; n < MAX_PATTERNS; n++) seq.savePattern(n);
+    drainWriteback();
+
+    seq.setClockSource(CLOCK_AUDIO);
+    seq.start();
+
+    Scene a, b;
+    b.masterVolume = 0.3f;
+    b.bpm = 96.0f;
+    b.fxMix = 0.7f;
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        b.trackVolumes[t] = 0.1f * t;
+        b.trackMutes[t] = (t & 1);
+    }
+    scenes.saveScene(0, a);
+    scenes.saveScene(1, b);
+    scenes.recallScene(0, a);
+
+    printf("Core host benchmarks (%s)\n", minSeconds < 0.1 ? "quick" : "full");
+    printf("%-24s %15s %12s\n", "Benchmark", "Time/op", "Iterations");
+    printf("----------------------------------------------------------\n");
+
+    for (const Benchmark& b : benchmarks) {
+        if (filter && !strstr(b.name, filter)) continue;
+        runBenchmark(b);
+        if (b.run == benchStepEvaluation) {
+            printf("%-24s %12.2f triggers/block\n", "", (double)triggers / blocks);
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    return seq.getDroppedEvents() == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/**
+ * Oh My Ondas - LFO Table Host Benchmark
+ *
+ * Runs on the development machine, not the Teensy. Sweeps the phase over
+ * 2^22 evenly spaced points and reports the largest error of each shared
+ * LFO table (lfo_tables.h) against the exact waveform, computed in
+ * double. Exits non-zero if the sine is outside LFO_SINE_MAX_ERROR or
+ * the triangle or saw is off by more than one Q15 step. Then times a
+ * table read against sinf(phase * 2π), the call the modulators used to
+ * make, stepping an LfoPhase as they do. Time and cycles are per read
+ * (cycles from the TSC on x86). Host cycles only rank the two. The
+ * Cortex-M7 has no sinf in hardware, so there the gap is wider.
+ *
+ * Build & run:
+ *   g++ -std=c++17 -O2 -I../../teensy/include bench_lfo_tables.cpp \
+ *       ../../teensy/lfo_tables.cpp -o bench_lfo_tables && ./bench_lfo_tables
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <chrono>
+#include "lfo_tables.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+static const int SWEEP_BITS = 22;
+static const int READS = 20000000;
+static volatile float sink;
+
+static double exactSine(uint32_t phase) {
+    return sin(phase * (2.0 * M_PI / 4294967296.0));
+}
+
+static double exactTriangle(uint32_t phase) {
+    double t = phase / 4294967296.0;
+    if (t < 0.25) return 4.0 * t;
+    if (t < 0.75) return 2.0 - 4.0 * t;
+    return 4.0 * t - 4.0;
+}
+
+static double exactSaw(uint32_t phase) {
+    return 2.0 * (phase / 4294967296.0) - 1.0;
+}
+
+static double worstError(const LfoTable& table, double (*exact)(uint32_t)) {
+    double worst = 0.0;
+    for (uint32_t i = 0; i < (1u << SWEEP_BITS); i++) {
+        uint32_t phase = i << (32 - SWEEP_BITS);
+        double e = fabs(lfoRead(table, phase) - exact(phase));
+        if (e > worst) worst = e;
+    }
+    return worst;
+}
+
+static double worstSinfError() {
+    double worst = 0.0;
+    for (uint32_t i = 0; i < (1u << SWEEP_BITS); i++) {
+        uint32_t phase = i << (32 - SWEEP_BITS);
+        float turn = phase * (1.0f / 4294967296.0f);
+        double e = fabs(sinf(turn * 2.0f * (float)M_PI) - exactSine(phase));
+        if (e > worst) worst = e;
+    }
+    return worst;
+}
+
+template <class Read>
+static void timeReads(const char* name, Read read) {
+    LfoPhase lfo;
+    lfo.setFrequency(3.7f, 44117.6f);
+    float acc = 0.0f;
+
+    uint64_t c0 = 0, c1 = 0;
+    auto t0 = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+    c0 = __rdtsc();
+#endif
+    for (int i = 0; i < READS; i++) {
+        lfo.advance(128);
+        acc += read(lfo.phase);
+    }
+#ifdef HAVE_TSC
+    c1 = __rdtsc();
+#endif
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    sink = acc;
+
+    printf("%-24s %7.2f ns/read", name, s * 1e9 / READS);
+#ifdef HAVE_TSC
+    printf(" %7.1f cycles/read", (double)(c1 - c0) / READS);
+#endif
+    printf("\n");
+}
+
+int main() {
+    printf("LFO tables: %d points, Q15\n", LFO_TABLE_SIZE);
+
+    double sine = worstError(lfoSineTable, exactSine);
+    double tri = worstError(lfoTriangleTable, exactTriangle);
+    double saw = worstError(lfoSawTable, exactSaw);
+    double ref = worstSinfError();
+    const double q15 = 1.0 / 32767.0 + 1e-9;     // One step, and float rounding of the read
+
+    printf("Largest error over 2^%d phases\n", SWEEP_BITS);
+    printf("  sine table  %.2e (%.1f dB)   bound %.0e\n", sine, 20.0 * log10(sine), LFO_SINE_MAX_ERROR);
+    printf("  triangle    %.2e\n", tri);
+    printf("  saw         %.2e\n", saw);
+    printf("  sinf()      %.2e (reference)\n", ref);
+
+    bool ok = sine <= LFO_SINE_MAX_ERROR && tri <= q15 && saw <= q15;
+
+    printf("Read cost, %d reads\n", READS);
+    timeReads("sinf(phase * 2pi)", [](uint32_t phase) {
+        return sinf(phase * (1.0f / 4294967296.0f) * 2.0f * (float)M_PI);
+    });
+    timeReads("lfoRead(sine)", [](uint32_t phase) { return lfoRead(lfoSineTable, phase); });
+    timeReads("lfoRead(triangle)", [](uint32_t phase) { return lfoRead(lfoTriangleTable, phase); });
+
+    if (!ok) printf("FAIL: table outside its documented bound\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/**
+ * Oh My Ondas - Modulation Matrix Host Benchmark
+ *
+ * Runs on the development machine, not the Teensy, against the host HAL
+ * (native/). Times ModMatrix::process(), the once-per-block evaluation
+ * that onAudioBlock() runs, with no routes, 4 routes and the full 16
+ * (every LFO shape, both envelope followers, FX, synth and track level
+ * destinations), and reports time and cycles per block (cycles from the
+ * TSC on x86). It also times the eight track amps with their levels held
+ * and with every one modulated. A modulated level ramps sample by sample,
+ * so it costs more in the amps than in the matrix. Host cycles only rank
+ * the cases. Check the absolute budget on hardware with the audio
+ * profiler.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target bench_mod_matrix
+ *   ./build/bench_mod_matrix
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include "host_hal.h"
+#include <Audio.h>
+#include "mod_matrix.h"
+#include "smoothed_audio.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+static const int BLOCKS = 200000;
+static volatile float sink;
+
+// Constant output, the amps' input
+class DcSource : public AudioStream {
+public:
+    DcSource() : AudioStream(0, nullptr) {}
+
+    virtual void update(void) {
+        audio_block_t* block = allocate();
+        if (!block) return;
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) block->data[i] = 12000;
+        transmit(block);
+        release(block);
+    }
+};
+
+static AudioAnalyzeEnvelope envelopes[MOD_ENV_COUNT];
+static DcSource dc;
+static AudioAmpSmooth amps[MAX_TRACKS];
+static AudioConnection* cords[MAX_TRACKS];
+
+static void report(const char* name, double seconds, uint64_t cycles, int blocks) {
+    double ns = seconds * 1e9 / blocks;
+    const double blockNs = AUDIO_BLOCK_SAMPLES * 1e9 / AUDIO_SAMPLE_RATE_EXACT;
+    printf("%-28s %9.1f ns/block", name, ns);
+#ifdef HAVE_TSC
+    printf(" %9.0f cycles/block", (double)cycles / blocks);
+#else
+    (void)cycles;
+#endif
+    printf("  (%.4f%% of a block period on this host)\n", 100.0 * ns / blockNs);
+}
+
+// Routes 0..count-1 of a fixed 16-route table
+static void setRoutes(ModMatrix& m, int count) {
+    static const struct { int src; int dst; float depth; } table[MOD_MAX_ROUTES] = {
+        { MOD_SRC_LFO1,     MOD_DST_SYNTH_CUTOFF,    0.5f },
+        { MOD_SRC_LFO1 + 1, MOD_DST_SYNTH_PITCH,     0.05f },
+        { MOD_SRC_LFO1 + 2, MOD_DST_FX_PARAM1,       0.4f },
+        { MOD_SRC_ENV1,     MOD_DST_TRACK_LEVEL,     0.8f },
+        { MOD_SRC_LFO1 + 3, MOD_DST_FX_MIX,          0.3f },
+        { MOD_SRC_ENV1 + 1, MOD_DST_SYNTH_LEVEL,     0.6f },
+        { MOD_SRC_LFO1,     MOD_DST_FX_PARAM2,      -0.2f },
+        { MOD_SRC_LFO1 + 1, MOD_DST_FX_PARAM3,       0.2f },
+        { MOD_SRC_LFO1 + 2, MOD_DST_TRACK_LEVEL + 1, 0.5f },
+        { MOD_SRC_LFO1 + 3, MOD_DST_TRACK_LEVEL + 2, -0.5f },
+        { MOD_SRC_ENV1,     MOD_DST_TRACK_LEVEL + 3, 0.7f },
+        { MOD_SRC_ENV1 + 1, MOD_DST_TRACK_LEVEL + 4, 0.7f },
+        { MOD_SRC_LFO1,     MOD_DST_TRACK_LEVEL + 5, 0.3f },
+        { MOD_SRC_LFO1 + 1, MOD_DST_TRACK_LEVEL + 6, 0.3f },
+        { MOD_SRC_LFO1 + 2, MOD_DST_TRACK_LEVEL + 7, 0.3f },
+        { MOD_SRC_ENV1,     MOD_DST_SYNTH_CUTOFF,    0.25f },
+    };
+    m.clearRoutes();
+    for (int i = 0; i < count; i++) {
+        m.setRoute(i, (ModSource)table[i].src, (ModDest)table[i].dst, table[i].depth);
+    }
+}
+
+static void benchMatrix(int routes) {
+    ModMatrix m;
+    m.begin(envelopes);
+    const LfoShape shapes[] = { LFO_SINE, LFO_TRIANGLE, LFO_SAMPLE_HOLD, LFO_SAW };
+    for (int i = 0; i < MOD_LFO_COUNT; i++) {
+        m.setLFOShape(i, shapes[i % 4]);
+        m.setLFORate(i, 0.5f + 3.0f * i);
+    }
+    setRoutes(m, routes);
+
+    uint64_t c0 = 0, c1 = 0;
+    auto t0 = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+    c0 = __rdtsc();
+#endif
+    float acc = 0.0f;
+    for (int b = 0; b < BLOCKS; b++) {
+        m.process(AUDIO_BLOCK_SAMPLES);
+        acc += m.value(MOD_DST_SYNTH_CUTOFF);
+    }
+#ifdef HAVE_TSC
+    c1 = __rdtsc();
+#endif
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    sink = acc;
+
+    char name[48];
+    snprintf(name, sizeof(name), "process(), %d routes", routes);
+    report(name, s, c1 - c0, BLOCKS);
+}
+
+static void benchAmps(bool modulated) {
+    ModMatrix m;
+    m.setLFORate(0, 5.0f);
+    m.clearRoutes();
+    for (int i = 0; i < MAX_TRACKS; i++) {
+        amps[i].gainNow(0.8f);
+        amps[i].modulate(1.0f);
+        if (modulated) m.setRoute(i, MOD_SRC_LFO1, (ModDest)(MOD_DST_TRACK_LEVEL + i), 0.5f);
+    }
+    hostAudioUpdate();
+
+    const int blocks = BLOCKS / 10;
+    uint64_t c0 = 0, c1 = 0;
+    auto t0 = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+    c0 = __rdtsc();
+#endif
+    for (int b = 0; b < blocks; b++) {
+        m.process(AUDIO_BLOCK_SAMPLES);
+        for (int i = 0; i < MAX_TRACKS; i++) {
+            amps[i].modulate(m.value((ModDest)(MOD_DST_TRACK_LEVEL + i)));
+        }
+        hostAudioUpdate();
+    }
+#ifdef HAVE_TSC
+    c1 = __rdtsc();
+#endif
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    report(modulated ? "8 amps, levels modulated" : "8 amps, levels held", s, c1 - c0, blocks);
+}
+
+int main() {
+    printf("Modulation matrix host benchmark (%d blocks of %d samples)\n",
+           BLOCKS, AUDIO_BLOCK_SAMPLES);
+    hostSerialEcho(false);
+    AudioMemory(32);
+    for (int i = 0; i < MAX_TRACKS; i++) cords[i] = new AudioConnection(dc, amps[i]);
+
+    benchMatrix(0);
+    benchMatrix(4);
+    benchMatrix(MOD_MAX_ROUTES);
+
+    // DC source and the graph pass included in both
+    benchAmps(false);
+    benchAmps(true);
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * Oh My Ondas - Pattern Load Host Benchmark
+ *
+ * Runs on the development machine, not the Teensy. Compares loading a
+ * pattern from the binary format (pattern.h) against parsing the JSON
+ * format with ArduinoJson, from an in-memory copy of the file: it times
+ * the decode only (SD read time scales with the file sizes printed) and
+ * counts heap bytes requested during a load.
+ *
+ * The JSON half needs ArduinoJson 6 on the include path, e.g. the copy
+ * PlatformIO fetches for the teensy41 environment. Without it only the
+ * binary path is measured.
+ *
+ * Build & run:
+ *   g++ -std=c++17 -O2 -I../../teensy/include \
+ *       -I../../.pio/libdeps/teensy41/ArduinoJson/src \
+ *       bench_pattern_load.cpp ../../teensy/pattern.cpp \
+ *       -o bench_pattern_load && ./bench_pattern_load
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+#include "pattern.h"
+
+#if __has_include(<ArduinoJson.h>)
+#include "pattern_json.h"
+#define HAVE_ARDUINOJSON 1
+#endif
+
+static const int LOADS = 2000;
+
+// Heap accounting for ArduinoJson (same role as its default allocator)
+static size_t heapRequested = 0;
+
+struct CountingAllocator {
+    void* allocate(size_t n) { heapRequested += n; return malloc(n); }
+    void deallocate(void* p) { free(p); }
+    void* reallocate(void* p, size_t n) { heapRequested += n; return realloc(p, n); }
+};
+
+// Half the steps active, a few parameter locks, some nudged or ratcheted
+// steps, every other track 32 steps long: a typical busy pattern
+static void buildPattern(Pattern& p) {
+    patternClear(p);
+    p.swing = 25;
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        p.tracks[t].length = (t % 2) ? 2 * STEPS_PER_PAGE : STEPS_PER_PAGE;
+        for (int s = 0; s < p.tracks[t].length; s++) {
+            if ((s + t) % 2 != 0) continue;
+            Step& st = *patternStepForEdit(p, t, s);
+            st.active = true;
+            st.velocity = 64 + (s * 2);
+            st.pitchOffset = (int8_t)(s % 5) - 2;
+            st.microTiming = (int8_t)(s % 7) - 3;
+            if (s % 6 == 0) {
+                st.ratchets = 3;
+                st.ratchetDecay = 20;
+            }
+            if (s % 4 == 0) {
+                stepSetLock(p, t, s, PARAM_FILTER_FREQ, 500.0f + s * 250.0f);
+            }
+            if (s % 8 == 0) {
+                stepSetLock(p, t, s, PARAM_PAN, -0.5f);
+            }
+        }
+    }
+}
+
+// Same schema as Sequencer::exportPatternJSON()
+static std::string toJson(const Pattern& p) {
+    std::string out;
+    char buf[64];
+    snprintf(buf, sizeof(buf), "{\"length\":%d,\"swing\":%d,\"bpm\":%.2f,\"tracks\":[",
+             p.length, p.swing, p.bpm);
+    out += buf;
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        const Track& trk = p.tracks[t];
+        snprintf(buf, sizeof(buf), "%s{\"muted\":%s,\"src\":%d,\"vol\":%.2f,\"pan\":%.2f,",
+                 t > 0 ? "," : "", trk.muted ? "true" : "false", trk.sourceSlot,
+                 trk.volume, trk.pan);
+        out += buf;
+        snprintf(buf, sizeof(buf), "\"len\":%d,\"spd\":%d,\"steps\":[", trk.length, (int)trk.speed);
+        out += buf;
+        for (int s = 0; s < trk.length; s++) {
+            if (s > 0) out += ",";
+            const Step& st = patternStep(p, t, s);
+            if (!st.active) {
+                out += "0";
+                continue;
+            }
+            snprintf(buf, sizeof(buf), "{\"v\":%d,\"c\":%d,\"p\":%d",
+                     st.velocity, (int)st.condition, st.pitchOffset);
+            out += buf;
+            if (st.microTiming) {
+                snprintf(buf, sizeof(buf), ",\"m\":%d", st.microTiming);
+                out += buf;
+            }
+            if (st.ratchets) {
+                snprintf(buf, sizeof(buf), ",\"r\":%d,\"d\":%d", st.ratchets, st.ratchetDecay);
+                out += buf;
+            }
+            StepLocks locks = stepLocks(p, t, s);
+            for (int l = 0; l < PARAM_COUNT; l++) {
+                if (locks.has((ParamType)l)) {
+                    snprintf(buf, sizeof(buf), ",\"L%d\":%.4f", l, locks.get((ParamType)l));
+                    out += buf;
+                }
+            }
+            out += "}";
+        }
+        out += "]}";
+    }
+    out += "]}";
+    return out;
+}
+
+static bool samePattern(const Pattern& a, const Pattern& b) {
+    if (a.length != b.length || a.swing != b.swing) return false;
+    for (int t = 0; t < MAX_TRACKS; t++) {
+        if (a.tracks[t].length != b.tracks[t].length) return false;
+        for (int s = 0; s < a.tracks[t].length; s++) {
+            const Step& x = patternStep(a, t, s);
+            const Step& y = patternStep(b, t, s);
+            if (x.active != y.active) return false;
+            if (!x.active) continue;
+            if (x.velocity != y.velocity || x.pitchOffset != y.pitchOffset) return false;
+            if (x.microTiming != y.microTiming || x.ratchets != y.ratchets ||
+                x.ratchetDecay != y.ratchetDecay) return false;
+            StepLocks lx = stepLocks(a, t, s);
+            StepLocks ly = stepLocks(b, t, s);
+            if (lx.mask != ly.mask) return false;
+            for (int l = 0; l < PARAM_COUNT; l++) {
+                if (lx.has((ParamType)l) &&
+                    fabsf(lx.get((ParamType)l) - ly.get((ParamType)l)) > 0.01f) return false;
+            }
+        }
+    }
+    return true;
+}
+
+static double elapsedNs(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+int main() {
+    static Pattern source;
+    static PatternFile onDisk;
+    static PatternFile staging;
+    static Pattern live;
+
+    buildPattern(source);
+    memcpy(&onDisk.pattern, &source, sizeof(Pattern));
+    patternFileSeal(onDisk);
+
+    bool crcOk = crc32("123456789", 9) == 0xCBF43926UL;
+    printf("Pattern load host benchmark (%d loads each)\n", LOADS);
+    size_t fileSize = patternFileSize(onDisk.header);
+    printf("  sizeof(Pattern) = %zu bytes (%d of %d step pages used), CRC-32 self-test %s\n\n",
+           sizeof(Pattern), source.pagesUsed, PATTERN_STEP_PAGES, crcOk ? "ok" : "FAILED");
+
+    // Binary: one read into staging, header + CRC check, copy to live
+    heapRequested = 0;
+    int bad = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < LOADS; i++) {
+        memcpy(&staging, &onDisk, fileSize);
+        if (patternFileCheck(staging) != PATTERN_FILE_OK) bad++;
+        memcpy(&live, &staging.pattern, sizeof(Pattern));
+    }
+    double binNs = elapsedNs(t0) / LOADS;
+    printf("  binary  %6zu bytes on SD  %9.0f ns/load  heap %zu bytes%s\n",
+           fileSize, binNs, heapRequested / LOADS,
+           bad ? "  (CHECK FAILED)" : "");
+
+#ifdef HAVE_ARDUINOJSON
+    std::string text = toJson(source);
+
+    heapRequested = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < LOADS; i++) {
+        // Same document capacity as Sequencer::readPatternJSON()
+        BasicJsonDocument<CountingAllocator> doc(8192);
+        if (deserializeJson(doc, text.c_str(), text.size())) bad++;
+        patternFromJson(doc, live);
+    }
+    double jsonNs = elapsedNs(t0) / LOADS;
+    printf("  json    %6zu bytes on SD  %9.0f ns/load  heap %zu bytes\n",
+           text.size(), jsonNs, heapRequested / LOADS);
+    printf("\n  binary is %.1fx faster to decode; JSON round trip %s\n",
+           jsonNs / binNs, samePattern(source, live) ? "matches" : "DIFFERS");
+#else
+    (void)toJson;
+    (void)samePattern;
+    printf("  json    skipped: ArduinoJson not on the include path\n");
+#endif
+
+    return (crcOk && bad == 0) ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+/**
+ * Oh My Ondas - Parameter Lock Host Benchmark
+ *
+ * Runs on the development machine, not the Teensy. Compares the cost of
+ * walking a step's parameter locks at trigger time with the old dense
+ * layout (a float and a flag per ParamType on every Step, all flags
+ * tested) against the sparse layout in pattern.h (a bitmask per step and
+ * 16-bit values in a per-track pool, only set bits visited). The work
+ * per lock mirrors onSequencerTrigger(): decode and dispatch on the type.
+ *
+ * Also randomly sets and clears locks across all step pages and checks
+ * the pool stays packed and matches a dense reference within the
+ * quantization step.
+ *
+ * Build & run:
+ *   g++ -std=c++17 -O2 -I../../teensy/include bench_plocks.cpp \
+ *       ../../teensy/pattern.cpp -o bench_plocks && ./bench_plocks
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include "pattern.h"
+
+static const int TRIGGERS = 2000000;
+
+// Step and Track as they were before sparse locks (pattern file v1),
+// when tracks had 16 steps
+static const int DENSE_STEPS = 16;
+
+struct DenseStep {
+    bool active;
+    TrigCondition condition;
+    uint8_t velocity;
+    int8_t pitchOffset;
+    uint8_t sampleSlice;
+    float paramLocks[PARAM_COUNT];
+    bool hasParamLock[PARAM_COUNT];
+};
+
+struct DenseTrack {
+    bool muted;
+    bool soloed;
+    uint8_t sourceSlot;
+    float volume;
+    float pan;
+    DenseStep steps[DENSE_STEPS];
+};
+
+struct DensePattern {
+    uint8_t length;
+    uint8_t swing;
+    float bpm;
+    DenseTrack tracks[MAX_TRACKS];
+};
+
+// Stand-in for posting audio commands: keeps the per-type work alive
+static inline void dispatch(ParamType p, float v, float& gain, float& acc) {
+    switch (p) {
+        case PARAM_VOLUME: gain = v; break;
+        case PARAM_PITCH:  acc += v * 0.0833f; break;
+        default:           acc += v; break;
+    }
+}
+
+static float lockValue(int p, int s) {
+    switch (p) {
+        case PARAM_PITCH:       return (float)(s % 12) - 6.0f;
+        case PARAM_FILTER_FREQ: return 200.0f + s * 700.0f;
+        case PARAM_FILTER_RES:  return 1.0f + s * 0.2f;
+        case PARAM_PAN:         return -1.0f + s * 0.125f;
+        default:                return s / 16.0f;
+    }
+}
+
+static double elapsedNs(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+// locksPerStep locks on as many steps as the pool holds
+static void bench(int locksPerStep, bool report = true) {
+    static DenseTrack dense;
+    static Pattern sparse;
+    memset(&dense, 0, sizeof(dense));
+    patternClear(sparse);
+
+    int steps = DENSE_STEPS;
+    if (locksPerStep > 0 && steps * locksPerStep > TRACK_PARAM_LOCKS) {
+        steps = TRACK_PARAM_LOCKS / locksPerStep;
+    }
+
+    for (int s = 0; s < steps; s++) {
+        for (int k = 0; k < locksPerStep; k++) {
+            // Spread the locks over the parameter list
+            int p = (k * PARAM_COUNT) / locksPerStep;
+            dense.steps[s].paramLocks[p] = lockValue(p, s);
+            dense.steps[s].hasParamLock[p] = true;
+            stepSetLock(sparse, 0, s, (ParamType)p, lockValue(p, s));
+        }
+    }
+
+    float gain = 0.0f, acc = 0.0f;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < TRIGGERS; i++) {
+        const DenseStep& st = dense.steps[i % steps];
+        for (int p = 0; p < PARAM_COUNT; p++) {
+            if (st.hasParamLock[p]) dispatch((ParamType)p, st.paramLocks[p], gain, acc);
+        }
+    }
+    double denseNs = elapsedNs(t0) / TRIGGERS;
+    float denseAcc = acc + gain;
+
+    gain = 0.0f;
+    acc = 0.0f;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < TRIGGERS; i++) {
+        StepLocks locks = stepLocks(sparse, 0, i % steps);
+        const uint16_t* q = locks.values;
+        for (uint16_t m = locks.mask; m; m &= m - 1) {
+            ParamType p = (ParamType)__builtin_ctz(m);
+            dispatch(p, paramLockDecode(p, *q++), gain, acc);
+        }
+    }
+    double sparseNs = elapsedNs(t0) / TRIGGERS;
+    float sparseAcc = acc + gain;
+
+    if (!report) return;
+    printf("  %d locks/step  dense %6.1f ns/trigger  sparse %6.1f ns/trigger  (%.0f/%.0f)\n",
+           locksPerStep, denseNs, sparseNs, denseAcc, sparseAcc);
+}
+
+// Random edits over all step pages against a dense reference; the page
+// map and lock pool must stay consistent. The edits settle near a quarter
+// of all 64 x PARAM_COUNT slots locked, past the pool, so refusals are
+// exercised too
+static bool fuzz() {
+    static Pattern p;
+    static DenseStep ref[MAX_STEPS];
+    patternClear(p);
+    memset(ref, 0, sizeof(ref));
+
+    const int t = 3;
+    uint32_t seed = 12345;
+    int refused = 0;
+
+    for (int i = 0; i < 20000; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        int s = (seed >> 8) % MAX_STEPS;
+        ParamType param = (ParamType)((seed >> 16) % PARAM_COUNT);
+        int op = (seed >> 24) % 8;
+        DenseStep& r = ref[s];
+
+        if (op == 0) {
+            stepClearLocks(p, t, s);
+            memset(r.hasParamLock, 0, sizeof(r.hasParamLock));
+        } else if (op < 3) {
+            stepClearLock(p, t, s, param);
+            r.hasParamLock[param] = false;
+        } else {
+            float v = lockValue(param, (seed >> 4) % 16);
+            if (stepSetLock(p, t, s, param, v)) {
+                r.hasParamLock[param] = true;
+                r.paramLocks[param] = v;
+            } else {
+                refused++;
+            }
+        }
+
+        if (!patternLayoutValid(p)) {
+            printf("  FAIL: pool inconsistent after edit %d\n", i);
+            return false;
+        }
+    }
+
+    for (int s = 0; s < MAX_STEPS; s++) {
+        StepLocks locks = stepLocks(p, t, s);
+        for (int l = 0; l < PARAM_COUNT; l++) {
+            ParamType param = (ParamType)l;
+            if (locks.has(param) != ref[s].hasParamLock[l]) {
+                printf("  FAIL: step %d param %d presence differs\n", s, l);
+                return false;
+            }
+            if (!locks.has(param)) continue;
+            float err = fabsf(locks.get(param) - ref[s].paramLocks[l]);
+            float q = (paramLockDecode(param, 65535) - paramLockDecode(param, 0)) / 65535.0f;
+            if (err > q) {
+                printf("  FAIL: step %d param %d off by %g\n", s, l, err);
+                return false;
+            }
+        }
+    }
+
+    printf("  PASS: 20000 random edits, pool consistent (%d sets refused: %d-value pool full)\n",
+           refused, TRACK_PARAM_LOCKS);
+    return true;
+}
+
+int main() {
+    printf("Parameter lock host benchmark (%d triggers each)\n", TRIGGERS);
+    printf("  sizeof(Step)    dense %3zu  sparse %3zu bytes\n",
+           sizeof(DenseStep), sizeof(Step));
+    printf("  sizeof(Pattern) dense %5zu  sparse %5zu bytes  (%d patterns: %zu KB vs %zu KB)\n\n",
+           sizeof(DensePattern), sizeof(Pattern), MAX_PATTERNS,
+           MAX_PATTERNS * sizeof(DensePattern) / 1024, MAX_PATTERNS * sizeof(Pattern) / 1024);
+
+    // Untimed pass first: the first row otherwise pays for cold caches
+    // and a CPU still ramping its clock
+    static const int densities[] = { 0, 1, 2, 4, PARAM_COUNT };
+    for (int d : densities) bench(d, false);
+    for (int d : densities) bench(d);
+
+    printf("\n");
+    return fuzz() ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+/**
+ * Oh My Ondas - Resampler Host Benchmark
+ *
+ * Runs on the development machine, not the Teensy. Renders 128-sample
+ * blocks through each interpolation mode at several playback rates and
+ * reports time and cycles per block (cycles from the TSC on x86; host
+ * cycles only rank the modes, check the absolute budget on hardware with
+ * processorUsageMax()). Also prints the SNR of a resampled sine against
+ * the exact sine, as a quality reference for each mode.
+ *
+ * Build & run:
+ *   g++ -std=c++17 -O2 -I../../teensy/include bench_resampler.cpp \
+ *       ../../teensy/resampler.cpp -o bench_resampler && ./bench_resampler
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "resampler.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+static const int BLOCK = 128;
+static const int VOICES = 8;
+static const int BLOCKS = 20000;
+
+static const char* modeName(InterpMode m) {
+    switch (m) {
+        case INTERP_LINEAR:    return "linear";
+        case INTERP_HERMITE:   return "hermite";
+        case INTERP_POLYPHASE: return "polyphase";
+        default:               return "?";
+    }
+}
+
+static void setupVoice(ResamplerVoice& v, const std::vector<int16_t>& pcm,
+                       InterpMode mode, float rate) {
+    v.data = pcm.data();
+    v.length = pcm.size();
+    v.end = pcm.size();
+    v.loopStart = 1000;
+    v.loopEnd = pcm.size() - 1000;
+    v.loop = true;              // Loop so every block is fully rendered
+    v.mode = mode;
+    v.phase = 0;
+    v.increment = resamplerIncrement(rate);
+}
+
+static void benchMode(const std::vector<int16_t>& pcm, InterpMode mode, float rate) {
+    ResamplerVoice voices[VOICES];
+    for (int i = 0; i < VOICES; i++) setupVoice(voices[i], pcm, mode, rate);
+
+    int16_t out[BLOCK];
+    int64_t sink = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+    uint64_t c0 = __rdtsc();
+#endif
+    for (int b = 0; b < BLOCKS; b++) {
+        for (int i = 0; i < VOICES; i++) {
+            resamplerRender(voices[i], out, BLOCK);
+            sink += out[b & (BLOCK - 1)];
+        }
+    }
+#ifdef HAVE_TSC
+    uint64_t c1 = __rdtsc();
+#endif
+    auto t1 = std::chrono::steady_clock::now();
+
+    double voiceBlocks = (double)BLOCKS * VOICES;
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / voiceBlocks;
+#ifdef HAVE_TSC
+    double cycles = (double)(c1 - c0) / voiceBlocks;
+    printf("  %-10s rate %.3f  %8.1f ns/block  %8.0f cycles/block  (%lld)\n",
+           modeName(mode), rate, ns, cycles, (long long)(sink & 1));
+#else
+    printf("  %-10s rate %.3f  %8.1f ns/block  (%lld)\n",
+           modeName(mode), rate, ns, (long long)(sink & 1));
+#endif
+}
+
+// Resample a sine and compare against the analytically shifted sine.
+// freq is in cycles per source frame (0.01 = 441 Hz at 44.1 kHz)
+static void accuracy(InterpMode mode, float rate, double freq) {
+    std::vector<int16_t> pcm(48000);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        pcm[i] = (int16_t)lrint(16000.0 * sin(2.0 * M_PI * freq * i));
+    }
+
+    ResamplerVoice v;
+    setupVoice(v, pcm, mode, rate);
+    v.loop = false;
+    v.phase = 10ULL << 32;
+
+    std::vector<int16_t> out(8192);
+    int n = resamplerRender(v, out.data(), out.size());
+
+    double sig = 0.0, err = 0.0;
+    double inc = (double)resamplerIncrement(rate) / 4294967296.0;
+    for (int i = 0; i < n; i++) {
+        double pos = 10.0 + i * inc;
+        double ref = 16000.0 * sin(2.0 * M_PI * freq * pos);
+        sig += ref * ref;
+        err += (out[i] - ref) * (out[i] - ref);
+    }
+    printf("  %-10s rate %.3f  %5.0f Hz  SNR %5.1f dB\n", modeName(mode), rate,
+           freq * 44100.0, 10.0 * log10(sig / (err > 0.0 ? err : 1e-9)));
+}
+
+int main() {
+    resamplerInit();
+
+    std::vector<int16_t> pcm(44100);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < pcm.size(); i++) {
+        seed = seed * 1664525u + 1013904223u;
+        pcm[i] = (int16_t)(seed >> 16);
+    }
+
+    static const float rates[] = { 1.0f, 0.5f, 1.4983f, 2.0f };
+
+    printf("Resampler host benchmark: %d voices x %d blocks of %d samples\n",
+           VOICES, BLOCKS, BLOCK);
+    for (float rate : rates) {
+        for (int m = 0; m < INTERP_MODE_COUNT; m++) {
+            benchMode(pcm, (InterpMode)m, rate);
+        }
+    }
+
+    printf("\nAccuracy (sine resampled by a fifth)\n");
+    static const double freqs[] = { 0.01, 0.1, 0.25 };
+    for (double f : freqs) {
+        for (int m = 0; m < INTERP_MODE_COUNT; m++) {
+            accuracy((InterpMode)m, 1.4983f, f);
+        }
+    }
+    return 0;
+}
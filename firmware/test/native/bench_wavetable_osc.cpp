@@ -0,0 +1,280 @@
+/**
+ * Oh My Ondas - Wavetable Oscillator Host Benchmark
+ *
+ * Runs on the development machine, not the Teensy, against the host HAL
+ * (native/). Compares the synth's band-limited AudioSynthWavetableOsc
+ * with the stock AudioSynthWaveform it replaced:
+ *
+ *   aliasing   a saw at about 1.3, 5 and 10 kHz, 8192 samples through a
+ *              Hann window and an FFT; everything away from the
+ *              harmonics below Nyquist counts as alias, in dB against
+ *              the harmonics. Exits non-zero unless the wavetable stays
+ *              below WT_ALIAS_MAX_DB at every pitch
+ *   cost       time and cycles per update() (cycles from the TSC on
+ *              x86): the stock saw, the wavetable on one frame, and the
+ *              wavetable morphing between frames (two reads a sample)
+ *   user table a two-cycle WAV (naive saw, sine) loaded through
+ *              WavetableBank: frame count, the sine cycle kept, and the
+ *              saw's top level reduced to its fundamental
+ *
+ * Host cycles only rank the cases. Check the absolute cost on hardware
+ * with the audio profiler (synthWave1, synthWave2).
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target bench_wavetable_osc
+ *   ./build/bench_wavetable_osc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "host_hal.h"
+#include <Audio.h>
+#include <SD.h>
+#include "wavetable_osc.h"
+#include "wavetable_bank.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define WT_ALIAS_MAX_DB -50.0
+
+static const int FFT_BITS = 13;
+static const int FFT_SIZE = 1 << FFT_BITS;
+static const int BLOCKS = 200000;
+
+static int passed = 0;
+static int failed = 0;
+
+static void check(bool ok, const char* what) {
+    if (ok) {
+        printf("  PASS  %s\n", what);
+        passed++;
+    } else {
+        printf("  FAIL  %s\n", what);
+        failed++;
+    }
+}
+
+// Keeps what arrives on its input
+class Capture : public AudioStream {
+public:
+    Capture() : AudioStream(1, inputQueueArray) {}
+    std::vector<int16_t> samples;
+
+    virtual void update(void) {
+        audio_block_t* block = receiveReadOnly();
+        if (!block) return;
+        samples.insert(samples.end(), block->data, block->data + AUDIO_BLOCK_SAMPLES);
+        release(block);
+    }
+
+private:
+    audio_block_t* inputQueueArray[1];
+};
+
+static AudioSynthWaveform     stock;
+static AudioSynthWavetableOsc table;
+static Capture                stockOut, tableOut;
+static AudioConnection        c1(stock, 0, stockOut, 0);
+static AudioConnection        c2(table, 0, tableOut, 0);
+
+// ============================================
+// ALIASING
+// ============================================
+
+// Alias energy against harmonic energy, dB. cycles: whole periods in
+// FFT_SIZE samples, so harmonic h sits on bin h·cycles
+static double aliasDb(const std::vector<int16_t>& x, int cycles) {
+    static double re[FFT_SIZE], im[FFT_SIZE];
+    for (int i = 0; i < FFT_SIZE; i++) {
+        double w = 0.5 - 0.5 * cos(2.0 * M_PI * i / FFT_SIZE);
+        re[i] = x[i] * w;
+        im[i] = 0.0;
+    }
+    wtFft(re, im, FFT_BITS, false);
+
+    double harmonic = 0.0, alias = 0.0;
+    for (int k = 1; k < FFT_SIZE / 2; k++) {
+        double e = re[k] * re[k] + im[k] * im[k];
+        int nearest = (k + cycles / 2) / cycles * cycles;
+        if (nearest > 0 && abs(k - nearest) <= 2) harmonic += e;   // Hann main lobe
+        else alias += e;
+    }
+    return 10.0 * log10((alias + 1e-30) / harmonic);
+}
+
+static void measureAliasing() {
+    printf("Aliasing (saw, alias energy against the harmonics)\n");
+    const int cycleCounts[] = { 241, 929, 1857 };
+    for (int cycles : cycleCounts) {
+        float freq = (float)(cycles * (AUDIO_SAMPLE_RATE_EXACT / FFT_SIZE));
+        stock.begin(0.8f, freq, WAVEFORM_SAWTOOTH);
+        table.begin(0.8f, freq, WAVEFORM_SAWTOOTH);
+        stockOut.samples.clear();
+        tableOut.samples.clear();
+        for (int b = 0; b < FFT_SIZE / AUDIO_BLOCK_SAMPLES + 1; b++) hostAudioUpdate();
+
+        double s = aliasDb(stockOut.samples, cycles);
+        double t = aliasDb(tableOut.samples, cycles);
+        printf("  %7.1f Hz   stock %6.1f dB   wavetable %6.1f dB\n", freq, s, t);
+
+        char what[64];
+        snprintf(what, sizeof(what), "%.0f Hz: wavetable below %.0f dB", freq, WT_ALIAS_MAX_DB);
+        check(t < WT_ALIAS_MAX_DB, what);
+    }
+    stock.amplitude(0.0f);
+    table.amplitude(0.0f);
+}
+
+// ============================================
+// COST
+// ============================================
+
+template <class Update>
+static void timeUpdates(const char* name, Update update) {
+    uint64_t c0 = 0, c1 = 0;
+    auto t0 = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+    c0 = __rdtsc();
+#endif
+    for (int b = 0; b < BLOCKS; b++) update(b);
+#ifdef HAVE_TSC
+    c1 = __rdtsc();
+#endif
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    double ns = s * 1e9 / BLOCKS;
+    printf("  %-30s %8.1f ns/block", name, ns);
+#ifdef HAVE_TSC
+    printf(" %8.0f cycles/block", (double)(c1 - c0) / BLOCKS);
+#endif
+    printf("\n");
+}
+
+static void measureCost() {
+    printf("Cost per update()\n");
+    // Disconnected: update() renders and frees its block, nothing else
+    c1.disconnect();
+    c2.disconnect();
+
+    stock.begin(0.8f, 1234.5f, WAVEFORM_SAWTOOTH);
+    timeUpdates("stock AudioSynthWaveform saw", [](int) { stock.update(); });
+
+    table.begin(0.8f, 1234.5f, WAVEFORM_SAWTOOTH);
+    timeUpdates("wavetable, one frame", [](int) { table.update(); });
+
+    // A new position every block keeps it crossfading
+    timeUpdates("wavetable, morphing", [](int b) {
+        table.morph((b & 255) * (3.0f / 256.0f) + 0.01f);
+        table.update();
+    });
+    stock.amplitude(0.0f);
+    table.amplitude(0.0f);
+}
+
+// ============================================
+// USER TABLE
+// ============================================
+
+static void put16(FILE* f, uint16_t v) { fputc(v & 0xFF, f); fputc(v >> 8, f); }
+static void put32(FILE* f, uint32_t v) { put16(f, v & 0xFFFF); put16(f, v >> 16); }
+
+// Mono: a naive saw cycle, then a sine cycle
+static bool writeUserTable(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    const uint32_t frames = 2 * WT_TABLE_SIZE;
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + frames * 2);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1);
+    put16(f, 1);
+    put32(f, 44100);
+    put32(f, 44100 * 2);
+    put16(f, 2);
+    put16(f, 16);
+    fwrite("data", 1, 4, f);
+    put32(f, frames * 2);
+    for (int i = 0; i < WT_TABLE_SIZE; i++) {
+        put16(f, (uint16_t)(int16_t)((i * 65536 / WT_TABLE_SIZE) - 32768));
+    }
+    for (int i = 0; i < WT_TABLE_SIZE; i++) {
+        put16(f, (uint16_t)(int16_t)lrint(20000.0 * sin(2.0 * M_PI * i / WT_TABLE_SIZE)));
+    }
+    return fclose(f) == 0;
+}
+
+static void loadUserTable() {
+    printf("User table\n");
+    char dir[] = "/tmp/omo_wavetable_XXXXXX";
+    if (!mkdtemp(dir) || !hostSdMount(dir)) {
+        check(false, "cannot create a temporary SD directory");
+        return;
+    }
+    SD.begin(BUILTIN_SDCARD);
+    SD.mkdir("/wavetables");
+    char path[32];
+    WavetableBank::slotPath(0, path, sizeof(path));
+    check(writeUserTable(std::string(dir) + path), "WAV written");
+
+    WavetableBank bank;
+    check(bank.begin() == 1, "slot 0 loaded at begin()");
+    const Wavetable* t = bank.get(0);
+    check(t && t->frames == 2, "two frames");
+    check(bank.getBytesUsed() == 2 * WT_FRAME_POINTS * sizeof(int16_t), "PSRAM accounted");
+    if (!t) return;
+
+    // The sine comes back as a sine, normalized
+    const int16_t* sine = t->data + WT_FRAME_POINTS;
+    int worst = 0;
+    for (int i = 0; i < WT_TABLE_SIZE; i++) {
+        int e = abs(sine[i] - (int)lrint(32767.0 * sin(2.0 * M_PI * i / WT_TABLE_SIZE)));
+        if (e > worst) worst = e;
+    }
+    check(worst <= 4, "sine cycle: within 4 Q15 steps");
+
+    // The saw's top level holds the fundamental alone
+    const int top = WT_LEVELS - 1;
+    const int n = 1 << wtLevelBits(top);
+    const int16_t* saw = t->data + wtLevelOffset(top);
+    double peak = 0.0, residue = 0.0;
+    for (int i = 0; i < n; i++) if (abs(saw[i]) > peak) peak = abs(saw[i]);
+    for (int i = 0; i < n; i++) {
+        // Rising through zero at the middle of the cycle, like the WAV
+        double fit = -peak * sin(2.0 * M_PI * i / n);
+        residue = fmax(residue, fabs(saw[i] - fit));
+    }
+    check(residue < peak * 0.01, "saw, top level: fundamental only");
+
+    // Playable, and frees its PSRAM on unload
+    table.setWavetable(t);
+    table.begin(0.8f, 440.0f, WAVEFORM_SAWTOOTH);
+    table.setWavetable(t);
+    table.morph(1.0f);
+    table.update();
+    check(table.getMorph() == 1.0f, "morph to the second frame");
+    table.setWavetable(&wavetableBasic);
+    bank.unload(0);
+    check(!bank.get(0) && bank.getBytesUsed() == 0, "unloaded");
+}
+
+int main() {
+    printf("Wavetable oscillator host benchmark\n");
+    hostSerialEcho(false);
+    AudioMemory(16);
+
+    measureAliasing();
+    measureCost();
+    loadUserTable();
+
+    printf("\n%d passed, %d failed\n", passed, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * Oh My Ondas - Audio Profiler Host Test
+ *
+ * Runs on the development machine, not the Teensy, against the host HAL
+ * (native/), whose AudioStream times each object on the wall clock like
+ * the Teensy library does on the cycle counter. A stand-in object that
+ * spins for a set time makes one object the heaviest and one block
+ * overrun its deadline. Checks the ranking, the array naming, the
+ * overrun count, the CSV rows, and that nothing is read or printed
+ * while the profiler is off.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_audio_profiler
+ *   ./build/test_audio_profiler
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "host_hal.h"
+#include <Audio.h>
+#include "audio_clock.h"
+#include "audio_profiler.h"
+#include "test_common.h"
+
+// Passes audio through after busy-waiting spinMicros
+class Spinner : public AudioStream {
+public:
+    Spinner() : AudioStream(1, inputQueueArray) {}
+    int spinMicros = 0;
+
+    virtual void update(void) {
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(spinMicros);
+        while (std::chrono::steady_clock::now() < until) {}
+        audio_block_t* block = receiveReadOnly(0);
+        if (!block) return;
+        transmit(block);
+        release(block);
+    }
+
+private:
+    audio_block_t* inputQueueArray[1];
+};
+
+// CSV sink
+class Capture : public Print {
+public:
+    std::string text;
+    virtual size_t write(uint8_t b) { text += (char)b; return 1; }
+    virtual size_t write(const uint8_t* buf, size_t size) {
+        text.append((const char*)buf, size);
+        return size;
+    }
+    using Print::write;
+};
+
+static AudioClock         audioClock;
+static AudioSynthWaveform wave;
+static Spinner            spin;
+static AudioMixer4        mix[2];
+static AudioOutputI2S     out;
+
+static AudioConnection c1(wave, spin);
+static AudioConnection c2(spin, 0, mix[0], 0);
+static AudioConnection c3(mix[0], 0, mix[1], 0);
+static AudioConnection c4(mix[1], 0, out, 0);
+
+static void runBlocks(int blocks) {
+    for (int i = 0; i < blocks; i++) hostAudioUpdate();
+}
+
+static void nextWindow() {
+    hostClockAdvance(PROFILER_WINDOW_MS * 1000UL);
+}
+
+static int countLines(const std::string& s) {
+    int n = 0;
+    for (char c : s) n += (c == '\n');
+    return n;
+}
+
+int main() {
+    printf("Audio profiler host test\n");
+    hostSerialEcho(false);
+
+    AudioMemory(16);
+    wave.begin(0.5f, 440.0f, WAVEFORM_SINE);
+
+    Capture csv;
+    AudioProfiler profiler;
+    profiler.begin(&audioClock, &csv);
+    profiler.add("clock", audioClock);
+    profiler.add("wave", wave);
+    profiler.add("spin", spin);
+    profiler.add("mix", mix);
+    profiler.add("output", out);
+    check(profiler.getObjectCount() == 6, "objects and array elements registered");
+
+    // Off: counters are left alone and nothing is printed
+    spin.spinMicros = 300;
+    runBlocks(4);
+    float before = spin.processorUsageMax();
+    nextWindow();
+    profiler.update();
+    check(csv.text.empty() && profiler.getTopCount() == 0, "off: no sampling, no output");
+    check(spin.processorUsageMax() == before && before > 0.0f, "off: object maxima untouched");
+
+    // On: header at once, one row per window
+    profiler.setEnabled(true);
+    check(csv.text.rfind("prof,ms,total,total_peak,overruns,mem_peak,top1,top1_pct", 0) == 0,
+          "header printed on enable");
+    runBlocks(8);
+    profiler.update();
+    check(countLines(csv.text) == 1, "no row before the window is up");
+    nextWindow();
+    profiler.update();
+    check(countLines(csv.text) == 2, "one row per window");
+
+    char name[24];
+    AudioProfiler::formatName(profiler.getTop(0), name, sizeof(name));
+    check(profiler.getTopCount() == 6 && strcmp(name, "spin") == 0, "heaviest object ranked first");
+
+    bool sorted = true;
+    for (int i = 1; i < profiler.getTopCount(); i++) {
+        if (profiler.getTop(i).windowMax > profiler.getTop(i - 1).windowMax) sorted = false;
+    }
+    check(sorted, "top list in descending order");
+
+    bool named = false;
+    for (int i = 0; i < profiler.getTopCount(); i++) {
+        AudioProfiler::formatName(profiler.getTop(i), name, sizeof(name));
+        if (strcmp(name, "mix1") == 0) named = true;
+    }
+    check(named, "array elements named by index");
+    check(csv.text.find(",spin,") != std::string::npos, "row lists the heaviest object");
+    check(profiler.getMemoryPeak() > 0, "audio memory high-water mark");
+
+    // One block well past the 2.9 ms deadline; the clock sees it on the
+    // next. (Wall-clock timing: a loaded host can add overruns of its own,
+    // so only check that this one was counted.)
+    uint32_t overruns = profiler.getOverruns();
+    spin.spinMicros = 4000;
+    runBlocks(1);
+    spin.spinMicros = 0;
+    runBlocks(2);
+    nextWindow();
+    profiler.update();
+    check(profiler.getOverruns() > overruns, "overrun counted");
+    check(profiler.getTotalPeak() > 100.0f, "total peak over the block period");
+
+    // The window max is reset each window; the peak is not
+    runBlocks(4);
+    nextWindow();
+    profiler.update();
+    const ProfiledObject* s = nullptr;
+    for (int i = 0; i < profiler.getTopCount(); i++) {
+        if (profiler.getTop(i).object == &spin) s = &profiler.getTop(i);
+    }
+    check(s && s->windowMax < s->peak && s->peak > 100.0f, "window max resets, peak holds");
+
+    // Off again: no more rows
+    profiler.setEnabled(false);
+    int lines = countLines(csv.text);
+    runBlocks(4);
+    nextWindow();
+    profiler.update();
+    check(countLines(csv.text) == lines, "off again: no rows");
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
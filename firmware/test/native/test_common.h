@@ -0,0 +1,28 @@
+/**
+ * Oh My Ondas - Host Test Harness
+ * PASS/FAIL reporting shared by the host tests in test/native/
+ *
+ * Each test is its own program: include this once, call check() for
+ * every expectation, then print the totals and return failed == 0 from
+ * main() so ctest sees the result.
+ */
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <stdio.h>
+
+static int passed = 0;
+static int failed = 0;
+
+static void check(bool ok, const char* what) {
+    if (ok) {
+        printf("  PASS  %s\n", what);
+        passed++;
+    } else {
+        printf("  FAIL  %s\n", what);
+        failed++;
+    }
+}
+
+#endif // TEST_COMMON_H
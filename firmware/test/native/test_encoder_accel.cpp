@@ -0,0 +1,91 @@
+/**
+ * Oh My Ondas - Encoder Acceleration Host Test
+ *
+ * Runs on the development machine, not the Teensy. Turns an EncoderAccel
+ * at steady rates and checks the steps per detent: exact below
+ * ENC_ACCEL_MIN_RATE, ENC_ACCEL_MAX at ENC_ACCEL_MAX_RATE, and back to one
+ * after a reversal or a pause. Prints how many detents a full 0-127
+ * parameter sweep takes at each rate.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_encoder_accel
+ *   ./build/test_encoder_accel
+ */
+
+#include <stdio.h>
+#include "encoder_accel.h"
+#include "test_common.h"
+
+// Detents at a steady rate until the steps add up to range; returns the
+// detents taken, and the largest step through largest
+static int sweep(EncoderAccel& a, uint32_t& now, float detentsPerSec, int range, int* largest) {
+    uint32_t interval = (uint32_t)(1000.0f / detentsPerSec);
+    int total = 0;
+    int detents = 0;
+    *largest = 0;
+    while (total < range) {
+        now += interval;
+        int steps = a.detent(+1, now);
+        if (steps > *largest) *largest = steps;
+        total += steps;
+        detents++;
+    }
+    return detents;
+}
+
+static void testCurve() {
+    printf("Steps per detent\n");
+    check(EncoderAccel::steps(0.0f) == 1, "at rest: 1");
+    check(EncoderAccel::steps(ENC_ACCEL_MIN_RATE) == 1, "up to ENC_ACCEL_MIN_RATE: 1");
+    check(EncoderAccel::steps(ENC_ACCEL_MAX_RATE) == ENC_ACCEL_MAX, "at ENC_ACCEL_MAX_RATE: ENC_ACCEL_MAX");
+    check(EncoderAccel::steps(1000.0f) == ENC_ACCEL_MAX, "capped above");
+
+    bool rising = true;
+    for (float r = 0.0f; r < ENC_ACCEL_MAX_RATE + 10.0f; r += 0.5f) {
+        if (EncoderAccel::steps(r + 0.5f) < EncoderAccel::steps(r)) rising = false;
+    }
+    check(rising, "never falls as the rate rises");
+}
+
+static void testSweeps() {
+    printf("Sweeps over 128 steps\n");
+    const float rates[] = { 5.0f, 15.0f, 25.0f, 40.0f, 60.0f };
+    int detents[5];
+    int largest[5];
+    for (int i = 0; i < 5; i++) {
+        EncoderAccel a;
+        uint32_t now = 1000;
+        detents[i] = sweep(a, now, rates[i], 128, &largest[i]);
+        printf("  %4.0f detents/s: %3d detents, largest step %d\n", rates[i], detents[i], largest[i]);
+    }
+    check(detents[0] == 128 && largest[0] == 1, "slow turn: one step per detent");
+    check(detents[3] <= 128 / ENC_ACCEL_MAX + 4, "fast turn: close to 128 / ENC_ACCEL_MAX detents");
+    check(detents[4] < detents[2] && detents[2] < detents[1], "faster turns need fewer detents");
+}
+
+static void testReset() {
+    printf("Reversal and pause\n");
+    EncoderAccel a;
+    uint32_t now = 1000;
+    int largest;
+    sweep(a, now, 50.0f, 64, &largest);
+    check(largest == ENC_ACCEL_MAX, "spun up");
+
+    now += 20;
+    check(a.detent(-1, now) == -1, "reversal: one step back");
+    now += 20;
+    check(a.detent(-1, now) > -ENC_ACCEL_MAX, "ramps up again rather than jumping to ENC_ACCEL_MAX");
+
+    for (int i = 0; i < 10; i++) { now += 20; a.detent(-1, now); }
+    now += ENC_ACCEL_IDLE_MS;
+    check(a.detent(-1, now) == -1, "after a pause: one step");
+}
+
+int main() {
+    testCurve();
+    testSweeps();
+    testReset();
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/**
+ * Oh My Ondas - Fader Filter Host Test
+ *
+ * Runs on the development machine, not the Teensy. Feeds FaderFilter the
+ * readings a fader produces (at rest with noise, with a wiper spike, a
+ * jump, a slow move, pulled to either end) and checks what it reports.
+ * Also prints how many readings a jump takes to be reported and to
+ * settle. The README fader latency figures come from these counts, at
+ * one reading per fader every FADER_READING_US.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_fader_filter
+ *   ./build/test_fader_filter
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fader_filter.h"
+#include "test_common.h"
+
+// ADS1115 round robin: a 1163µs conversion and ~200µs of I2C
+// (channel switch and read) per channel, four channels
+#define FADER_READING_US (4 * (1163 + 200))
+
+static float noise(float amplitude) {
+    return amplitude * ((float)rand() / RAND_MAX * 2.0f - 1.0f);
+}
+
+static void testAtRest() {
+    printf("At rest\n");
+    FaderFilter f;
+    check(f.update(0.5f) && f.value() == 0.5f, "first reading reported as is");
+
+    // ±0.2% of noise: a few counts of wiper and ADC noise
+    int reports = 0;
+    for (int i = 0; i < 2000; i++) reports += f.update(0.5f + noise(0.002f));
+    check(reports == 0, "noise inside the band: no events");
+
+    // A single-reading spike is the median's to drop
+    reports = f.update(0.9f);
+    reports += f.update(0.5f);
+    reports += f.update(0.5f);
+    check(reports == 0, "one-reading spike: no events");
+
+    // A full-travel move over one second (~180 readings per fader) with
+    // noise: events are bounded by the band, not by the readings
+    reports = 0;
+    int readings = 1000000 / FADER_READING_US;
+    for (int i = 0; i <= readings; i++) {
+        reports += f.update((float)i / readings + noise(0.002f));
+    }
+    printf("  full sweep: %d events from %d readings\n", reports, readings + 1);
+    check(reports <= (int)(1.0f / FADER_HYSTERESIS), "at most one event per band");
+}
+
+static void testMoves() {
+    printf("Moves\n");
+    FaderFilter f;
+    f.update(0.2f);
+
+    // Jump: readings until the first event and until within the band
+    int first = -1;
+    int settled = -1;
+    for (int i = 1; i <= 50 && settled < 0; i++) {
+        bool event = f.update(0.7f);
+        if (event && first < 0) first = i;
+        if (f.value() > 0.7f - 2 * FADER_HYSTERESIS) settled = i;
+    }
+    printf("  0.2 -> 0.7: first event after %d readings (%.1f ms), settled after %d (%.1f ms)\n",
+           first, first * FADER_READING_US / 1000.0f, settled, settled * FADER_READING_US / 1000.0f);
+    check(first == 2, "a jump is reported on its second reading (median)");
+    check(settled > 0 && settled <= 10, "settles within 10 readings");
+
+    // Slow move: the reported value tracks within a few bands
+    float worst = 0.0f;
+    for (int i = 0; i <= 200; i++) {
+        float pos = 0.7f - i * 0.002f;
+        f.update(pos + noise(0.001f));
+        float lag = f.value() - pos;
+        if (lag < 0) lag = -lag;
+        if (i > 10 && lag > worst) worst = lag;
+    }
+    printf("  slow move: reported value within %.4f of the fader\n", worst);
+    check(worst < 4 * FADER_HYSTERESIS, "slow move tracked");
+}
+
+static void testEnds() {
+    printf("Ends\n");
+    FaderFilter f;
+    f.update(0.5f);
+    for (int i = 0; i < 30; i++) f.update(0.001f + noise(0.001f));
+    check(f.value() == 0.0f, "pulled down: exactly 0");
+    for (int i = 0; i < 30; i++) f.update(0.999f + noise(0.001f));
+    check(f.value() == 1.0f, "pushed up: exactly 1");
+
+    int reports = 0;
+    for (int i = 0; i < 500; i++) reports += f.update(0.999f + noise(0.001f));
+    check(reports == 0, "no events at the end stop");
+}
+
+int main() {
+    srand(1);
+    testAtRest();
+    testMoves();
+    testEnds();
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
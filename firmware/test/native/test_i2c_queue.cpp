@@ -0,0 +1,226 @@
+/**
+ * Oh My Ondas - I2C Queue Host Test
+ *
+ * Runs on the development machine, not the Teensy. A simulated LPI2C
+ * master executes the command words the queue hands out against a few
+ * register-file devices (an MCP23017, an ADS1115), the way the I2cBus
+ * interrupt does on the hardware. Checks the command sequences, that
+ * results reach their callbacks only from dispatch() and in submission
+ * order, that a missing device fails only its own transfer, that a full
+ * queue refuses rather than overwrites, and the statistics.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_i2c_queue
+ *   ./build/test_i2c_queue
+ */
+
+#include <stdio.h>
+#include <vector>
+#include "i2c_queue.h"
+#include "test_common.h"
+
+// ============================================
+// SIMULATED BUS
+// ============================================
+
+struct SimDevice {
+    uint8_t addr;
+    uint8_t regs[256];
+    uint8_t pointer;
+};
+
+struct SimBus {
+    std::vector<SimDevice*> devices;
+    std::vector<uint16_t> words;    // Everything written to MTDR
+    uint32_t now = 0;
+
+    SimDevice* find(uint8_t addr) {
+        for (SimDevice* d : devices) {
+            if (d->addr == addr) return d;
+        }
+        return nullptr;
+    }
+
+    // The interrupt handler's job, one transfer after the other, with
+    // 9 bit times (22.5µs at 400 kHz) per address or data byte
+    void run(I2cQueue& q) {
+        while (q.start(now)) {
+            SimDevice* dev = nullptr;
+            bool first = true;
+            bool nack = false;
+            uint16_t w;
+
+            while (!nack && q.nextCommand(w)) {
+                words.push_back(w);
+                uint16_t cmd = w & 0x700;
+                uint8_t data = w & 0xFF;
+
+                if (cmd == I2cQueue::CMD_START) {
+                    now += 23;
+                    dev = find(data >> 1);
+                    nack = dev == nullptr;
+                    first = true;
+                } else if (cmd == I2cQueue::CMD_TRANSMIT) {
+                    now += 23;
+                    if (first) dev->pointer = data;
+                    else dev->regs[dev->pointer++] = data;
+                    first = false;
+                } else if (cmd == I2cQueue::CMD_RECEIVE) {
+                    for (int i = 0; i <= data; i++) {
+                        now += 23;
+                        q.received(dev->regs[dev->pointer++]);
+                    }
+                }
+            }
+            q.finish(nack ? I2C_NACK : (q.commandsDone() && q.readDone() ? I2C_OK : I2C_BUS_ERROR),
+                     now);
+        }
+    }
+};
+
+// ============================================
+// CALLBACKS
+// ============================================
+
+struct Result {
+    int order;
+    uint8_t status;
+    uint16_t value;
+};
+
+static std::vector<Result> results;
+
+static void onRead(const I2cTransfer& t, void* ctx) {
+    results.push_back({ (int)(intptr_t)ctx, t.status, t.rxLen == 2 ? t.rx16le() : (uint16_t)0 });
+}
+
+// ============================================
+// TESTS
+// ============================================
+
+static void testSequences() {
+    printf("Command sequences\n");
+    I2cQueue q;
+    SimBus bus;
+    SimDevice mcp = { 0x20, {}, 0 };
+    bus.devices.push_back(&mcp);
+
+    q.readReg(0x20, 0x12, 2, onRead);
+    bus.run(q);
+    std::vector<uint16_t> read = { 0x440, 0x012, 0x441, 0x101, 0x200 };
+    check(bus.words == read, "register read: START+W, reg, START+R, RECEIVE 2, STOP");
+
+    bus.words.clear();
+    const uint8_t config[2] = { 0xC3, 0xE3 };
+    q.writeReg(0x48, 0x01, config, 2);
+    bus.run(q);
+    std::vector<uint16_t> write = { 0x490, 0x001, 0x0C3, 0x0E3, 0x200 };
+    check(bus.words.size() == 1 && bus.words[0] == 0x490, "write to a missing device stops at the address");
+
+    SimDevice ads = { 0x48, {}, 0 };
+    bus.devices.push_back(&ads);
+    bus.words.clear();
+    q.writeReg(0x48, 0x01, config, 2);
+    bus.run(q);
+    check(bus.words == write, "register write: START+W, reg, data, STOP");
+    check(ads.regs[1] == 0xC3 && ads.regs[2] == 0xE3, "data lands in the device");
+
+    bus.words.clear();
+    q.submit(0x20, nullptr, 0, 1, onRead);
+    q.submit(0x20, nullptr, 0, 0);
+    bus.run(q);
+    std::vector<uint16_t> bare = { 0x441, 0x100, 0x200, 0x440, 0x200 };
+    check(bus.words == bare, "read without a register, and a probe");
+
+    uint8_t big[I2C_MAX_WRITE] = {};
+    check(!q.writeReg(0x3C, 0x40, big, I2C_MAX_WRITE), "write longer than I2C_MAX_WRITE refused");
+    check(!q.readReg(0x20, 0x00, I2C_MAX_READ + 1, onRead), "read longer than I2C_MAX_READ refused");
+    q.dispatch();
+}
+
+static void testCompletion() {
+    printf("Completion\n");
+    I2cQueue q;
+    SimBus bus;
+    SimDevice mcp = { 0x20, {}, 0 };
+    mcp.regs[0x12] = 0x34;
+    mcp.regs[0x13] = 0x12;
+    bus.devices.push_back(&mcp);
+    results.clear();
+
+    q.readReg(0x20, 0x12, 2, onRead, (void*)1);
+    q.readReg(0x21, 0x12, 2, onRead, (void*)2);     // Not fitted
+    q.readReg(0x20, 0x12, 2, onRead, (void*)3);
+    bus.run(q);
+    check(results.empty(), "no callback until dispatch()");
+    check(q.pending() == 0 && q.space() == I2C_QUEUE_SIZE - 3, "finished slots held until dispatched");
+
+    check(q.dispatch() == 3 && results.size() == 3, "three callbacks");
+    check(results[0].order == 1 && results[1].order == 2 && results[2].order == 3,
+          "in submission order");
+    check(results[0].status == I2C_OK && results[0].value == 0x1234, "read delivered, low byte first");
+    check(results[1].status == I2C_NACK, "missing device: NACK");
+    check(results[2].status == I2C_OK && results[2].value == 0x1234, "next transfer unaffected");
+    check(q.getCompleted() == 2 && q.getFailed() == 1, "completed and failed counts");
+    check(q.space() == I2C_QUEUE_SIZE, "slots freed");
+
+    // 5 bytes on the bus (address, register, address, 2 data) at 23µs each
+    check(q.getBusyMicros() == 2 * 115 + 23, "bus time: two reads and a NACKed address");
+}
+
+static bool resubmitted = false;
+static I2cQueue* chainQueue = nullptr;
+
+static void onChain(const I2cTransfer& t, void* ctx) {
+    (void)t;
+    int left = (int)(intptr_t)ctx;
+    if (left > 0) resubmitted = chainQueue->readReg(0x20, 0x12, 2, onChain, (void*)(intptr_t)(left - 1));
+}
+
+static void testFullAndChained() {
+    printf("Full queue and chaining\n");
+    I2cQueue q;
+    SimBus bus;
+    SimDevice mcp = { 0x20, {}, 0 };
+    bus.devices.push_back(&mcp);
+
+    int accepted = 0;
+    for (int i = 0; i < I2C_QUEUE_SIZE + 3; i++) {
+        accepted += q.readReg(0x20, 0x12, 2, nullptr);
+    }
+    check(accepted == I2C_QUEUE_SIZE && q.getDropped() == 3, "full queue refuses, counts drops");
+    check(q.getPeakDepth() == I2C_QUEUE_SIZE, "peak depth");
+    bus.run(q);
+    check(q.space() == 0, "finished but undispatched slots still count as full");
+    q.dispatch();
+
+    // A callback queues the next transfer, as the ADS1115 sweep and the OLED do
+    chainQueue = &q;
+    q.readReg(0x20, 0x12, 2, onChain, (void*)3);
+    int rounds = 0;
+    do {
+        resubmitted = false;
+        bus.run(q);
+        q.dispatch();
+        rounds++;
+    } while (resubmitted && rounds < 10);
+    check(rounds == 4, "callback resubmits from dispatch()");
+
+    // Index wrap: many more transfers than slots
+    bool ok = true;
+    for (int i = 0; i < 70000 && ok; i++) {
+        ok = q.readReg(0x20, 0x12, 2, nullptr);
+        bus.run(q);
+        q.dispatch();
+    }
+    check(ok && q.space() == I2C_QUEUE_SIZE && q.pending() == 0, "16-bit indices wrap cleanly");
+}
+
+int main() {
+    testSequences();
+    testCompletion();
+    testFullAndChained();
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
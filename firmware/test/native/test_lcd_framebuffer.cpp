@@ -0,0 +1,143 @@
+/**
+ * Oh My Ondas - LCD Framebuffer Host Test
+ *
+ * Runs on the development machine, not the Teensy. Checks the drawing
+ * primitives against the pixels they should set, the dirty band
+ * rectangles, and the flush staging: a small frame is copied out whole
+ * at publish() so drawing can go on while it is sent, and a large one
+ * streams with isFlushing() holding the next frame off until every band
+ * has been copied. The SPI DMA itself is Teensy-only (LCDDisplay::flush).
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_lcd_framebuffer
+ *   ./build/test_lcd_framebuffer
+ */
+
+#include <stdio.h>
+#include "host_hal.h"
+#include "lcd_framebuffer.h"
+#include "test_common.h"
+
+static const uint16_t RED   = 0xF800;
+static const uint16_t GREEN = 0x07E0;
+static const uint16_t BLUE  = 0x001F;
+
+// A font with one glyph: 'A' as the classic 5×7 bitmap
+static uint8_t testFont[256 * 5];
+
+static void testDrawing(LcdFrameBuffer& fb) {
+    printf("Drawing\n");
+
+    fb.fillRect(10, 10, 4, 3, RED);
+    check(fb.getPixel(10, 10) == RED && fb.getPixel(13, 12) == RED, "fill inside");
+    check(fb.getPixel(14, 10) == 0 && fb.getPixel(10, 13) == 0, "fill stops at its edge");
+
+    fb.fillRect(-5, -5, 10, 10, GREEN);
+    fb.fillRect(LCD_WIDTH - 2, LCD_HEIGHT - 2, 10, 10, GREEN);
+    check(fb.getPixel(0, 0) == GREEN && fb.getPixel(4, 4) == GREEN && fb.getPixel(5, 5) == 0,
+          "clipped at the top left");
+    check(fb.getPixel(LCD_WIDTH - 1, LCD_HEIGHT - 1) == GREEN, "clipped at the bottom right");
+
+    fb.drawRect(100, 100, 10, 6, BLUE);
+    check(fb.getPixel(100, 100) == BLUE && fb.getPixel(109, 105) == BLUE &&
+          fb.getPixel(104, 102) == 0, "outline is hollow");
+
+    // 'A': column 0 is 0x7C, rows 2..6 on
+    fb.drawText(200, 50, 1, RED, BLUE, "A");
+    check(fb.getPixel(200, 50) == BLUE && fb.getPixel(200, 52) == RED, "glyph pixels");
+    check(fb.getPixel(205, 52) == BLUE && fb.getPixel(200, 57) == BLUE,
+          "spacing column and bottom row in the background colour");
+
+    fb.drawText(300, 50, 2, RED, BLUE, "AA");
+    check(fb.getPixel(300, 54) == RED && fb.getPixel(301, 55) == RED &&
+          fb.getPixel(300, 53) == BLUE, "size 2 doubles each pixel");
+    check(fb.getPixel(312, 54) == RED && fb.getPixel(324, 54) == 0, "next cell 12 px on, then nothing");
+
+    fb.drawCircle(50, 200, 10, RED);
+    check(fb.getPixel(60, 200) == RED && fb.getPixel(40, 200) == RED &&
+          fb.getPixel(50, 190) == RED && fb.getPixel(50, 200) == 0, "circle outline");
+
+    fb.fillCircle(100, 200, 6, GREEN);
+    check(fb.getPixel(100, 200) == GREEN && fb.getPixel(106, 200) == GREEN &&
+          fb.getPixel(107, 200) == 0, "filled circle");
+
+    // The header's play triangle
+    fb.fillTriangle(454, 8, 454, 20, 466, 14, GREEN);
+    check(fb.getPixel(454, 8) == GREEN && fb.getPixel(466, 14) == GREEN &&
+          fb.getPixel(460, 14) == GREEN && fb.getPixel(466, 8) == 0, "triangle");
+}
+
+static void drain(LcdFrameBuffer& fb, int& windows, uint32_t& bytes) {
+    while (const LcdBand* b = fb.front()) {
+        windows++;
+        bytes += b->bytes();
+        fb.sent();
+        fb.service();
+    }
+}
+
+static void testStaging(LcdFrameBuffer& fb) {
+    printf("Dirty bands and staging\n");
+    int windows = 0;
+    uint32_t bytes = 0;
+    fb.publish();
+    drain(fb, windows, bytes);
+
+    // Rows 10..39 touch bands 0, 1 and 2
+    fb.fillRect(20, 10, 8, 30, RED);
+    check(fb.getDirtyBands() == 3, "a fill marks the bands it crosses");
+
+    fb.publish();
+    check(fb.getStagedBands() == 3 && !fb.isFlushing(), "a small frame is staged whole");
+    const LcdBand* b = fb.front();
+    check(b && b->rect.x == 20 && b->rect.y == 10 && b->rect.w == 8 && b->rect.h == 6,
+          "band window is the dirty part of the band");
+    check(b->pixels[0] == (uint16_t)((RED << 8) | (RED >> 8)), "staged high byte first");
+
+    // The next frame draws over it before the DMA is done: the copy holds
+    fb.fillRect(20, 10, 8, 30, BLUE);
+    check(b->pixels[0] == (uint16_t)((RED << 8) | (RED >> 8)), "staged copy unaffected by new drawing");
+
+    windows = 0;
+    bytes = 0;
+    drain(fb, windows, bytes);
+    check(windows == 3 && bytes == 8 * 30 * 2, "three windows, only the dirty pixels");
+    fb.publish();
+    drain(fb, windows, bytes);
+
+    // A full screen: more bands than staging buffers, so it streams
+    fb.fillRect(0, 0, LCD_WIDTH, LCD_HEIGHT, GREEN);
+    fb.publish();
+    check(fb.getStagedBands() == LCD_FB_STAGING && fb.isFlushing(), "a large frame streams");
+
+    windows = 0;
+    bytes = 0;
+    bool consistent = true;
+    while (const LcdBand* s = fb.front()) {
+        if (s->pixels[0] != (uint16_t)((GREEN << 8) | (GREEN >> 8))) consistent = false;
+        windows++;
+        bytes += s->bytes();
+        fb.sent();
+        fb.service();
+    }
+    check(!fb.isFlushing(), "held off until every band is copied");
+    check(windows == LcdFrameBuffer::BANDS && bytes == (uint32_t)LCD_WIDTH * LCD_HEIGHT * 2,
+          "whole screen sent, one window per band");
+    check(consistent, "every band sent as drawn");
+}
+
+int main() {
+    hostSerialEcho(false);
+    const uint8_t glyphA[5] = { 0x7C, 0x12, 0x11, 0x12, 0x7C };
+    memcpy(testFont + 'A' * 5, glyphA, 5);
+
+    LcdFrameBuffer fb;
+    check(fb.begin(), "framebuffer and staging allocated");
+    fb.setFont(testFont);
+
+    testDrawing(fb);
+    testStaging(fb);
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/**
+ * Oh My Ondas - LCD Widgets Host Test
+ *
+ * Runs on the development machine, not the Teensy. Checks retained
+ * widget diffing, the coalescing of clear rectangles, and the SPI byte
+ * model, then measures a running pattern page the way drawPatternScreen()
+ * paints it: SPI bytes per frame with every widget repainted (as before)
+ * against only the dirty ones.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_lcd_widgets
+ *   ./build/test_lcd_widgets
+ */
+
+#include <stdio.h>
+#include "host_hal.h"
+#include "lcd_widgets.h"
+#include "test_common.h"
+
+static bool sameRect(const LcdRect& r, int x, int y, int w, int h) {
+    return r.x == x && r.y == y && r.w == w && r.h == h;
+}
+
+static void testDiffing() {
+    printf("Retained widgets\n");
+    LcdWidgets w;
+
+    check(w.mark(0, 0, 0, 10, 10, 1) && w.mark(1, 20, 0, 10, 10, 2), "first frame: all dirty");
+    check(w.getDirtyCount() == 2 && w.getClearCount() == 0, "opaque widgets queue no clears");
+    w.commit();
+
+    check(!w.mark(0, 0, 0, 10, 10, 1) && !w.mark(1, 20, 0, 10, 10, 2), "same keys: nothing dirty");
+    check(w.mark(1, 20, 0, 10, 10, 3) && !w.isDirty(0) && w.isDirty(1), "a changed key dirties one widget");
+    w.commit();
+
+    // Moving to a rectangle that does not cover the old one clears the old
+    check(w.mark(1, 40, 0, 10, 10, 3), "a moved widget is dirty");
+    check(w.getClearCount() == 1 && sameRect(w.getClear(0), 20, 0, 10, 10), "old rectangle cleared");
+    w.commit();
+
+    w.setRetained(false);
+    check(w.mark(0, 0, 0, 10, 10, 1), "not retained: dirty every frame");
+    w.setRetained(true);
+    w.commit();
+
+    w.invalidate();
+    check(w.mark(0, 0, 0, 10, 10, 1) && !w.isDrawn(5), "invalidate: redraw on next mark");
+}
+
+// Draws widget id at the rectangle once, so the next change has to clear
+static void drawn(LcdWidgets& w, int id, int x, int y, int wd, int h) {
+    w.mark(id, x, y, wd, h, 0, false);
+}
+
+static void testCoalescing() {
+    printf("Clear coalescing\n");
+    LcdWidgets w;
+    drawn(w, 0, 20, 0, 10, 12);
+    drawn(w, 1, 0, 0, 10, 12);
+    drawn(w, 2, 10, 0, 10, 12);
+    drawn(w, 3, 0, 20, 10, 8);
+    drawn(w, 4, 0, 28, 10, 8);
+    drawn(w, 5, 0, 40, 10, 10);
+    drawn(w, 6, 14, 40, 10, 10);
+    drawn(w, 7, 24, 40, 10, 12);
+    drawn(w, 8, 0, 60, 40, 40);
+    drawn(w, 9, 10, 70, 5, 5);
+    check(w.getClearCount() == 0, "first draw after invalidate: the screen is blank");
+    w.commit();
+
+    // A row of touching cells, out of order: one window
+    w.mark(0, 20, 0, 10, 12, 1, false);
+    w.mark(1, 0, 0, 10, 12, 1, false);
+    w.mark(2, 10, 0, 10, 12, 1, false);
+    check(w.getClearCount() == 1 && sameRect(w.getClear(0), 0, 0, 30, 12), "touching row merged");
+    w.clearsIssued();
+
+    // A column stacks the same way
+    w.mark(3, 0, 20, 10, 8, 1, false);
+    w.mark(4, 0, 28, 10, 8, 1, false);
+    check(w.getClearCount() == 1 && sameRect(w.getClear(0), 0, 20, 10, 16), "touching column merged");
+    w.clearsIssued();
+
+    // A gap or a different height would clear pixels nobody queued
+    w.mark(5, 0, 40, 10, 10, 1, false);
+    w.mark(6, 14, 40, 10, 10, 1, false);
+    w.mark(7, 24, 40, 10, 12, 1, false);
+    check(w.getClearCount() == 3, "gapped or ragged rectangles kept apart");
+    w.clearsIssued();
+
+    // Contained
+    w.mark(8, 0, 60, 40, 40, 1, false);
+    w.mark(9, 10, 70, 5, 5, 1, false);
+    check(w.getClearCount() == 1 && sameRect(w.getClear(0), 0, 60, 40, 40), "contained rectangle absorbed");
+    w.commit();
+
+    // Only changed non-opaque widgets are cleared
+    w.mark(0, 20, 0, 10, 12, 1, false);
+    w.mark(1, 0, 0, 10, 12, 2, false);
+    check(w.getClearCount() == 1 && sameRect(w.getClear(0), 0, 0, 10, 12), "clean widgets not cleared");
+    w.commit();
+
+    // An outline redrawn as an outline covers itself; one that was a
+    // filled box needs its inside cleared
+    w.mark(20, 0, 120, 10, 10, 1, false, LcdWidgets::OUTLINE);
+    w.commit();
+    w.mark(20, 0, 120, 10, 10, 2, false, LcdWidgets::OUTLINE);
+    check(w.isDirty(20) && w.getClearCount() == 0, "outline over outline: no clear");
+    w.commit();
+    w.mark(20, 0, 120, 10, 10, 3, true);
+    w.commit();
+    w.mark(20, 0, 120, 10, 10, 4, false, LcdWidgets::OUTLINE);
+    check(w.getClearCount() == 1, "outline over a filled box: cleared");
+}
+
+static void testMeter() {
+    printf("SPI meter\n");
+    LcdSpiMeter m;
+
+    m.fill(10, 10);
+    m.endFrame();
+    check(m.getLastFrameBytes() == 11 + 200, "fill: one window, 2 bytes a pixel");
+
+    m.text(3, 1);
+    m.endFrame();
+    check(m.getLastFrameBytes() == 3 * (11 + 2 * 48), "text: one window per character cell");
+
+    m.text(1, 2);
+    m.endFrame();
+    check(m.getLastFrameBytes() == 11 + 2 * 192, "size 2 text: 12x16 cells");
+
+    m.outline(10, 5);
+    m.endFrame();
+    check(m.getLastFrameBytes() == 4 * 11 + 2 * (10 + 10 + 5 + 5), "outline: four lines");
+
+    check(m.getPeakFrameBytes() == 11 + 2 * 192 && m.getFrames() == 4, "peak and frame count");
+    check(m.getAverageFrameBytes() == (211 + 321 + 395 + 104) / 4, "average bytes per frame");
+}
+
+// One pattern page, 16 boxes, painted like drawPatternScreen()
+struct Page {
+    bool active[STEPS_PER_PAGE];
+    int playhead;
+};
+
+// Returns the number of boxes repainted
+static int paintPage(const Page& p, LcdWidgets& w, LcdSpiMeter& m) {
+    const int boxW = 54, boxH = 40, gap = 4, gridY = 80;
+    for (int i = 0; i < STEPS_PER_PAGE; i++) {
+        int32_t k[] = { i, p.active[i], i == p.playhead, 0, 0 };
+        w.mark(i, 8 + (i % 8) * (boxW + gap), gridY + (i / 8) * (boxH + gap), boxW, boxH,
+               LcdWidgets::hash(k, sizeof(k)), p.active[i], p.active[i] ? 0 : LcdWidgets::OUTLINE);
+    }
+    for (int i = 0; i < w.getClearCount(); i++) m.fill(w.getClear(i).w, w.getClear(i).h);
+    w.clearsIssued();
+
+    for (int i = 0; i < STEPS_PER_PAGE; i++) {
+        if (!w.isDirty(i)) continue;
+        int digits = (i + 1) >= 10 ? 2 : 1;
+        if (p.active[i]) {
+            m.fill(boxW, boxH);
+        } else {
+            m.outline(boxW, boxH);
+        }
+        m.text(digits, 1);
+    }
+    int dirty = w.getDirtyCount();
+    w.commit();
+    m.endFrame();
+    return dirty;
+}
+
+static void testPlayhead() {
+    printf("Running pattern page\n");
+    Page p = {};
+    for (int i = 0; i < STEPS_PER_PAGE; i += 4) p.active[i] = true;
+
+    LcdWidgets full;
+    LcdWidgets diff;
+    full.setRetained(false);
+    LcdSpiMeter fullMeter;
+    LcdSpiMeter diffMeter;
+
+    // First frame paints everything either way
+    p.playhead = 0;
+    paintPage(p, full, fullMeter);
+    paintPage(p, diff, diffMeter);
+    check(fullMeter.getLastFrameBytes() == diffMeter.getLastFrameBytes(), "first frame identical");
+
+    // Then one frame per step, over two passes of the page
+    int worstDirty = 0;
+    for (int step = 1; step <= 2 * STEPS_PER_PAGE; step++) {
+        p.playhead = step % STEPS_PER_PAGE;
+        paintPage(p, full, fullMeter);
+        int dirty = paintPage(p, diff, diffMeter);
+        if (dirty > worstDirty) worstDirty = dirty;
+    }
+
+    uint32_t before = fullMeter.getLastFrameBytes();
+    uint32_t after = diffMeter.getLastFrameBytes();
+    printf("  SPI bytes per step: %lu full repaint, %lu playhead only (%.1fx less)\n",
+           (unsigned long)before, (unsigned long)after, (double)before / after);
+    check(after * 4 < before, "playhead step sends under a quarter of a full repaint");
+    check(worstDirty == 2, "only the old and new playhead boxes repainted");
+
+    // Toggling a step repaints that box alone
+    LcdSpiMeter toggle;
+    p.active[5] = true;
+    paintPage(p, diff, toggle);
+    check(toggle.getLastFrameBytes() == 11 + 2 * 54 * 40 + 11 + 2 * 48, "step toggle: one box");
+}
+
+int main() {
+    hostSerialEcho(false);
+    testDiffing();
+    testCoalescing();
+    testMeter();
+    testPlayhead();
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
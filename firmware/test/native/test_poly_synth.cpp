@@ -0,0 +1,215 @@
+/**
+ * Oh My Ondas - Poly Synth Host Test
+ *
+ * Runs on the development machine, not the Teensy, against the host HAL
+ * (native/). Builds the firmware's synth voice chains and drives
+ * PolySynth block by block. Checks that a chord takes one voice per
+ * note, that the same note retriggers its own voice, that a full pool
+ * steals the quietest released voice before the oldest held one, that a
+ * released voice parks once its envelope has finished, that a sequenced
+ * note takes its step's locks and ignores the gate-off of a note it
+ * retriggered, and that allocateBudget() lowers the voice limit and sheds
+ * voices before the ceiling is crossed, then raises it again one voice
+ * at a time.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_poly_synth
+ *   ./build/test_poly_synth
+ */
+
+#include <stdio.h>
+#include "host_hal.h"
+#include <Audio.h>
+#include "poly_synth.h"
+#include "test_common.h"
+
+// The voice chains as audio_objects.h/audio_connections.h build them
+static AudioSynthWavetableOsc wave1[SYNTH_VOICES];
+static AudioSynthWavetableOsc wave2[SYNTH_VOICES];
+static AudioSynthNoiseWhite   noise;
+static AudioMixer4Smooth      mixer[SYNTH_VOICES];
+static AudioFilterLadder      ladder[SYNTH_VOICES];
+static AudioEffectEnvelope    env[SYNTH_VOICES];
+static AudioOutputI2S         out[SYNTH_VOICES];
+static LadderSmoother         ladderCtl[SYNTH_VOICES];
+
+static PolySynth synth;
+
+static void connectGraph() {
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        new AudioConnection(wave1[v], 0, mixer[v], 0);
+        new AudioConnection(wave2[v], 0, mixer[v], 1);
+        new AudioConnection(noise, 0, mixer[v], 2);
+        new AudioConnection(mixer[v], 0, ladder[v], 0);
+        new AudioConnection(ladder[v], 0, env[v], 0);
+        new AudioConnection(env[v], 0, out[v], 0);
+
+        wave1[v].begin(0.0, 440, WAVEFORM_SAWTOOTH);
+        wave2[v].begin(0.0, 440, WAVEFORM_SQUARE);
+        mixer[v].gainNow(0, 0.5);
+        mixer[v].gainNow(1, 0.3);
+        ladderCtl[v].begin(&ladder[v], 8000, 0.7);
+    }
+}
+
+// One audio ISR pass: the graph, then what onAudioBlock() does
+static void runBlocks(int blocks) {
+    for (int b = 0; b < blocks; b++) {
+        hostAudioUpdate();
+        synth.updateVoices();
+    }
+}
+
+static const int RELEASE_BLOCKS = (int)(50.0f * AUDIO_SAMPLE_RATE_EXACT / 1000.0f / AUDIO_BLOCK_SAMPLES) + 2;
+
+static void releaseAll() {
+    synth.allNotesOff();
+    runBlocks(RELEASE_BLOCKS);
+}
+
+static void testAllocation() {
+    printf("Allocation\n");
+    synth.noteOn(60, 0.8f);
+    synth.noteOn(64, 0.8f);
+    synth.noteOn(67, 0.8f);
+    runBlocks(2);
+    check(synth.getActiveVoices() == 3, "chord: one voice per note");
+    int v = synth.findVoice(64);
+    check(v >= 0 && v != synth.findVoice(60) && v != synth.findVoice(67), "each note has its own voice");
+
+    synth.noteOn(64, 0.5f);
+    check(synth.getActiveVoices() == 3 && synth.findVoice(64) == v, "same note: retriggers its voice");
+
+    synth.noteOff(64);
+    check(synth.findVoice(64) < 0 && synth.voice(v).isActive(), "noteOff: releasing, still sounding");
+    runBlocks(RELEASE_BLOCKS);
+    check(!synth.voice(v).isActive(), "parked once the release has finished");
+    check(synth.getActiveVoices() == 2, "the rest hold");
+    releaseAll();
+    check(synth.getActiveVoices() == 0, "allNotesOff: every voice parked");
+}
+
+static void testStealing() {
+    printf("Stealing\n");
+    uint32_t stolen = synth.getStolenCount();
+    for (int n = 0; n < SYNTH_VOICES; n++) synth.noteOn(48 + n, 0.8f);
+    runBlocks(1);
+    check(synth.getActiveVoices() == SYNTH_VOICES, "pool full");
+
+    // Released voices go first, the one let go longest ago before others
+    int first = synth.findVoice(50);
+    int second = synth.findVoice(52);
+    synth.noteOff(50);
+    synth.noteOff(52);
+    synth.noteOn(72, 0.8f);
+    check(synth.findVoice(72) == first, "steals the released voice that let go first");
+    synth.noteOn(73, 0.8f);
+    check(synth.findVoice(73) == second, "then the next released one");
+
+    // None released: the oldest held note
+    int oldest = synth.findVoice(48);
+    synth.noteOn(74, 0.8f);
+    check(synth.findVoice(74) == oldest && synth.findVoice(48) < 0, "all held: steals the oldest note");
+    check(synth.getStolenCount() - stolen == 3, "steals counted");
+    releaseAll();
+}
+
+static void testSequencedNotes() {
+    printf("Sequenced notes\n");
+    const SynthNoteParams& base = synth.getNoteParams();
+
+    // Locks shape the next note only
+    synth.lockNextNote(PARAM_FILTER_FREQ, 1500.0f);
+    synth.lockNextNote(PARAM_SYNTH_RELEASE, 5.0f);
+    synth.playNote(60, 0.8f, 1000);
+    synth.playNote(64, 0.8f, 1000);
+    int locked = synth.findVoice(60);
+    int plain = synth.findVoice(64);
+    check(locked >= 0 && synth.voice(locked).getFilterFreq() == 1500.0f &&
+          synth.voice(locked).getRelease() == 5.0f, "locked note: filter and release locked");
+    check(plain >= 0 && synth.voice(plain).getFilterFreq() == base.filterFreq &&
+          synth.voice(plain).getRelease() == base.release, "next note: back to the settings");
+
+    // Retriggered before its gate-off: the old gate-off is not this note's
+    synth.playNote(60, 0.8f, 2000);
+    synth.releaseNote(60, 1000);
+    check(synth.findVoice(60) == locked, "stale gate-off ignored");
+    synth.releaseNote(60, 2000);
+    check(synth.findVoice(60) < 0, "own gate-off releases");
+
+    // A note played by hand meanwhile is not the sequencer's to end
+    synth.noteOn(64, 0.8f);
+    synth.releaseNote(64, 1000);
+    check(synth.findVoice(64) == plain, "hand-played note keeps its voice");
+    releaseAll();
+}
+
+static void testBudget() {
+    printf("CPU budget\n");
+    float usage[SYNTH_VOICES];
+    for (int n = 0; n < SYNTH_VOICES; n++) synth.noteOn(48 + n, 0.8f);
+    runBlocks(1);
+
+    // 10% a voice next to 20% for the rest of the graph: 6 fit under
+    // an 80% ceiling
+    const float cost = 10.0f;
+    for (int v = 0; v < SYNTH_VOICES; v++) usage[v] = cost;
+    float total = 20.0f + SYNTH_VOICES * cost;
+    uint32_t shed = synth.getShedCount();
+    synth.allocateBudget(total, usage);
+    int expected = (int)((SYNTH_CPU_CEILING - 20.0f) / cost);
+    if (expected > SYNTH_VOICES) expected = SYNTH_VOICES;
+    check(synth.getVoiceLimit() == expected, "limit drops to what fits in one block");
+    check((int)(synth.getShedCount() - shed) == SYNTH_VOICES - expected, "excess voices shed at once");
+
+    int held = 0;
+    for (int v = 0; v < SYNTH_VOICES; v++) {
+        if (synth.voice(v).isActive() && !synth.voice(v).isKilled()) held++;
+    }
+    check(held == expected, "the rest keep playing");
+
+    // A shed voice fades over SYNTH_STEAL_MS, then parks
+    runBlocks((int)(SYNTH_STEAL_MS * AUDIO_SAMPLE_RATE_EXACT / 1000.0f / AUDIO_BLOCK_SAMPLES) + 2);
+    check(synth.getActiveVoices() == expected, "shed voices parked");
+
+    // New notes over the limit steal instead of growing the pool
+    synth.noteOn(90, 0.8f);
+    runBlocks(1);
+    check(synth.getActiveVoices() == expected, "limit holds for new notes");
+
+    // Voices cheap again: the cost figure falls slowly, and the limit
+    // follows one voice a block, never past setPolyphony()
+    synth.setPolyphony(SYNTH_VOICES - 1);
+    for (int v = 0; v < SYNTH_VOICES; v++) usage[v] = synth.voice(v).isActive() ? 1.0f : 0.0f;
+    int limit = synth.getVoiceLimit();
+    bool stepwise = true;
+    for (int b = 0; b < 200; b++) {
+        synth.allocateBudget(20.0f + expected, usage);
+        if (synth.getVoiceLimit() > limit + 1) stepwise = false;
+        limit = synth.getVoiceLimit();
+    }
+    check(stepwise, "rises one voice at a time");
+    check(synth.getVoiceLimit() == SYNTH_VOICES - 1, "up to the polyphony setting");
+    releaseAll();
+
+    // Never below one voice, whatever the rest of the graph costs
+    synth.allocateBudget(150.0f, usage);
+    check(synth.getVoiceLimit() == 1, "floor of one voice");
+    synth.setPolyphony(SYNTH_VOICES);
+}
+
+int main() {
+    hostSerialEcho(false);
+    AudioMemory(8 * SYNTH_VOICES + 8);
+    connectGraph();
+    synth.begin(wave1, wave2, &noise, mixer, ladderCtl, env);
+    synth.setRelease(20.0f);
+
+    testAllocation();
+    testStealing();
+    testSequencedNotes();
+    testBudget();
+
+    printf("\n%d passed, %d failed\n", passed, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * Oh My Ondas - Offline Render Host Test
+ *
+ * Runs on the development machine, not the Teensy. Builds a throwaway SD
+ * directory with one sample and a four-on-the-floor pattern, renders it
+ * through the firmware graph with the offline renderer (native/render/),
+ * then reads the WAV back and checks that every hit starts on the sample
+ * the sequencer scheduled it for, that a sample-end lock shortens only
+ * its own hit, that nothing was late or dropped, and that the render ran
+ * faster than realtime.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_render
+ *   ./build/test_render
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <AudioStream.h>
+#include <Audio.h>           // HOST_AUDIO_SILENT_EFFECTS
+#include "host_hal.h"
+#include "sequencer.h"
+#include "offline_render.h"
+#include "test_common.h"
+
+static const int BURST_FRAMES = 2000;
+
+static void put16(FILE* f, uint16_t v) { fputc(v & 0xFF, f); fputc(v >> 8, f); }
+static void put32(FILE* f, uint32_t v) { put16(f, v & 0xFFFF); put16(f, v >> 16); }
+
+// Mono 16-bit square burst that starts at full level on its first frame
+static bool writeBurst(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + BURST_FRAMES * 2);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1);
+    put16(f, 1);
+    put32(f, 44100);
+    put32(f, 44100 * 2);
+    put16(f, 2);
+    put16(f, 16);
+    fwrite("data", 1, 4, f);
+    put32(f, BURST_FRAMES * 2);
+    for (int i = 0; i < BURST_FRAMES; i++) {
+        put16(f, (uint16_t)(((i / 22) & 1) ? -20000 : 20000));
+    }
+    return fclose(f) == 0;
+}
+
+// Pattern 0: track 0 on steps 0, 4, 8, 12, step 0 cut to its first quarter
+static void writePattern() {
+    static Sequencer editor;
+    editor.begin(120.0f);
+    editor.clearPattern();
+    for (int s = 0; s < 16; s += 4) editor.setStep(0, s, true);
+    editor.setParamLock(0, 0, PARAM_SAMPLE_END, 0.25f);
+    editor.savePattern(0);
+    for (int i = 0; i <= MAX_PATTERNS && editor.getDirtyPatternCount() > 0; i++) {
+        hostClockAdvance((PATTERN_WRITEBACK_DELAY_MS + 1) * 1000UL);
+        editor.update();
+    }
+}
+
+static std::vector<int16_t> readLeft(const std::string& path, uint32_t& frames) {
+    std::vector<int16_t> left;
+    frames = 0;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return left;
+
+    uint8_t h[44];
+    if (fread(h, 1, 44, f) == 44 && memcmp(h, "RIFF", 4) == 0 && memcmp(h + 36, "data", 4) == 0) {
+        frames = (h[40] | (h[41] << 8) | (h[42] << 16) | ((uint32_t)h[43] << 24)) / 4;
+        std::vector<int16_t> pcm(frames * 2);
+        frames = fread(pcm.data(), 4, frames, f);
+        for (uint32_t i = 0; i < frames; i++) left.push_back(pcm[i * 2]);
+    }
+    fclose(f);
+    return left;
+}
+
+static int maxAbs(const std::vector<int16_t>& x, int from, int to) {
+    int m = 0;
+    for (int i = from; i <= to; i++) {
+        if (i >= 0 && i < (int)x.size()) m = std::max(m, abs((int)x[i]));
+    }
+    return m;
+}
+
+int main() {
+    printf("Offline render host test\n");
+
+    char dir[] = "/tmp/omo_render_XXXXXX";
+    if (!mkdtemp(dir) || !hostSdMount(dir)) {
+        printf("  FAIL  cannot create a temporary SD directory\n");
+        return 1;
+    }
+    hostSerialEcho(false);
+    SD.begin(BUILTIN_SDCARD);
+    SD.mkdir("/samples/bank00");
+    SD.mkdir(PATTERNS_DIR);
+
+    std::string root = dir;
+    check(writeBurst(root + "/samples/bank00/sample01.wav"), "sample written");
+    writePattern();
+
+    RenderOptions options;
+    std::string out = root + "/render.wav";
+    options.sdRoot = dir;
+    options.outPath = out.c_str();
+    options.tailSeconds = 0.25f;
+
+    RenderResult r;
+    check(renderOffline(options, r), "render completes");
+    printf("        %.2f s of audio in %.4f s: %.1fx realtime (excludes %s)\n",
+           r.audioSeconds, r.wallSeconds, r.realtimeFactor(), HOST_AUDIO_SILENT_EFFECTS);
+
+    uint32_t frames = 0;
+    std::vector<int16_t> left = readLeft(out, frames);
+    check(frames == r.frames && frames > 0, "WAV holds every rendered frame");
+    check(r.triggers == 4, "four triggers");
+    check(r.lateCommands == 0 && r.droppedCommands == 0, "no late or dropped commands");
+
+    // Hits are silent just before their step and loud from it on
+    const float sps = AUDIO_SAMPLE_RATE_EXACT * 60.0f / 120.0f / 4.0f;
+    bool onTime = true;
+    for (int step = 0; step < 16; step += 4) {
+        int on = (int)(step * sps);
+        bool quietBefore = (step == 0) || maxAbs(left, on - 12, on - 3) < 100;
+        bool loudAfter = maxAbs(left, on - 2, on + 8) > 1000;
+        if (!quietBefore || !loudAfter) {
+            printf("        step %d at frame %d: before %d, after %d\n", step, on,
+                   maxAbs(left, on - 12, on - 3), maxAbs(left, on - 2, on + 8));
+            onTime = false;
+        }
+    }
+    check(onTime, "every hit starts on its scheduled sample");
+
+    // The locked hit stops after BURST_FRAMES / 4; the next one plays whole
+    int tail = (int)(4 * sps);
+    check(maxAbs(left, BURST_FRAMES / 2, BURST_FRAMES * 3 / 4) < 100 &&
+          maxAbs(left, tail + BURST_FRAMES / 2, tail + BURST_FRAMES * 3 / 4) > 1000,
+          "a sample-end lock lasts one hit");
+    check(r.realtimeFactor() > 1.0, "faster than realtime");
+
+    std::filesystem::remove_all(dir);
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+/**
+ * Oh My Ondas - Sequencer Host Test
+ *
+ * Runs on the development machine, not the Teensy, against the host HAL
+ * (native/): the audio clock is driven by hand one block at a time, so
+ * every trigger timestamp is exact and repeatable. Checks grid timing,
+ * micro-timing and ratchets on the sample clock, that a synth track
+ * sends its steps to the note callback with their note and gate length,
+ * that a replay seed reproduces a run's probability trigs, that a
+ * saved pattern goes to the SD directory and comes back from it in a
+ * fresh sequencer, and that a step edit the bank's shared page pool
+ * cannot hold is refused.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_sequencer
+ *   ./build/test_sequencer
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <filesystem>
+#include "host_hal.h"
+#include <AudioStream.h>
+#include "sequencer.h"
+#include "test_common.h"
+
+struct Hit {
+    int track;
+    int step;
+    uint8_t velocity;
+    uint32_t sampleTime;
+};
+
+static std::vector<Hit> hits;
+
+static void onTrigger(int track, int step, const Step& stepData,
+                      StepLocks locks, uint32_t sampleTime) {
+    (void)locks;
+    hits.push_back({track, step, stepData.velocity, sampleTime});
+}
+
+struct Note {
+    int track;
+    int step;
+    uint8_t note;
+    uint32_t sampleTime;
+    uint32_t gateSamples;
+};
+
+static std::vector<Note> notes;
+
+static void onNote(int track, int step, const Step& stepData, StepLocks locks,
+                   uint32_t sampleTime, uint32_t gateSamples) {
+    (void)locks;
+    notes.push_back({track, step, stepData.note, sampleTime, gateSamples});
+}
+
+static Sequencer seq;
+static uint32_t blockStart = 0;
+
+// One audio block, then loop() once, as the firmware does
+static void runBlocks(int blocks) {
+    for (int i = 0; i < blocks; i++) {
+        seq.processAudioBlock(blockStart, AUDIO_BLOCK_SAMPLES);
+        blockStart += AUDIO_BLOCK_SAMPLES;
+        hostClockAdvance((uint64_t)(AUDIO_BLOCK_SAMPLES * 1e6 / AUDIO_SAMPLE_RATE_EXACT));
+        seq.update();
+    }
+}
+
+static void runSteps(int steps, float samplesPerStep) {
+    runBlocks((int)ceilf(steps * samplesPerStep / AUDIO_BLOCK_SAMPLES));
+}
+
+static const Hit* findHit(int track, int step, int nth = 0) {
+    for (const Hit& h : hits) {
+        if (h.track == track && h.step == step && nth-- == 0) return &h;
+    }
+    return nullptr;
+}
+
+// Tick times and offsets are each truncated to whole samples
+static bool near(int32_t actual, float expected) {
+    return fabsf((float)actual - expected) <= 2.0f;
+}
+
+static void testTiming() {
+    printf("Sample clock timing\n");
+    const float sps = AUDIO_SAMPLE_RATE_EXACT * 60.0f / 120.0f / 4.0f;
+
+    seq.clearPattern();
+    seq.setStep(0, 0, true);
+    seq.setStep(0, 4, true);
+    seq.setStep(0, 8, true);
+    seq.setStep(1, 12, true);
+    seq.setMicroTiming(0, 4, 6);        // A quarter of a step late
+    seq.setMicroTiming(1, 12, -6);      // A quarter early
+    seq.setRatchet(0, 8, 3, 50);
+
+    hits.clear();
+    seq.start();
+    uint32_t origin = blockStart + SEQ_LOOKAHEAD_BLOCKS * AUDIO_BLOCK_SAMPLES;
+    runSteps(16, sps);
+    seq.stop();
+
+    const Hit* s0 = findHit(0, 0);
+    const Hit* s4 = findHit(0, 4);
+    const Hit* s12 = findHit(1, 12);
+    check(s0 && s0->sampleTime == origin, "first step lands on the look-ahead origin");
+    check(s4 && near((int32_t)(s4->sampleTime - origin), 4.25f * sps), "micro +6 is a quarter step late");
+    check(s12 && near((int32_t)(s12->sampleTime - origin), 11.75f * sps), "micro -6 is a quarter step early");
+
+    int ratchetHits = 0;
+    bool spaced = true;
+    bool decays = true;
+    const Hit* prev = nullptr;
+    for (int n = 0; n < 8; n++) {
+        const Hit* h = findHit(0, 8, n);
+        if (!h) break;
+        ratchetHits++;
+        if (prev) {
+            spaced &= near((int32_t)(h->sampleTime - prev->sampleTime), sps / 4.0f);
+            decays &= h->velocity < prev->velocity;
+        }
+        prev = h;
+    }
+    check(ratchetHits == 4, "three ratchets give four hits");
+    check(spaced, "ratchet hits split the step evenly");
+    check(decays, "ratchet hits decay");
+}
+
+static void testSynthTrack() {
+    printf("Synth track\n");
+    const float sps = AUDIO_SAMPLE_RATE_EXACT * 60.0f / 120.0f / 4.0f;
+
+    seq.clearPattern();
+    seq.setTrackType(2, TRACK_SYNTH);
+    seq.setStep(1, 0, true);
+    seq.setStep(2, 0, true);
+    seq.setNote(2, 0, 64);
+    seq.setGate(2, 0, GATE_PER_STEP * 3 / 2);
+    seq.setStep(2, 8, true);
+    seq.setRatchet(2, 8, 1, 0);
+
+    hits.clear();
+    notes.clear();
+    seq.start();
+    uint32_t origin = blockStart + SEQ_LOOKAHEAD_BLOCKS * AUDIO_BLOCK_SAMPLES;
+    runSteps(12, sps);
+    seq.stop();
+
+    check(findHit(1, 0) && !findHit(2, 0) && !findHit(2, 8), "synth steps skip the sample callback");
+    check(notes.size() == 3, "one note per step, one per ratchet hit");
+    if (notes.size() != 3) return;
+    check(notes[0].track == 2 && notes[0].step == 0 && notes[0].note == 64 &&
+          notes[0].sampleTime == origin, "note and time of the step");
+    check(near((int32_t)notes[0].gateSamples, 1.5f * sps), "gate of one and a half steps");
+    check(notes[1].note == SEQ_DEFAULT_NOTE && near((int32_t)notes[1].gateSamples, sps / 4.0f),
+          "default gate: half of a ratchet hit");
+    check(near((int32_t)(notes[2].sampleTime - notes[1].sampleTime), sps / 2.0f),
+          "ratchet hits split the step");
+}
+
+static std::vector<int> probabilityRun(int bars, float sps) {
+    hits.clear();
+    seq.start();
+    runSteps(bars * 16, sps);
+    seq.stop();
+
+    std::vector<int> steps;
+    for (const Hit& h : hits) steps.push_back(h.track * 100 + h.step);
+    return steps;
+}
+
+static void testReplaySeed() {
+    printf("Replay seed\n");
+    const float sps = AUDIO_SAMPLE_RATE_EXACT * 60.0f / 120.0f / 4.0f;
+
+    seq.clearPattern();
+    for (int t = 0; t < 4; t++) {
+        for (int s = 0; s < 16; s++) {
+            seq.setStep(t, s, true);
+            seq.setTrigCondition(t, s, TRIG_PROB);
+            seq.setProbability(t, s, 50);
+        }
+    }
+
+    seq.setReplaySeed(0x1234);
+    std::vector<int> a = probabilityRun(4, sps);
+    std::vector<int> b = probabilityRun(4, sps);
+    seq.clearReplaySeed();
+    std::vector<int> c = probabilityRun(4, sps);
+
+    int expected = 4 * 16 * 4 / 2;
+    check(!a.empty() && a == b, "same replay seed, same trigs");
+    check(abs((int)a.size() - expected) < expected / 4, "about half the trigs pass at 50%");
+    check(c != a, "a free run draws new trigs");
+}
+
+static void testSaveReload() {
+    printf("Pattern save and reload\n");
+
+    seq.clearPattern();
+    seq.setStep(2, 3, true);
+    seq.setStep(5, 11, true);
+    seq.setParamLock(5, 11, PARAM_FILTER_FREQ, 1200.0f);
+    seq.setTrackLength(5, 24);
+    seq.setTrackType(5, TRACK_SYNTH);
+    seq.setNote(5, 11, 43);
+    seq.setGate(5, 11, GATE_MAX);
+    seq.setParamLock(5, 11, PARAM_SYNTH_RELEASE, 750.0f);
+    seq.savePattern(7);
+
+    // Writeback waits for editing to go quiet, then writes one per update
+    for (int i = 0; i < MAX_PATTERNS + 1 && seq.getDirtyPatternCount() > 0; i++) {
+        hostClockAdvance((PATTERN_WRITEBACK_DELAY_MS + 10) * 1000UL);
+        seq.update();
+    }
+    check(seq.getDirtyPatternCount() == 0, "writeback drains the dirty patterns");
+    check(SD.exists("/patterns/pattern07.bin"), "pattern07.bin written to the SD directory");
+    File saved = SD.open("/patterns/pattern07.bin", FILE_READ);
+    uint32_t savedSize = saved ? saved.size() : 0;
+    if (saved) saved.close();
+    check(savedSize > sizeof(PatternFileHeader) && savedSize < sizeof(PatternFile),
+          "pattern file ends after its last page in use");
+
+    static Sequencer fresh;
+    fresh.begin(120.0f);
+    fresh.loadPattern(7);
+    check(fresh.getStep(2, 3) && fresh.getStep(5, 11), "steps come back");
+    check(!fresh.getStep(2, 4), "empty steps stay empty");
+    check(fresh.hasParamLock(5, 11, PARAM_FILTER_FREQ) &&
+          fabsf(fresh.getParamLock(5, 11, PARAM_FILTER_FREQ) - 1200.0f) < 20.0f,
+          "parameter lock comes back");
+    check(fresh.getTrackLength(5) == 24, "track length comes back");
+    check(fresh.getTrackType(5) == TRACK_SYNTH && fresh.getTrackType(2) == TRACK_SAMPLE,
+          "track types come back");
+    check(fresh.getNote(5, 11) == 43 && fresh.getGate(5, 11) == GATE_MAX &&
+          fabsf(fresh.getParamLock(5, 11, PARAM_SYNTH_RELEASE) - 750.0f) < 1.0f,
+          "synth note, gate and lock come back");
+}
+
+static void testBankFull() {
+    printf("Pattern bank page pool\n");
+
+    // Every track at full length with a step on each page: a whole
+    // pattern's worth of pages each, until the shared pool runs out
+    uint32_t refused = seq.getRefusedSteps();
+    int filled = 0;
+    int n = 16;
+    for (; n < MAX_PATTERNS; n++) {
+        seq.loadPattern(n);
+        for (int t = 0; t < MAX_TRACKS; t++) {
+            seq.setTrackLength(t, MAX_STEPS);
+            for (int s = 0; s < MAX_STEPS; s += STEPS_PER_PAGE) seq.setStep(t, s, true);
+        }
+        if (seq.getRefusedSteps() != refused) break;
+        filled++;
+    }
+    check(seq.getRefusedSteps() > refused, "a step edit is refused once the bank's pages run out");
+    check(filled >= BANK_STEP_PAGES / PATTERN_STEP_PAGES - 1 &&
+          filled <= BANK_STEP_PAGES / PATTERN_STEP_PAGES,
+          "the pool holds BANK_STEP_PAGES between the patterns");
+    check(!seq.getStep(MAX_TRACKS - 1, MAX_STEPS - STEPS_PER_PAGE), "the refused step stays empty");
+
+    // Clearing a full pattern returns its pages for the refused edit
+    int full = n;
+    seq.loadPattern(16);
+    seq.clearPattern();
+    seq.loadPattern(full);
+    refused = seq.getRefusedSteps();
+    int last = MAX_STEPS - STEPS_PER_PAGE;
+    seq.setStep(MAX_TRACKS - 1, last, true);
+    check(seq.getRefusedSteps() == refused && seq.getStep(MAX_TRACKS - 1, last),
+          "clearing a pattern gives its pages back");
+}
+
+int main() {
+    printf("Sequencer host test\n");
+
+    char dir[] = "/tmp/omo_sd_XXXXXX";
+    if (!mkdtemp(dir) || !hostSdMount(dir)) {
+        printf("  FAIL  cannot create a temporary SD directory\n");
+        return 1;
+    }
+    hostSerialEcho(false);
+    SD.begin(BUILTIN_SDCARD);
+    SD.mkdir(PATTERNS_DIR);
+
+    seq.begin(120.0f);
+    seq.setTriggerCallback(onTrigger);
+    seq.setNoteCallback(onNote);
+    seq.setClockSource(CLOCK_AUDIO);
+
+    testTiming();
+    testSynthTrack();
+    testReplaySeed();
+    testSaveReload();
+    testBankFull();
+
+    std::filesystem::remove_all(dir);
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+/**
+ * Oh My Ondas - Smoothed Audio Host Test
+ *
+ * Runs on the development machine, not the Teensy, against the host HAL
+ * (native/). A DC source goes through AudioAmpSmooth and, for
+ * comparison, the plain AudioAmplifier, and two DC sources through
+ * AudioMixer4Smooth. Checks that a gain change ramps over the slew time
+ * and ends exactly on target, that gainNow() does not ramp, that a new
+ * target mid-ramp carries on from where the ramp is, that a crossfade
+ * keeps the sum, that modulate() scales a gain over one block and lets
+ * go of it exactly, and that FilterSmoother steps a cutoff evenly in
+ * octaves. Prints the largest sample-to-sample step of a gain change
+ * with and without the ramp.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_smoothed_audio
+ *   ./build/test_smoothed_audio
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "host_hal.h"
+#include <Audio.h>
+#include "smoothed_audio.h"
+#include "test_common.h"
+
+// Constant output
+class DcSource : public AudioStream {
+public:
+    DcSource() : AudioStream(0, nullptr), level(16384) {}
+    int16_t level;
+
+    virtual void update(void) {
+        audio_block_t* block = allocate();
+        if (!block) return;
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) block->data[i] = level;
+        transmit(block);
+        release(block);
+    }
+};
+
+static DcSource          dcA, dcB;
+static AudioAmpSmooth    ampSmooth;
+static AudioAmplifier    ampPlain;
+static AudioMixer4Smooth mix;
+static AudioOutputI2S    outAmp;        // Left: smoothed, right: plain
+static AudioOutputI2S    outMix;
+
+static AudioConnection c1(dcA, ampSmooth);
+static AudioConnection c2(dcA, ampPlain);
+static AudioConnection c3(ampSmooth, 0, outAmp, 0);
+static AudioConnection c4(ampPlain, 0, outAmp, 1);
+static AudioConnection c5(dcA, 0, mix, 0);
+static AudioConnection c6(dcB, 0, mix, 1);
+static AudioConnection c7(mix, 0, outMix, 0);
+
+static const int SLEW_SAMPLES = (int)(GAIN_SLEW_MS * AUDIO_SAMPLE_RATE_EXACT / 1000.0f);
+
+// Renders blocks and appends what each output received
+struct Capture {
+    std::vector<int16_t> smooth, plain, mixed;
+
+    void run(int blocks) {
+        for (int b = 0; b < blocks; b++) {
+            hostAudioUpdate();
+            smooth.insert(smooth.end(), outAmp.left, outAmp.left + AUDIO_BLOCK_SAMPLES);
+            plain.insert(plain.end(), outAmp.right, outAmp.right + AUDIO_BLOCK_SAMPLES);
+            mixed.insert(mixed.end(), outMix.left, outMix.left + AUDIO_BLOCK_SAMPLES);
+        }
+    }
+};
+
+// From sample `from` on, including the step into it
+static int largestStep(const std::vector<int16_t>& v, size_t from = 1) {
+    int worst = 0;
+    for (size_t i = from ? from : 1; i < v.size(); i++) {
+        int d = abs(v[i] - v[i - 1]);
+        if (d > worst) worst = d;
+    }
+    return worst;
+}
+
+static void testAmp() {
+    printf("Amplifier\n");
+    ampSmooth.gainNow(0.2f);
+    ampPlain.gain(0.2f);
+    Capture cap;
+    cap.run(2);
+    check(cap.smooth.back() == (int16_t)(16384 * 0.2f), "gainNow: at the next block");
+
+    // 0.2 -> 0.8: one step on the plain amplifier, a ramp here
+    size_t from = cap.smooth.size();
+    ampSmooth.gain(0.8f);
+    ampPlain.gain(0.8f);
+    cap.run(8);
+    int smoothStep = largestStep(cap.smooth, from);
+    int plainStep = largestStep(cap.plain, from);
+    printf("  0.2 -> 0.8 on a half-scale DC: largest step %d (plain amplifier %d)\n",
+           smoothStep, plainStep);
+    check(plainStep > 9000, "plain amplifier steps in one sample");
+    check(smoothStep <= 9830 / SLEW_SAMPLES + 2, "ramp: step of 1/slew of the change");
+
+    bool rising = true;
+    for (size_t i = from + 1; i < from + SLEW_SAMPLES; i++) {
+        if (cap.smooth[i] < cap.smooth[i - 1]) rising = false;
+    }
+    check(rising, "ramp rises monotonically");
+    int16_t end = (int16_t)(16384 * 0.8f);
+    check(cap.smooth[from + SLEW_SAMPLES - 2] < end && cap.smooth[from + SLEW_SAMPLES - 1] == end,
+          "reaches the target exactly after GAIN_SLEW_MS");
+    check(cap.smooth.back() == end, "stays there");
+
+    // New target half way: carries on from where the ramp is
+    from = cap.smooth.size();
+    ampSmooth.gain(0.0f);
+    cap.run(2);
+    ampSmooth.gain(1.0f);
+    cap.run(8);
+    check(largestStep(cap.smooth, from) <= 16384 / SLEW_SAMPLES + 2, "retarget mid-ramp: no jump");
+    check(cap.smooth.back() == 16384, "unity: passes the input through");
+
+    ampSmooth.slew(50.0f);
+    ampSmooth.gain(0.0f);
+    cap = Capture();
+    cap.run(8);
+    check(cap.smooth.back() > 0, "longer slew: still on its way after 8 blocks");
+    cap.run(12);
+    check(cap.smooth.back() == 0, "then silent");
+    ampSmooth.slew(GAIN_SLEW_MS);
+}
+
+static void testMixer() {
+    printf("Mixer\n");
+    dcB.level = 16384;
+    mix.gainNow(0, 1.0f);
+    mix.gainNow(1, 0.0f);
+    Capture cap;
+    cap.run(2);
+    check(cap.mixed.back() == 16384, "one channel open");
+
+    // Crossfade: the two ramps move together, so the sum holds
+    mix.gain(0, 0.0f);
+    mix.gain(1, 1.0f);
+    cap = Capture();
+    cap.run(8);
+    int worst = 0;
+    for (int16_t v : cap.mixed) {
+        if (abs(v - 16384) > worst) worst = abs(v - 16384);
+    }
+    check(worst <= 2, "equal crossfade keeps the sum");
+
+    dcB.level = 8000;
+    cap.run(1);
+    size_t from = cap.mixed.size();
+    mix.gain(0, 1.0f);
+    cap.run(8);
+    check(cap.mixed.back() == 16384 + 8000, "both channels summed");
+    check(largestStep(cap.mixed, from) <= 16384 / SLEW_SAMPLES + 2, "channel opened without a step");
+    dcB.level = 16384;
+}
+
+static void testModulation() {
+    printf("Modulation\n");
+    ampSmooth.gainNow(0.5f);
+    Capture cap;
+    cap.run(2);
+
+    // A factor on top of the set gain: one block, no step
+    size_t from = cap.smooth.size();
+    ampSmooth.modulate(0.5f);
+    cap.run(1);
+    check(cap.smooth.back() == 4096, "modulate: set gain x factor within one block");
+    check(largestStep(cap.smooth, from) <= 4096 / AUDIO_BLOCK_SAMPLES + 2, "modulate: ramped");
+
+    // A new set gain under modulation still takes the slew time
+    from = cap.smooth.size();
+    ampSmooth.gain(1.0f);
+    cap.run(8);
+    check(cap.smooth.back() == 8192, "set gain under modulation");
+    check(largestStep(cap.smooth, from) <= 4096 / SLEW_SAMPLES + 2, "set gain: slewed, not one block");
+
+    ampSmooth.modulate(1.0f);
+    cap.run(2);
+    check(cap.smooth.back() == 16384, "factor 1: back on the set gain exactly");
+}
+
+// Records what the smoother writes, in place of a library filter
+struct FakeFilter {
+    std::vector<float> freq, res;
+    void frequency(float f) { freq.push_back(f); }
+    void resonance(float r) { res.push_back(r); }
+};
+
+static void testFilter() {
+    printf("Filter\n");
+    FakeFilter f;
+    FilterSmoother<FakeFilter> s;
+    s.begin(&f, 1000.0f, 0.7f);
+    check(f.freq.size() == 1 && fabsf(f.freq[0] - 1000.0f) < 0.01f, "begin: set at once");
+
+    s.update();
+    check(f.freq.size() == 1, "nothing written while steady");
+
+    int blocks = (int)(FILTER_SLEW_MS * AUDIO_SAMPLE_RATE_EXACT / (1000.0f * AUDIO_BLOCK_SAMPLES) + 0.5f);
+    if (blocks < 1) blocks = 1;
+    s.frequency(4000.0f);
+    s.resonance(1.7f);
+    for (int i = 0; i < blocks + 2; i++) s.update();
+    check((int)f.freq.size() == 1 + blocks, "one write per block for FILTER_SLEW_MS");
+    check(fabsf(f.freq.back() - 4000.0f) < 0.1f && fabsf(f.res.back() - 1.7f) < 1e-5f,
+          "ends on target");
+
+    // Two octaves in equal ratios
+    bool even = true;
+    float ratio = powf(4.0f, 1.0f / blocks);
+    float prev = 1000.0f;
+    for (size_t i = 1; i < f.freq.size(); i++) {
+        if (fabsf(f.freq[i] / prev - ratio) > 1e-3f) even = false;
+        prev = f.freq[i];
+    }
+    check(even, "steps evenly in octaves");
+
+    s.frequencyNow(200.0f);
+    s.update();
+    check(fabsf(f.freq.back() - 200.0f) < 0.01f && fabsf(s.getFrequency() - 200.0f) < 0.01f,
+          "frequencyNow: no ramp");
+}
+
+int main() {
+    printf("Smoothed audio host test\n");
+    hostSerialEcho(false);
+    AudioMemory(32);
+
+    testAmp();
+    testMixer();
+    testModulation();
+    testFilter();
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+/**
+ * Oh My Ondas - SPSC Queue Host Test
+ *
+ * Runs on the development machine, not the Teensy. Checks the basic ring
+ * semantics of SPSCQueue, then stresses it with a real producer thread
+ * and consumer thread (standing in for loop() and the audio ISR) and
+ * verifies every command arrives exactly once, in order, intact.
+ *
+ * Build & run:
+ *   g++ -std=c++17 -O2 -pthread -I../../teensy/include \
+ *       test_spsc_queue.cpp -o test_spsc_queue && ./test_spsc_queue
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <thread>
+#include "spsc_queue.h"
+#include "test_common.h"
+
+// Same shape as AudioCommand (audio_commands.h), kept local so this test
+// only depends on the queue header
+struct TestCommand {
+    uint32_t when;
+    uint8_t type;
+    uint8_t track;
+    uint8_t param;
+    float value;
+};
+
+static void testBasics() {
+    printf("Basics\n");
+    SPSCQueue<int, 8> q;
+    int v = 0;
+
+    check(q.empty() && q.size() == 0, "starts empty");
+    check(!q.pop(v), "pop on empty fails");
+    check(q.front() == nullptr, "front on empty is null");
+
+    bool allPushed = true;
+    for (int i = 0; i < 8; i++) allPushed &= q.push(i);
+    check(allPushed, "fills to full capacity");
+    check(!q.push(99), "push on full fails");
+    check(q.size() == 8, "size reports capacity when full");
+
+    check(q.front() && *q.front() == 0, "front is oldest");
+    q.drop();
+    check(q.pop(v) && v == 1, "pop after drop returns next");
+
+    // Wrap the indices many times around the ring
+    bool order = true;
+    int next = 2;
+    for (int i = 8; i < 70000; i++) {
+        order &= q.push(i);
+        order &= q.pop(v) && v == next++;
+    }
+    check(order, "FIFO order across 16-bit index wrap");
+
+    q.clear();
+    check(q.empty(), "clear empties the queue");
+}
+
+static void testThreaded() {
+    printf("Producer/consumer threads\n");
+
+    const uint32_t count = 500000;
+    SPSCQueue<TestCommand, 256> q;
+
+    uint32_t received = 0;
+    uint32_t outOfOrder = 0;
+    uint32_t corrupt = 0;
+    uint32_t fullSpins = 0;
+
+    std::thread consumer([&]() {
+        TestCommand cmd;
+        uint32_t expected = 0;
+        while (expected < count) {
+            // Exercise both consumer paths: front()/drop() and pop()
+            const TestCommand* f = q.front();
+            if (f == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (expected & 1) {
+                cmd = *f;
+                q.drop();
+            } else if (!q.pop(cmd)) {
+                corrupt++;
+                break;
+            }
+
+            if (cmd.when != expected) outOfOrder++;
+            if (cmd.track != (uint8_t)(expected % 8) ||
+                cmd.param != (uint8_t)(expected >> 3) ||
+                cmd.value != (float)(expected & 0xFFFF)) {
+                corrupt++;
+            }
+            expected++;
+            received++;
+        }
+    });
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < count; i++) {
+            TestCommand cmd;
+            cmd.when = i;
+            cmd.type = 0;
+            cmd.track = (uint8_t)(i % 8);
+            cmd.param = (uint8_t)(i >> 3);
+            cmd.value = (float)(i & 0xFFFF);
+            while (!q.push(cmd)) {
+                fullSpins++;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    printf("  (%u commands, producer hit full %u times)\n", count, fullSpins);
+    check(received == count, "every command received");
+    check(outOfOrder == 0, "commands received in order");
+    check(corrupt == 0, "command payloads intact");
+    check(q.empty(), "queue drained");
+}
+
+int main() {
+    printf("SPSCQueue host test\n");
+    testBasics();
+    testThreaded();
+    printf("\n%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/**
+ * Oh My Ondas - Task Scheduler Host Test
+ *
+ * Runs on the development machine, not the Teensy, against the host HAL
+ * (native/). micros() is the simulated clock, and each test task
+ * "executes" by advancing it, so every timing below is exact. Checks
+ * that per-pass tasks run on every pass, that one periodic slice runs
+ * per pass in priority order, that a sliced job lets input run between
+ * its slices and yields to a more urgent release, and the execution
+ * time, response time, deadline and skip statistics.
+ *
+ * Build & run (from firmware/):
+ *   cmake -S . -B build && cmake --build build --target test_task_scheduler
+ *   ./build/test_task_scheduler
+ */
+
+#include <stdio.h>
+#include <string>
+#include "host_hal.h"
+#include "task_scheduler.h"
+#include "test_common.h"
+
+// Execution trace, one letter per slice
+static std::string trace;
+
+static bool inputTask() {
+    trace += 'i';
+    hostClockAdvance(100);
+    return true;
+}
+
+static bool urgentTask() {
+    trace += 'U';
+    hostClockAdvance(500);
+    return true;
+}
+
+static bool normalTask() {
+    trace += 'N';
+    hostClockAdvance(1000);
+    return true;
+}
+
+// A 4-slice job of 3 ms per slice, like an LCD frame
+static int frameSlice = 0;
+static bool frameTask() {
+    trace += 'F';
+    hostClockAdvance(3000);
+    if (++frameSlice < 4) return false;
+    frameSlice = 0;
+    return true;
+}
+
+// Blocks for stallMicros once, then is quick
+static uint32_t stallMicros = 0;
+static bool stallTask() {
+    trace += 'S';
+    hostClockAdvance(stallMicros ? stallMicros : 200);
+    stallMicros = 0;
+    return true;
+}
+
+// Runs passes until `micros` of simulated time have gone by
+static void runFor(uint32_t micros, TaskScheduler& s) {
+    uint64_t until = hostClockMicros() + micros;
+    while (hostClockMicros() < until) {
+        s.run();
+        hostClockAdvance(10);   // The rest of loop()
+    }
+}
+
+static int countOf(const std::string& t, char c) {
+    int n = 0;
+    for (char x : t) n += (x == c);
+    return n;
+}
+
+static void testOrdering() {
+    printf("Every-pass and priority order\n");
+    TaskScheduler s;
+    s.addEveryPass("input", inputTask);
+    s.addPeriodic("normal", normalTask, 50, TASK_PRIO_NORMAL);
+    s.addPeriodic("urgent", urgentTask, 50, TASK_PRIO_HIGH);
+
+    trace.clear();
+    s.run();
+    s.run();
+    s.run();
+    check(trace == "iUiNi", "input every pass, one periodic slice per pass, high priority first");
+
+    trace.clear();
+    runFor(1000000, s);
+    check(countOf(trace, 'U') == 20 && countOf(trace, 'N') == 20, "50ms tasks run 20 times a second");
+    check(s.getTask(1).stats.deadlineMisses == 0 && s.getTask(1).stats.skipped == 0,
+          "no misses or skips when idle");
+}
+
+static void testSlicing() {
+    printf("Sliced jobs\n");
+    TaskScheduler s;
+    s.addEveryPass("input", inputTask);
+    int frame = s.addPeriodic("frame", frameTask, 50, TASK_PRIO_NORMAL);
+    int urgent = s.addPeriodic("urgent", urgentTask, 5, TASK_PRIO_HIGH);
+
+    trace.clear();
+    frameSlice = 0;
+    for (int i = 0; i < 7; i++) s.run();
+    // Pass 1: urgent (both released, high first); then frame slices. The
+    // urgent releases at 5 and 10 ms land mid-frame and go between slices.
+    check(trace == "iUiFiFiUiFiUiF", "input between slices, urgent release preempts a frame");
+
+    const TaskStats& f = s.getTask(frame).stats;
+    check(f.jobs == 1 && f.slices == 4, "four slices make one job");
+    check(f.worstSliceUs == 3000 && f.worstJobUs == 12000, "slice and job execution time");
+    check(s.getWorstPassUs() == 3100, "worst pass is one slice plus input");
+    check(f.worstResponseUs == 12000 + 3 * 500 + 7 * 100, "response time includes preemption");
+    check(s.getTask(urgent).stats.averageJobUs() == 500, "average job time");
+}
+
+static void testDeadlinesAndSkips() {
+    printf("Deadlines and skips\n");
+    TaskScheduler s;
+    s.addEveryPass("input", inputTask);
+    int st = s.addPeriodic("stall", stallTask, 10, TASK_PRIO_NORMAL, 5);
+
+    trace.clear();
+    runFor(45000, s);       // Releases at 0, 10, ... 40 ms
+    const TaskStats& a = s.getTask(st).stats;
+    check(a.jobs == 5 && a.deadlineMisses == 0, "on time under the deadline");
+
+    // One 35 ms stall at the 50 ms release: a deadline miss, then a skip
+    // to 10 ms after it ends instead of three late jobs back to back
+    stallMicros = 35000;
+    runFor(100000, s);
+    const TaskStats& b = s.getTask(st).stats;
+    check(b.deadlineMisses == 1, "long job misses its deadline");
+    check(b.skipped == 1, "a task periods behind skips ahead");
+    check(b.jobs == 5 + 1 + 5, "no catch-up burst after the stall");
+    check(b.worstJobUs == 35000, "worst job time");
+
+    s.resetStats();
+    check(s.getTask(st).stats.jobs == 0 && s.getWorstPassUs() == 0, "stats reset");
+}
+
+int main() {
+    hostSerialEcho(false);
+    testOrdering();
+    testSlicing();
+    testDeadlinesAndSkips();
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}